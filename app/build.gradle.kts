@@ -25,6 +25,15 @@ android {
             //noinspection ChromeOsAbiSupport
             abiFilters += listOf("arm64-v8a")
         }
+
+        externalNativeBuild {
+            cmake {
+                // nativesensor_bench is only built on request: -Pnativesensor.bench=true
+                if (providers.gradleProperty("nativesensor.bench").orNull == "true") {
+                    arguments += "-DNATIVESENSOR_BUILD_BENCH=ON"
+                }
+            }
+        }
     }
 
     externalNativeBuild {
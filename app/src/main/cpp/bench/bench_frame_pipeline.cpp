@@ -0,0 +1,168 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.h"
+#include "frame_buffer_pool.h"
+#include "frame_dispatcher.h"
+#include "frame_latency_tracker.h"
+#include "yuv_convert.h"
+
+namespace {
+constexpr size_t kPoolSlots = 8;
+constexpr int32_t kPacedRateHz = 90;
+constexpr int64_t kNsPerUs = 1'000;
+constexpr auto kDrainTimeout = std::chrono::seconds(2);
+
+struct PipelineRun {
+    int32_t width;
+    int32_t height;
+    bool paced;         // Camera-rate producer, otherwise back-to-back frames
+};
+
+constexpr PipelineRun kRuns[] = {
+    {1280, 720, true},
+    {2048, 1536, true},
+    {1280, 720, false},
+    {2048, 1536, false},
+};
+
+/// Same pixel-stride 2 source the HAL hands the image reader (see bench_yuv.cpp)
+struct SourceImage {
+    std::vector<uint8_t> luma;
+    std::vector<uint8_t> chroma;
+    nativesensor::YuvPlanes planes;
+
+    SourceImage(int32_t width, int32_t height)
+        : luma(static_cast<size_t>(width) * height, 16),
+          chroma(static_cast<size_t>(width) * height / 2, 128) {
+        planes.y = luma.data();
+        planes.u = chroma.data();
+        planes.v = chroma.data() + 1;
+        planes.yRowStride = width;
+        planes.uvRowStride = width;
+        planes.uvPixelStride = 2;
+        planes.width = width;
+        planes.height = height;
+    }
+};
+}
+
+namespace nativesensor::bench {
+
+/// Image-reader-side work of CameraEncoderBridge (pool acquire, repack, submit) feeding a
+/// FrameDispatcher whose sink stands in for the JNI upcall. Latency runs from the synthetic
+/// exposure timestamp to the sink, the JniDelivered stage of a real capture minus the JVM.
+/// Per-op statistics are per-frame latencies rather than timed samples.
+void runFramePipelineBenchmarks(BenchSuite& suite) {
+    for (const PipelineRun& run : kRuns) {
+        const std::string name = "frame_pipeline/" + std::to_string(run.width) + "x" +
+                                 std::to_string(run.height) +
+                                 (run.paced ? "/paced_90hz" : "/unpaced");
+        if (!suite.enabled(name)) {
+            continue;
+        }
+        fprintf(stderr, "%s ...\n", name.c_str());
+
+        const int64_t frameTarget = run.paced
+            ? (suite.config().quick ? 1 : 4) * kPacedRateHz
+            : (suite.config().quick ? 200 : 2000);
+
+        const SourceImage source(run.width, run.height);
+        const size_t frameSize = yuvBufferSize(YuvOutputFormat::I420, run.width, run.height);
+        FrameBufferPool pool;
+        if (!pool.allocate(kPoolSlots, frameSize)) {
+            fprintf(stderr, "  failed to allocate frame pool\n");
+            continue;
+        }
+
+        FrameLatencyTracker latency;
+        FrameDispatcher dispatcher;
+        uint64_t checksum = 0;
+        dispatcher.start([&latency, &checksum](const DispatchedFrame& frame) {
+            // Touch the payload the way a consumer reading the direct ByteBuffer would
+            checksum += frame.buffer.data()[0] + frame.buffer.data()[frame.buffer.size() - 1];
+            latency.record(LatencyStage::JniDelivered, frame.metadata.timestampNs);
+        }, FrameDropPolicy::DropOldest);
+
+        int64_t submitted = 0;
+        const auto period = std::chrono::nanoseconds(1'000'000'000LL / kPacedRateHz);
+        auto nextFrame = std::chrono::steady_clock::now();
+        const int64_t startNs = monotonicNowNs();
+
+        for (int64_t frameNumber = 0; frameNumber < frameTarget; ++frameNumber) {
+            if (run.paced) {
+                std::this_thread::sleep_until(nextFrame);
+                nextFrame += period;
+            }
+
+            const int64_t exposureNs = bootTimeNowNs();
+            latency.onFrameStarted(frameNumber, exposureNs);
+
+            FrameBufferHandle frame = pool.acquire();
+            if (!frame) {
+                latency.onBufferLost();
+                continue;
+            }
+            convertYuv420888(source.planes, YuvOutputFormat::I420, frame.data());
+            frame.setSize(frameSize);
+
+            FrameMetadata metadata;
+            metadata.timestampNs = exposureNs;
+            metadata.width = run.width;
+            metadata.height = run.height;
+            metadata.format = static_cast<int32_t>(YuvOutputFormat::I420);
+            metadata.frameNumber = frameNumber;
+            dispatcher.submit(std::move(frame), metadata);
+            submitted++;
+        }
+
+        // Let the sink finish queued frames before reading the counters
+        const auto deadline = std::chrono::steady_clock::now() + kDrainTimeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            const FrameDispatchStats stats = dispatcher.getStats();
+            if (stats.deliveredFrames + stats.droppedFrames >= submitted) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const int64_t elapsedNs = monotonicNowNs() - startNs;
+        const FrameDispatchStats dispatchStats = dispatcher.getStats();
+        dispatcher.stop();
+        doNotOptimize(checksum);
+
+        const FrameLatencySnapshot snapshot = latency.snapshot();
+        const LatencySummary& delivered =
+            snapshot.stages[static_cast<size_t>(LatencyStage::JniDelivered)];
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = static_cast<int64_t>(delivered.count);
+        result.samples = 1;
+        result.nsPerOpMin = static_cast<double>(delivered.minUs) * kNsPerUs;
+        result.nsPerOpMedian = static_cast<double>(delivered.p50Us) * kNsPerUs;
+        result.nsPerOpMean = static_cast<double>(delivered.meanUs) * kNsPerUs;
+        result.nsPerOpP99 = static_cast<double>(delivered.p99Us) * kNsPerUs;
+        result.nsPerOpMax = static_cast<double>(delivered.maxUs) * kNsPerUs;
+        if (elapsedNs > 0) {
+            result.opsPerSecond = static_cast<double>(dispatchStats.deliveredFrames) * 1e9 /
+                                  static_cast<double>(elapsedNs);
+            result.bytesPerSecond = result.opsPerSecond * static_cast<double>(frameSize);
+        }
+        result.metrics = {
+            {"latency_us_p95", delivered.p95Us},
+            {"frames_submitted", static_cast<double>(submitted)},
+            {"frames_delivered", static_cast<double>(dispatchStats.deliveredFrames)},
+            {"frames_dropped", static_cast<double>(dispatchStats.droppedFrames)},
+            {"pool_starvation", static_cast<double>(pool.getStats().starvationCount)},
+            {"frame_rate_hz", snapshot.frameRateHz},
+            {"jitter_us", snapshot.jitterUs},
+        };
+        suite.add(std::move(result));
+    }
+}
+
+}  // namespace nativesensor::bench
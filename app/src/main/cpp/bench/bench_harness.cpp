@@ -0,0 +1,199 @@
+#include "bench_harness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <thread>
+
+#include <sys/system_properties.h>
+
+#include "yuv_convert.h"
+
+namespace {
+constexpr int64_t kNsPerSecond = 1'000'000'000LL;
+// Calibration stops growing the batch here even if a sample is still too short
+constexpr int64_t kMaxIterations = 1LL << 34;
+
+int64_t clockNs(clockid_t clock) noexcept {
+    struct timespec t{};
+    clock_gettime(clock, &t);
+    return static_cast<int64_t>(t.tv_sec) * kNsPerSecond + t.tv_nsec;
+}
+
+int64_t timeBody(const nativesensor::bench::BenchBody& body, int64_t iterations) {
+    const int64_t start = nativesensor::bench::monotonicNowNs();
+    body(iterations);
+    return nativesensor::bench::monotonicNowNs() - start;
+}
+
+std::string systemProperty(const char* name) {
+    char value[PROP_VALUE_MAX] = {};
+    __system_property_get(name, value);
+    return value;
+}
+
+void writeJsonString(FILE* out, const std::string& value) {
+    fputc('"', out);
+    for (const char c : value) {
+        switch (c) {
+            case '"':  fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\t': fputs("\\t", out); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    fprintf(out, "\\u%04x", c);
+                } else {
+                    fputc(c, out);
+                }
+        }
+    }
+    fputc('"', out);
+}
+
+void writeJsonNumber(FILE* out, double value) {
+    // JSON has no NaN/Inf
+    if (std::isfinite(value)) {
+        fprintf(out, "%.6g", value);
+    } else {
+        fputs("null", out);
+    }
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+}
+
+namespace nativesensor::bench {
+
+int64_t monotonicNowNs() noexcept {
+    return clockNs(CLOCK_MONOTONIC);
+}
+
+int64_t bootTimeNowNs() noexcept {
+    return clockNs(CLOCK_BOOTTIME);
+}
+
+bool BenchSuite::enabled(const std::string& name) const {
+    return config_.filter.empty() || name.find(config_.filter) != std::string::npos;
+}
+
+BenchResult* BenchSuite::measure(const std::string& name, const BenchBody& body, size_t bytesPerOp) {
+    if (!enabled(name)) {
+        return nullptr;
+    }
+    fprintf(stderr, "%s ...\n", name.c_str());
+
+    // Warm up caches and branch predictors, then grow the batch until one sample is long enough
+    int64_t iterations = 1;
+    int64_t elapsedNs = timeBody(body, iterations);
+    while (elapsedNs < config_.minSampleNs && iterations < kMaxIterations) {
+        const int64_t scale = elapsedNs > 0 ? (config_.minSampleNs * 12 / 10) / elapsedNs : 100;
+        iterations *= std::clamp<int64_t>(scale, 2, 100);
+        elapsedNs = timeBody(body, iterations);
+    }
+
+    std::vector<double> nsPerOp;
+    nsPerOp.reserve(static_cast<size_t>(config_.repetitions));
+    for (int32_t i = 0; i < config_.repetitions; ++i) {
+        nsPerOp.push_back(static_cast<double>(timeBody(body, iterations)) /
+                          static_cast<double>(iterations));
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.samples = static_cast<int32_t>(nsPerOp.size());
+    result.nsPerOpMin = nsPerOp.front();
+    result.nsPerOpMax = nsPerOp.back();
+    result.nsPerOpMedian = percentile(nsPerOp, 0.5);
+    result.nsPerOpP99 = percentile(nsPerOp, 0.99);
+    double sum = 0.0;
+    for (const double value : nsPerOp) {
+        sum += value;
+    }
+    result.nsPerOpMean = sum / static_cast<double>(nsPerOp.size());
+    if (result.nsPerOpMedian > 0.0) {
+        result.opsPerSecond = 1e9 / result.nsPerOpMedian;
+        result.bytesPerSecond = result.opsPerSecond * static_cast<double>(bytesPerOp);
+    }
+    return add(std::move(result));
+}
+
+BenchResult* BenchSuite::add(BenchResult result) {
+    fprintf(stderr, "  %-56s %12.1f ns/op %14.0f ops/s\n",
+            result.name.c_str(), result.nsPerOpMedian, result.opsPerSecond);
+    results_.push_back(std::move(result));
+    return &results_.back();
+}
+
+void BenchSuite::writeJson(FILE* out) const {
+    fputs("{\n  \"environment\": {\n", out);
+
+    const std::pair<const char*, const char*> properties[] = {
+        {"device", "ro.product.model"},
+        {"manufacturer", "ro.product.manufacturer"},
+        {"soc", "ro.soc.model"},
+        {"abi", "ro.product.cpu.abi"},
+        {"sdk", "ro.build.version.sdk"},
+        {"fingerprint", "ro.build.fingerprint"},
+    };
+    for (const auto& [key, property] : properties) {
+        fprintf(out, "    \"%s\": ", key);
+        writeJsonString(out, systemProperty(property));
+        fputs(",\n", out);
+    }
+    fprintf(out, "    \"cpu_count\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(out, "    \"timestamp\": %lld,\n", static_cast<long long>(time(nullptr)));
+    fputs("    \"yuv_kernels\": ", out);
+    writeJsonString(out, yuvKernelSetName(activeYuvKernelSet()));
+#if NATIVESENSOR_TRACING
+    fputs(",\n    \"tracing\": true,\n", out);
+#else
+    fputs(",\n    \"tracing\": false,\n", out);
+#endif
+#ifdef NDEBUG
+    fputs("    \"build\": \"release\",\n", out);
+#else
+    fputs("    \"build\": \"debug\",\n", out);
+#endif
+    fprintf(out, "    \"repetitions\": %d,\n", config_.repetitions);
+    fprintf(out, "    \"quick\": %s\n  },\n", config_.quick ? "true" : "false");
+
+    fputs("  \"benchmarks\": [", out);
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const BenchResult& result = results_[i];
+        fputs(i == 0 ? "\n" : ",\n", out);
+        fputs("    {\"name\": ", out);
+        writeJsonString(out, result.name);
+        fprintf(out, ", \"iterations\": %lld, \"samples\": %d",
+                static_cast<long long>(result.iterations), result.samples);
+
+        const std::pair<const char*, double> fields[] = {
+            {"ns_per_op_min", result.nsPerOpMin},
+            {"ns_per_op_median", result.nsPerOpMedian},
+            {"ns_per_op_mean", result.nsPerOpMean},
+            {"ns_per_op_p99", result.nsPerOpP99},
+            {"ns_per_op_max", result.nsPerOpMax},
+            {"ops_per_second", result.opsPerSecond},
+            {"bytes_per_second", result.bytesPerSecond},
+        };
+        for (const auto& [key, value] : fields) {
+            fprintf(out, ", \"%s\": ", key);
+            writeJsonNumber(out, value);
+        }
+        for (const auto& [key, value] : result.metrics) {
+            fputs(", ", out);
+            writeJsonString(out, key);
+            fputs(": ", out);
+            writeJsonNumber(out, value);
+        }
+        fputc('}', out);
+    }
+    fputs("\n  ]\n}\n", out);
+}
+
+}  // namespace nativesensor::bench
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nativesensor::bench {
+
+/// Command-line settings shared by every benchmark
+struct BenchConfig {
+    std::string filter;             // Substring a benchmark name must contain (empty runs all)
+    int32_t repetitions = 10;       // Timed samples per benchmark
+    int64_t minSampleNs = 20'000'000;   // Each sample runs at least this long
+    bool quick = false;             // Fewer samples and shorter pipeline runs (smoke test)
+};
+
+/// Measurements for one benchmark, serialized as one JSON object
+struct BenchResult {
+    std::string name;
+    int64_t iterations = 0;         // Operations per timed sample
+    int32_t samples = 0;
+    double nsPerOpMin = 0.0;
+    double nsPerOpMedian = 0.0;
+    double nsPerOpMean = 0.0;
+    double nsPerOpP99 = 0.0;
+    double nsPerOpMax = 0.0;
+    double opsPerSecond = 0.0;      // From the median sample
+    double bytesPerSecond = 0.0;    // 0 when the benchmark has no byte payload
+    std::vector<std::pair<std::string, double>> metrics;    // Benchmark-specific extras
+};
+
+/// Timed body: performs exactly `iterations` operations
+using BenchBody = std::function<void(int64_t iterations)>;
+
+/// Collects benchmark results and writes them as a single JSON document.
+/// measure() calibrates the iteration count so each sample runs for minSampleNs, then
+/// times `repetitions` samples and reports per-operation statistics.
+class BenchSuite {
+public:
+    explicit BenchSuite(BenchConfig config) : config_(std::move(config)) {}
+
+    [[nodiscard]]
+    const BenchConfig& config() const noexcept { return config_; }
+
+    /// Whether a benchmark passes --filter
+    [[nodiscard]]
+    bool enabled(const std::string& name) const;
+
+    /// Calibrate, time and record a benchmark. bytesPerOp feeds bytesPerSecond.
+    BenchResult* measure(const std::string& name, const BenchBody& body, size_t bytesPerOp = 0);
+
+    /// Record a result produced outside measure() (e.g. paced pipeline runs)
+    BenchResult* add(BenchResult result);
+
+    /// Write {"environment": ..., "benchmarks": [...]} to out
+    void writeJson(FILE* out) const;
+
+    [[nodiscard]]
+    size_t resultCount() const noexcept { return results_.size(); }
+
+private:
+    BenchConfig config_;
+    std::vector<BenchResult> results_;
+};
+
+/// CLOCK_MONOTONIC in nanoseconds
+int64_t monotonicNowNs() noexcept;
+
+/// CLOCK_BOOTTIME in nanoseconds (the sensor and camera timestamp base)
+int64_t bootTimeNowNs() noexcept;
+
+/// Keep a value alive so the optimizer cannot drop the work that produced it
+template<typename T>
+inline void doNotOptimize(const T& value) noexcept {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Benchmark groups (one translation unit each); each runs the enabled benchmarks it owns
+void runRingBufferBenchmarks(BenchSuite& suite);
+void runYuvBenchmarks(BenchSuite& suite);
+void runImuBenchmarks(BenchSuite& suite);
+void runFramePipelineBenchmarks(BenchSuite& suite);
+
+}  // namespace nativesensor::bench
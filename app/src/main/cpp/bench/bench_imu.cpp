@@ -0,0 +1,65 @@
+#include <android/sensor.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "imu_manager.h"
+
+namespace {
+// 1 kHz IMU interleaving accel and gyro, as a typical XR sensor hub reports them
+constexpr int64_t kSamplePeriodNs = 1'000'000;
+
+// Samples between drains: one sensor-thread batch up to a quarter of the history
+constexpr size_t kDrainIntervals[] = {64, 256, 1024};
+
+std::vector<ASensorEvent> makeEvents(size_t count) {
+    std::vector<ASensorEvent> events(count);
+    const int64_t start = nativesensor::bench::bootTimeNowNs();
+    for (size_t i = 0; i < count; ++i) {
+        ASensorEvent& event = events[i];
+        event.version = sizeof(ASensorEvent);
+        event.type = (i % 2 == 0) ? ASENSOR_TYPE_ACCELEROMETER : ASENSOR_TYPE_GYROSCOPE;
+        event.timestamp = start + static_cast<int64_t>(i / 2) * kSamplePeriodNs;
+        event.data[0] = 0.01f * static_cast<float>(i);
+        event.data[1] = 9.81f;
+        event.data[2] = -0.02f * static_cast<float>(i);
+    }
+    return events;
+}
+}
+
+namespace nativesensor::bench {
+
+void runImuBenchmarks(BenchSuite& suite) {
+    ImuManager manager;
+
+    for (const size_t interval : kDrainIntervals) {
+        const std::string name = "imu_drain/inject_drain_every_" + std::to_string(interval);
+        const std::vector<ASensorEvent> events = makeEvents(interval);
+        std::vector<PackedImuSample> out(interval);
+        int64_t drained = 0;
+
+        // Sensor-thread conversion and history push, then one JNI-style drain per interval
+        BenchResult* result = suite.measure(name, [&](int64_t iterations) {
+            for (int64_t done = 0; done < iterations;) {
+                const auto batch = static_cast<size_t>(
+                    std::min<int64_t>(iterations - done, static_cast<int64_t>(interval)));
+                manager.injectEvents(events.data(), batch);
+                drained += static_cast<int64_t>(manager.drainHistory(out.data(), out.size()));
+                done += static_cast<int64_t>(batch);
+            }
+            doNotOptimize(drained);
+        }, sizeof(PackedImuSample));
+
+        if (result != nullptr) {
+            result->metrics.emplace_back("drain_interval", static_cast<double>(interval));
+            result->metrics.emplace_back("history_overflows",
+                                         static_cast<double>(manager.getHistoryOverflowCount()));
+        }
+    }
+}
+
+}  // namespace nativesensor::bench
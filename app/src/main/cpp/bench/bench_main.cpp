@@ -0,0 +1,91 @@
+// nativesensor_bench: microbenchmarks for the native capture hot paths.
+//
+//   adb push nativesensor_bench /data/local/tmp/
+//   adb shell /data/local/tmp/nativesensor_bench [--filter yuv/1920] [--quick] [--out FILE]
+//
+// Progress goes to stderr; the JSON report goes to stdout or --out.
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "bench_harness.h"
+
+namespace {
+void printUsage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --filter SUBSTR     Run only benchmarks whose name contains SUBSTR\n"
+            "  --repetitions N     Timed samples per benchmark (default 10)\n"
+            "  --min-time-ms N     Minimum duration of one sample (default 20)\n"
+            "  --quick             Short smoke run (3 samples, shorter pipeline runs)\n"
+            "  --out FILE          Write the JSON report to FILE instead of stdout\n",
+            argv0);
+}
+}
+
+int main(int argc, char** argv) {
+    using namespace nativesensor::bench;
+
+    BenchConfig config;
+    const char* outPath = nullptr;
+    bool repetitionsSet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--filter") == 0 && hasValue) {
+            config.filter = argv[++i];
+        } else if (strcmp(arg, "--repetitions") == 0 && hasValue) {
+            config.repetitions = atoi(argv[++i]);
+            repetitionsSet = true;
+        } else if (strcmp(arg, "--min-time-ms") == 0 && hasValue) {
+            config.minSampleNs = static_cast<int64_t>(atoi(argv[++i])) * 1'000'000;
+        } else if (strcmp(arg, "--quick") == 0) {
+            config.quick = true;
+        } else if (strcmp(arg, "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return strcmp(arg, "--help") == 0 ? 0 : 2;
+        }
+    }
+    if (config.quick) {
+        config.minSampleNs /= 4;
+        if (!repetitionsSet) {
+            config.repetitions = 3;
+        }
+    }
+    if (config.repetitions < 1 || config.minSampleNs < 1) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    BenchSuite suite(config);
+    runRingBufferBenchmarks(suite);
+    runYuvBenchmarks(suite);
+    runImuBenchmarks(suite);
+    runFramePipelineBenchmarks(suite);
+
+    if (suite.resultCount() == 0) {
+        fprintf(stderr, "No benchmark matches \"%s\"\n", config.filter.c_str());
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (outPath != nullptr) {
+        out = fopen(outPath, "w");
+        if (out == nullptr) {
+            fprintf(stderr, "Cannot open %s: %s\n", outPath, strerror(errno));
+            return 1;
+        }
+    }
+    suite.writeJson(out);
+    if (out != stdout) {
+        fclose(out);
+        fprintf(stderr, "Wrote %zu results to %s\n", suite.resultCount(), outPath);
+    }
+    return 0;
+}
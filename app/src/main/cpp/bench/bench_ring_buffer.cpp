@@ -0,0 +1,131 @@
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "bench_harness.h"
+#include "imu_data.h"
+#include "ring_buffer.h"
+
+namespace {
+// Matches the IMU history rings
+constexpr size_t kCapacity = 4096;
+// One sensor-thread batch
+constexpr size_t kBulkSize = 64;
+
+using nativesensor::ImuSample;
+using nativesensor::RingBuffer;
+using nativesensor::RingOverflow;
+
+template<typename T>
+T makeItem(int64_t i) noexcept;
+
+template<>
+int64_t makeItem<int64_t>(int64_t i) noexcept {
+    return i;
+}
+
+template<>
+ImuSample makeItem<ImuSample>(int64_t i) noexcept {
+    return ImuSample{static_cast<float>(i), 0.5f, -0.5f, i, nativesensor::SensorType::Accelerometer};
+}
+
+/// One thread: push then pop each item (cache-hot, measures the index bookkeeping)
+template<typename T>
+void runUncontended(nativesensor::bench::BenchSuite& suite, const std::string& name) {
+    auto ring = std::make_unique<RingBuffer<T, kCapacity>>();
+    suite.measure(name + "/push_pop", [&ring](int64_t iterations) {
+        T item{};
+        for (int64_t i = 0; i < iterations; ++i) {
+            ring->push(makeItem<T>(i));
+            ring->pop(item);
+        }
+        nativesensor::bench::doNotOptimize(item);
+    }, sizeof(T));
+}
+
+/// One thread: kBulkSize elements in and out per index publish
+template<typename T>
+void runBulk(nativesensor::bench::BenchSuite& suite, const std::string& name) {
+    auto ring = std::make_unique<RingBuffer<T, kCapacity>>();
+    T in[kBulkSize];
+    T out[kBulkSize];
+    for (size_t i = 0; i < kBulkSize; ++i) {
+        in[i] = makeItem<T>(static_cast<int64_t>(i));
+    }
+    suite.measure(name + "/push_pop_bulk_" + std::to_string(kBulkSize), [&](int64_t iterations) {
+        for (int64_t done = 0; done < iterations; done += kBulkSize) {
+            ring->pushBulk(in, kBulkSize);
+            ring->popBulk(out, kBulkSize);
+        }
+        nativesensor::bench::doNotOptimize(out[0]);
+    }, sizeof(T));
+}
+
+/// Full ring: every push drops the oldest element, as the IMU history does under backpressure
+template<typename T>
+void runOverwrite(nativesensor::bench::BenchSuite& suite, const std::string& name) {
+    auto ring = std::make_unique<RingBuffer<T, kCapacity, RingOverflow::OverwriteOldest>>();
+    for (size_t i = 0; i < kCapacity; ++i) {
+        ring->push(makeItem<T>(static_cast<int64_t>(i)));
+    }
+    suite.measure(name + "/push_overwrite_full", [&ring](int64_t iterations) {
+        for (int64_t i = 0; i < iterations; ++i) {
+            ring->push(makeItem<T>(i));
+        }
+        nativesensor::bench::doNotOptimize(ring->size());
+    }, sizeof(T));
+}
+
+/// Producer and consumer on separate threads, both spinning on full/empty.
+/// Reports the sustained transfer rate with the indices bouncing between cores.
+template<typename T>
+void runContended(nativesensor::bench::BenchSuite& suite, const std::string& name) {
+    auto ring = std::make_unique<RingBuffer<T, kCapacity>>();
+    nativesensor::bench::BenchResult* result =
+        suite.measure(name + "/spsc_contended", [&ring](int64_t iterations) {
+            std::atomic<bool> go{false};
+            std::thread producer([&ring, &go, iterations] {
+                while (!go.load(std::memory_order_acquire)) {
+                }
+                for (int64_t i = 0; i < iterations; ++i) {
+                    while (!ring->push(makeItem<T>(i))) {
+                    }
+                }
+            });
+
+            go.store(true, std::memory_order_release);
+            T item{};
+            for (int64_t received = 0; received < iterations;) {
+                if (ring->pop(item)) {
+                    ++received;
+                }
+            }
+            producer.join();
+            nativesensor::bench::doNotOptimize(item);
+        }, sizeof(T));
+
+    if (result != nullptr) {
+        result->metrics.emplace_back("capacity", static_cast<double>(kCapacity));
+    }
+}
+
+template<typename T>
+void runAll(nativesensor::bench::BenchSuite& suite, const std::string& name) {
+    runUncontended<T>(suite, name);
+    runBulk<T>(suite, name);
+    runOverwrite<T>(suite, name);
+    runContended<T>(suite, name);
+}
+}
+
+namespace nativesensor::bench {
+
+void runRingBufferBenchmarks(BenchSuite& suite) {
+    // int64 mirrors the timestamp rings; ImuSample the IMU history
+    runAll<int64_t>(suite, "ring_buffer/int64");
+    runAll<ImuSample>(suite, "ring_buffer/imu_sample");
+}
+
+}  // namespace nativesensor::bench
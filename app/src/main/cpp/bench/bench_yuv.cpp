@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "yuv_convert.h"
+
+namespace {
+// Camera HALs commonly pad rows to 64 bytes; the extra tail exercises the stride handling
+constexpr int32_t kRowAlignment = 64;
+constexpr int32_t kRowPadding = 32;
+
+struct Resolution {
+    int32_t width;
+    int32_t height;
+};
+
+// VGA tracking cameras through 2K passthrough streams
+constexpr Resolution kResolutions[] = {
+    {640, 480},
+    {1280, 720},
+    {1920, 1080},
+    {2048, 1536},
+};
+
+int32_t paddedStride(int32_t bytes) noexcept {
+    return ((bytes + kRowAlignment - 1) / kRowAlignment) * kRowAlignment + kRowPadding;
+}
+
+/// Synthetic YUV_420_888 image with HAL-like strides: pixelStride 2 mimics an NV12/NV21
+/// semi-planar buffer (U and V interleaved in one allocation), pixelStride 1 a planar one
+class SyntheticImage {
+public:
+    SyntheticImage(Resolution resolution, int32_t uvPixelStride) {
+        const int32_t chromaWidth = resolution.width / 2;
+        const int32_t chromaHeight = resolution.height / 2;
+
+        planes_.width = resolution.width;
+        planes_.height = resolution.height;
+        planes_.uvPixelStride = uvPixelStride;
+        planes_.yRowStride = paddedStride(resolution.width);
+        planes_.uvRowStride = paddedStride(chromaWidth * uvPixelStride);
+
+        luma_.resize(static_cast<size_t>(planes_.yRowStride) * resolution.height);
+        chromaU_.resize(static_cast<size_t>(planes_.uvRowStride) * chromaHeight);
+        if (uvPixelStride == 1) {
+            chromaV_.resize(chromaU_.size());
+        }
+        fill(luma_, 16);
+        fill(chromaU_, 128);
+        fill(chromaV_, 64);
+
+        planes_.y = luma_.data();
+        planes_.u = chromaU_.data();
+        planes_.v = uvPixelStride == 2 ? chromaU_.data() + 1 : chromaV_.data();
+    }
+
+    [[nodiscard]]
+    const nativesensor::YuvPlanes& planes() const noexcept { return planes_; }
+
+private:
+    static void fill(std::vector<uint8_t>& plane, uint8_t seed) {
+        for (size_t i = 0; i < plane.size(); ++i) {
+            plane[i] = static_cast<uint8_t>(seed + i * 7);
+        }
+    }
+
+    nativesensor::YuvPlanes planes_;
+    std::vector<uint8_t> luma_;
+    std::vector<uint8_t> chromaU_;
+    std::vector<uint8_t> chromaV_;
+};
+
+const char* formatName(nativesensor::YuvOutputFormat format) noexcept {
+    switch (format) {
+        case nativesensor::YuvOutputFormat::NV12:
+            return "nv12";
+        case nativesensor::YuvOutputFormat::Y8:
+            return "y8";
+        case nativesensor::YuvOutputFormat::I420:
+        default:
+            return "i420";
+    }
+}
+
+const char* scaleName(nativesensor::YuvScale scale) noexcept {
+    return scale == nativesensor::YuvScale::Half ? "half" : "quarter";
+}
+}
+
+namespace nativesensor::bench {
+
+void runYuvBenchmarks(BenchSuite& suite) {
+    std::vector<YuvKernelSet> kernelSets = {YuvKernelSet::Scalar};
+    if (activeYuvKernelSet() != YuvKernelSet::Scalar) {
+        kernelSets.push_back(activeYuvKernelSet());
+    }
+
+    for (const Resolution& resolution : kResolutions) {
+        for (const int32_t uvPixelStride : {2, 1}) {
+            const std::string prefix = "yuv/" + std::to_string(resolution.width) + "x" +
+                                       std::to_string(resolution.height) +
+                                       (uvPixelStride == 2 ? "/semiplanar" : "/planar");
+            const SyntheticImage image(resolution, uvPixelStride);
+            for (const YuvOutputFormat format :
+                 {YuvOutputFormat::I420, YuvOutputFormat::NV12, YuvOutputFormat::Y8}) {
+                const size_t frameBytes = yuvBufferSize(format, resolution.width, resolution.height);
+                std::vector<uint8_t> dst(frameBytes);
+
+                for (const YuvKernelSet kernels : kernelSets) {
+                    const std::string name = prefix + "_to_" + formatName(format) + "/" +
+                                             yuvKernelSetName(kernels);
+                    BenchResult* result = suite.measure(name, [&](int64_t iterations) {
+                        for (int64_t i = 0; i < iterations; ++i) {
+                            convertYuv420888(image.planes(), format, dst.data(), kernels);
+                        }
+                        doNotOptimize(dst.data());
+                    }, frameBytes);
+
+                    if (result != nullptr) {
+                        result->metrics.emplace_back("frame_bytes", static_cast<double>(frameBytes));
+                        result->metrics.emplace_back("y_row_stride", image.planes().yRowStride);
+                        result->metrics.emplace_back("uv_row_stride", image.planes().uvRowStride);
+                    }
+                }
+
+                // Adaptive capture path: repack and box-downscale in one pass
+                for (const YuvScale scale : {YuvScale::Half, YuvScale::Quarter}) {
+                    const size_t scaledBytes = yuvBufferSize(
+                        format, yuvScaledDimension(resolution.width, scale),
+                        yuvScaledDimension(resolution.height, scale));
+                    for (const YuvKernelSet kernels : kernelSets) {
+                        const std::string name = prefix + "_to_" + formatName(format) + "_" +
+                                                 scaleName(scale) + "/" + yuvKernelSetName(kernels);
+                        BenchResult* result = suite.measure(name, [&](int64_t iterations) {
+                            for (int64_t i = 0; i < iterations; ++i) {
+                                convertYuv420888Scaled(image.planes(), format, scale, dst.data(),
+                                                       kernels);
+                            }
+                            doNotOptimize(dst.data());
+                        }, frameBytes);
+
+                        if (result != nullptr) {
+                            result->metrics.emplace_back("frame_bytes",
+                                                         static_cast<double>(scaledBytes));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace nativesensor::bench
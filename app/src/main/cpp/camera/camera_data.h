@@ -2,6 +2,9 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
+
+#include "sync_data.h"
 
 namespace nativesensor {
 
@@ -22,6 +25,32 @@ enum class CameraFacing : int32_t {
     External = 2
 };
 
+/// How captured frames are handed to the encoder path
+enum class FrameDeliveryMode : int32_t {
+    CpuPacked = 0,      // Map each AImage and repack into a tightly packed YUV buffer
+    HardwareBuffer = 1  // Pass the AImage's AHardwareBuffer through untouched (no CPU access)
+};
+
+/// Start-of-exposure alignment between the physical cameras of a logical camera
+enum class MultiCameraSyncType : int32_t {
+    Unknown = -1,
+    Approximate = 0,    // Software-synchronized; physical timestamps only approximate
+    Calibrated = 1      // Hardware-synchronized; physical timestamps match per exposure
+};
+
+/// One output stream configuration (ACAMERA_SCALER_AVAILABLE_STREAM_CONFIGURATIONS)
+struct StreamConfiguration {
+    int32_t format = 0;             // AIMAGE_FORMAT_* / HAL pixel format
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+/// One auto-exposure target frame-rate range (ACAMERA_CONTROL_AE_AVAILABLE_TARGET_FPS_RANGES)
+struct FpsRange {
+    int32_t min = 0;
+    int32_t max = 0;
+};
+
 /// Camera metadata for enumeration and display
 struct CameraInfo {
     std::string id;
@@ -32,6 +61,15 @@ struct CameraInfo {
     int32_t maxFps = 0;
     bool isPhysicalCamera = false;
     std::string physicalCameraIds;  // Comma-separated for logical cameras
+    std::vector<StreamConfiguration> streamConfigurations;  // Output configurations only
+    std::vector<FpsRange> fpsRanges;
+};
+
+/// Physical cameras behind a logical multi-camera
+struct LogicalCameraInfo {
+    std::string id;
+    std::vector<std::string> physicalCameraIds;
+    MultiCameraSyncType syncType = MultiCameraSyncType::Unknown;
 };
 
 /// Camera frame statistics
@@ -40,15 +78,44 @@ struct CameraStats {
     float latencyMs = 0.0f;
     int64_t frameCount = 0;
     int64_t droppedFrames = 0;
+
+    // Frame buffer pool occupancy (encoder captures only; hardware buffer captures report the
+    // frames held until the consumer releases them)
+    int32_t bufferPoolCapacity = 0;
+    int32_t bufferPoolInUse = 0;
+    int64_t bufferPoolStarvations = 0;
+
+    // Frames waiting on the dispatch thread (encoder captures only)
+    int32_t dispatchQueueDepth = 0;
+
+    // Adaptation (encoder captures only): frames discarded by the frame-rate cap before
+    // conversion, and the current downscale factor (1, 2 or 4)
+    int64_t decimatedFrames = 0;
+    int32_t scaleFactor = 1;
+};
+
+/// Synchronized multi-camera capture statistics
+struct MultiCameraStats {
+    float frameSetRateHz = 0.0f;
+    float latencyMs = 0.0f;             // Latest exposure in the set to delivery
+    int64_t frameSetCount = 0;
+    int64_t incompleteFrameSets = 0;    // Evicted before every physical camera delivered
+    int64_t droppedFrames = 0;          // Images dropped before grouping (pool starvation, repack)
+    float timestampSpreadUs = 0.0f;     // Latest minus earliest exposure of the last set
+    int32_t physicalCameraCount = 0;
+    MultiCameraSyncType syncType = MultiCameraSyncType::Unknown;
 };
 
 /// Frame metadata passed with each captured frame
-struct [[maybe_unused]] FrameMetadata {
-    [[maybe_unused]] int64_t timestampNs = 0;
+struct FrameMetadata {
+    int64_t timestampNs = 0;
     int32_t width = 0;
     int32_t height = 0;
-    [[maybe_unused]] int32_t format = 0;
-    [[maybe_unused]] int64_t frameNumber = 0;
+    int32_t format = 0;         // YuvOutputFormat of the packed data
+    int32_t cropX = 0;          // Origin of the delivered window in capture pixels
+    int32_t cropY = 0;
+    int64_t frameNumber = 0;    // Sequential index within the capture
+    FrameImuSync imu{};         // IMU aligned to timestampNs (status NoData without an IMU sync)
 };
 
 }  // namespace nativesensor
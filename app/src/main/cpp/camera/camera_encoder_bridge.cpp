@@ -2,13 +2,84 @@
 
 #include <android/log.h>
 #include <media/NdkImage.h>
+#include <algorithm>
+#include <ctime>
+
+#include "camera_session_registry.h"
+#include "trace.h"
 
 namespace {
 constexpr const char* kLogTag = "NativeSensor.Encoder";
 // YUV_420_888 format
 constexpr int32_t kImageFormat = AIMAGE_FORMAT_YUV_420_888;
-// Maximum images in the reader queue
-constexpr int32_t kMaxImages = 4;
+// Opaque format for the hardware buffer path (layout chosen by the camera HAL)
+constexpr int32_t kPrivateImageFormat = AIMAGE_FORMAT_PRIVATE;
+// Consumers of the hardware buffer path: GPU import and MediaCodec input
+constexpr uint64_t kHardwareBufferUsage =
+    AHARDWAREBUFFER_USAGE_GPU_SAMPLED_IMAGE | AHARDWAREBUFFER_USAGE_VIDEO_ENCODE;
+// Longest the dispatch thread waits for the IMU to reach a frame's timestamp
+constexpr int64_t kImuAlignWaitNs = 5'000'000LL;
+constexpr int64_t kNsPerSecond = 1'000'000'000LL;
+constexpr double kNsToMs = 1'000'000.0;
+// Encoded bits per pixel per frame below which full resolution starves the encoder; about the
+// H.264 conversational operating point (1080p30 at 2.5 Mbps)
+constexpr double kMinBitsPerPixel = 0.04;
+// Frame rate assumed for the bitrate budget when no frame-rate cap is set
+constexpr double kDefaultFrameRate = 30.0;
+// A frame this fraction of the cap interval early still counts as due (timestamp jitter)
+constexpr int64_t kDecimationToleranceDivisor = 4;
+// Async trace track spanning image arrival to the end of delivery, keyed by frame number
+constexpr const char* kFrameFlowTrace = "Encoder frame";
+
+// Hardware buffer frame ids, unique across captures so a release finds its capture by id alone
+std::atomic<uint64_t> g_nextHardwareFrameId{1};
+
+/// Largest downscale-free resolution the bitrate can carry at the given frame rate
+nativesensor::YuvScale scaleForBitrate(int32_t width, int32_t height, double frameRate,
+                                       int32_t bitrateBps) noexcept {
+    using nativesensor::YuvScale;
+    if (bitrateBps <= 0 || width <= 0 || height <= 0) {
+        return YuvScale::Full;
+    }
+    const double bitsPerFrame = static_cast<double>(bitrateBps) / frameRate;
+    for (const YuvScale scale : {YuvScale::Full, YuvScale::Half}) {
+        const double pixels = static_cast<double>(nativesensor::yuvScaledDimension(width, scale)) *
+                              nativesensor::yuvScaledDimension(height, scale);
+        if (bitsPerFrame >= pixels * kMinBitsPerPixel) {
+            return scale;
+        }
+    }
+    return YuvScale::Quarter;
+}
+
+// setCropRegion() packs the window into one atomic word, 16 bits per field
+constexpr int32_t kCropFieldMax = 0xFFFF;
+
+uint64_t packCropRegion(const nativesensor::YuvCropRect& rect) noexcept {
+    auto field = [](int32_t value) {
+        return static_cast<uint64_t>(value < 0 ? 0 : value > kCropFieldMax ? kCropFieldMax : value);
+    };
+    if (rect.width <= 0 || rect.height <= 0) {
+        return 0;
+    }
+    return field(rect.x) | field(rect.y) << 16 | field(rect.width) << 32 |
+           field(rect.height) << 48;
+}
+
+nativesensor::YuvCropRect unpackCropRegion(uint64_t packed) noexcept {
+    nativesensor::YuvCropRect rect;
+    rect.x = static_cast<int32_t>(packed & kCropFieldMax);
+    rect.y = static_cast<int32_t>((packed >> 16) & kCropFieldMax);
+    rect.width = static_cast<int32_t>((packed >> 32) & kCropFieldMax);
+    rect.height = static_cast<int32_t>((packed >> 48) & kCropFieldMax);
+    return rect;
+}
+
+int64_t getBootTimeNs() noexcept {
+    struct timespec t{};
+    clock_gettime(CLOCK_BOOTTIME, &t);
+    return static_cast<int64_t>(t.tv_sec) * kNsPerSecond + t.tv_nsec;
+}
 }
 
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
@@ -17,8 +88,8 @@ constexpr int32_t kMaxImages = 4;
 
 namespace nativesensor {
 
-CameraEncoderBridge::CameraEncoderBridge(CameraManager& manager)
-    : manager_(manager) {
+CameraEncoderBridge::CameraEncoderBridge(CameraSessionRegistry& sessions)
+    : sessions_(sessions) {
     LOGI("CameraEncoderBridge created");
 }
 
@@ -29,11 +100,29 @@ CameraEncoderBridge::~CameraEncoderBridge() {
 
 bool CameraEncoderBridge::startCapture(const std::string& cameraId,
                                         int32_t width, int32_t height,
-                                        FrameDataCallback callback) {
+                                        FrameDataCallback callback,
+                                        YuvOutputFormat outputFormat) {
+    // Raw-pointer consumers only see the buffer for the duration of the call
+    auto handleCallback = [callback = std::move(callback)](FrameBufferHandle frame,
+                                                           const FrameMetadata& metadata) {
+        if (callback) {
+            callback(frame.data(), static_cast<int32_t>(frame.size()),
+                     metadata.width, metadata.height, metadata.timestampNs);
+        }
+    };
+    return startPooledCapture(cameraId, width, height, std::move(handleCallback), outputFormat);
+}
+
+bool CameraEncoderBridge::startPooledCapture(const std::string& cameraId,
+                                              int32_t width, int32_t height,
+                                              FrameHandleCallback callback,
+                                              YuvOutputFormat outputFormat) {
+    std::shared_ptr<CameraSession> session = joinSession(cameraId);
     std::lock_guard<std::mutex> lock(mutex_);
 
-    if (capturing_.load(std::memory_order_acquire)) {
-        if (currentCameraId_ == cameraId) {
+    if (session_) {
+        if (isCapturing() && currentCameraId_ == cameraId &&
+            deliveryMode_ == FrameDeliveryMode::CpuPacked && outputFormat_ == outputFormat) {
             LOGI("Already capturing camera %s, skipping restart", cameraId.c_str());
             return true;
         }
@@ -41,139 +130,216 @@ bool CameraEncoderBridge::startCapture(const std::string& cameraId,
         cleanup();
     }
 
-    if (!manager_.isValid()) {
-        LOGE("Cannot start capture: camera manager invalid");
-        return false;
-    }
+    deliveryMode_ = FrameDeliveryMode::CpuPacked;
+    outputFormat_ = outputFormat;
 
-    LOGI("Starting frame capture: %s (%dx%d)", cameraId.c_str(), width, height);
+    // Delivery happens on the dispatch thread; the image reader thread only repacks and queues
+    auto sink = [this, callback = std::move(callback), previousFrameNs = int64_t{0}](
+                    const DispatchedFrame& frame) mutable {
+        if (!callback) {
+            return;
+        }
 
-    frameCallback_ = std::move(callback);
-    currentCameraId_ = cameraId;
+        ImuFrameSync* sync = imuSync_.load(std::memory_order_acquire);
+        if (!sync) {
+            callback(frame.buffer, frame.metadata);
+            latency_.record(LatencyStage::JniDelivered, frame.metadata.timestampNs);
+            NS_TRACE_FLOW_END(kFrameFlowTrace, frame.metadata.frameNumber);
+            return;
+        }
 
-    // Create AImageReader for YUV capture
-    media_status_t mediaStatus = AImageReader_new(width, height, kImageFormat, kMaxImages, &imageReader_);
-    if (mediaStatus != AMEDIA_OK || !imageReader_) {
-        LOGE("Failed to create AImageReader: %d", mediaStatus);
-        cleanup();
-        return false;
-    }
+        FrameMetadata metadata = frame.metadata;
+        {
+            NS_TRACE_SCOPE("ImuFrameSync::alignFrame");
+            sync->alignFrame(metadata.timestampNs, previousFrameNs, metadata.imu, kImuAlignWaitNs);
+        }
+        previousFrameNs = metadata.timestampNs;
+        callback(frame.buffer, metadata);
+        latency_.record(LatencyStage::JniDelivered, metadata.timestampNs);
+        NS_TRACE_FLOW_END(kFrameFlowTrace, metadata.frameNumber);
+    };
+    dispatcher_.start(std::move(sink), dropPolicy_, dispatchHooks_);
+
+    return openCaptureSession(cameraId, width, height, std::move(session));
+}
 
-    // Set image available listener
-    imageListener_.context = this;
-    imageListener_.onImageAvailable = onImageAvailable;
-    mediaStatus = AImageReader_setImageListener(imageReader_, &imageListener_);
-    if (mediaStatus != AMEDIA_OK) {
-        LOGE("Failed to set image listener: %d", mediaStatus);
-        cleanup();
-        return false;
-    }
+void CameraEncoderBridge::setDispatchConfig(FrameDropPolicy policy, DispatcherThreadHooks hooks) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropPolicy_ = policy;
+    dispatchHooks_ = std::move(hooks);
+}
 
-    // Get the ANativeWindow from AImageReader
-    mediaStatus = AImageReader_getWindow(imageReader_, &imageReaderWindow_);
-    if (mediaStatus != AMEDIA_OK || !imageReaderWindow_) {
-        LOGE("Failed to get window from AImageReader: %d", mediaStatus);
-        cleanup();
-        return false;
+void CameraEncoderBridge::setCaptureTarget(int32_t targetBitrateBps, float maxFrameRate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    targetBitrateBps_ = targetBitrateBps > 0 ? targetBitrateBps : 0;
+    maxFrameRate_ = maxFrameRate > 0.0f ? maxFrameRate : 0.0f;
+    applyCaptureTargetLocked();
+}
+
+void CameraEncoderBridge::applyCaptureTargetLocked() {
+    const double frameRate = maxFrameRate_ > 0.0f ? maxFrameRate_ : kDefaultFrameRate;
+    YuvScale scale = scaleForBitrate(captureWidth_, captureHeight_, frameRate, targetBitrateBps_);
+
+    // The pool may be sized for a coarser repack than the bitrate asks for
+    if (static_cast<int32_t>(bufferPlan_.minScale) > static_cast<int32_t>(scale)) {
+        scale = bufferPlan_.minScale;
     }
+    const int64_t intervalNs = maxFrameRate_ > 0.0f
+        ? static_cast<int64_t>(static_cast<double>(kNsPerSecond) / maxFrameRate_)
+        : 0;
+
+    const auto previous = static_cast<YuvScale>(
+        scale_.exchange(static_cast<int32_t>(scale), std::memory_order_acq_rel));
+    frameIntervalNs_.store(intervalNs, std::memory_order_release);
+    if (previous != scale) {
+        LOGI("Capture scale 1/%d (%dx%d at %d bps, %.1f fps cap)", 1 << static_cast<int>(scale),
+             yuvScaledDimension(captureWidth_, scale), yuvScaledDimension(captureHeight_, scale),
+             targetBitrateBps_, maxFrameRate_);
+    }
+}
 
-    // Setup device callbacks
-    deviceCallbacks_.context = this;
-    deviceCallbacks_.onDisconnected = onDeviceDisconnected;
-    deviceCallbacks_.onError = onDeviceError;
+void CameraEncoderBridge::setCropRegion(const YuvCropRect& rect) noexcept {
+    cropRegion_.store(packCropRegion(rect), std::memory_order_release);
+    LOGI("Capture crop region %dx%d at (%d, %d)", rect.width, rect.height, rect.x, rect.y);
+}
 
-    // Open camera device
-    camera_status_t status = ACameraManager_openCamera(
-        manager_.getNativeManager(),
-        cameraId.c_str(),
-        &deviceCallbacks_,
-        &cameraDevice_);
+bool CameraEncoderBridge::startHardwareBufferCapture(const std::string& cameraId,
+                                                      int32_t width, int32_t height,
+                                                      HardwareBufferCallback callback) {
+    std::shared_ptr<CameraSession> session = joinSession(cameraId);
+    std::lock_guard<std::mutex> lock(mutex_);
 
-    if (status != ACAMERA_OK || !cameraDevice_) {
-        LOGE("Failed to open camera %s for encoding: %d", cameraId.c_str(), status);
+    if (session_) {
+        if (isCapturing() && currentCameraId_ == cameraId &&
+            deliveryMode_ == FrameDeliveryMode::HardwareBuffer) {
+            LOGI("Already capturing camera %s, skipping restart", cameraId.c_str());
+            return true;
+        }
+        LOGI("Switching encoder from camera %s to %s", currentCameraId_.c_str(), cameraId.c_str());
         cleanup();
-        return false;
     }
 
-    LOGI("Camera device opened for encoding: %s", cameraId.c_str());
+    deliveryMode_ = FrameDeliveryMode::HardwareBuffer;
+    hardwareBufferCallback_ = std::move(callback);
+    return openCaptureSession(cameraId, width, height, std::move(session));
+}
 
-    // Create output target from image reader window
-    status = ACameraOutputTarget_create(imageReaderWindow_, &outputTarget_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to create output target: %d", status);
-        cleanup();
-        return false;
+std::shared_ptr<CameraSession> CameraEncoderBridge::joinSession(const std::string& cameraId) {
+    // Join (or open) the camera's shared session; a running preview is reconfigured, not reopened
+    std::shared_ptr<CameraSession> session = sessions_.acquireSession(cameraId);
+    if (session && !session->waitForOpen()) {
+        LOGE("Failed to open camera %s for encoding", cameraId.c_str());
+        session.reset();
     }
+    return session;
+}
 
-    // Create capture request
-    status = ACameraDevice_createCaptureRequest(cameraDevice_, TEMPLATE_RECORD, &captureRequest_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to create capture request: %d", status);
-        cleanup();
-        return false;
+media_status_t CameraEncoderBridge::createImageReader(int32_t width, int32_t height) {
+    if (deliveryMode_ == FrameDeliveryMode::HardwareBuffer) {
+        // Opaque buffers the GPU and video encoder can consume directly; CPU never maps them
+        return AImageReader_newWithUsage(width, height, kPrivateImageFormat, kHardwareBufferUsage,
+                                         bufferPlan_.maxImages, &imageReader_);
     }
+    return AImageReader_new(width, height, kImageFormat, bufferPlan_.maxImages, &imageReader_);
+}
 
-    // Add target to request
-    status = ACaptureRequest_addTarget(captureRequest_, outputTarget_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to add target to request: %d", status);
+bool CameraEncoderBridge::openCaptureSession(const std::string& cameraId,
+                                              int32_t width, int32_t height,
+                                              std::shared_ptr<CameraSession> session) {
+    LOGI("Starting frame capture: %s (%dx%d, mode=%d, format=%d, kernels=%s)",
+         cameraId.c_str(), width, height, static_cast<int>(deliveryMode_),
+         static_cast<int>(outputFormat_), yuvKernelSetName(activeYuvKernelSet()));
+
+    // Fewer buffers first, then a coarser repack, rather than exceeding the memory budget
+    const bool pooled = deliveryMode_ == FrameDeliveryMode::CpuPacked;
+    if (!planStreamBuffers(width, height, 1, pooled, outputFormat_, true, bufferPlan_)) {
+        LOGE("Capture %dx%d does not fit the native memory budget", width, height);
         cleanup();
         return false;
     }
 
-    // Create session output container
-    status = ACaptureSessionOutputContainer_create(&outputContainer_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to create output container: %d", status);
+    currentCameraId_ = cameraId;
+    captureWidth_ = width;
+    captureHeight_ = height;
+    nextFrameDueNs_ = 0;
+    applyCaptureTargetLocked();
+
+    session_ = std::move(session);
+    if (!session_) {
         cleanup();
         return false;
     }
 
-    // Create session output
-    status = ACaptureSessionOutput_create(imageReaderWindow_, &sessionOutput_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to create session output: %d", status);
+    // Reset statistics
+    frameCount_.store(0, std::memory_order_release);
+    droppedFrames_.store(0, std::memory_order_release);
+    decimatedFrames_.store(0, std::memory_order_release);
+    prevFrameTimestampNs_.store(0, std::memory_order_release);
+    lastFrameRateHz_.store(0.0f, std::memory_order_release);
+    lastLatencyMs_.store(0.0f, std::memory_order_release);
+    latency_.reset();
+
+    // Allocate all packed frame storage up front so steady-state capture never allocates
+    if (pooled) {
+        const size_t frameSize = bufferPlan_.poolSlotBytes;
+        const size_t slotCount = bufferPlan_.poolSlots;
+        if (!framePool_.allocate(slotCount, frameSize)) {
+            LOGE("Failed to allocate frame buffer pool (%zu x %zu bytes)", slotCount, frameSize);
+            cleanup();
+            return false;
+        }
+    }
+
+    // Consumers may hold all but one reader image; the spare keeps the camera's latest frame
+    if (deliveryMode_ == FrameDeliveryMode::HardwareBuffer) {
+        std::lock_guard<std::mutex> heldLock(heldImagesMutex_);
+        heldImages_.assign(static_cast<size_t>(std::max(1, bufferPlan_.maxImages - 1)),
+                           HeldImage{});
+    }
+
+    // Create AImageReader for the selected delivery mode
+    media_status_t mediaStatus = createImageReader(width, height);
+    if (mediaStatus != AMEDIA_OK || !imageReader_) {
+        LOGE("Failed to create AImageReader: %d", mediaStatus);
         cleanup();
         return false;
     }
+    readerReservation_ = MemoryReservation(MemoryComponent::ImageReaders, bufferPlan_.readerBytes);
 
-    // Add output to container
-    status = ACaptureSessionOutputContainer_add(outputContainer_, sessionOutput_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to add output to container: %d", status);
+    // Set image available listener
+    imageListener_.context = this;
+    imageListener_.onImageAvailable = onImageAvailable;
+    mediaStatus = AImageReader_setImageListener(imageReader_, &imageListener_);
+    if (mediaStatus != AMEDIA_OK) {
+        LOGE("Failed to set image listener: %d", mediaStatus);
         cleanup();
         return false;
     }
 
-    // Setup session callbacks
-    sessionCallbacks_.context = this;
-    sessionCallbacks_.onClosed = onSessionClosed;
-    sessionCallbacks_.onReady = onSessionReady;
-    sessionCallbacks_.onActive = onSessionActive;
-
-    // Create capture session
-    status = ACameraDevice_createCaptureSession(
-        cameraDevice_,
-        outputContainer_,
-        &sessionCallbacks_,
-        &captureSession_);
-
-    if (status != ACAMERA_OK || !captureSession_) {
-        LOGE("Failed to create capture session for encoding: %d", status);
+    // Get the ANativeWindow from AImageReader
+    mediaStatus = AImageReader_getWindow(imageReader_, &imageReaderWindow_);
+    if (mediaStatus != AMEDIA_OK || !imageReaderWindow_) {
+        LOGE("Failed to get window from AImageReader: %d", mediaStatus);
         cleanup();
         return false;
     }
 
-    // Start repeating capture request
-    status = ACameraCaptureSession_setRepeatingRequest(
-        captureSession_,
-        nullptr,  // No capture callbacks needed, we use image reader
-        1,
-        &captureRequest_,
-        nullptr);
-
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to set repeating request: %d", status);
+    SessionOutputCallbacks callbacks;
+    callbacks.onCaptureStarted = [this](int64_t timestampNs, int64_t frameNumber) {
+        latency_.onFrameStarted(frameNumber, timestampNs);
+    };
+    callbacks.onCaptureCompleted = [this](int64_t sensorTimestampNs) {
+        latency_.record(LatencyStage::CaptureCompleted, sensorTimestampNs);
+    };
+    callbacks.onCaptureFailed = [this](int64_t) { latency_.onCaptureFailed(); };
+    callbacks.onCaptureBufferLost = [this](int64_t) { latency_.onBufferLost(); };
+    callbacks.onDeviceLost = [this] {
+        LOGI("Encoder camera device lost");
+        capturing_.store(false, std::memory_order_release);
+    };
+    if (!session_->attachOutput(SessionOutputRole::Encoder, imageReaderWindow_,
+                                std::move(callbacks))) {
+        LOGE("Failed to attach image reader to camera %s", cameraId.c_str());
         cleanup();
         return false;
     }
@@ -185,7 +351,8 @@ bool CameraEncoderBridge::startCapture(const std::string& cameraId,
 
 void CameraEncoderBridge::stopCapture() {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!capturing_.load(std::memory_order_acquire)) {
+    // A lost device clears capturing_ but leaves the reader attached until stopped
+    if (!session_) {
         return;
     }
     LOGI("Stopping frame capture");
@@ -195,52 +362,38 @@ void CameraEncoderBridge::stopCapture() {
 void CameraEncoderBridge::cleanup() {
     capturing_.store(false, std::memory_order_release);
 
-    if (captureSession_) {
-        ACameraCaptureSession_stopRepeating(captureSession_);
-        ACameraCaptureSession_close(captureSession_);
-        captureSession_ = nullptr;
-    }
-
-    if (cameraDevice_) {
-        ACameraDevice_close(cameraDevice_);
-        cameraDevice_ = nullptr;
-    }
-
-    if (captureRequest_) {
-        ACaptureRequest_free(captureRequest_);
-        captureRequest_ = nullptr;
-    }
-
-    if (outputTarget_) {
-        ACameraOutputTarget_free(outputTarget_);
-        outputTarget_ = nullptr;
-    }
-
-    if (sessionOutput_) {
-        ACaptureSessionOutput_free(sessionOutput_);
-        sessionOutput_ = nullptr;
-    }
-
-    if (outputContainer_) {
-        ACaptureSessionOutputContainer_free(outputContainer_);
-        outputContainer_ = nullptr;
+    // Stop the camera writing into the reader before deleting it; other outputs keep streaming
+    if (session_) {
+        session_->detachOutput(SessionOutputRole::Encoder);
+        session_.reset();
     }
 
     // Note: imageReaderWindow_ is owned by imageReader_, don't release separately
     imageReaderWindow_ = nullptr;
 
+    // Held frames must go back before their reader; late releases then find no match
+    releaseHeldImages();
+
     if (imageReader_) {
         AImageReader_delete(imageReader_);
         imageReader_ = nullptr;
     }
+    readerReservation_.reset();
+
+    // Producer is gone; stop delivery and return queued frames to the pool
+    dispatcher_.stop();
+
+    // Outstanding handles keep their storage alive until the consumer releases them
+    framePool_.release();
 
     currentCameraId_.clear();
-    frameCallback_ = nullptr;
+    hardwareBufferCallback_ = nullptr;
 
     LOGI("Encoder resources cleaned up");
 }
 
 void CameraEncoderBridge::onImageAvailable(void* context, AImageReader* reader) {
+    NS_TRACE_SCOPE("CameraEncoderBridge::onImageAvailable");
     auto* self = static_cast<CameraEncoderBridge*>(context);
 
     AImage* image = nullptr;
@@ -249,12 +402,28 @@ void CameraEncoderBridge::onImageAvailable(void* context, AImageReader* reader)
         return;
     }
 
-    if (!self->frameCallback_) {
+    if (self->deliveryMode_ == FrameDeliveryMode::HardwareBuffer) {
+        self->deliverHardwareBuffer(image);
+        return;
+    }
+
+    self->deliverCpuFrame(image);
+    AImage_delete(image);
+}
+
+void CameraEncoderBridge::deliverHardwareBuffer(AImage* image) {
+    if (!hardwareBufferCallback_) {
+        AImage_delete(image);
+        return;
+    }
+
+    AHardwareBuffer* buffer = nullptr;
+    if (AImage_getHardwareBuffer(image, &buffer) != AMEDIA_OK || !buffer) {
+        LOGW("Image has no backing hardware buffer, dropping frame");
         AImage_delete(image);
         return;
     }
 
-    // Get image properties
     int32_t width = 0, height = 0;
     AImage_getWidth(image, &width);
     AImage_getHeight(image, &height);
@@ -262,101 +431,216 @@ void CameraEncoderBridge::onImageAvailable(void* context, AImageReader* reader)
     int64_t timestampNs = 0;
     AImage_getTimestamp(image, &timestampNs);
 
-    // Get Y plane data (for YUV_420_888, Y plane is the largest and most useful)
-    uint8_t* yData = nullptr;
-    int yLen = 0;
-    AImage_getPlaneData(image, 0, &yData, &yLen);
-
-    uint8_t* uData = nullptr;
-    int uLen = 0;
-    AImage_getPlaneData(image, 1, &uData, &uLen);
+    latency_.record(LatencyStage::ImageAvailable, timestampNs);
+    if (decimateFrame(timestampNs)) {
+        AImage_delete(image);
+        return;
+    }
 
-    uint8_t* vData = nullptr;
-    int vLen = 0;
-    AImage_getPlaneData(image, 2, &vData, &vLen);
-
-    if (yData && uData && vData) {
-        // Get row strides and pixel strides
-        int32_t yRowStride = 0, uvRowStride = 0, uvPixelStride = 0;
-        AImage_getPlaneRowStride(image, 0, &yRowStride);
-        AImage_getPlaneRowStride(image, 1, &uvRowStride);
-        AImage_getPlanePixelStride(image, 1, &uvPixelStride);
-
-        // Calculate I420 buffer size: Y + U + V = w*h + w*h/4 + w*h/4 = w*h*3/2
-        int32_t i420Size = width * height * 3 / 2;
-
-        // For tightly packed I420 data, pack the planes
-        // Allocate on stack for small frames, heap for large
-        std::vector<uint8_t> i420Buffer(static_cast<size_t>(i420Size));
-
-        // Copy Y plane
-        if (yRowStride == width) {
-            memcpy(i420Buffer.data(), yData, static_cast<size_t>(width * height));
-        } else {
-            for (int32_t row = 0; row < height; ++row) {
-                memcpy(i420Buffer.data() + row * width,
-                       yData + row * yRowStride,
-                       static_cast<size_t>(width));
+    // Hold the image until the consumer releases it; the camera reuses the buffer once deleted
+    const uint64_t frameId = g_nextHardwareFrameId.fetch_add(1, std::memory_order_relaxed);
+    bool held = false;
+    {
+        std::lock_guard<std::mutex> lock(heldImagesMutex_);
+        for (HeldImage& slot : heldImages_) {
+            if (!slot.image) {
+                slot = HeldImage{frameId, image};
+                held = true;
+                break;
             }
         }
+    }
+    if (!held) {
+        // Consumer is holding every frame it may; drop rather than starve the reader
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        AImage_delete(image);
+        return;
+    }
+    updateStats(timestampNs);
 
-        // Copy U and V planes (deinterleave if needed)
-        int32_t uvWidth = width / 2;
-        int32_t uvHeight = height / 2;
-        uint8_t* uDst = i420Buffer.data() + width * height;
-        uint8_t* vDst = uDst + uvWidth * uvHeight;
-
-        if (uvPixelStride == 1) {
-            // Already planar, just copy
-            if (uvRowStride == uvWidth) {
-                memcpy(uDst, uData, static_cast<size_t>(uvWidth * uvHeight));
-                memcpy(vDst, vData, static_cast<size_t>(uvWidth * uvHeight));
-            } else {
-                for (int32_t row = 0; row < uvHeight; ++row) {
-                    memcpy(uDst + row * uvWidth, uData + row * uvRowStride,
-                           static_cast<size_t>(uvWidth));
-                    memcpy(vDst + row * uvWidth, vData + row * uvRowStride,
-                           static_cast<size_t>(uvWidth));
-                }
-            }
-        } else {
-            // Interleaved UV (NV12/NV21 style) - deinterleave
-            for (int32_t row = 0; row < uvHeight; ++row) {
-                for (int32_t col = 0; col < uvWidth; ++col) {
-                    uDst[row * uvWidth + col] = uData[row * uvRowStride + col * uvPixelStride];
-                    vDst[row * uvWidth + col] = vData[row * uvRowStride + col * uvPixelStride];
-                }
+    NS_TRACE_SCOPE("CameraEncoderBridge::deliverHardwareBuffer");
+    if (!hardwareBufferCallback_(buffer, width, height, timestampNs, frameId)) {
+        releaseHardwareBuffer(frameId);
+    }
+    latency_.record(LatencyStage::JniDelivered, timestampNs);
+}
+
+bool CameraEncoderBridge::releaseHardwareBuffer(uint64_t frameId, int releaseFenceFd) {
+    AImage* image = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(heldImagesMutex_);
+        for (HeldImage& slot : heldImages_) {
+            if (slot.image && slot.frameId == frameId) {
+                image = slot.image;
+                slot = HeldImage{};
+                break;
             }
         }
-
-        self->frameCallback_(i420Buffer.data(), i420Size, width, height, timestampNs);
     }
 
-    AImage_delete(image);
+    if (!image) {
+        return false;
+    }
+    // The camera waits on the fence before writing the buffer again
+    AImage_deleteAsync(image, releaseFenceFd);
+    return true;
 }
 
-void CameraEncoderBridge::onDeviceDisconnected(void* context, ACameraDevice* /*device*/) {
-    auto* self = static_cast<CameraEncoderBridge*>(context);
-    LOGI("Encoder camera device disconnected");
-    self->capturing_.store(false, std::memory_order_release);
+void CameraEncoderBridge::releaseHeldImages() {
+    std::lock_guard<std::mutex> lock(heldImagesMutex_);
+    for (HeldImage& slot : heldImages_) {
+        if (slot.image) {
+            AImage_delete(slot.image);
+        }
+    }
+    heldImages_.clear();
 }
 
-void CameraEncoderBridge::onDeviceError(void* context, ACameraDevice* /*device*/, int error) {
-    auto* self = static_cast<CameraEncoderBridge*>(context);
-    LOGE("Encoder camera device error: %d", error);
-    self->capturing_.store(false, std::memory_order_release);
+void CameraEncoderBridge::deliverCpuFrame(AImage* image) {
+    if (!dispatcher_.isRunning()) {
+        return;
+    }
+
+    // Get image properties
+    YuvPlanes planes;
+    AImage_getWidth(image, &planes.width);
+    AImage_getHeight(image, &planes.height);
+
+    int64_t timestampNs = 0;
+    AImage_getTimestamp(image, &timestampNs);
+    latency_.record(LatencyStage::ImageAvailable, timestampNs);
+
+    // Discard before touching any pixels; the consumer would drop this frame anyway
+    if (decimateFrame(timestampNs)) {
+        return;
+    }
+
+    uint8_t* yData = nullptr;
+    uint8_t* uData = nullptr;
+    uint8_t* vData = nullptr;
+    int planeLen = 0;
+    AImage_getPlaneData(image, 0, &yData, &planeLen);
+    AImage_getPlaneData(image, 1, &uData, &planeLen);
+    AImage_getPlaneData(image, 2, &vData, &planeLen);
+    planes.y = yData;
+    planes.u = uData;
+    planes.v = vData;
+
+    AImage_getPlaneRowStride(image, 0, &planes.yRowStride);
+    AImage_getPlaneRowStride(image, 1, &planes.uvRowStride);
+    AImage_getPlanePixelStride(image, 1, &planes.uvPixelStride);
+
+    FrameBufferHandle frame = framePool_.acquire();
+    NS_TRACE_COUNTER("Encoder pool in use", framePool_.getStats().inUse);
+    if (!frame) {
+        // Consumer is holding every pooled buffer; drop rather than allocate
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Cropping only narrows the plane pointers; the repack below reads just the window
+    FrameMetadata metadata;
+    const uint64_t cropRegion = cropRegion_.load(std::memory_order_acquire);
+    if (cropRegion != 0) {
+        const YuvCropRect crop = unpackCropRegion(cropRegion);
+        if (cropYuvPlanes(planes, crop, planes)) {
+            metadata.cropX = crop.x & ~1;
+            metadata.cropY = crop.y & ~1;
+        }
+    }
+
+    // Downscaled frames are repacked straight from the image planes into a smaller frame
+    const auto scale = static_cast<YuvScale>(scale_.load(std::memory_order_acquire));
+    const int32_t width = yuvScaledDimension(planes.width, scale);
+    const int32_t height = yuvScaledDimension(planes.height, scale);
+    const size_t frameSize = yuvBufferSize(outputFormat_, width, height);
+    bool converted = false;
+    if (frameSize > 0 && frameSize <= frame.capacity()) {
+        NS_TRACE_SCOPE("convertYuv420888");
+        converted = convertYuv420888Scaled(planes, outputFormat_, scale, frame.data());
+    }
+    if (!converted) {
+        LOGW("Failed to repack YUV_420_888 image (%dx%d), dropping frame",
+             planes.width, planes.height);
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    frame.setSize(frameSize);
+
+    metadata.timestampNs = timestampNs;
+    metadata.width = width;
+    metadata.height = height;
+    metadata.format = static_cast<int32_t>(outputFormat_);
+    metadata.frameNumber = frameCount_.load(std::memory_order_relaxed);
+
+    updateStats(timestampNs);
+    NS_TRACE_FLOW_BEGIN(kFrameFlowTrace, metadata.frameNumber);
+    dispatcher_.submit(std::move(frame), metadata);
 }
 
-void CameraEncoderBridge::onSessionClosed(void* /*context*/, ACameraCaptureSession* /*session*/) {
-    LOGI("Encoder capture session closed");
+CameraStats CameraEncoderBridge::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    CameraStats stats;
+    stats.frameRateHz = lastFrameRateHz_.load(std::memory_order_acquire);
+    stats.latencyMs = lastLatencyMs_.load(std::memory_order_acquire);
+    stats.frameCount = frameCount_.load(std::memory_order_acquire);
+    stats.droppedFrames = droppedFrames_.load(std::memory_order_acquire) +
+                          latency_.getDroppedFrames();
+
+    const FrameDispatchStats dispatchStats = dispatcher_.getStats();
+    stats.droppedFrames += dispatchStats.droppedFrames;
+    stats.dispatchQueueDepth = dispatchStats.queueDepth;
+    stats.decimatedFrames = decimatedFrames_.load(std::memory_order_acquire);
+    stats.scaleFactor = 1 << scale_.load(std::memory_order_acquire);
+
+    const FramePoolStats poolStats = framePool_.getStats();
+    stats.bufferPoolCapacity = poolStats.capacity;
+    stats.bufferPoolInUse = poolStats.inUse;
+    stats.bufferPoolStarvations = poolStats.starvationCount;
+
+    // Hardware buffer captures have no pool; report the frames held for the consumer instead
+    if (deliveryMode_ == FrameDeliveryMode::HardwareBuffer) {
+        std::lock_guard<std::mutex> heldLock(heldImagesMutex_);
+        stats.bufferPoolCapacity = static_cast<int32_t>(heldImages_.size());
+        stats.bufferPoolInUse = static_cast<int32_t>(
+            std::count_if(heldImages_.begin(), heldImages_.end(),
+                          [](const HeldImage& slot) { return slot.image != nullptr; }));
+    }
+    return stats;
 }
 
-void CameraEncoderBridge::onSessionReady(void* /*context*/, ACameraCaptureSession* /*session*/) {
-    LOGI("Encoder capture session ready");
+bool CameraEncoderBridge::decimateFrame(int64_t timestampNs) {
+    const int64_t intervalNs = frameIntervalNs_.load(std::memory_order_acquire);
+    if (intervalNs <= 0) {
+        return false;
+    }
+
+    if (timestampNs + intervalNs / kDecimationToleranceDivisor < nextFrameDueNs_) {
+        decimatedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    // Keep the cadence on schedule; after a gap (or the first frame) restart from this frame
+    const bool onSchedule = nextFrameDueNs_ > 0 && timestampNs - nextFrameDueNs_ < intervalNs;
+    nextFrameDueNs_ = (onSchedule ? nextFrameDueNs_ : timestampNs) + intervalNs;
+    return false;
 }
 
-void CameraEncoderBridge::onSessionActive(void* /*context*/, ACameraCaptureSession* /*session*/) {
-    LOGI("Encoder capture session active");
+void CameraEncoderBridge::updateStats(int64_t timestampNs) {
+    const int64_t now = getBootTimeNs();
+    frameCount_.fetch_add(1, std::memory_order_relaxed);
+
+    const int64_t prevTimestampNs = prevFrameTimestampNs_.exchange(timestampNs,
+                                                                   std::memory_order_acq_rel);
+    if (prevTimestampNs > 0 && timestampNs > prevTimestampNs) {
+        double intervalSec = static_cast<double>(timestampNs - prevTimestampNs) / kNsPerSecond;
+        lastFrameRateHz_.store(static_cast<float>(1.0 / intervalSec), std::memory_order_release);
+    }
+
+    if (timestampNs > 0 && now > timestampNs) {
+        lastLatencyMs_.store(static_cast<float>(static_cast<double>(now - timestampNs) / kNsToMs),
+                             std::memory_order_release);
+    }
 }
 
 }  // namespace nativesensor
@@ -1,32 +1,57 @@
 #pragma once
 
-#include <camera/NdkCameraDevice.h>
-#include <camera/NdkCameraCaptureSession.h>
-#include <camera/NdkCaptureRequest.h>
 #include <media/NdkImageReader.h>
 #include <android/native_window.h>
+#include <android/hardware_buffer.h>
 #include <functional>
 #include <memory>
 #include <atomic>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "camera_data.h"
-#include "camera_manager.h"
+#include "camera_session.h"
+#include "frame_buffer_pool.h"
+#include "frame_dispatcher.h"
+#include "frame_latency_tracker.h"
+#include "imu_frame_sync.h"
+#include "memory_budget.h"
+#include "stream_budget.h"
+#include "yuv_convert.h"
 
 namespace nativesensor {
 
-/// Callback for YUV frame data ready for encoding
+class CameraSessionRegistry;
+
+/// Callback for YUV frame data ready for encoding (tightly packed I420 or NV12).
+/// Invoked on the capture's dispatch thread; data is valid until the callback returns.
 /// Parameters: data pointer, data size, width, height, timestamp_ns
 using FrameDataCallback = std::function<void(const uint8_t* data, int32_t size,
                                               int32_t width, int32_t height,
                                               int64_t timestampNs)>;
 
+/// Callback for pooled YUV frames, invoked on the capture's dispatch thread.
+/// The handle may be retained (copied or moved) past the callback; the buffer
+/// returns to the pool when the last copy is released.
+using FrameHandleCallback = std::function<void(FrameBufferHandle frame,
+                                                const FrameMetadata& metadata)>;
+
+/// Callback for GPU-resident frames delivered without any CPU copy, invoked on the image
+/// reader thread. Returning true hands the frame to the consumer: the camera does not reuse
+/// the buffer until CameraEncoderBridge::releaseHardwareBuffer(frameId), so it may be read
+/// asynchronously. Returning false releases it as soon as the callback returns.
+/// Parameters: hardware buffer, width, height, timestamp_ns, frame id (unique per process)
+using HardwareBufferCallback = std::function<bool(AHardwareBuffer* buffer,
+                                                   int32_t width, int32_t height,
+                                                   int64_t timestampNs, uint64_t frameId)>;
+
 /// Camera stream that captures frames via AImageReader for encoding/streaming.
-/// Operates independently from the preview CameraStream - uses its own camera session.
+/// The reader is the Encoder output of the camera's shared session, so a preview of the
+/// same camera keeps running (and sees the same frames) while capture starts and stops.
 class CameraEncoderBridge {
 public:
-    explicit CameraEncoderBridge(CameraManager& manager);
+    explicit CameraEncoderBridge(CameraSessionRegistry& sessions);
     ~CameraEncoderBridge();
 
     CameraEncoderBridge(const CameraEncoderBridge&) = delete;
@@ -37,9 +62,39 @@ public:
     /// @param width Desired capture width
     /// @param height Desired capture height
     /// @param callback Callback invoked with each frame's YUV data
+    /// @param outputFormat Packed layout delivered to the callback
     /// @return true if capture started successfully
     bool startCapture(const std::string& cameraId, int32_t width, int32_t height,
-                      FrameDataCallback callback);
+                      FrameDataCallback callback,
+                      YuvOutputFormat outputFormat = YuvOutputFormat::I420);
+
+    /// Start capturing frames into pooled, ref-counted buffers
+    /// @param cameraId Camera to capture from
+    /// @param width Desired capture width
+    /// @param height Desired capture height
+    /// @param callback Callback invoked with a handle to each frame's YUV data
+    /// @param outputFormat Packed layout written into the pooled buffers
+    /// @return true if capture started successfully
+    bool startPooledCapture(const std::string& cameraId, int32_t width, int32_t height,
+                            FrameHandleCallback callback,
+                            YuvOutputFormat outputFormat = YuvOutputFormat::I420);
+
+    /// Start capturing frames as AHardwareBuffers (zero-copy, pixels never mapped)
+    /// @param cameraId Camera to capture from
+    /// @param width Desired capture width
+    /// @param height Desired capture height
+    /// @param callback Callback invoked with each frame's hardware buffer
+    /// @return true if capture started successfully
+    bool startHardwareBufferCapture(const std::string& cameraId, int32_t width, int32_t height,
+                                    HardwareBufferCallback callback);
+
+    /// Return a frame handed out by the hardware buffer callback to the camera. At most
+    /// maxImages - 1 frames are held at once; while that many are outstanding new frames drop.
+    /// @param frameId Id passed to the callback; unknown or already released ids are ignored
+    /// @param releaseFenceFd Fence signalled when the consumer's last access completes, or -1
+    ///        if it already has. Ownership passes to this call only when it returns true.
+    /// @return true if the frame belonged to this capture
+    bool releaseHardwareBuffer(uint64_t frameId, int releaseFenceFd = -1);
 
     /// Stop capturing and release resources
     void stopCapture();
@@ -48,42 +103,144 @@ public:
     [[nodiscard]]
     bool isCapturing() const { return capturing_.load(std::memory_order_acquire); }
 
+    /// Configure the dispatch thread used by the next CPU capture start
+    /// @param policy Drop policy applied when the consumer falls behind the camera
+    /// @param hooks Hooks run on the dispatch thread (e.g. permanent JVM attachment)
+    void setDispatchConfig(FrameDropPolicy policy, DispatcherThreadHooks hooks);
+
+    /// Align every CPU frame with the IMU before delivery (FrameMetadata::imu).
+    /// Alignment runs on the dispatch thread; pass nullptr to disable. Must outlive the capture.
+    void setImuFrameSync(ImuFrameSync* sync) noexcept {
+        imuSync_.store(sync, std::memory_order_release);
+    }
+
+    /// Adapt delivery to what the consumer can use, so frames it would drop are never
+    /// converted or copied. Frames above maxFrameRate are discarded on arrival, and CPU frames
+    /// are box-downscaled 2x or 4x during the repack when targetBitrateBps cannot carry the
+    /// capture resolution. Applies from the next frame and carries over to later captures.
+    /// @param targetBitrateBps Bitrate of the encoder fed by the frames; 0 keeps full resolution
+    /// @param maxFrameRate Delivered frame rate cap; 0 delivers every camera frame
+    void setCaptureTarget(int32_t targetBitrateBps, float maxFrameRate);
+
+    /// Deliver only a window of each CPU frame, cut out while repacking so the rest is never
+    /// read. Coordinates are capture pixels before any setCaptureTarget() downscale; an empty
+    /// rect restores the full frame. Applies from the next frame and carries over to later
+    /// captures. A window outside the frame falls back to the full frame.
+    void setCropRegion(const YuvCropRect& rect) noexcept;
+
+    /// Downscale currently applied to CPU frames
+    [[nodiscard]]
+    YuvScale getScale() const noexcept {
+        return static_cast<YuvScale>(scale_.load(std::memory_order_acquire));
+    }
+
+    /// Get capture statistics including frame buffer pool occupancy
+    [[nodiscard]]
+    CameraStats getStats() const;
+
+    /// Latency histograms, jitter and drop counters since the capture started
+    [[nodiscard]]
+    FrameLatencySnapshot getLatencySnapshot() const { return latency_.snapshot(); }
+
+    /// Get the delivery mode of the active (or last) capture
+    [[nodiscard]]
+    FrameDeliveryMode getDeliveryMode() const { return deliveryMode_; }
+
 private:
     // AImageReader callback
     static void onImageAvailable(void* context, AImageReader* reader);
 
-    // Camera device callbacks
-    static void onDeviceDisconnected(void* context, ACameraDevice* device);
-    static void onDeviceError(void* context, ACameraDevice* device, int error);
+    /// Acquire the camera's shared session and wait for its device to open. Called before
+    /// taking mutex_: the registry lock is never requested under it, and a slow open does not
+    /// stall stats or target updates. Returns nullptr if the device failed to open.
+    std::shared_ptr<CameraSession> joinSession(const std::string& cameraId);
+
+    /// Shared session setup for both delivery modes (caller holds mutex_)
+    /// @param session Opened session from joinSession(); nullptr fails the start
+    bool openCaptureSession(const std::string& cameraId, int32_t width, int32_t height,
+                            std::shared_ptr<CameraSession> session);
 
-    // Capture session callbacks
-    static void onSessionClosed(void* context, ACameraCaptureSession* session);
-    static void onSessionReady(void* context, ACameraCaptureSession* session);
-    static void onSessionActive(void* context, ACameraCaptureSession* session);
+    /// Create the AImageReader matching deliveryMode_
+    media_status_t createImageReader(int32_t width, int32_t height);
 
+    /// Repack a YUV_420_888 image into a pooled buffer and queue it on dispatcher_
+    void deliverCpuFrame(AImage* image);
+
+    /// Hand the image's backing AHardwareBuffer to hardwareBufferCallback_. Takes ownership
+    /// of the image: it is held for the consumer or deleted before returning.
+    void deliverHardwareBuffer(AImage* image);
+
+    /// Delete every image still held for the consumer (before the reader is deleted)
+    void releaseHeldImages();
+
+    /// Publish scale_ and frameIntervalNs_ for the capture size (caller holds mutex_)
+    void applyCaptureTargetLocked();
+
+    /// True if the frame-rate cap discards a frame (image reader thread)
+    bool decimateFrame(int64_t timestampNs);
+
+    void updateStats(int64_t timestampNs);
     void cleanup();
 
-    CameraManager& manager_;
+    CameraSessionRegistry& sessions_;
     mutable std::mutex mutex_;
     std::atomic<bool> capturing_{false};
     std::string currentCameraId_;
 
+    // Shared with any preview of the same camera
+    std::shared_ptr<CameraSession> session_;
+
     // NDK handles
-    ACameraDevice* cameraDevice_ = nullptr;
-    ACameraCaptureSession* captureSession_ = nullptr;
-    ACaptureSessionOutputContainer* outputContainer_ = nullptr;
-    ACaptureSessionOutput* sessionOutput_ = nullptr;
-    ACameraOutputTarget* outputTarget_ = nullptr;
-    ACaptureRequest* captureRequest_ = nullptr;
     AImageReader* imageReader_ = nullptr;
     ANativeWindow* imageReaderWindow_ = nullptr;
 
-    // Frame callback
-    FrameDataCallback frameCallback_;
-
-    // Callback structs (must persist for camera session lifetime)
-    ACameraDevice_StateCallbacks deviceCallbacks_{};
-    ACameraCaptureSession_stateCallbacks sessionCallbacks_{};
+    // Frame callbacks (only the one matching deliveryMode_ is set)
+    FrameDeliveryMode deliveryMode_ = FrameDeliveryMode::CpuPacked;
+    YuvOutputFormat outputFormat_ = YuvOutputFormat::I420;
+    HardwareBufferCallback hardwareBufferCallback_;
+
+    // Hardware buffer frames the consumer has not released yet; sized once per capture so at
+    // least one reader image stays free for acquireLatestImage() to skip stale frames
+    struct HeldImage {
+        uint64_t frameId = 0;
+        AImage* image = nullptr;
+    };
+    mutable std::mutex heldImagesMutex_;
+    std::vector<HeldImage> heldImages_;
+
+    // Delivers CPU frames off the image reader thread
+    FrameDispatcher dispatcher_;
+    FrameDropPolicy dropPolicy_ = FrameDropPolicy::DropOldest;
+    DispatcherThreadHooks dispatchHooks_;
+    std::atomic<ImuFrameSync*> imuSync_{nullptr};
+
+    // Packed frame storage, allocated once per capture in openCaptureSession()
+    FrameBufferPool framePool_;
+
+    // Reader depth and repack floor planned against the memory budget (guarded by mutex_)
+    StreamBufferPlan bufferPlan_;
+    MemoryReservation readerReservation_;
+
+    // Adaptation (setCaptureTarget); targets and capture size guarded by mutex_
+    int32_t captureWidth_ = 0;
+    int32_t captureHeight_ = 0;
+    int32_t targetBitrateBps_ = 0;
+    float maxFrameRate_ = 0.0f;
+    std::atomic<int32_t> scale_{static_cast<int32_t>(YuvScale::Full)};
+    std::atomic<int64_t> frameIntervalNs_{0};
+    int64_t nextFrameDueNs_ = 0;            // Image reader thread
+    std::atomic<uint64_t> cropRegion_{0};   // Packed YuvCropRect, 0 = full frame
+
+    // Statistics (written from the image reader thread)
+    std::atomic<int64_t> frameCount_{0};
+    std::atomic<int64_t> droppedFrames_{0};
+    std::atomic<int64_t> decimatedFrames_{0};
+    std::atomic<int64_t> prevFrameTimestampNs_{0};
+    std::atomic<float> lastFrameRateHz_{0.0f};
+    std::atomic<float> lastLatencyMs_{0.0f};
+    FrameLatencyTracker latency_;
+
+    // Callback struct (must persist for image reader lifetime)
     AImageReader_ImageListener imageListener_{};
 };
 
@@ -27,19 +27,45 @@ std::string toLower(const std::string& str) {
     return result;
 }
 
+// Split the null-separated ACAMERA_LOGICAL_MULTI_CAMERA_PHYSICAL_IDS entry
+std::vector<std::string> parsePhysicalIds(const ACameraMetadata_const_entry& entry) {
+    std::vector<std::string> ids;
+    const char* begin = reinterpret_cast<const char*>(entry.data.u8);
+    for (uint32_t j = 0; j < entry.count; ++j) {
+        const char* ptr = reinterpret_cast<const char*>(entry.data.u8) + j;
+        if (*ptr == '\0') {
+            if (ptr > begin) {
+                ids.emplace_back(begin, ptr);
+            }
+            begin = ptr + 1;
+        }
+    }
+    return ids;
+}
+
 }  // namespace
 
 CameraManager::CameraManager() {
     cameraManager_ = ACameraManager_create();
     if (!cameraManager_) {
         LOGE("Failed to create ACameraManager");
-    } else {
-        LOGI("ACameraManager created successfully");
+        return;
+    }
+    LOGI("ACameraManager created successfully");
+
+    availabilityCallbacks_.context = this;
+    availabilityCallbacks_.onCameraAvailable = onCameraAvailable;
+    availabilityCallbacks_.onCameraUnavailable = onCameraUnavailable;
+    camera_status_t status = ACameraManager_registerAvailabilityCallback(cameraManager_,
+                                                                         &availabilityCallbacks_);
+    if (status != ACAMERA_OK) {
+        LOGW("Failed to register availability callbacks (%d); cache never invalidates", status);
     }
 }
 
 CameraManager::~CameraManager() {
     if (cameraManager_) {
+        ACameraManager_unregisterAvailabilityCallback(cameraManager_, &availabilityCallbacks_);
         ACameraManager_delete(cameraManager_);
         cameraManager_ = nullptr;
         LOGI("ACameraManager destroyed");
@@ -55,6 +81,10 @@ std::vector<CameraInfo> CameraManager::enumerateCameras() {
         return cameras;
     }
 
+    if (camerasCached_) {
+        return cachedCameras_;
+    }
+
     ACameraIdList* cameraIds = nullptr;
     camera_status_t status = ACameraManager_getCameraIdList(cameraManager_, &cameraIds);
 
@@ -65,8 +95,10 @@ std::vector<CameraInfo> CameraManager::enumerateCameras() {
 
     LOGI("Found %d cameras", cameraIds->numCameras);
 
+    knownCameraIds_.clear();
     for (int i = 0; i < cameraIds->numCameras; ++i) {
         const char* id = cameraIds->cameraIds[i];
+        knownCameraIds_.insert(id);
         CameraInfo info;
         info.id = id;
 
@@ -83,9 +115,78 @@ std::vector<CameraInfo> CameraManager::enumerateCameras() {
     }
 
     ACameraManager_deleteCameraIdList(cameraIds);
+
+    cachedCameras_ = cameras;
+    camerasCached_ = true;
     return cameras;
 }
 
+void CameraManager::invalidateCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        camerasCached_ = false;
+        logicalCache_.clear();
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    notifyChanged();
+}
+
+void CameraManager::setChangeListener(CameraChangeListener listener) {
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    changeListener_ = std::move(listener);
+}
+
+void CameraManager::notifyChanged() {
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    if (changeListener_) {
+        changeListener_(generation_.load(std::memory_order_acquire));
+    }
+}
+
+void CameraManager::onCameraAvailable(void* context, const char* cameraId) {
+    auto* self = static_cast<CameraManager*>(context);
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(self->mutex_);
+
+        // Registration replays every present camera; only an id we have not seen is news
+        if (self->camerasCached_ && self->knownCameraIds_.count(cameraId) == 0) {
+            LOGI("Camera %s appeared, invalidating characteristics cache", cameraId);
+            self->camerasCached_ = false;
+            self->logicalCache_.erase(cameraId);
+            self->generation_.fetch_add(1, std::memory_order_acq_rel);
+            changed = true;
+        }
+    }
+    if (changed) {
+        self->notifyChanged();
+    }
+}
+
+void CameraManager::onCameraUnavailable(void* context, const char* cameraId) {
+    auto* self = static_cast<CameraManager*>(context);
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(self->mutex_);
+
+        // Built-in cameras turn unavailable whenever any client opens them; only
+        // external cameras can actually be removed
+        for (const CameraInfo& info : self->cachedCameras_) {
+            if (info.id == cameraId && info.facing == CameraFacing::External) {
+                LOGI("External camera %s removed, invalidating characteristics cache", cameraId);
+                self->camerasCached_ = false;
+                self->logicalCache_.erase(cameraId);
+                self->generation_.fetch_add(1, std::memory_order_acq_rel);
+                changed = true;
+                break;
+            }
+        }
+    }
+    if (changed) {
+        self->notifyChanged();
+    }
+}
+
 bool CameraManager::queryCharacteristics(const char* cameraId, CameraInfo& outInfo) {
     ACameraMetadata* metadata = nullptr;
     camera_status_t status = ACameraManager_getCameraCharacteristics(
@@ -121,11 +222,14 @@ bool CameraManager::queryCharacteristics(const char* cameraId, CameraInfo& outIn
             ACAMERA_SCALER_AVAILABLE_STREAM_CONFIGURATIONS, &scmEntry) == ACAMERA_OK) {
         // Format: [format, width, height, input] tuples
         int32_t maxWidth = 0, maxHeight = 0;
-        for (uint32_t j = 0; j < scmEntry.count; j += 4) {
+        for (uint32_t j = 0; j + 3 < scmEntry.count; j += 4) {
             int32_t format = scmEntry.data.i32[j];
             int32_t width = scmEntry.data.i32[j + 1];
             int32_t height = scmEntry.data.i32[j + 2];
             int32_t isInput = scmEntry.data.i32[j + 3];
+            if (isInput == 0) {
+                outInfo.streamConfigurations.push_back({format, width, height});
+            }
 
             // Only output configurations, prefer YUV_420_888 or IMPLEMENTATION_DEFINED
             if (isInput == 0 && (format == 0x23 || format == 0x22)) {  // YUV_420_888 or IMPLEMENTATION_DEFINED
@@ -144,8 +248,10 @@ bool CameraManager::queryCharacteristics(const char* cameraId, CameraInfo& outIn
     if (ACameraMetadata_getConstEntry(metadata,
             ACAMERA_CONTROL_AE_AVAILABLE_TARGET_FPS_RANGES, &fpsEntry) == ACAMERA_OK) {
         int32_t maxFps = 0;
-        for (uint32_t j = 0; j < fpsEntry.count; j += 2) {
+        for (uint32_t j = 0; j + 1 < fpsEntry.count; j += 2) {
+            int32_t minRange = fpsEntry.data.i32[j];
             int32_t maxRange = fpsEntry.data.i32[j + 1];
+            outInfo.fpsRanges.push_back({minRange, maxRange});
             maxFps = std::max(maxFps, maxRange);
         }
         outInfo.maxFps = maxFps;
@@ -156,15 +262,10 @@ bool CameraManager::queryCharacteristics(const char* cameraId, CameraInfo& outIn
     if (ACameraMetadata_getConstEntry(metadata,
             ACAMERA_LOGICAL_MULTI_CAMERA_PHYSICAL_IDS, &physicalEntry) == ACAMERA_OK) {
         outInfo.isPhysicalCamera = false;
-        // Parse null-separated physical camera IDs
         std::string ids;
-        const char* ptr = reinterpret_cast<const char*>(physicalEntry.data.u8);
-        for (uint32_t j = 0; j < physicalEntry.count; ++j) {
-            if (ptr[j] == '\0' && j + 1 < physicalEntry.count) {
-                if (!ids.empty()) ids += ",";
-                ids += std::string(ptr);
-                ptr = reinterpret_cast<const char*>(physicalEntry.data.u8) + j + 1;
-            }
+        for (const std::string& physicalId : parsePhysicalIds(physicalEntry)) {
+            if (!ids.empty()) ids += ",";
+            ids += physicalId;
         }
         if (!ids.empty()) {
             outInfo.physicalCameraIds = ids;
@@ -177,6 +278,48 @@ bool CameraManager::queryCharacteristics(const char* cameraId, CameraInfo& outIn
     return outInfo.width > 0 && outInfo.height > 0;
 }
 
+bool CameraManager::getLogicalCameraInfo(const std::string& cameraId, LogicalCameraInfo& outInfo) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    outInfo = {};
+    outInfo.id = cameraId;
+
+    if (!cameraManager_) {
+        return false;
+    }
+
+    if (auto it = logicalCache_.find(cameraId); it != logicalCache_.end()) {
+        outInfo = it->second;
+        return !outInfo.physicalCameraIds.empty();
+    }
+
+    ACameraMetadata* metadata = nullptr;
+    camera_status_t status = ACameraManager_getCameraCharacteristics(
+        cameraManager_, cameraId.c_str(), &metadata);
+    if (status != ACAMERA_OK || !metadata) {
+        LOGE("Failed to get characteristics for camera %s: %d", cameraId.c_str(), status);
+        return false;
+    }
+
+    ACameraMetadata_const_entry physicalEntry;
+    if (ACameraMetadata_getConstEntry(metadata,
+            ACAMERA_LOGICAL_MULTI_CAMERA_PHYSICAL_IDS, &physicalEntry) == ACAMERA_OK) {
+        outInfo.physicalCameraIds = parsePhysicalIds(physicalEntry);
+    }
+
+    ACameraMetadata_const_entry syncEntry;
+    if (ACameraMetadata_getConstEntry(metadata,
+            ACAMERA_LOGICAL_MULTI_CAMERA_SENSOR_SYNC_TYPE, &syncEntry) == ACAMERA_OK &&
+        syncEntry.count > 0) {
+        outInfo.syncType = syncEntry.data.u8[0] == ACAMERA_LOGICAL_MULTI_CAMERA_SENSOR_SYNC_TYPE_CALIBRATED
+            ? MultiCameraSyncType::Calibrated
+            : MultiCameraSyncType::Approximate;
+    }
+
+    ACameraMetadata_free(metadata);
+    logicalCache_[cameraId] = outInfo;
+    return !outInfo.physicalCameraIds.empty();
+}
+
 CameraClusterType CameraManager::classifyCamera(const CameraInfo& info, const std::string& id) {
     std::string lowerId = toLower(id);
 
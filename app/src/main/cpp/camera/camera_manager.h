@@ -3,16 +3,25 @@
 #include <camera/NdkCameraManager.h>
 #include <camera/NdkCameraDevice.h>
 #include <camera/NdkCameraMetadata.h>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "camera_data.h"
 
 namespace nativesensor {
 
-/// RAII wrapper for ACameraManager
+/// Invoked with the new generation after the camera set changed (camera service thread)
+using CameraChangeListener = std::function<void(uint64_t generation)>;
+
+/// RAII wrapper for ACameraManager.
+/// Characteristics are queried once per camera and cached; availability callbacks
+/// invalidate the cache when a camera appears or a hot-pluggable camera goes away.
 class CameraManager {
 public:
     CameraManager();
@@ -21,10 +30,25 @@ public:
     CameraManager(const CameraManager&) = delete;
     CameraManager& operator=(const CameraManager&) = delete;
 
-    /// Enumerate all available cameras with metadata
+    /// Enumerate all available cameras with metadata (served from the cache when valid)
     [[nodiscard]]
     std::vector<CameraInfo> enumerateCameras();
 
+    /// Force the next enumeration to re-query every camera
+    void invalidateCache();
+
+    /// Incremented whenever the cache is invalidated; an unchanged value means the last
+    /// enumeration is still current
+    [[nodiscard]]
+    uint64_t getGeneration() const noexcept { return generation_.load(std::memory_order_acquire); }
+
+    /// Register (or clear, with nullptr) the single change listener
+    void setChangeListener(CameraChangeListener listener);
+
+    /// Query the physical cameras and sensor sync type of a logical multi-camera
+    /// @return false if the camera is not a logical multi-camera
+    bool getLogicalCameraInfo(const std::string& cameraId, LogicalCameraInfo& outInfo);
+
     /// Get the native camera manager handle (for CameraStream use)
     [[nodiscard]]
     ACameraManager* getNativeManager() const { return cameraManager_; }
@@ -34,14 +58,34 @@ public:
     bool isValid() const { return cameraManager_ != nullptr; }
 
 private:
+    // Availability callbacks (camera service thread)
+    static void onCameraAvailable(void* context, const char* cameraId);
+    static void onCameraUnavailable(void* context, const char* cameraId);
+
     /// Classify camera into cluster based on metadata heuristics
     static CameraClusterType classifyCamera(const CameraInfo& info, const std::string& id);
 
     /// Query camera characteristics
     bool queryCharacteristics(const char* cameraId, CameraInfo& outInfo);
 
+    /// Call the change listener; never called with mutex_ held
+    void notifyChanged();
+
     ACameraManager* cameraManager_ = nullptr;
     std::mutex mutex_;
+
+    // Characteristics cache (guarded by mutex_)
+    bool camerasCached_ = false;
+    std::vector<CameraInfo> cachedCameras_;
+    std::unordered_set<std::string> knownCameraIds_;    // Every id in the last id list
+    std::unordered_map<std::string, LogicalCameraInfo> logicalCache_;
+    std::atomic<uint64_t> generation_{0};
+
+    std::mutex listenerMutex_;
+    CameraChangeListener changeListener_;
+
+    // Must persist while registered
+    ACameraManager_AvailabilityCallbacks availabilityCallbacks_{};
 };
 
 }  // namespace nativesensor
@@ -0,0 +1,495 @@
+#include "camera_session.h"
+
+#include <android/log.h>
+#include <utility>
+
+#include "trace.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Session";
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+namespace {
+
+size_t roleIndex(SessionOutputRole role) noexcept {
+    return static_cast<size_t>(role);
+}
+
+}  // namespace
+
+CameraSession::CameraSession(CameraManager& manager, std::string cameraId)
+    : manager_(manager), cameraId_(std::move(cameraId)) {
+    deviceCallbacks_.context = this;
+    deviceCallbacks_.onDisconnected = onDeviceDisconnected;
+    deviceCallbacks_.onError = onDeviceError;
+
+    sessionCallbacks_.context = this;
+    sessionCallbacks_.onClosed = onSessionClosed;
+    sessionCallbacks_.onReady = onSessionReady;
+    sessionCallbacks_.onActive = onSessionActive;
+
+    captureCallbacks_.context = this;
+    captureCallbacks_.onCaptureStarted = onCaptureStarted;
+    captureCallbacks_.onCaptureProgressed = nullptr;
+    captureCallbacks_.onCaptureCompleted = onCaptureCompleted;
+    captureCallbacks_.onCaptureFailed = onCaptureFailed;
+    captureCallbacks_.onCaptureSequenceCompleted = nullptr;
+    captureCallbacks_.onCaptureSequenceAborted = nullptr;
+    captureCallbacks_.onCaptureBufferLost = onCaptureBufferLost;
+}
+
+CameraSession::~CameraSession() {
+    close();
+}
+
+void CameraSession::openAsync(SessionOpenCallback onComplete) {
+    std::unique_lock<std::mutex> lock(openMutex_);
+
+    switch (openState_) {
+        case OpenState::Opening:
+            if (onComplete) {
+                openCallbacks_.push_back(std::move(onComplete));
+            }
+            return;
+
+        case OpenState::Open:
+        case OpenState::Failed: {
+            const bool opened = openState_ == OpenState::Open && isOpen();
+            lock.unlock();
+            if (onComplete) {
+                onComplete(opened);
+            }
+            return;
+        }
+
+        case OpenState::Closed:
+            break;
+    }
+
+    if (!manager_.isValid()) {
+        LOGE("Cannot open camera %s: camera manager invalid", cameraId_.c_str());
+        openState_ = OpenState::Failed;
+        failed_.store(true, std::memory_order_release);
+        lock.unlock();
+        if (onComplete) {
+            onComplete(false);
+        }
+        return;
+    }
+
+    openState_ = OpenState::Opening;
+    if (onComplete) {
+        openCallbacks_.push_back(std::move(onComplete));
+    }
+    openThread_ = std::thread([this] { runOpen(); });
+}
+
+void CameraSession::runOpen() {
+    // Blocks for the camera service round trip; nothing else waits on it until attachOutput()
+    NS_TRACE_SCOPE("CameraSession::open");
+    ACameraDevice* device = nullptr;
+    camera_status_t status = ACameraManager_openCamera(
+        manager_.getNativeManager(),
+        cameraId_.c_str(),
+        &deviceCallbacks_,
+        &device);
+
+    const bool opened = status == ACAMERA_OK && device;
+    if (opened) {
+        LOGI("Camera device opened: %s", cameraId_.c_str());
+    } else {
+        LOGE("Failed to open camera %s: %d", cameraId_.c_str(), status);
+    }
+
+    std::vector<SessionOpenCallback> callbacks;
+    bool usable;
+    {
+        std::lock_guard<std::mutex> lock(openMutex_);
+        cameraDevice_ = opened ? device : nullptr;
+        // A disconnect can race the open; it leaves failed_ set
+        usable = opened && !failed_.load(std::memory_order_acquire);
+        deviceOpen_.store(usable, std::memory_order_release);
+        if (!opened) {
+            failed_.store(true, std::memory_order_release);
+        }
+        openState_ = opened ? OpenState::Open : OpenState::Failed;
+        callbacks.swap(openCallbacks_);
+    }
+    openSettled_.notify_all();
+
+    for (const SessionOpenCallback& callback : callbacks) {
+        callback(usable);
+    }
+}
+
+bool CameraSession::waitForOpen() {
+    std::unique_lock<std::mutex> lock(openMutex_);
+    openSettled_.wait(lock, [this] { return openState_ != OpenState::Opening; });
+    return openState_ == OpenState::Open && isOpen();
+}
+
+bool CameraSession::open() {
+    openAsync();
+    return waitForOpen();
+}
+
+void CameraSession::close() {
+    // An open in flight cannot be cancelled; let it settle first
+    std::thread openThread;
+    {
+        std::lock_guard<std::mutex> lock(openMutex_);
+        openThread = std::move(openThread_);
+    }
+    if (openThread.joinable()) {
+        if (openThread.get_id() == std::this_thread::get_id()) {
+            openThread.detach();    // Last reference dropped from an open completion callback
+        } else {
+            openThread.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    teardownSession();
+    for (Output& output : outputs_) {
+        freeOutput(output);
+    }
+    {
+        std::lock_guard<std::mutex> callbackLock(callbackMutex_);
+        callbacks_ = {};
+        callbackWindows_ = {};
+    }
+
+    if (cameraDevice_) {
+        ACameraDevice_close(cameraDevice_);
+        cameraDevice_ = nullptr;
+        LOGI("Camera device closed: %s", cameraId_.c_str());
+    }
+    deviceOpen_.store(false, std::memory_order_release);
+
+    std::lock_guard<std::mutex> openLock(openMutex_);
+    openState_ = OpenState::Closed;
+    failed_.store(false, std::memory_order_release);
+}
+
+bool CameraSession::attachOutput(SessionOutputRole role, ANativeWindow* window,
+                                 SessionOutputCallbacks callbacks) {
+    // Callers prepare their window while the device opens; join the open here
+    if (!waitForOpen()) {
+        LOGE("Cannot attach output to camera %s: device not open", cameraId_.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!deviceOpen_.load(std::memory_order_acquire)) {
+        LOGE("Cannot attach output to camera %s: device lost", cameraId_.c_str());
+        return false;
+    }
+    if (!window) {
+        LOGE("Cannot attach output to camera %s: null window", cameraId_.c_str());
+        return false;
+    }
+
+    // Streams are only reconfigured between repeating requests
+    teardownSession();
+
+    const size_t index = roleIndex(role);
+    Output& output = outputs_[index];
+    freeOutput(output);
+
+    output.window = window;
+    ANativeWindow_acquire(output.window);
+
+    camera_status_t status = ACaptureSessionOutput_create(output.window, &output.sessionOutput);
+    if (status == ACAMERA_OK) {
+        status = ACameraOutputTarget_create(output.window, &output.target);
+    }
+
+    bool attached = status == ACAMERA_OK;
+    if (!attached) {
+        LOGE("Failed to create output for role %d: %d", static_cast<int>(role), status);
+    } else {
+        {
+            std::lock_guard<std::mutex> callbackLock(callbackMutex_);
+            callbacks_[index] = std::move(callbacks);
+            callbackWindows_[index] = output.window;
+        }
+        attached = reconfigure();
+    }
+
+    if (!attached) {
+        {
+            std::lock_guard<std::mutex> callbackLock(callbackMutex_);
+            callbacks_[index] = {};
+            callbackWindows_[index] = nullptr;
+        }
+        freeOutput(output);
+
+        // Keep the remaining outputs streaming
+        teardownSession();
+        reconfigure();
+        return false;
+    }
+
+    LOGI("Attached role %d to camera %s (%zu outputs)", static_cast<int>(role),
+         cameraId_.c_str(), getAttachedOutputCountLocked());
+    return true;
+}
+
+void CameraSession::detachOutput(SessionOutputRole role) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const size_t index = roleIndex(role);
+    if (!outputs_[index].window) {
+        return;
+    }
+
+    // Stop frames reaching the window before it is released
+    teardownSession();
+    {
+        std::lock_guard<std::mutex> callbackLock(callbackMutex_);
+        callbacks_[index] = {};
+        callbackWindows_[index] = nullptr;
+    }
+    freeOutput(outputs_[index]);
+
+    if (deviceOpen_.load(std::memory_order_acquire)) {
+        reconfigure();
+    }
+
+    LOGI("Detached role %d from camera %s (%zu outputs)", static_cast<int>(role),
+         cameraId_.c_str(), getAttachedOutputCountLocked());
+}
+
+size_t CameraSession::getAttachedOutputCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return getAttachedOutputCountLocked();
+}
+
+size_t CameraSession::getAttachedOutputCountLocked() const {
+    size_t count = 0;
+    for (const Output& output : outputs_) {
+        if (output.window) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool CameraSession::reconfigure() {
+    NS_TRACE_SCOPE("CameraSession::reconfigure");
+    if (!cameraDevice_ || getAttachedOutputCountLocked() == 0) {
+        return true;    // Nothing to stream; the device stays open for the next attach
+    }
+
+    camera_status_t status = ACaptureSessionOutputContainer_create(&outputContainer_);
+    if (status != ACAMERA_OK) {
+        LOGE("Failed to create output container: %d", status);
+        teardownSession();
+        return false;
+    }
+
+    // Encoder consumers want stable frame rate over preview-tuned 3A
+    const bool recording = outputs_[roleIndex(SessionOutputRole::Encoder)].window != nullptr ||
+                           outputs_[roleIndex(SessionOutputRole::VideoEncoder)].window != nullptr;
+    status = ACameraDevice_createCaptureRequest(cameraDevice_,
+        recording ? TEMPLATE_RECORD : TEMPLATE_PREVIEW, &captureRequest_);
+    if (status != ACAMERA_OK) {
+        LOGE("Failed to create capture request: %d", status);
+        teardownSession();
+        return false;
+    }
+
+    for (const Output& output : outputs_) {
+        if (!output.window) {
+            continue;
+        }
+
+        status = ACaptureSessionOutputContainer_add(outputContainer_, output.sessionOutput);
+        if (status != ACAMERA_OK) {
+            LOGE("Failed to add output to container: %d", status);
+            teardownSession();
+            return false;
+        }
+
+        status = ACaptureRequest_addTarget(captureRequest_, output.target);
+        if (status != ACAMERA_OK) {
+            LOGE("Failed to add target to request: %d", status);
+            teardownSession();
+            return false;
+        }
+    }
+
+    // Replaces any previous session on this device without reopening it
+    status = ACameraDevice_createCaptureSession(
+        cameraDevice_,
+        outputContainer_,
+        &sessionCallbacks_,
+        &captureSession_);
+
+    if (status != ACAMERA_OK || !captureSession_) {
+        LOGE("Failed to create capture session for camera %s: %d", cameraId_.c_str(), status);
+        captureSession_ = nullptr;
+        teardownSession();
+        return false;
+    }
+
+    // V2 callbacks carry frame numbers, which consumers use to detect skipped captures
+    status = ACameraCaptureSession_setRepeatingRequestV2(
+        captureSession_,
+        &captureCallbacks_,
+        1,
+        &captureRequest_,
+        nullptr);
+
+    if (status != ACAMERA_OK) {
+        LOGE("Failed to set repeating request: %d", status);
+        teardownSession();
+        return false;
+    }
+
+    return true;
+}
+
+void CameraSession::teardownSession() {
+    if (captureSession_) {
+        ACameraCaptureSession_stopRepeating(captureSession_);
+        ACameraCaptureSession_close(captureSession_);
+        captureSession_ = nullptr;
+    }
+
+    if (captureRequest_) {
+        ACaptureRequest_free(captureRequest_);
+        captureRequest_ = nullptr;
+    }
+
+    if (outputContainer_) {
+        ACaptureSessionOutputContainer_free(outputContainer_);
+        outputContainer_ = nullptr;
+    }
+}
+
+void CameraSession::freeOutput(Output& output) {
+    if (output.target) {
+        ACameraOutputTarget_free(output.target);
+        output.target = nullptr;
+    }
+
+    if (output.sessionOutput) {
+        ACaptureSessionOutput_free(output.sessionOutput);
+        output.sessionOutput = nullptr;
+    }
+
+    if (output.window) {
+        ANativeWindow_release(output.window);
+        output.window = nullptr;
+    }
+}
+
+void CameraSession::notifyDeviceLost() {
+    deviceOpen_.store(false, std::memory_order_release);
+    failed_.store(true, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    for (const SessionOutputCallbacks& callbacks : callbacks_) {
+        if (callbacks.onDeviceLost) {
+            callbacks.onDeviceLost();
+        }
+    }
+}
+
+// Static callbacks
+
+void CameraSession::onDeviceDisconnected(void* context, ACameraDevice* /*device*/) {
+    auto* self = static_cast<CameraSession*>(context);
+    LOGW("Camera device disconnected: %s", self->cameraId_.c_str());
+    self->notifyDeviceLost();
+}
+
+void CameraSession::onDeviceError(void* context, ACameraDevice* /*device*/, int error) {
+    auto* self = static_cast<CameraSession*>(context);
+    LOGE("Camera device error on %s: %d", self->cameraId_.c_str(), error);
+    self->notifyDeviceLost();
+}
+
+void CameraSession::onSessionClosed(void* /*context*/, ACameraCaptureSession* /*session*/) {
+    LOGI("Capture session closed");
+}
+
+void CameraSession::onSessionReady(void* /*context*/, ACameraCaptureSession* /*session*/) {
+    LOGI("Capture session ready");
+}
+
+void CameraSession::onSessionActive(void* /*context*/, ACameraCaptureSession* /*session*/) {
+    LOGI("Capture session active");
+}
+
+void CameraSession::onCaptureStarted(void* context, ACameraCaptureSession* /*session*/,
+                                     const ACaptureRequest* /*request*/, int64_t timestamp,
+                                     int64_t frameNumber) {
+    auto* self = static_cast<CameraSession*>(context);
+
+    std::lock_guard<std::mutex> lock(self->callbackMutex_);
+    for (const SessionOutputCallbacks& callbacks : self->callbacks_) {
+        if (callbacks.onCaptureStarted) {
+            callbacks.onCaptureStarted(timestamp, frameNumber);
+        }
+    }
+}
+
+void CameraSession::onCaptureCompleted(void* context, ACameraCaptureSession* /*session*/,
+                                       ACaptureRequest* /*request*/,
+                                       const ACameraMetadata* result) {
+    auto* self = static_cast<CameraSession*>(context);
+
+    ACameraMetadata_const_entry entry{};
+    if (ACameraMetadata_getConstEntry(result, ACAMERA_SENSOR_TIMESTAMP, &entry) != ACAMERA_OK ||
+        entry.count == 0) {
+        return;
+    }
+    const int64_t sensorTimestampNs = entry.data.i64[0];
+
+    std::lock_guard<std::mutex> lock(self->callbackMutex_);
+    for (const SessionOutputCallbacks& callbacks : self->callbacks_) {
+        if (callbacks.onCaptureCompleted) {
+            callbacks.onCaptureCompleted(sensorTimestampNs);
+        }
+    }
+}
+
+void CameraSession::onCaptureFailed(void* context, ACameraCaptureSession* /*session*/,
+                                    ACaptureRequest* /*request*/, ACameraCaptureFailure* failure) {
+    auto* self = static_cast<CameraSession*>(context);
+    const int64_t frameNumber = failure ? failure->frameNumber : -1;
+    LOGW("Capture failed on camera %s: frame %lld, reason %d", self->cameraId_.c_str(),
+         static_cast<long long>(frameNumber), failure ? failure->reason : -1);
+
+    std::lock_guard<std::mutex> lock(self->callbackMutex_);
+    for (const SessionOutputCallbacks& callbacks : self->callbacks_) {
+        if (callbacks.onCaptureFailed) {
+            callbacks.onCaptureFailed(frameNumber);
+        }
+    }
+}
+
+void CameraSession::onCaptureBufferLost(void* context, ACameraCaptureSession* /*session*/,
+                                        ACaptureRequest* /*request*/, ANativeWindow* window,
+                                        int64_t frameNumber) {
+    auto* self = static_cast<CameraSession*>(context);
+
+    // Only the output that owns the window lost a frame
+    std::lock_guard<std::mutex> lock(self->callbackMutex_);
+    for (size_t i = 0; i < kRoleCount; ++i) {
+        if (self->callbackWindows_[i] == window && self->callbacks_[i].onCaptureBufferLost) {
+            self->callbacks_[i].onCaptureBufferLost(frameNumber);
+        }
+    }
+}
+
+}  // namespace nativesensor
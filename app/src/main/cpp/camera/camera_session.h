@@ -0,0 +1,180 @@
+#pragma once
+
+#include <camera/NdkCameraDevice.h>
+#include <camera/NdkCameraCaptureSession.h>
+#include <camera/NdkCaptureRequest.h>
+#include <android/native_window.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_manager.h"
+
+namespace nativesensor {
+
+/// Consumer slots of a shared camera session
+enum class SessionOutputRole : int32_t {
+    Preview = 0,        // Display surface (SurfaceView/SpatialExternalSurface)
+    Encoder = 1,        // AImageReader window feeding the encoder path
+    VideoEncoder = 2    // AMediaCodec input surface (hardware encoding, no CPU access)
+};
+
+/// Per-output hooks invoked from the camera callback thread
+struct SessionOutputCallbacks {
+    /// Start of exposure for every frame of the shared repeating request
+    std::function<void(int64_t timestampNs, int64_t frameNumber)> onCaptureStarted;
+    /// Result metadata for a frame arrived (sensor timestamp of that frame)
+    std::function<void(int64_t sensorTimestampNs)> onCaptureCompleted;
+    /// A capture failed; no output receives its image
+    std::function<void(int64_t frameNumber)> onCaptureFailed;
+    /// The camera dropped this output's buffer for a capture
+    std::function<void(int64_t frameNumber)> onCaptureBufferLost;
+    /// Device disconnected or failed; the output no longer receives frames
+    std::function<void()> onDeviceLost;
+};
+
+/// Invoked once a device open settles (true if the device is open)
+using SessionOpenCallback = std::function<void(bool opened)>;
+
+/// One ACameraDevice serving every consumer of a camera id.
+/// All attached outputs are targets of a single repeating request, so preview and encoder
+/// see the same frames. Outputs are attached and detached at runtime; the session is
+/// reconfigured on the already-open device, which is never reopened while the object lives.
+///
+/// The device opens on a background thread so consumers can build their outputs (image
+/// readers, buffer pools) while the camera service connects; attachOutput() waits for it.
+class CameraSession {
+public:
+    static constexpr size_t kRoleCount = 3;
+
+    CameraSession(CameraManager& manager, std::string cameraId);
+    ~CameraSession();
+
+    CameraSession(const CameraSession&) = delete;
+    CameraSession& operator=(const CameraSession&) = delete;
+
+    /// Start opening the device on a background thread and return immediately.
+    /// Calls while an open is pending only queue onComplete.
+    /// @param onComplete Optional; runs on the open thread, or inline if the open already settled
+    void openAsync(SessionOpenCallback onComplete = nullptr);
+
+    /// Block until a pending open settles
+    /// @return true if the device is open
+    bool waitForOpen();
+
+    /// Open the camera device synchronously (no outputs, nothing streams yet)
+    /// @return false on failure
+    bool open();
+
+    /// Stop streaming to every output and close the device
+    void close();
+
+    /// Check if the device is open and has not been lost
+    [[nodiscard]]
+    bool isOpen() const { return deviceOpen_.load(std::memory_order_acquire); }
+
+    /// Check if the open failed or the device was lost (the session must be replaced)
+    [[nodiscard]]
+    bool hasFailed() const { return failed_.load(std::memory_order_acquire); }
+
+    [[nodiscard]]
+    const std::string& getCameraId() const { return cameraId_; }
+
+    /// Add an output (replacing any window already in that role) and restart the repeating request
+    /// @param role Slot to fill
+    /// @param window Target surface; the session holds its own reference until detach
+    /// @param callbacks Optional per-frame and device-loss hooks for this output
+    /// @return false if the session could not be reconfigured (the role is left detached)
+    bool attachOutput(SessionOutputRole role, ANativeWindow* window,
+                      SessionOutputCallbacks callbacks = {});
+
+    /// Remove an output. When this returns no more frames or callbacks reach it.
+    void detachOutput(SessionOutputRole role);
+
+    /// Number of roles currently attached
+    [[nodiscard]]
+    size_t getAttachedOutputCount() const;
+
+private:
+    enum class OpenState { Closed, Opening, Open, Failed };
+
+    struct Output {
+        ANativeWindow* window = nullptr;
+        ACaptureSessionOutput* sessionOutput = nullptr;
+        ACameraOutputTarget* target = nullptr;
+    };
+
+    // Camera device callbacks
+    static void onDeviceDisconnected(void* context, ACameraDevice* device);
+    static void onDeviceError(void* context, ACameraDevice* device, int error);
+
+    // Capture session callbacks
+    static void onSessionClosed(void* context, ACameraCaptureSession* session);
+    static void onSessionReady(void* context, ACameraCaptureSession* session);
+    static void onSessionActive(void* context, ACameraCaptureSession* session);
+
+    // Capture callbacks, fanned out to each attached output
+    static void onCaptureStarted(void* context, ACameraCaptureSession* session,
+                                 const ACaptureRequest* request, int64_t timestamp,
+                                 int64_t frameNumber);
+    static void onCaptureCompleted(void* context, ACameraCaptureSession* session,
+                                   ACaptureRequest* request, const ACameraMetadata* result);
+    static void onCaptureFailed(void* context, ACameraCaptureSession* session,
+                                ACaptureRequest* request, ACameraCaptureFailure* failure);
+    static void onCaptureBufferLost(void* context, ACameraCaptureSession* session,
+                                    ACaptureRequest* request, ANativeWindow* window,
+                                    int64_t frameNumber);
+
+    /// Body of the open thread
+    void runOpen();
+
+    /// Rebuild container, request and capture session from outputs_ (caller holds mutex_)
+    bool reconfigure();
+
+    /// Stop the repeating request and free session-level handles (caller holds mutex_)
+    void teardownSession();
+
+    [[nodiscard]]
+    size_t getAttachedOutputCountLocked() const;
+
+    static void freeOutput(Output& output);
+    void notifyDeviceLost();
+
+    CameraManager& manager_;
+    const std::string cameraId_;
+    mutable std::mutex mutex_;
+    std::atomic<bool> deviceOpen_{false};
+    std::atomic<bool> failed_{false};
+
+    // Asynchronous open (cameraDevice_ is published under openMutex_ before the state settles)
+    std::mutex openMutex_;
+    std::condition_variable openSettled_;
+    OpenState openState_ = OpenState::Closed;
+    std::vector<SessionOpenCallback> openCallbacks_;
+    std::thread openThread_;
+
+    // NDK handles
+    ACameraDevice* cameraDevice_ = nullptr;
+    ACameraCaptureSession* captureSession_ = nullptr;
+    ACaptureSessionOutputContainer* outputContainer_ = nullptr;
+    ACaptureRequest* captureRequest_ = nullptr;
+    std::array<Output, kRoleCount> outputs_{};
+
+    // Guarded separately so camera callbacks never wait on a reconfiguration
+    std::mutex callbackMutex_;
+    std::array<SessionOutputCallbacks, kRoleCount> callbacks_{};
+    std::array<ANativeWindow*, kRoleCount> callbackWindows_{};  // Routes lost-buffer reports
+
+    // Callback structs (must persist for lifetime of camera session)
+    ACameraDevice_StateCallbacks deviceCallbacks_{};
+    ACameraCaptureSession_stateCallbacks sessionCallbacks_{};
+    ACameraCaptureSession_captureCallbacksV2 captureCallbacks_{};
+};
+
+}  // namespace nativesensor
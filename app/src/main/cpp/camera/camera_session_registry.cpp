@@ -0,0 +1,306 @@
+#include "camera_session_registry.h"
+
+#include <android/log.h>
+#include <utility>
+#include <vector>
+
+#include "camera_encoder_bridge.h"
+#include "camera_stream.h"
+#include "multi_camera_capture.h"
+#include "native_encoder.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Session";
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+CameraSessionRegistry::CameraSessionRegistry(CameraManager& manager)
+    : manager_(manager) {
+}
+
+CameraSessionRegistry::~CameraSessionRegistry() {
+    // Consumers release their sessions while stopping
+    stopAllPreviews();
+    releaseAllEncoders();
+    releaseNativeEncoder();
+    releaseMultiCapture();
+
+    std::unordered_map<std::string, std::shared_ptr<CameraSession>> prewarmed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        prewarmed.swap(prewarmed_);
+    }
+}
+
+std::shared_ptr<CameraSession> CameraSessionRegistry::acquireSession(const std::string& cameraId) {
+    std::shared_ptr<CameraSession> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // The first consumer takes over a prewarmed session
+        auto it = prewarmed_.find(cameraId);
+        if (it != prewarmed_.end()) {
+            session = std::move(it->second);
+            prewarmed_.erase(it);
+            if (session->hasFailed()) {
+                session.reset();
+            } else {
+                sessions_[cameraId] = session;
+            }
+        }
+        if (!session) {
+            session = findOrCreateLocked(cameraId);
+        }
+    }
+
+    // No-op unless newly created; the open overlaps the caller's output setup
+    session->openAsync();
+    return session;
+}
+
+void CameraSessionRegistry::prewarm(const std::string& cameraId, SessionOpenCallback onComplete) {
+    std::shared_ptr<CameraSession> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& held = prewarmed_[cameraId];
+        if (!held || held->hasFailed()) {
+            held = findOrCreateLocked(cameraId);
+            LOGI("Prewarming camera %s", cameraId.c_str());
+        }
+        session = held;
+    }
+
+    session->openAsync(std::move(onComplete));
+}
+
+void CameraSessionRegistry::cancelPrewarm(const std::string& cameraId) {
+    std::shared_ptr<CameraSession> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = prewarmed_.find(cameraId);
+        if (it == prewarmed_.end()) {
+            return;
+        }
+        session = std::move(it->second);
+        prewarmed_.erase(it);
+    }
+
+    // Closing joins a pending open; keep that outside the registry lock
+    session.reset();
+}
+
+std::shared_ptr<CameraSession> CameraSessionRegistry::findOrCreateLocked(const std::string& cameraId) {
+    auto it = sessions_.find(cameraId);
+    if (it != sessions_.end()) {
+        if (auto session = it->second.lock(); session && !session->hasFailed()) {
+            return session;
+        }
+    }
+
+    auto session = std::make_shared<CameraSession>(manager_, cameraId);
+    sessions_[cameraId] = session;
+    LOGI("Shared session created for camera %s", cameraId.c_str());
+    return session;
+}
+
+CameraStream& CameraSessionRegistry::getOrCreatePreview(const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& stream = previews_[cameraId];
+    if (!stream) {
+        stream = std::make_unique<CameraStream>(*this);
+    }
+    return *stream;
+}
+
+bool CameraSessionRegistry::withPreview(const std::string& cameraId,
+                                        const std::function<void(CameraStream&)>& fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = previews_.find(cameraId);
+    if (it == previews_.end() || !it->second) {
+        return false;
+    }
+    fn(*it->second);
+    return true;
+}
+
+void CameraSessionRegistry::forEachPreview(
+    const std::function<void(const std::string&, CameraStream&)>& fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [id, stream] : previews_) {
+        if (stream) {
+            fn(id, *stream);
+        }
+    }
+}
+
+void CameraSessionRegistry::stopPreview(const std::string& cameraId) {
+    std::unique_ptr<CameraStream> stream;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = previews_.find(cameraId);
+        if (it == previews_.end()) {
+            return;
+        }
+        stream = std::move(it->second);
+        previews_.erase(it);
+    }
+
+    // Detaching reconfigures the shared session; keep that outside the registry lock
+    if (stream) {
+        stream->stopPreview();
+    }
+}
+
+void CameraSessionRegistry::stopAllPreviews() {
+    std::unordered_map<std::string, std::unique_ptr<CameraStream>> streams;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        streams.swap(previews_);
+    }
+
+    for (auto& [id, stream] : streams) {
+        if (stream) {
+            stream->stopPreview();
+        }
+    }
+}
+
+std::shared_ptr<CameraEncoderBridge> CameraSessionRegistry::getOrCreateEncoder(
+    const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& encoder = encoders_[cameraId];
+    if (!encoder) {
+        encoder = std::make_shared<CameraEncoderBridge>(*this);
+    }
+    return encoder;
+}
+
+bool CameraSessionRegistry::withEncoder(const std::string& cameraId,
+                                        const std::function<void(CameraEncoderBridge&)>& fn) {
+    std::shared_ptr<CameraEncoderBridge> encoder;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = encoders_.find(cameraId);
+        if (it == encoders_.end() || !it->second) {
+            return false;
+        }
+        encoder = it->second;
+    }
+
+    // Encoder calls take the encoder lock; never hold the registry lock across them
+    fn(*encoder);
+    return true;
+}
+
+void CameraSessionRegistry::forEachEncoder(
+    const std::function<void(const std::string&, CameraEncoderBridge&)>& fn) {
+    std::vector<std::pair<std::string, std::shared_ptr<CameraEncoderBridge>>> encoders;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        encoders.reserve(encoders_.size());
+        for (const auto& [id, encoder] : encoders_) {
+            if (encoder) {
+                encoders.emplace_back(id, encoder);
+            }
+        }
+    }
+
+    for (const auto& [id, encoder] : encoders) {
+        fn(id, *encoder);
+    }
+}
+
+void CameraSessionRegistry::releaseEncoder(const std::string& cameraId) {
+    std::shared_ptr<CameraEncoderBridge> encoder;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = encoders_.find(cameraId);
+        if (it == encoders_.end()) {
+            return;
+        }
+        encoder = std::move(it->second);
+        encoders_.erase(it);
+    }
+
+    // Stopping detaches from the shared session; keep that outside the registry lock
+    if (encoder) {
+        encoder->stopCapture();
+    }
+}
+
+void CameraSessionRegistry::releaseAllEncoders() {
+    std::unordered_map<std::string, std::shared_ptr<CameraEncoderBridge>> encoders;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        encoders.swap(encoders_);
+    }
+
+    for (auto& [id, encoder] : encoders) {
+        if (encoder) {
+            encoder->stopCapture();
+        }
+    }
+}
+
+NativeEncoder& CameraSessionRegistry::getOrCreateNativeEncoder() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!nativeEncoder_) {
+        nativeEncoder_ = std::make_unique<NativeEncoder>(*this);
+    }
+    return *nativeEncoder_;
+}
+
+bool CameraSessionRegistry::withNativeEncoder(const std::function<void(NativeEncoder&)>& fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!nativeEncoder_) {
+        return false;
+    }
+    fn(*nativeEncoder_);
+    return true;
+}
+
+void CameraSessionRegistry::releaseNativeEncoder() {
+    std::unique_ptr<NativeEncoder> encoder;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        encoder = std::move(nativeEncoder_);
+    }
+
+    if (encoder) {
+        encoder->stop();
+    }
+}
+
+MultiCameraCapture& CameraSessionRegistry::getOrCreateMultiCapture() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!multiCapture_) {
+        multiCapture_ = std::make_unique<MultiCameraCapture>(manager_);
+    }
+    return *multiCapture_;
+}
+
+bool CameraSessionRegistry::withMultiCapture(const std::function<void(MultiCameraCapture&)>& fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!multiCapture_) {
+        return false;
+    }
+    fn(*multiCapture_);
+    return true;
+}
+
+void CameraSessionRegistry::releaseMultiCapture() {
+    std::unique_ptr<MultiCameraCapture> capture;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capture = std::move(multiCapture_);
+    }
+
+    if (capture) {
+        capture->stop();
+    }
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "camera_manager.h"
+#include "camera_session.h"
+
+namespace nativesensor {
+
+class CameraStream;
+class CameraEncoderBridge;
+class MultiCameraCapture;
+class NativeEncoder;
+
+/// Owner of every camera consumer, keyed by camera id.
+/// Previews, encoder captures and the hardware encoder on the same id share one CameraSession (and so one
+/// ACameraDevice); the session closes when its last consumer releases it.
+/// A prewarmed session is held by the registry until its first consumer takes it over.
+/// Synchronized multi-camera capture owns its logical device outright.
+class CameraSessionRegistry {
+public:
+    explicit CameraSessionRegistry(CameraManager& manager);
+    ~CameraSessionRegistry();
+
+    CameraSessionRegistry(const CameraSessionRegistry&) = delete;
+    CameraSessionRegistry& operator=(const CameraSessionRegistry&) = delete;
+
+    [[nodiscard]]
+    CameraManager& getManager() const { return manager_; }
+
+    /// Shared session for a camera. If no consumer (or prewarm) holds one yet, the device
+    /// starts opening in the background; CameraSession::attachOutput() waits for it.
+    std::shared_ptr<CameraSession> acquireSession(const std::string& cameraId);
+
+    /// Open a camera ahead of its first consumer, e.g. before the preview surface exists
+    /// @param onComplete Optional; invoked once the open settles
+    void prewarm(const std::string& cameraId, SessionOpenCallback onComplete = nullptr);
+
+    /// Drop a prewarmed session no consumer has taken over (closes the device if unused)
+    void cancelPrewarm(const std::string& cameraId);
+
+    /// Preview stream for a camera, created on first use
+    CameraStream& getOrCreatePreview(const std::string& cameraId);
+
+    /// Run fn on a camera's preview while the registry lock keeps it alive
+    /// @return false if the camera has no preview stream
+    bool withPreview(const std::string& cameraId, const std::function<void(CameraStream&)>& fn);
+
+    /// Visit every preview stream under the registry lock
+    void forEachPreview(const std::function<void(const std::string&, CameraStream&)>& fn);
+
+    /// Stop and remove one camera's preview
+    void stopPreview(const std::string& cameraId);
+
+    /// Stop and remove every preview
+    void stopAllPreviews();
+
+    /// Encoder capture for a camera, created on first use. Captures of different cameras run
+    /// side by side; shared ownership lets a slow start (device open) proceed outside the
+    /// registry lock while a concurrent release drops the capture from the registry.
+    std::shared_ptr<CameraEncoderBridge> getOrCreateEncoder(const std::string& cameraId);
+
+    /// Run fn on a camera's encoder capture, kept alive by a reference taken under the registry
+    /// lock; fn runs after the lock is released, so it may block on the capture
+    /// @return false if the camera has no encoder capture
+    bool withEncoder(const std::string& cameraId,
+                     const std::function<void(CameraEncoderBridge&)>& fn);
+
+    /// Visit a snapshot of the encoder captures outside the registry lock
+    void forEachEncoder(const std::function<void(const std::string&, CameraEncoderBridge&)>& fn);
+
+    /// Stop and destroy one camera's encoder capture
+    void releaseEncoder(const std::string& cameraId);
+
+    /// Stop and destroy every encoder capture
+    void releaseAllEncoders();
+
+    /// Hardware video encoder fed by a camera session, created on first use
+    NativeEncoder& getOrCreateNativeEncoder();
+
+    /// Run fn on the hardware video encoder if one exists
+    /// @return false if no hardware encoder was created
+    bool withNativeEncoder(const std::function<void(NativeEncoder&)>& fn);
+
+    /// Stop and destroy the hardware video encoder
+    void releaseNativeEncoder();
+
+    /// Synchronized multi-camera capture, created on first use
+    MultiCameraCapture& getOrCreateMultiCapture();
+
+    /// Run fn on the multi-camera capture if one exists
+    /// @return false if no multi-camera capture was created
+    bool withMultiCapture(const std::function<void(MultiCameraCapture&)>& fn);
+
+    /// Stop and destroy the multi-camera capture
+    void releaseMultiCapture();
+
+private:
+    /// Live session for a camera, or a new unopened one. Caller holds mutex_.
+    std::shared_ptr<CameraSession> findOrCreateLocked(const std::string& cameraId);
+
+    CameraManager& manager_;
+    std::mutex mutex_;
+
+    // Sessions stay alive only while a consumer holds them
+    std::unordered_map<std::string, std::weak_ptr<CameraSession>> sessions_;
+    std::unordered_map<std::string, std::shared_ptr<CameraSession>> prewarmed_;
+    std::unordered_map<std::string, std::unique_ptr<CameraStream>> previews_;
+    std::unordered_map<std::string, std::shared_ptr<CameraEncoderBridge>> encoders_;
+    std::unique_ptr<NativeEncoder> nativeEncoder_;
+    std::unique_ptr<MultiCameraCapture> multiCapture_;
+};
+
+}  // namespace nativesensor
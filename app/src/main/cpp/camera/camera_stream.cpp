@@ -1,6 +1,8 @@
 #include "camera_stream.h"
 
 #include <android/log.h>
+
+#include "camera_session_registry.h"
 #include <ctime>
 
 namespace {
@@ -25,8 +27,8 @@ int64_t getBootTimeNs() noexcept {
 
 }  // namespace
 
-CameraStream::CameraStream(CameraManager& manager)
-    : manager_(manager) {
+CameraStream::CameraStream(CameraSessionRegistry& sessions)
+    : sessions_(sessions) {
     LOGI("CameraStream created");
 }
 
@@ -49,11 +51,8 @@ bool CameraStream::startPreview(const std::string& cameraId,
     if (streaming_.load(std::memory_order_acquire)) {
         LOGI("Switching from camera %s to %s", currentCameraId_.c_str(), cameraId.c_str());
         cleanup();
-    }
-
-    if (!manager_.isValid()) {
-        LOGE("Cannot start preview: camera manager invalid");
-        return false;
+    } else if (session_ || surface_) {
+        cleanup();  // Left attached by a lost device
     }
 
     if (!surface) {
@@ -63,14 +62,30 @@ bool CameraStream::startPreview(const std::string& cameraId,
 
     LOGI("Starting camera preview: %s", cameraId.c_str());
 
+    // Join (or open) the camera's shared session; an encoder capture may already be running on it.
+    // A fresh device opens in the background while the stream state is reset below.
+    session_ = sessions_.acquireSession(cameraId);
+    if (!session_) {
+        LOGE("Failed to open camera %s", cameraId.c_str());
+        return false;
+    }
+
     surface_ = surface;
     ANativeWindow_acquire(surface_);
     statsCallback_ = std::move(statsCallback);
     currentCameraId_ = cameraId;
 
+    // Drop frame sync state from a previous session (callbacks not registered yet)
+    {
+        std::lock_guard<std::mutex> syncLock(syncDrainMutex_);
+        pendingSyncFrames_.clear();
+        heldSyncFrameNs_ = 0;
+        lastSyncedFrameNs_ = 0;
+    }
+
     // Reset statistics
     frameCount_.store(0, std::memory_order_release);
-    droppedFrames_.store(0, std::memory_order_release);
+    latency_.reset();
     {
         std::lock_guard<std::mutex> statsLock(statsMutex_);
         prevFrameTimestampNs_ = 0;
@@ -79,115 +94,21 @@ bool CameraStream::startPreview(const std::string& cameraId,
         lastCallbackTimeNs_ = 0;
     }
 
-    // Setup device callbacks
-    deviceCallbacks_.context = this;
-    deviceCallbacks_.onDisconnected = onDeviceDisconnected;
-    deviceCallbacks_.onError = onDeviceError;
-
-    // Open camera device
-    camera_status_t status = ACameraManager_openCamera(
-        manager_.getNativeManager(),
-        cameraId.c_str(),
-        &deviceCallbacks_,
-        &cameraDevice_);
-
-    if (status != ACAMERA_OK || !cameraDevice_) {
-        LOGE("Failed to open camera %s: %d", cameraId.c_str(), status);
-        cleanup();
-        return false;
-    }
-
-    LOGI("Camera device opened: %s", cameraId.c_str());
-
-    // Create output target from surface
-    status = ACameraOutputTarget_create(surface_, &outputTarget_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to create output target: %d", status);
-        cleanup();
-        return false;
-    }
-
-    // Create capture request
-    status = ACameraDevice_createCaptureRequest(cameraDevice_, 
-        TEMPLATE_PREVIEW, &captureRequest_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to create capture request: %d", status);
-        cleanup();
-        return false;
-    }
-
-    // Add target to request
-    status = ACaptureRequest_addTarget(captureRequest_, outputTarget_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to add target to request: %d", status);
-        cleanup();
-        return false;
-    }
-
-    // Create session output container
-    status = ACaptureSessionOutputContainer_create(&outputContainer_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to create output container: %d", status);
-        cleanup();
-        return false;
-    }
-
-    // Create session output
-    status = ACaptureSessionOutput_create(surface_, &sessionOutput_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to create session output: %d", status);
-        cleanup();
-        return false;
-    }
-
-    // Add output to container
-    status = ACaptureSessionOutputContainer_add(outputContainer_, sessionOutput_);
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to add output to container: %d", status);
-        cleanup();
-        return false;
-    }
-
-    // Setup session callbacks
-    sessionCallbacks_.context = this;
-    sessionCallbacks_.onClosed = onSessionClosed;
-    sessionCallbacks_.onReady = onSessionReady;
-    sessionCallbacks_.onActive = onSessionActive;
-
-    // Create capture session
-    status = ACameraDevice_createCaptureSession(
-        cameraDevice_,
-        outputContainer_,
-        &sessionCallbacks_,
-        &captureSession_);
-
-    if (status != ACAMERA_OK || !captureSession_) {
-        LOGE("Failed to create capture session: %d", status);
-        cleanup();
-        return false;
-    }
-
-    LOGI("Capture session created");
-
-    // Setup capture callbacks for statistics
-    captureCallbacks_.context = this;
-    captureCallbacks_.onCaptureStarted = onCaptureStarted;
-    captureCallbacks_.onCaptureCompleted = onCaptureCompleted;
-    captureCallbacks_.onCaptureFailed = nullptr;
-    captureCallbacks_.onCaptureSequenceCompleted = nullptr;
-    captureCallbacks_.onCaptureSequenceAborted = nullptr;
-    captureCallbacks_.onCaptureBufferLost = nullptr;
-
-    // Start repeating capture request
-    status = ACameraCaptureSession_setRepeatingRequest(
-        captureSession_,
-        &captureCallbacks_,
-        1,
-        &captureRequest_,
-        nullptr);
-
-    if (status != ACAMERA_OK) {
-        LOGE("Failed to set repeating request: %d", status);
+    SessionOutputCallbacks callbacks;
+    callbacks.onCaptureStarted = [this](int64_t timestampNs, int64_t frameNumber) {
+        onCaptureStarted(timestampNs, frameNumber);
+    };
+    callbacks.onCaptureCompleted = [this](int64_t sensorTimestampNs) {
+        latency_.record(LatencyStage::CaptureCompleted, sensorTimestampNs);
+    };
+    callbacks.onCaptureFailed = [this](int64_t) { latency_.onCaptureFailed(); };
+    callbacks.onCaptureBufferLost = [this](int64_t) { latency_.onBufferLost(); };
+    callbacks.onDeviceLost = [this] {
+        LOGI("Camera device lost");
+        streaming_.store(false, std::memory_order_release);
+    };
+    if (!session_->attachOutput(SessionOutputRole::Preview, surface_, std::move(callbacks))) {
+        LOGE("Failed to attach preview surface to camera %s", cameraId.c_str());
         cleanup();
         return false;
     }
@@ -200,7 +121,8 @@ bool CameraStream::startPreview(const std::string& cameraId,
 void CameraStream::stopPreview() {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (!streaming_.load(std::memory_order_acquire)) {
+    // A lost device clears streaming_ but leaves the surface attached until stopped
+    if (!session_ && !surface_) {
         return;
     }
 
@@ -211,35 +133,10 @@ void CameraStream::stopPreview() {
 void CameraStream::cleanup() {
     streaming_.store(false, std::memory_order_release);
 
-    if (captureSession_) {
-        ACameraCaptureSession_stopRepeating(captureSession_);
-        ACameraCaptureSession_close(captureSession_);
-        captureSession_ = nullptr;
-    }
-
-    if (cameraDevice_) {
-        ACameraDevice_close(cameraDevice_);
-        cameraDevice_ = nullptr;
-    }
-
-    if (captureRequest_) {
-        ACaptureRequest_free(captureRequest_);
-        captureRequest_ = nullptr;
-    }
-
-    if (outputTarget_) {
-        ACameraOutputTarget_free(outputTarget_);
-        outputTarget_ = nullptr;
-    }
-
-    if (sessionOutput_) {
-        ACaptureSessionOutput_free(sessionOutput_);
-        sessionOutput_ = nullptr;
-    }
-
-    if (outputContainer_) {
-        ACaptureSessionOutputContainer_free(outputContainer_);
-        outputContainer_ = nullptr;
+    // Other outputs of the shared session keep streaming; the device closes with its last user
+    if (session_) {
+        session_->detachOutput(SessionOutputRole::Preview);
+        session_.reset();
     }
 
     if (surface_) {
@@ -260,7 +157,7 @@ CameraStats CameraStream::getStats() const {
     stats.frameRateHz = lastFrameRateHz_;
     stats.latencyMs = lastLatencyMs_;
     stats.frameCount = frameCount_.load(std::memory_order_acquire);
-    stats.droppedFrames = droppedFrames_.load(std::memory_order_acquire);
+    stats.droppedFrames = latency_.getDroppedFrames();
 
     return stats;
 }
@@ -291,47 +188,42 @@ void CameraStream::updateStats(int64_t timestampNs) {
         stats.frameRateHz = lastFrameRateHz_;
         stats.latencyMs = lastLatencyMs_;
         stats.frameCount = frameCount_.load(std::memory_order_acquire);
-        stats.droppedFrames = droppedFrames_.load(std::memory_order_acquire);
+        stats.droppedFrames = latency_.getDroppedFrames();
         statsCallback_(stats);
         lastCallbackTimeNs_ = now;
     }
 }
 
-// Static callbacks
-
-void CameraStream::onDeviceDisconnected(void* context, ACameraDevice* /*device*/) {
-    auto* self = static_cast<CameraStream*>(context);
-    LOGI("Camera device disconnected");
-    self->streaming_.store(false, std::memory_order_release);
-}
-
-void CameraStream::onDeviceError(void* context, ACameraDevice* /*device*/, int error) {
-    auto* self = static_cast<CameraStream*>(context);
-    LOGE("Camera device error: %d", error);
-    self->streaming_.store(false, std::memory_order_release);
+void CameraStream::onCaptureStarted(int64_t timestampNs, int64_t frameNumber) {
+    latency_.onFrameStarted(frameNumber, timestampNs);
+    updateStats(timestampNs);
+    pendingSyncFrames_.push(timestampNs);
 }
 
-void CameraStream::onSessionClosed(void* /*context*/, ACameraCaptureSession* /*session*/) {
-    LOGI("Capture session closed");
-}
+size_t CameraStream::drainFrameSync(ImuFrameSync& sync, FrameImuSync* out, size_t capacity) {
+    if (!out) {
+        return 0;
+    }
 
-void CameraStream::onSessionReady(void* /*context*/, ACameraCaptureSession* /*session*/) {
-    LOGI("Capture session ready");
-}
+    std::lock_guard<std::mutex> lock(syncDrainMutex_);
 
-void CameraStream::onSessionActive(void* /*context*/, ACameraCaptureSession* /*session*/) {
-    LOGI("Capture session active");
-}
+    size_t written = 0;
+    while (written < capacity) {
+        if (heldSyncFrameNs_ == 0 && !pendingSyncFrames_.pop(heldSyncFrameNs_)) {
+            break;
+        }
 
-void CameraStream::onCaptureStarted(void* context, ACameraCaptureSession* /*session*/,
-                                     const ACaptureRequest* /*request*/, int64_t timestamp) {
-    auto* self = static_cast<CameraStream*>(context);
-    self->updateStats(timestamp);
-}
+        const ImuAlignStatus status =
+            sync.alignFrame(heldSyncFrameNs_, lastSyncedFrameNs_, out[written]);
+        if (status == ImuAlignStatus::Pending) {
+            break;
+        }
 
-void CameraStream::onCaptureCompleted(void* /*context*/, ACameraCaptureSession* /*session*/,
-                                       ACaptureRequest* /*request*/, const ACameraMetadata* /*result*/) {
-    // Frame completed - could extract additional metadata here if needed
+        lastSyncedFrameNs_ = heldSyncFrameNs_;
+        heldSyncFrameNs_ = 0;
+        written++;
+    }
+    return written;
 }
 
 }  // namespace nativesensor
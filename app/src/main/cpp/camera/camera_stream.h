@@ -1,9 +1,5 @@
 #pragma once
 
-#include <camera/NdkCameraDevice.h>
-#include <camera/NdkCameraCaptureSession.h>
-#include <camera/NdkCaptureRequest.h>
-#include <media/NdkImageReader.h>
 #include <android/native_window.h>
 #include <functional>
 #include <memory>
@@ -13,17 +9,22 @@
 #include <string>
 
 #include "camera_data.h"
-#include "camera_manager.h"
+#include "camera_session.h"
+#include "frame_latency_tracker.h"
+#include "imu_frame_sync.h"
+#include "ring_buffer.h"
 
 namespace nativesensor {
 
+class CameraSessionRegistry;
+
 /// Callback for frame statistics updates
 using CameraStatsCallback = std::function<void(const CameraStats&)>;
 
-/// Zero-copy camera stream using AImageReader with ANativeWindow output
+/// Zero-copy camera preview: the surface is the Preview output of the camera's shared session
 class CameraStream {
 public:
-    explicit CameraStream(CameraManager& manager);
+    explicit CameraStream(CameraSessionRegistry& sessions);
     ~CameraStream();
 
     CameraStream(const CameraStream&) = delete;
@@ -49,6 +50,18 @@ public:
     [[nodiscard]]
     CameraStats getStats() const;
 
+    /// Latency histograms, jitter and drop counters since the preview started
+    [[nodiscard]]
+    FrameLatencySnapshot getLatencySnapshot() const { return latency_.snapshot(); }
+
+    /// Align frames started since the previous drain with the IMU, oldest first.
+    /// A frame the IMU has not reached yet stays queued for the next call.
+    /// @param sync IMU window to align against
+    /// @param out Destination records
+    /// @param capacity Records available in out
+    /// @return Number of records written
+    size_t drainFrameSync(ImuFrameSync& sync, FrameImuSync* out, size_t capacity);
+
     /// Get the currently active camera ID
     [[nodiscard]] [[maybe_unused]]
     std::string getCurrentCameraId() const {
@@ -57,43 +70,26 @@ public:
     }
 
 private:
-    // Camera device callbacks
-    static void onDeviceDisconnected(void* context, ACameraDevice* device);
-    static void onDeviceError(void* context, ACameraDevice* device, int error);
-
-    // Capture session callbacks
-    static void onSessionClosed(void* context, ACameraCaptureSession* session);
-    static void onSessionReady(void* context, ACameraCaptureSession* session);
-    static void onSessionActive(void* context, ACameraCaptureSession* session);
-
-    // Capture callbacks for statistics
-    static void onCaptureStarted(void* context, ACameraCaptureSession* session,
-                                  const ACaptureRequest* request, int64_t timestamp);
-    static void onCaptureCompleted(void* context, ACameraCaptureSession* session,
-                                    ACaptureRequest* request, const ACameraMetadata* result);
+    /// Per-frame hook from the shared session's capture callbacks
+    void onCaptureStarted(int64_t timestampNs, int64_t frameNumber);
 
     void cleanup();
     void updateStats(int64_t timestampNs);
 
-    CameraManager& manager_;
+    CameraSessionRegistry& sessions_;
     mutable std::mutex mutex_;
 
     std::atomic<bool> streaming_{false};
     std::string currentCameraId_;
 
-    // NDK handles (RAII cleanup in destructor/cleanup)
-    ACameraDevice* cameraDevice_ = nullptr;
-    ACameraCaptureSession* captureSession_ = nullptr;
-    ACaptureSessionOutputContainer* outputContainer_ = nullptr;
-    ACaptureSessionOutput* sessionOutput_ = nullptr;
-    ACameraOutputTarget* outputTarget_ = nullptr;
-    ACaptureRequest* captureRequest_ = nullptr;
+    // Shared with any encoder capture on the same camera
+    std::shared_ptr<CameraSession> session_;
     ANativeWindow* surface_ = nullptr;
 
     // Statistics tracking
     CameraStatsCallback statsCallback_;
     std::atomic<int64_t> frameCount_{0};
-    std::atomic<int64_t> droppedFrames_{0};
+    FrameLatencyTracker latency_;       // Also the source of dropped frame counts
 
     // Direct frequency/latency calculation (instant values)
     mutable std::mutex statsMutex_;
@@ -102,10 +98,13 @@ private:
     float lastLatencyMs_{0.0f};         // Latency = now - eventTimestamp
     int64_t lastCallbackTimeNs_{0};     // For periodic callback throttling
 
-    // Callback structs (must persist for lifetime of camera session)
-    ACameraDevice_StateCallbacks deviceCallbacks_{};
-    ACameraCaptureSession_stateCallbacks sessionCallbacks_{};
-    ACameraCaptureSession_captureCallbacks captureCallbacks_{};
+    // Capture-start timestamps awaiting IMU alignment. The camera callback thread produces;
+    // when nobody drains, the queue fills and later frames are skipped.
+    static constexpr size_t kSyncQueueCapacity = 64;
+    RingBuffer<int64_t, kSyncQueueCapacity> pendingSyncFrames_;
+    std::mutex syncDrainMutex_;
+    int64_t heldSyncFrameNs_ = 0;       // Popped but still waiting for the IMU
+    int64_t lastSyncedFrameNs_ = 0;     // Previous aligned frame, start of rotation integration
 };
 
 }  // namespace nativesensor
@@ -0,0 +1,134 @@
+#include "frame_dispatcher.h"
+
+#include <android/log.h>
+
+#include "trace.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Dispatch";
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+FrameDispatcher::~FrameDispatcher() {
+    stop();
+}
+
+bool FrameDispatcher::start(FrameSinkCallback sink, FrameDropPolicy policy,
+                            DispatcherThreadHooks hooks) {
+    if (running_.load(std::memory_order_acquire)) {
+        LOGI("FrameDispatcher already running");
+        return false;
+    }
+
+    sink_ = std::move(sink);
+    policy_ = policy;
+    hooks_ = std::move(hooks);
+    deliveredFrames_.store(0, std::memory_order_release);
+    droppedFrames_.store(0, std::memory_order_release);
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&FrameDispatcher::threadLoop, this);
+    LOGI("FrameDispatcher started (policy=%d)", static_cast<int>(policy_));
+    return true;
+}
+
+void FrameDispatcher::stop() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_.store(false, std::memory_order_release);
+    }
+    wakeCondition_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // Dispatch thread has exited; this thread is now the sole consumer
+    queue_.clear();
+
+    sink_ = nullptr;
+    hooks_ = {};
+    LOGI("FrameDispatcher stopped");
+}
+
+void FrameDispatcher::submit(FrameBufferHandle buffer, const FrameMetadata& metadata) {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    if (!queue_.emplace(std::move(buffer), metadata)) {
+        // Full: the consumer is more than a queue behind. The producer may not pop
+        // (SPSC), so the incoming frame is dropped under either policy.
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    NS_TRACE_COUNTER("Dispatch queue depth", queue_.size());
+
+    // Empty critical section orders the push before a waiting consumer's predicate check
+    { std::lock_guard<std::mutex> lock(wakeMutex_); }
+    wakeCondition_.notify_one();
+}
+
+FrameDispatchStats FrameDispatcher::getStats() const noexcept {
+    FrameDispatchStats stats;
+    stats.deliveredFrames = deliveredFrames_.load(std::memory_order_acquire);
+    stats.droppedFrames = droppedFrames_.load(std::memory_order_acquire);
+    stats.queueDepth = static_cast<int32_t>(queue_.size());
+    return stats;
+}
+
+bool FrameDispatcher::takeNext(DispatchedFrame& frame) {
+    if (!queue_.pop(frame)) {
+        return false;
+    }
+
+    if (policy_ == FrameDropPolicy::DropOldest) {
+        // Skip ahead to the newest queued frame; stale ones go straight back to the pool
+        DispatchedFrame newer;
+        while (queue_.pop(newer)) {
+            frame = std::move(newer);
+            droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+void FrameDispatcher::threadLoop() {
+    if (hooks_.onThreadStart) {
+        hooks_.onThreadStart();
+    }
+
+    DispatchedFrame frame;
+    while (running_.load(std::memory_order_acquire)) {
+        if (!takeNext(frame)) {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCondition_.wait(lock, [this] {
+                return !running_.load(std::memory_order_acquire) || !queue_.empty();
+            });
+            continue;
+        }
+
+        if (sink_) {
+            NS_TRACE_SCOPE("FrameDispatcher::deliver");
+            sink_(frame);
+        }
+        deliveredFrames_.fetch_add(1, std::memory_order_relaxed);
+
+        // Return the buffer to the pool now rather than when the next frame arrives
+        frame.buffer.reset();
+    }
+
+    if (hooks_.onThreadStop) {
+        hooks_.onThreadStop();
+    }
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "camera_data.h"
+#include "frame_buffer_pool.h"
+#include "ring_buffer.h"
+
+namespace nativesensor {
+
+/// What to discard when the consumer falls behind the camera
+enum class FrameDropPolicy : int32_t {
+    DropOldest = 0,     // Deliver the most recent frame, discarding stale queued ones
+    DropNewest = 1      // Deliver every queued frame in order, discarding new arrivals while full
+};
+
+/// Hooks run on the dispatch thread itself, e.g. to attach it to the JVM once
+struct DispatcherThreadHooks {
+    std::function<void()> onThreadStart;
+    std::function<void()> onThreadStop;
+};
+
+/// Dispatch queue statistics
+struct FrameDispatchStats {
+    int64_t deliveredFrames = 0;
+    int64_t droppedFrames = 0;      // Discarded by the drop policy
+    int32_t queueDepth = 0;
+};
+
+/// A pooled frame queued for delivery
+struct DispatchedFrame {
+    FrameBufferHandle buffer;
+    FrameMetadata metadata;
+};
+
+/// Callback invoked on the dispatch thread for every delivered frame
+using FrameSinkCallback = std::function<void(const DispatchedFrame& frame)>;
+
+/// Long-lived worker that decouples frame delivery from the AImageReader callback.
+/// The image reader thread submits pooled frames into a lock-free SPSC queue and
+/// returns immediately; the worker drains the queue and invokes the sink, so a slow
+/// consumer never stalls the camera's buffer queue.
+class FrameDispatcher {
+public:
+    /// Frames that can queue before the drop policy applies
+    static constexpr size_t kQueueCapacity = 8;
+
+    FrameDispatcher() = default;
+    ~FrameDispatcher();
+
+    FrameDispatcher(const FrameDispatcher&) = delete;
+    FrameDispatcher& operator=(const FrameDispatcher&) = delete;
+
+    /// Start the dispatch thread
+    /// @param sink Consumer invoked on the dispatch thread
+    /// @param policy Drop policy applied when the consumer falls behind
+    /// @param hooks Optional thread start/stop hooks
+    /// @return false if already running
+    bool start(FrameSinkCallback sink, FrameDropPolicy policy,
+               DispatcherThreadHooks hooks = {});
+
+    /// Stop the dispatch thread and release any queued frames
+    void stop();
+
+    /// Queue a frame for delivery (producer side, never blocks on the consumer)
+    void submit(FrameBufferHandle buffer, const FrameMetadata& metadata);
+
+    /// Check if the dispatch thread is running
+    [[nodiscard]]
+    bool isRunning() const noexcept { return running_.load(std::memory_order_acquire); }
+
+    /// Get dispatch statistics
+    [[nodiscard]]
+    FrameDispatchStats getStats() const noexcept;
+
+private:
+    void threadLoop();
+
+    /// Pop the next frame to deliver according to policy_. Returns false if empty.
+    bool takeNext(DispatchedFrame& frame);
+
+    RingBuffer<DispatchedFrame, kQueueCapacity> queue_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    FrameSinkCallback sink_;
+    FrameDropPolicy policy_ = FrameDropPolicy::DropOldest;
+    DispatcherThreadHooks hooks_;
+
+    // Wakeup signal only; frames never pass through the mutex
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    std::atomic<int64_t> deliveredFrames_{0};
+    std::atomic<int64_t> droppedFrames_{0};
+};
+
+}  // namespace nativesensor
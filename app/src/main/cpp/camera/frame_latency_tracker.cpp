@@ -0,0 +1,99 @@
+#include "frame_latency_tracker.h"
+
+#include <cmath>
+#include <ctime>
+
+namespace {
+constexpr int64_t kNsPerSecond = 1'000'000'000LL;
+constexpr int64_t kNsPerUs = 1'000LL;
+// RFC 3550 jitter smoothing: J += (|D| - J) / 16
+constexpr float kJitterGain = 1.0f / 16.0f;
+
+int64_t getBootTimeNs() noexcept {
+    struct timespec t{};
+    clock_gettime(CLOCK_BOOTTIME, &t);
+    return static_cast<int64_t>(t.tv_sec) * kNsPerSecond + t.tv_nsec;
+}
+}
+
+namespace nativesensor {
+
+void FrameLatencyTracker::onFrameStarted(int64_t frameNumber, int64_t timestampNs) noexcept {
+    frameCount_.fetch_add(1, std::memory_order_relaxed);
+
+    // Frame numbers rise by one per capture; a jump means the camera skipped requests
+    const int64_t lastFrameNumber = lastFrameNumber_.load(std::memory_order_relaxed);
+    if (lastFrameNumber >= 0 && frameNumber > lastFrameNumber + 1) {
+        frameNumberGaps_.fetch_add(frameNumber - lastFrameNumber - 1, std::memory_order_relaxed);
+    }
+    lastFrameNumber_.store(frameNumber, std::memory_order_relaxed);
+
+    const int64_t lastTimestampNs = lastTimestampNs_.load(std::memory_order_relaxed);
+    lastTimestampNs_.store(timestampNs, std::memory_order_relaxed);
+    if (lastTimestampNs <= 0 || timestampNs <= lastTimestampNs) {
+        return;
+    }
+
+    const int64_t intervalNs = timestampNs - lastTimestampNs;
+    frameInterval_.record(intervalNs / kNsPerUs);
+
+    const int64_t lastIntervalNs = lastIntervalNs_.exchange(intervalNs, std::memory_order_relaxed);
+    if (lastIntervalNs > 0) {
+        const auto deviation = static_cast<float>(std::llabs(intervalNs - lastIntervalNs));
+        const float jitter = jitterNs_.load(std::memory_order_relaxed);
+        jitterNs_.store(jitter + (deviation - jitter) * kJitterGain, std::memory_order_relaxed);
+    }
+}
+
+void FrameLatencyTracker::record(LatencyStage stage, int64_t sensorTimestampNs) noexcept {
+    const auto index = static_cast<size_t>(stage);
+    if (index >= kLatencyStageCount || sensorTimestampNs <= 0) {
+        return;
+    }
+    stages_[index].record((getBootTimeNs() - sensorTimestampNs) / kNsPerUs);
+}
+
+int64_t FrameLatencyTracker::getDroppedFrames() const noexcept {
+    return frameNumberGaps_.load(std::memory_order_relaxed) +
+           captureFailures_.load(std::memory_order_relaxed) +
+           buffersLost_.load(std::memory_order_relaxed);
+}
+
+void FrameLatencyTracker::reset() noexcept {
+    for (LatencyHistogram& histogram : stages_) {
+        histogram.reset();
+    }
+    frameInterval_.reset();
+
+    frameCount_.store(0, std::memory_order_relaxed);
+    frameNumberGaps_.store(0, std::memory_order_relaxed);
+    captureFailures_.store(0, std::memory_order_relaxed);
+    buffersLost_.store(0, std::memory_order_relaxed);
+    lastFrameNumber_.store(-1, std::memory_order_relaxed);
+    lastTimestampNs_.store(0, std::memory_order_relaxed);
+    lastIntervalNs_.store(0, std::memory_order_relaxed);
+    jitterNs_.store(0.0f, std::memory_order_relaxed);
+}
+
+FrameLatencySnapshot FrameLatencyTracker::snapshot() const noexcept {
+    FrameLatencySnapshot snapshot;
+    snapshot.frameCount = frameCount_.load(std::memory_order_relaxed);
+    snapshot.frameNumberGaps = frameNumberGaps_.load(std::memory_order_relaxed);
+    snapshot.captureFailures = captureFailures_.load(std::memory_order_relaxed);
+    snapshot.buffersLost = buffersLost_.load(std::memory_order_relaxed);
+    snapshot.droppedFrames =
+        snapshot.frameNumberGaps + snapshot.captureFailures + snapshot.buffersLost;
+    snapshot.jitterUs = jitterNs_.load(std::memory_order_relaxed) / static_cast<float>(kNsPerUs);
+
+    snapshot.frameInterval = frameInterval_.summarize();
+    if (snapshot.frameInterval.meanUs > 0) {
+        snapshot.frameRateHz = 1'000'000.0f / static_cast<float>(snapshot.frameInterval.meanUs);
+    }
+
+    for (size_t i = 0; i < kLatencyStageCount; ++i) {
+        snapshot.stages[i] = stages_[i].summarize();
+    }
+    return snapshot;
+}
+
+}  // namespace nativesensor
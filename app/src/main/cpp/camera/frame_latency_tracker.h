@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "latency_histogram.h"
+
+namespace nativesensor {
+
+/// Pipeline points measured from the sensor start-of-exposure timestamp
+enum class LatencyStage : int32_t {
+    CaptureCompleted = 0,   // Result metadata delivered (onCaptureCompleted)
+    ImageAvailable = 1,     // AImageReader listener fired (encoder captures only)
+    JniDelivered = 2        // Frame callback returned, including any JNI upcall (encoder captures only)
+};
+
+constexpr size_t kLatencyStageCount = 3;
+
+/// Binary latency snapshot handed to Java as-is (native byte order).
+/// Bump kVersion whenever the layout changes; Kotlin offsets mirror it.
+struct FrameLatencySnapshot {
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t version = kVersion;
+    uint32_t stageCount = kLatencyStageCount;
+    int64_t frameCount = 0;             // Captures started
+    int64_t droppedFrames = 0;          // frameNumberGaps + captureFailures + buffersLost
+    int64_t frameNumberGaps = 0;        // Frame numbers skipped between consecutive captures
+    int64_t captureFailures = 0;        // onCaptureFailed
+    int64_t buffersLost = 0;            // onCaptureBufferLost for this output
+    float jitterUs = 0.0f;              // RFC 3550 interarrival jitter of sensor timestamps
+    float frameRateHz = 0.0f;           // From the mean frame interval
+    LatencySummary frameInterval;       // Sensor timestamp deltas
+    std::array<LatencySummary, kLatencyStageCount> stages{};
+};
+static_assert(sizeof(FrameLatencySnapshot) == 184, "Update CameraBridge snapshot offsets");
+
+/// Per-consumer frame timing: latency histograms per pipeline stage, frame interval and
+/// jitter, and drop detection from failures, lost buffers and frame-number gaps.
+/// Every hook is lock-free and may be called from camera, image reader or dispatch threads;
+/// onFrameStarted() must only be called from one thread at a time (the capture callback thread).
+class FrameLatencyTracker {
+public:
+    FrameLatencyTracker() = default;
+
+    FrameLatencyTracker(const FrameLatencyTracker&) = delete;
+    FrameLatencyTracker& operator=(const FrameLatencyTracker&) = delete;
+
+    /// Start of exposure for a capture (onCaptureStarted)
+    void onFrameStarted(int64_t frameNumber, int64_t timestampNs) noexcept;
+
+    /// A frame reached a pipeline stage; latency is now minus its sensor timestamp
+    void record(LatencyStage stage, int64_t sensorTimestampNs) noexcept;
+
+    /// The camera reported a failed capture (no image for any output)
+    void onCaptureFailed() noexcept {
+        captureFailures_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// The camera dropped this consumer's buffer for a capture
+    void onBufferLost() noexcept {
+        buffersLost_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Frames missing for any reason since the last reset
+    [[nodiscard]]
+    int64_t getDroppedFrames() const noexcept;
+
+    /// Clear every histogram and counter (call before a capture starts)
+    void reset() noexcept;
+
+    [[nodiscard]]
+    FrameLatencySnapshot snapshot() const noexcept;
+
+private:
+    std::array<LatencyHistogram, kLatencyStageCount> stages_;
+    LatencyHistogram frameInterval_;
+
+    std::atomic<int64_t> frameCount_{0};
+    std::atomic<int64_t> frameNumberGaps_{0};
+    std::atomic<int64_t> captureFailures_{0};
+    std::atomic<int64_t> buffersLost_{0};
+
+    // Written only by onFrameStarted()
+    std::atomic<int64_t> lastFrameNumber_{-1};
+    std::atomic<int64_t> lastTimestampNs_{0};
+    std::atomic<int64_t> lastIntervalNs_{0};
+    std::atomic<float> jitterNs_{0.0f};
+};
+
+}  // namespace nativesensor
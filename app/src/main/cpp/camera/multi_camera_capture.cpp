@@ -0,0 +1,556 @@
+#include "multi_camera_capture.h"
+
+#include <android/log.h>
+#include <media/NdkImage.h>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+
+#include "trace.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.MultiCam";
+// YUV_420_888 format
+constexpr int32_t kImageFormat = AIMAGE_FORMAT_YUV_420_888;
+// Frames of one exposure land within this window when the sensors are hardware-synchronized
+constexpr int64_t kCalibratedToleranceNs = 100'000LL;
+// Software-synchronized sensors drift further; still well under half a frame at 90 fps
+constexpr int64_t kApproximateToleranceNs = 5'000'000LL;
+constexpr int64_t kNsPerSecond = 1'000'000'000LL;
+constexpr double kNsToMs = 1'000'000.0;
+constexpr double kNsToUs = 1'000.0;
+
+int64_t getBootTimeNs() noexcept {
+    struct timespec t{};
+    clock_gettime(CLOCK_BOOTTIME, &t);
+    return static_cast<int64_t>(t.tv_sec) * kNsPerSecond + t.tv_nsec;
+}
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+MultiCameraCapture::MultiCameraCapture(CameraManager& manager)
+    : manager_(manager) {
+    LOGI("MultiCameraCapture created");
+}
+
+MultiCameraCapture::~MultiCameraCapture() {
+    stop();
+    LOGI("MultiCameraCapture destroyed");
+}
+
+bool MultiCameraCapture::start(const std::string& logicalCameraId,
+                               const std::vector<std::string>& physicalCameraIds,
+                               int32_t width, int32_t height,
+                               MultiCameraFrameSetCallback callback,
+                               YuvOutputFormat outputFormat) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (cameraDevice_) {
+        LOGI("Restarting multi-camera capture on %s", logicalCameraId.c_str());
+        cleanup();
+    }
+
+    if (!manager_.isValid()) {
+        LOGE("Cannot start multi-camera capture: camera manager invalid");
+        return false;
+    }
+
+    LogicalCameraInfo logical;
+    if (!manager_.getLogicalCameraInfo(logicalCameraId, logical)) {
+        LOGE("Camera %s is not a logical multi-camera", logicalCameraId.c_str());
+        return false;
+    }
+
+    // Requested sub-cameras must belong to the logical camera
+    std::vector<std::string> selected = physicalCameraIds.empty() ? logical.physicalCameraIds
+                                                                  : physicalCameraIds;
+    for (const std::string& id : selected) {
+        if (std::find(logical.physicalCameraIds.begin(), logical.physicalCameraIds.end(), id) ==
+            logical.physicalCameraIds.end()) {
+            LOGE("Camera %s is not a physical camera of %s", id.c_str(), logicalCameraId.c_str());
+            return false;
+        }
+    }
+    if (selected.size() > kMaxPhysicalCameras) {
+        LOGW("Streaming the first %zu of %zu physical cameras", kMaxPhysicalCameras, selected.size());
+        selected.resize(kMaxPhysicalCameras);
+    }
+
+    LOGI("Starting multi-camera capture: %s (%zu physical, %dx%d, sync=%d)",
+         logicalCameraId.c_str(), selected.size(), width, height,
+         static_cast<int>(logical.syncType));
+
+    // Every physical stream shares one plan; sets need a frame from each camera. Frames are
+    // repacked at full size, so only the buffer counts can degrade.
+    if (!planStreamBuffers(width, height, selected.size(), true, outputFormat, false,
+                           bufferPlan_)) {
+        LOGE("Multi-camera capture %zu x %dx%d does not fit the native memory budget",
+             selected.size(), width, height);
+        return false;
+    }
+
+    logicalCameraId_ = logicalCameraId;
+    callback_ = std::move(callback);
+    outputFormat_ = outputFormat;
+    syncType_ = logical.syncType;
+    groupToleranceNs_ = syncType_ == MultiCameraSyncType::Calibrated ? kCalibratedToleranceNs
+                                                                      : kApproximateToleranceNs;
+
+    // Reset statistics and assembly state
+    frameSetCount_.store(0, std::memory_order_release);
+    incompleteFrameSets_.store(0, std::memory_order_release);
+    droppedFrames_.store(0, std::memory_order_release);
+    prevSetTimestampNs_.store(0, std::memory_order_release);
+    lastFrameSetRateHz_.store(0.0f, std::memory_order_release);
+    lastLatencyMs_.store(0.0f, std::memory_order_release);
+    lastSpreadUs_.store(0.0f, std::memory_order_release);
+    resetPendingSets();
+
+    // One reader per physical camera
+    for (size_t i = 0; i < selected.size(); ++i) {
+        PhysicalStream& stream = streams_[i];
+        stream.owner = this;
+        stream.index = i;
+        stream.physicalId = selected[i];
+        streamCount_ = i + 1;
+        if (!createPhysicalStream(stream, width, height)) {
+            cleanup();
+            return false;
+        }
+    }
+
+    // Setup device callbacks
+    deviceCallbacks_.context = this;
+    deviceCallbacks_.onDisconnected = onDeviceDisconnected;
+    deviceCallbacks_.onError = onDeviceError;
+
+    // Open the logical camera once for every physical stream
+    camera_status_t status = ACameraManager_openCamera(
+        manager_.getNativeManager(),
+        logicalCameraId.c_str(),
+        &deviceCallbacks_,
+        &cameraDevice_);
+
+    if (status != ACAMERA_OK || !cameraDevice_) {
+        LOGE("Failed to open logical camera %s: %d", logicalCameraId.c_str(), status);
+        cameraDevice_ = nullptr;
+        cleanup();
+        return false;
+    }
+
+    status = ACaptureSessionOutputContainer_create(&outputContainer_);
+    if (status != ACAMERA_OK) {
+        LOGE("Failed to create output container: %d", status);
+        cleanup();
+        return false;
+    }
+
+    status = ACameraDevice_createCaptureRequest(cameraDevice_, TEMPLATE_PREVIEW, &captureRequest_);
+    if (status != ACAMERA_OK) {
+        LOGE("Failed to create capture request: %d", status);
+        cleanup();
+        return false;
+    }
+
+    for (size_t i = 0; i < streamCount_; ++i) {
+        status = ACaptureSessionOutputContainer_add(outputContainer_, streams_[i].sessionOutput);
+        if (status != ACAMERA_OK) {
+            LOGE("Failed to add physical output %s: %d", streams_[i].physicalId.c_str(), status);
+            cleanup();
+            return false;
+        }
+
+        status = ACaptureRequest_addTarget(captureRequest_, streams_[i].target);
+        if (status != ACAMERA_OK) {
+            LOGE("Failed to add physical target %s: %d", streams_[i].physicalId.c_str(), status);
+            cleanup();
+            return false;
+        }
+    }
+
+    // Setup session callbacks
+    sessionCallbacks_.context = this;
+    sessionCallbacks_.onClosed = onSessionClosed;
+    sessionCallbacks_.onReady = onSessionReady;
+    sessionCallbacks_.onActive = onSessionActive;
+
+    status = ACameraDevice_createCaptureSession(
+        cameraDevice_,
+        outputContainer_,
+        &sessionCallbacks_,
+        &captureSession_);
+
+    if (status != ACAMERA_OK || !captureSession_) {
+        LOGE("Failed to create multi-camera capture session: %d", status);
+        captureSession_ = nullptr;
+        cleanup();
+        return false;
+    }
+
+    // One request drives every physical sensor, so each exposure yields one frame per camera
+    status = ACameraCaptureSession_setRepeatingRequest(
+        captureSession_,
+        nullptr,  // Frame sets are assembled from the image readers
+        1,
+        &captureRequest_,
+        nullptr);
+
+    if (status != ACAMERA_OK) {
+        LOGE("Failed to set repeating request: %d", status);
+        cleanup();
+        return false;
+    }
+
+    capturing_.store(true, std::memory_order_release);
+    LOGI("Multi-camera capture started: %s", logicalCameraId.c_str());
+    return true;
+}
+
+bool MultiCameraCapture::createPhysicalStream(PhysicalStream& stream, int32_t width, int32_t height) {
+    const size_t frameSize = bufferPlan_.poolSlotBytes;
+    const size_t slotCount = bufferPlan_.poolSlots;
+    if (!stream.pool.allocate(slotCount, frameSize)) {
+        LOGE("Failed to allocate frame buffer pool for %s", stream.physicalId.c_str());
+        return false;
+    }
+
+    media_status_t mediaStatus = AImageReader_new(width, height, kImageFormat,
+                                                  bufferPlan_.maxImages, &stream.imageReader);
+    if (mediaStatus != AMEDIA_OK || !stream.imageReader) {
+        LOGE("Failed to create AImageReader for %s: %d", stream.physicalId.c_str(), mediaStatus);
+        stream.imageReader = nullptr;
+        return false;
+    }
+    stream.readerReservation =
+        MemoryReservation(MemoryComponent::ImageReaders, bufferPlan_.readerBytes);
+
+    stream.listener.context = &stream;
+    stream.listener.onImageAvailable = onImageAvailable;
+    mediaStatus = AImageReader_setImageListener(stream.imageReader, &stream.listener);
+    if (mediaStatus != AMEDIA_OK) {
+        LOGE("Failed to set image listener for %s: %d", stream.physicalId.c_str(), mediaStatus);
+        return false;
+    }
+
+    mediaStatus = AImageReader_getWindow(stream.imageReader, &stream.window);
+    if (mediaStatus != AMEDIA_OK || !stream.window) {
+        LOGE("Failed to get window for %s: %d", stream.physicalId.c_str(), mediaStatus);
+        return false;
+    }
+
+    // Routes this window to one sensor of the logical camera
+    camera_status_t status = ACaptureSessionPhysicalOutput_create(
+        stream.window, stream.physicalId.c_str(), &stream.sessionOutput);
+    if (status != ACAMERA_OK) {
+        LOGE("Failed to create physical output for %s: %d", stream.physicalId.c_str(), status);
+        return false;
+    }
+
+    status = ACameraOutputTarget_create(stream.window, &stream.target);
+    if (status != ACAMERA_OK) {
+        LOGE("Failed to create output target for %s: %d", stream.physicalId.c_str(), status);
+        return false;
+    }
+    return true;
+}
+
+void MultiCameraCapture::stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!cameraDevice_ && streamCount_ == 0) {
+        return;
+    }
+    LOGI("Stopping multi-camera capture");
+    cleanup();
+}
+
+void MultiCameraCapture::cleanup() {
+    capturing_.store(false, std::memory_order_release);
+
+    if (captureSession_) {
+        ACameraCaptureSession_stopRepeating(captureSession_);
+        ACameraCaptureSession_close(captureSession_);
+        captureSession_ = nullptr;
+    }
+
+    if (cameraDevice_) {
+        ACameraDevice_close(cameraDevice_);
+        cameraDevice_ = nullptr;
+    }
+
+    if (captureRequest_) {
+        ACaptureRequest_free(captureRequest_);
+        captureRequest_ = nullptr;
+    }
+
+    for (size_t i = 0; i < streamCount_; ++i) {
+        PhysicalStream& stream = streams_[i];
+
+        if (stream.target) {
+            ACameraOutputTarget_free(stream.target);
+            stream.target = nullptr;
+        }
+
+        if (stream.sessionOutput) {
+            ACaptureSessionOutput_free(stream.sessionOutput);
+            stream.sessionOutput = nullptr;
+        }
+
+        // Note: window is owned by the image reader, don't release separately
+        stream.window = nullptr;
+
+        if (stream.imageReader) {
+            AImageReader_delete(stream.imageReader);
+            stream.imageReader = nullptr;
+        }
+        stream.readerReservation.reset();
+
+        stream.pool.release();
+        stream.physicalId.clear();
+    }
+    streamCount_ = 0;
+
+    if (outputContainer_) {
+        ACaptureSessionOutputContainer_free(outputContainer_);
+        outputContainer_ = nullptr;
+    }
+
+    // Readers are gone; partially assembled sets return their buffers
+    resetPendingSets();
+
+    callback_ = nullptr;
+    logicalCameraId_.clear();
+
+    LOGI("Multi-camera resources cleaned up");
+}
+
+void MultiCameraCapture::onImageAvailable(void* context, AImageReader* reader) {
+    auto* stream = static_cast<PhysicalStream*>(context);
+
+    // Take images in order: skipping on one camera would orphan that exposure on the others
+    AImage* image = nullptr;
+    media_status_t status = AImageReader_acquireNextImage(reader, &image);
+    if (status != AMEDIA_OK || !image) {
+        return;
+    }
+
+    stream->owner->handleImage(*stream, image);
+    AImage_delete(image);
+}
+
+void MultiCameraCapture::handleImage(PhysicalStream& stream, AImage* image) {
+    if (!capturing_.load(std::memory_order_acquire)) {
+        return;
+    }
+    NS_TRACE_SCOPE("MultiCameraCapture::handleImage");
+
+    YuvPlanes planes;
+    AImage_getWidth(image, &planes.width);
+    AImage_getHeight(image, &planes.height);
+
+    int64_t timestampNs = 0;
+    AImage_getTimestamp(image, &timestampNs);
+
+    uint8_t* yData = nullptr;
+    uint8_t* uData = nullptr;
+    uint8_t* vData = nullptr;
+    int planeLen = 0;
+    AImage_getPlaneData(image, 0, &yData, &planeLen);
+    AImage_getPlaneData(image, 1, &uData, &planeLen);
+    AImage_getPlaneData(image, 2, &vData, &planeLen);
+    planes.y = yData;
+    planes.u = uData;
+    planes.v = vData;
+
+    AImage_getPlaneRowStride(image, 0, &planes.yRowStride);
+    AImage_getPlaneRowStride(image, 1, &planes.uvRowStride);
+    AImage_getPlanePixelStride(image, 1, &planes.uvPixelStride);
+
+    FrameBufferHandle frame = stream.pool.acquire();
+    if (!frame) {
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const size_t frameSize = yuvBufferSize(outputFormat_, planes.width, planes.height);
+    if (frameSize == 0 || frameSize > frame.capacity() ||
+        !convertYuv420888(planes, outputFormat_, frame.data())) {
+        LOGW("Failed to repack image from %s (%dx%d), dropping frame",
+             stream.physicalId.c_str(), planes.width, planes.height);
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    frame.setSize(frameSize);
+
+    FrameMetadata metadata;
+    metadata.timestampNs = timestampNs;
+    metadata.width = planes.width;
+    metadata.height = planes.height;
+    metadata.format = static_cast<int32_t>(outputFormat_);
+
+    MultiCameraFrameSet frameSet;
+    {
+        std::lock_guard<std::mutex> lock(assemblyMutex_);
+        if (!assemble(stream.index, std::move(frame), metadata, frameSet)) {
+            return;
+        }
+    }
+
+    updateStats(frameSet);
+    if (callback_) {
+        callback_(frameSet);
+    }
+}
+
+bool MultiCameraCapture::assemble(size_t index, FrameBufferHandle&& frame,
+                                  const FrameMetadata& metadata, MultiCameraFrameSet& out) {
+    const uint32_t bit = 1u << index;
+    const uint32_t completeMask = (1u << streamCount_) - 1u;
+    const int64_t timestampNs = metadata.timestampNs;
+
+    // Join the set of the same exposure, if another camera already delivered it
+    PendingSet* target = nullptr;
+    for (PendingSet& set : pending_) {
+        if (set.receivedMask != 0 && (set.receivedMask & bit) == 0 &&
+            std::abs(timestampNs - set.anchorNs) <= groupToleranceNs_) {
+            target = &set;
+            break;
+        }
+    }
+
+    if (!target) {
+        // Start a new set, evicting the oldest incomplete one if every slot is taken
+        PendingSet* oldest = nullptr;
+        for (PendingSet& set : pending_) {
+            if (set.receivedMask == 0) {
+                target = &set;
+                break;
+            }
+            if (!oldest || set.anchorNs < oldest->anchorNs) {
+                oldest = &set;
+            }
+        }
+        if (!target) {
+            incompleteFrameSets_.fetch_add(1, std::memory_order_relaxed);
+            *oldest = {};
+            target = oldest;
+        }
+        target->anchorNs = timestampNs;
+        target->earliestNs = timestampNs;
+        target->latestNs = timestampNs;
+    }
+
+    target->receivedMask |= bit;
+    target->frames[index] = std::move(frame);
+    target->metadata[index] = metadata;
+    target->earliestNs = std::min(target->earliestNs, timestampNs);
+    target->latestNs = std::max(target->latestNs, timestampNs);
+
+    if (target->receivedMask != completeMask) {
+        return false;
+    }
+
+    // Readers deliver in order, so older sets are missing a frame that will never arrive
+    for (PendingSet& set : pending_) {
+        if (&set != target && set.receivedMask != 0 && set.anchorNs < target->anchorNs) {
+            incompleteFrameSets_.fetch_add(1, std::memory_order_relaxed);
+            set = {};
+        }
+    }
+
+    out.timestampNs = target->earliestNs;
+    out.timestampSpreadNs = target->latestNs - target->earliestNs;
+    out.setNumber = nextSetNumber_++;
+    out.count = streamCount_;
+    for (size_t i = 0; i < streamCount_; ++i) {
+        out.frames[i] = std::move(target->frames[i]);
+        out.metadata[i] = target->metadata[i];
+        out.metadata[i].frameNumber = out.setNumber;
+    }
+    *target = {};
+    return true;
+}
+
+void MultiCameraCapture::resetPendingSets() {
+    std::lock_guard<std::mutex> lock(assemblyMutex_);
+    for (PendingSet& set : pending_) {
+        set = {};
+    }
+    nextSetNumber_ = 0;
+}
+
+void MultiCameraCapture::updateStats(const MultiCameraFrameSet& frameSet) {
+    const int64_t now = getBootTimeNs();
+    frameSetCount_.fetch_add(1, std::memory_order_relaxed);
+
+    const int64_t prevTimestampNs = prevSetTimestampNs_.exchange(frameSet.timestampNs,
+                                                                 std::memory_order_acq_rel);
+    if (prevTimestampNs > 0 && frameSet.timestampNs > prevTimestampNs) {
+        double intervalSec = static_cast<double>(frameSet.timestampNs - prevTimestampNs) / kNsPerSecond;
+        lastFrameSetRateHz_.store(static_cast<float>(1.0 / intervalSec), std::memory_order_release);
+    }
+
+    const int64_t latestNs = frameSet.timestampNs + frameSet.timestampSpreadNs;
+    if (latestNs > 0 && now > latestNs) {
+        lastLatencyMs_.store(static_cast<float>(static_cast<double>(now - latestNs) / kNsToMs),
+                             std::memory_order_release);
+    }
+
+    lastSpreadUs_.store(static_cast<float>(static_cast<double>(frameSet.timestampSpreadNs) / kNsToUs),
+                        std::memory_order_release);
+}
+
+MultiCameraStats MultiCameraCapture::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    MultiCameraStats stats;
+    stats.frameSetRateHz = lastFrameSetRateHz_.load(std::memory_order_acquire);
+    stats.latencyMs = lastLatencyMs_.load(std::memory_order_acquire);
+    stats.frameSetCount = frameSetCount_.load(std::memory_order_acquire);
+    stats.incompleteFrameSets = incompleteFrameSets_.load(std::memory_order_acquire);
+    stats.droppedFrames = droppedFrames_.load(std::memory_order_acquire);
+    stats.timestampSpreadUs = lastSpreadUs_.load(std::memory_order_acquire);
+    stats.physicalCameraCount = static_cast<int32_t>(streamCount_);
+    stats.syncType = syncType_;
+    return stats;
+}
+
+std::vector<std::string> MultiCameraCapture::getPhysicalCameraIds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> ids;
+    ids.reserve(streamCount_);
+    for (size_t i = 0; i < streamCount_; ++i) {
+        ids.push_back(streams_[i].physicalId);
+    }
+    return ids;
+}
+
+void MultiCameraCapture::onDeviceDisconnected(void* context, ACameraDevice* /*device*/) {
+    auto* self = static_cast<MultiCameraCapture*>(context);
+    LOGI("Logical camera device disconnected");
+    self->capturing_.store(false, std::memory_order_release);
+}
+
+void MultiCameraCapture::onDeviceError(void* context, ACameraDevice* /*device*/, int error) {
+    auto* self = static_cast<MultiCameraCapture*>(context);
+    LOGE("Logical camera device error: %d", error);
+    self->capturing_.store(false, std::memory_order_release);
+}
+
+void MultiCameraCapture::onSessionClosed(void* /*context*/, ACameraCaptureSession* /*session*/) {
+    LOGI("Multi-camera capture session closed");
+}
+
+void MultiCameraCapture::onSessionReady(void* /*context*/, ACameraCaptureSession* /*session*/) {
+    LOGI("Multi-camera capture session ready");
+}
+
+void MultiCameraCapture::onSessionActive(void* /*context*/, ACameraCaptureSession* /*session*/) {
+    LOGI("Multi-camera capture session active");
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <camera/NdkCameraDevice.h>
+#include <camera/NdkCameraCaptureSession.h>
+#include <camera/NdkCaptureRequest.h>
+#include <media/NdkImageReader.h>
+#include <android/native_window.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "camera_data.h"
+#include "camera_manager.h"
+#include "frame_buffer_pool.h"
+#include "memory_budget.h"
+#include "stream_budget.h"
+#include "yuv_convert.h"
+
+namespace nativesensor {
+
+/// Physical camera frames from one exposure of a logical multi-camera
+struct MultiCameraFrameSet {
+    static constexpr size_t kMaxFrames = 4;
+
+    int64_t timestampNs = 0;            // Earliest start of exposure in the set
+    int64_t timestampSpreadNs = 0;      // Latest minus earliest start of exposure
+    int64_t setNumber = 0;              // Sequential index within the capture
+    size_t count = 0;                   // One frame per physical camera, in start() order
+    std::array<FrameBufferHandle, kMaxFrames> frames{};
+    std::array<FrameMetadata, kMaxFrames> metadata{};
+};
+
+/// Callback for complete frame sets, invoked on the image reader thread that completed the set.
+/// Handles may be retained past the callback; keep the callback itself short.
+using MultiCameraFrameSetCallback = std::function<void(const MultiCameraFrameSet& frameSet)>;
+
+/// Synchronized capture from the physical sub-cameras of a logical camera.
+/// The logical device is opened once and each physical camera streams into its own
+/// AImageReader through a physical-camera output of a single session, so every repeating
+/// request exposes all sensors together. Frames are regrouped by start-of-exposure timestamp
+/// and delivered as one set per exposure.
+class MultiCameraCapture {
+public:
+    static constexpr size_t kMaxPhysicalCameras = MultiCameraFrameSet::kMaxFrames;
+
+    explicit MultiCameraCapture(CameraManager& manager);
+    ~MultiCameraCapture();
+
+    MultiCameraCapture(const MultiCameraCapture&) = delete;
+    MultiCameraCapture& operator=(const MultiCameraCapture&) = delete;
+
+    /// Start synchronized capture
+    /// @param logicalCameraId Logical multi-camera to open
+    /// @param physicalCameraIds Sub-cameras to stream (empty = all, up to kMaxPhysicalCameras)
+    /// @param width Capture width of every physical stream
+    /// @param height Capture height of every physical stream
+    /// @param callback Callback invoked with each complete frame set
+    /// @param outputFormat Packed layout written into the pooled buffers
+    /// @return true if capture started successfully
+    bool start(const std::string& logicalCameraId,
+               const std::vector<std::string>& physicalCameraIds,
+               int32_t width, int32_t height,
+               MultiCameraFrameSetCallback callback,
+               YuvOutputFormat outputFormat = YuvOutputFormat::I420);
+
+    /// Stop capturing and release resources
+    void stop();
+
+    /// Check if currently capturing
+    [[nodiscard]]
+    bool isCapturing() const { return capturing_.load(std::memory_order_acquire); }
+
+    /// Get frame set statistics
+    [[nodiscard]]
+    MultiCameraStats getStats() const;
+
+    /// Physical camera ids of the active (or last) capture, in frame set order
+    [[nodiscard]]
+    std::vector<std::string> getPhysicalCameraIds() const;
+
+private:
+    /// One physical camera's reader and session output
+    struct PhysicalStream {
+        MultiCameraCapture* owner = nullptr;
+        size_t index = 0;
+        std::string physicalId;
+        AImageReader* imageReader = nullptr;
+        ANativeWindow* window = nullptr;
+        ACaptureSessionOutput* sessionOutput = nullptr;
+        ACameraOutputTarget* target = nullptr;
+        AImageReader_ImageListener listener{};
+        FrameBufferPool pool;           // One producer per pool: this reader's thread
+        MemoryReservation readerReservation;
+    };
+
+    /// Frame set being assembled
+    struct PendingSet {
+        uint32_t receivedMask = 0;
+        int64_t anchorNs = 0;           // Timestamp of the first frame to arrive
+        int64_t earliestNs = 0;
+        int64_t latestNs = 0;
+        std::array<FrameBufferHandle, kMaxPhysicalCameras> frames{};
+        std::array<FrameMetadata, kMaxPhysicalCameras> metadata{};
+    };
+
+    static constexpr size_t kPendingSetCount = 4;
+
+    // AImageReader callback (context is the PhysicalStream)
+    static void onImageAvailable(void* context, AImageReader* reader);
+
+    // Camera device callbacks
+    static void onDeviceDisconnected(void* context, ACameraDevice* device);
+    static void onDeviceError(void* context, ACameraDevice* device, int error);
+
+    // Capture session callbacks
+    static void onSessionClosed(void* context, ACameraCaptureSession* session);
+    static void onSessionReady(void* context, ACameraCaptureSession* session);
+    static void onSessionActive(void* context, ACameraCaptureSession* session);
+
+    /// Create reader, physical output and target for one stream
+    bool createPhysicalStream(PhysicalStream& stream, int32_t width, int32_t height);
+
+    /// Repack an image and add it to its frame set
+    void handleImage(PhysicalStream& stream, AImage* image);
+
+    /// Place a frame into a pending set; fills out and returns true when the set completes.
+    /// Caller holds assemblyMutex_.
+    bool assemble(size_t index, FrameBufferHandle&& frame, const FrameMetadata& metadata,
+                  MultiCameraFrameSet& out);
+
+    void resetPendingSets();
+    void updateStats(const MultiCameraFrameSet& frameSet);
+    void cleanup();
+
+    CameraManager& manager_;
+    mutable std::mutex mutex_;
+    std::atomic<bool> capturing_{false};
+    std::string logicalCameraId_;
+
+    // NDK handles
+    ACameraDevice* cameraDevice_ = nullptr;
+    ACameraCaptureSession* captureSession_ = nullptr;
+    ACaptureSessionOutputContainer* outputContainer_ = nullptr;
+    ACaptureRequest* captureRequest_ = nullptr;
+    std::array<PhysicalStream, kMaxPhysicalCameras> streams_{};
+    size_t streamCount_ = 0;
+
+    MultiCameraFrameSetCallback callback_;
+    YuvOutputFormat outputFormat_ = YuvOutputFormat::I420;
+    StreamBufferPlan bufferPlan_;       // Shared by every physical stream of the capture
+    MultiCameraSyncType syncType_ = MultiCameraSyncType::Unknown;
+    int64_t groupToleranceNs_ = 0;
+
+    // Frame set assembly (shared by every reader thread)
+    std::mutex assemblyMutex_;
+    std::array<PendingSet, kPendingSetCount> pending_{};
+    int64_t nextSetNumber_ = 0;
+
+    // Statistics
+    std::atomic<int64_t> frameSetCount_{0};
+    std::atomic<int64_t> incompleteFrameSets_{0};
+    std::atomic<int64_t> droppedFrames_{0};
+    std::atomic<int64_t> prevSetTimestampNs_{0};
+    std::atomic<float> lastFrameSetRateHz_{0.0f};
+    std::atomic<float> lastLatencyMs_{0.0f};
+    std::atomic<float> lastSpreadUs_{0.0f};
+
+    // Callback structs (must persist for camera session lifetime)
+    ACameraDevice_StateCallbacks deviceCallbacks_{};
+    ACameraCaptureSession_stateCallbacks sessionCallbacks_{};
+};
+
+}  // namespace nativesensor
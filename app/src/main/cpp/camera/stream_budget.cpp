@@ -0,0 +1,85 @@
+#include "stream_budget.h"
+
+#include <android/log.h>
+
+#include "memory_budget.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Memory";
+
+constexpr double kBytesToMiB = 1024.0 * 1024.0;
+
+/// Reader depth and extra pooled frames consumers may hold, from the full configuration down
+struct BufferTier {
+    int32_t maxImages;
+    size_t poolHeadroomSlots;
+};
+
+constexpr BufferTier kBufferTiers[] = {
+    {4, 4},     // Full: absorbs consumer stalls without starving the reader
+    {3, 2},
+    {2, 1}      // Smallest: the camera can still double-buffer
+};
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+size_t estimateImageReaderBytes(int32_t width, int32_t height, int32_t maxImages) noexcept {
+    if (width <= 0 || height <= 0 || maxImages <= 0) {
+        return 0;
+    }
+    const size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    return pixels * 3 / 2 * static_cast<size_t>(maxImages);
+}
+
+bool planStreamBuffers(int32_t width, int32_t height, size_t readerCount, bool pooled,
+                       YuvOutputFormat format, bool allowDownscale, StreamBufferPlan& out) noexcept {
+    const int64_t available = memoryBudgetAvailable();
+    const YuvScale scales[] = {YuvScale::Full, YuvScale::Half, YuvScale::Quarter};
+    const size_t scaleCount = pooled && allowDownscale ? 3 : 1;
+
+    size_t smallestBytes = 0;
+    for (size_t s = 0; s < scaleCount; ++s) {
+        const YuvScale scale = scales[s];
+        const size_t slotBytes = pooled ? yuvBufferSize(format, yuvScaledDimension(width, scale),
+                                                        yuvScaledDimension(height, scale))
+                                        : 0;
+        for (const BufferTier& tier : kBufferTiers) {
+            const size_t readerBytes = estimateImageReaderBytes(width, height, tier.maxImages);
+            const size_t poolSlots =
+                pooled ? static_cast<size_t>(tier.maxImages) + tier.poolHeadroomSlots : 0;
+            const size_t totalBytes = (readerBytes + poolSlots * slotBytes) * readerCount;
+            smallestBytes = totalBytes;
+            if (static_cast<int64_t>(totalBytes) > available) {
+                continue;
+            }
+
+            out.maxImages = tier.maxImages;
+            out.poolSlots = poolSlots;
+            out.poolSlotBytes = slotBytes;
+            out.minScale = scale;
+            out.readerBytes = readerBytes;
+            out.degraded = &tier != &kBufferTiers[0] || scale != YuvScale::Full;
+            if (out.degraded) {
+                recordMemoryDegradedStream();
+                LOGI("Stream %dx%d degraded to %d images, %zu pooled frames, 1/%d repack "
+                     "(%.1f MiB of %.1f MiB available)",
+                     width, height, out.maxImages, out.poolSlots, 1 << static_cast<int>(scale),
+                     static_cast<double>(totalBytes) / kBytesToMiB,
+                     static_cast<double>(available) / kBytesToMiB);
+            }
+            return true;
+        }
+    }
+
+    recordMemoryRefusedStream();
+    LOGW("Stream %dx%d needs at least %.1f MiB, %.1f MiB available under the memory budget",
+         width, height, static_cast<double>(smallestBytes) / kBytesToMiB,
+         static_cast<double>(available) / kBytesToMiB);
+    return false;
+}
+
+}  // namespace nativesensor
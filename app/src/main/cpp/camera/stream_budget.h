@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "yuv_convert.h"
+
+namespace nativesensor {
+
+/// Reader depth, pool size and repack scale chosen for a new camera stream
+struct StreamBufferPlan {
+    int32_t maxImages = 0;              // AImageReader queue depth per reader
+    size_t poolSlots = 0;               // Pooled frames per reader (0 for unpooled streams)
+    size_t poolSlotBytes = 0;           // Bytes per pooled frame at minScale
+    YuvScale minScale = YuvScale::Full; // Coarsest of this and any other repack downscale applies
+    size_t readerBytes = 0;             // Estimated footprint of one reader
+    bool degraded = false;              // Below the full configuration
+};
+
+/// Estimated gralloc footprint of an AImageReader: 4:2:0 buffers of the capture size
+[[nodiscard]]
+size_t estimateImageReaderBytes(int32_t width, int32_t height, int32_t maxImages) noexcept;
+
+/// Pick the largest stream configuration that fits memoryBudgetAvailable(). Fewer reader images
+/// and pooled frames are tried first, then (if allowDownscale) a 2x and 4x coarser repack.
+/// Degraded and refused plans are counted in MemoryUsage.
+/// @param readerCount Readers streaming at this size (physical cameras of a multi-camera)
+/// @param pooled Whether each reader repacks into a frame pool of the given format
+/// @return false if even the smallest configuration exceeds the budget
+bool planStreamBuffers(int32_t width, int32_t height, size_t readerCount, bool pooled,
+                       YuvOutputFormat format, bool allowDownscale, StreamBufferPlan& out) noexcept;
+
+}  // namespace nativesensor
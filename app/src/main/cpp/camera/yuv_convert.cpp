@@ -0,0 +1,587 @@
+#include "yuv_convert.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__ARM_NEON) && !defined(__aarch64__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace nativesensor {
+
+namespace {
+
+/// Row kernels for chroma handling. Counts are in output samples per plane.
+struct ChromaKernels {
+    /// dst[i] = src[2i] (one component out of a semi-planar row)
+    void (*deinterleave)(const uint8_t* src, uint8_t* dst, int32_t count);
+    /// a[i] = src[2i], b[i] = src[2i + 1] (both components of a semi-planar row)
+    void (*split)(const uint8_t* src, uint8_t* a, uint8_t* b, int32_t count);
+    /// dst[2i] = a[i], dst[2i + 1] = b[i] (planar rows to semi-planar)
+    void (*interleave)(const uint8_t* a, const uint8_t* b, uint8_t* dst, int32_t count);
+    /// dst[2i] = a[2i], dst[2i + 1] = b[2i] (two semi-planar rows to one)
+    void (*gather)(const uint8_t* a, const uint8_t* b, uint8_t* dst, int32_t count);
+};
+
+/// Row kernels for box downscaling. rows holds the 2 (half) or 4 (quarter) source rows of one
+/// output row; counts are in output samples and results are rounded to nearest.
+struct ScaleKernels {
+    /// dst[i] = mean of the 2x2 block at column 2i
+    void (*half)(const uint8_t* const* rows, uint8_t* dst, int32_t count);
+    /// dst[i] = mean of the 4x4 block at column 4i
+    void (*quarter)(const uint8_t* const* rows, uint8_t* dst, int32_t count);
+    /// Semi-planar rows: a[i] / b[i] = mean of the 2x2 block of even / odd bytes at pair 2i
+    void (*halfPairs)(const uint8_t* const* rows, uint8_t* a, uint8_t* b, int32_t count);
+    /// Semi-planar rows: a[i] / b[i] = mean of the 4x4 block of even / odd bytes at pair 4i
+    void (*quarterPairs)(const uint8_t* const* rows, uint8_t* a, uint8_t* b, int32_t count);
+};
+
+// -----------------------------------------------------------------------------
+// Scalar kernels (reference implementation and tail handling)
+// -----------------------------------------------------------------------------
+
+void deinterleaveScalar(const uint8_t* src, uint8_t* dst, int32_t count) {
+    for (int32_t i = 0; i < count; ++i) {
+        dst[i] = src[i * 2];
+    }
+}
+
+void splitScalar(const uint8_t* src, uint8_t* a, uint8_t* b, int32_t count) {
+    for (int32_t i = 0; i < count; ++i) {
+        a[i] = src[i * 2];
+        b[i] = src[i * 2 + 1];
+    }
+}
+
+void interleaveScalar(const uint8_t* a, const uint8_t* b, uint8_t* dst, int32_t count) {
+    for (int32_t i = 0; i < count; ++i) {
+        dst[i * 2] = a[i];
+        dst[i * 2 + 1] = b[i];
+    }
+}
+
+void gatherScalar(const uint8_t* a, const uint8_t* b, uint8_t* dst, int32_t count) {
+    for (int32_t i = 0; i < count; ++i) {
+        dst[i * 2] = a[i * 2];
+        dst[i * 2 + 1] = b[i * 2];
+    }
+}
+
+constexpr ChromaKernels kScalarKernels{
+    deinterleaveScalar, splitScalar, interleaveScalar, gatherScalar
+};
+
+/// Mean of a kFactor x kFactor block of samples pixelStride bytes apart
+template <int32_t kFactor>
+uint8_t boxMean(const uint8_t* const* rows, size_t offset, int32_t pixelStride) {
+    constexpr uint32_t kShift = kFactor == 2 ? 2 : 4;
+    uint32_t sum = 0;
+    for (int32_t r = 0; r < kFactor; ++r) {
+        for (int32_t c = 0; c < kFactor; ++c) {
+            sum += rows[r][offset + static_cast<size_t>(c) * pixelStride];
+        }
+    }
+    return static_cast<uint8_t>((sum + (1u << (kShift - 1))) >> kShift);
+}
+
+template <int32_t kFactor>
+void boxScalar(const uint8_t* const* rows, uint8_t* dst, int32_t count) {
+    for (int32_t i = 0; i < count; ++i) {
+        dst[i] = boxMean<kFactor>(rows, static_cast<size_t>(i) * kFactor, 1);
+    }
+}
+
+template <int32_t kFactor>
+void boxPairsScalar(const uint8_t* const* rows, uint8_t* a, uint8_t* b, int32_t count) {
+    for (int32_t i = 0; i < count; ++i) {
+        const size_t offset = static_cast<size_t>(i) * kFactor * 2;
+        a[i] = boxMean<kFactor>(rows, offset, 2);
+        b[i] = boxMean<kFactor>(rows, offset + 1, 2);
+    }
+}
+
+/// Any pixel stride (chroma planes that are neither planar nor one interleaved allocation)
+template <int32_t kFactor>
+void boxStridedScalar(const uint8_t* const* rows, int32_t pixelStride, uint8_t* dst,
+                      int32_t count) {
+    for (int32_t i = 0; i < count; ++i) {
+        dst[i] = boxMean<kFactor>(rows, static_cast<size_t>(i) * kFactor * pixelStride,
+                                  pixelStride);
+    }
+}
+
+constexpr ScaleKernels kScalarScaleKernels{
+    boxScalar<2>, boxScalar<4>, boxPairsScalar<2>, boxPairsScalar<4>
+};
+
+// -----------------------------------------------------------------------------
+// NEON kernels: 16 chroma samples per iteration via vld2/vst2.
+// Loops that read a stride-2 source stop one vector early: the last sample of a
+// semi-planar plane has no partner byte, so reading it as a pair would run past
+// the end of the plane on the final row.
+// -----------------------------------------------------------------------------
+
+#if defined(__ARM_NEON)
+
+constexpr int32_t kNeonLanes = 16;
+
+void deinterleaveNeon(const uint8_t* src, uint8_t* dst, int32_t count) {
+    int32_t i = 0;
+    for (; i + kNeonLanes < count; i += kNeonLanes) {
+        const uint8x16x2_t pair = vld2q_u8(src + i * 2);
+        vst1q_u8(dst + i, pair.val[0]);
+    }
+    deinterleaveScalar(src + i * 2, dst + i, count - i);
+}
+
+void splitNeon(const uint8_t* src, uint8_t* a, uint8_t* b, int32_t count) {
+    int32_t i = 0;
+    for (; i + kNeonLanes <= count; i += kNeonLanes) {
+        const uint8x16x2_t pair = vld2q_u8(src + i * 2);
+        vst1q_u8(a + i, pair.val[0]);
+        vst1q_u8(b + i, pair.val[1]);
+    }
+    splitScalar(src + i * 2, a + i, b + i, count - i);
+}
+
+void interleaveNeon(const uint8_t* a, const uint8_t* b, uint8_t* dst, int32_t count) {
+    int32_t i = 0;
+    for (; i + kNeonLanes <= count; i += kNeonLanes) {
+        uint8x16x2_t pair;
+        pair.val[0] = vld1q_u8(a + i);
+        pair.val[1] = vld1q_u8(b + i);
+        vst2q_u8(dst + i * 2, pair);
+    }
+    interleaveScalar(a + i, b + i, dst + i * 2, count - i);
+}
+
+void gatherNeon(const uint8_t* a, const uint8_t* b, uint8_t* dst, int32_t count) {
+    int32_t i = 0;
+    for (; i + kNeonLanes < count; i += kNeonLanes) {
+        uint8x16x2_t pair;
+        pair.val[0] = vld2q_u8(a + i * 2).val[0];
+        pair.val[1] = vld2q_u8(b + i * 2).val[0];
+        vst2q_u8(dst + i * 2, pair);
+    }
+    gatherScalar(a + i * 2, b + i * 2, dst + i * 2, count - i);
+}
+
+constexpr ChromaKernels kNeonKernels{
+    deinterleaveNeon, splitNeon, interleaveNeon, gatherNeon
+};
+
+// Box kernels widen to 16 bits with pairwise adds (vpaddl/vpadal) and narrow with a rounding
+// shift, matching the scalar (sum + half) >> shift bit for bit. A 4x4 sum is at most 4080.
+
+/// Advance the first kRows row pointers by offset bytes (tail handling)
+template <int32_t kRows>
+void offsetRows(const uint8_t* const* rows, size_t offset, const uint8_t** out) {
+    for (int32_t r = 0; r < kRows; ++r) {
+        out[r] = rows[r] + offset;
+    }
+}
+
+/// 8 lanes, each the sum of 2 adjacent bytes of 16 over 4 rows
+uint16x8_t sumColumnPairs4(const uint8x16_t* rows) {
+    uint16x8_t sum = vpaddlq_u8(rows[0]);
+    sum = vpadalq_u8(sum, rows[1]);
+    sum = vpadalq_u8(sum, rows[2]);
+    return vpadalq_u8(sum, rows[3]);
+}
+
+/// Add adjacent lanes of a:b, turning two-column sums into four-column sums
+uint16x8_t addAdjacentLanes(uint16x8_t a, uint16x8_t b) {
+    return vcombine_u16(vpadd_u16(vget_low_u16(a), vget_high_u16(a)),
+                        vpadd_u16(vget_low_u16(b), vget_high_u16(b)));
+}
+
+void halfNeon(const uint8_t* const* rows, uint8_t* dst, int32_t count) {
+    int32_t i = 0;
+    for (; i + kNeonLanes <= count; i += kNeonLanes) {
+        const uint8_t* r0 = rows[0] + i * 2;
+        const uint8_t* r1 = rows[1] + i * 2;
+        const uint16x8_t lo = vpadalq_u8(vpaddlq_u8(vld1q_u8(r0)), vld1q_u8(r1));
+        const uint16x8_t hi = vpadalq_u8(vpaddlq_u8(vld1q_u8(r0 + 16)), vld1q_u8(r1 + 16));
+        vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+    }
+    const uint8_t* tail[2];
+    offsetRows<2>(rows, static_cast<size_t>(i) * 2, tail);
+    boxScalar<2>(tail, dst + i, count - i);
+}
+
+void quarterNeon(const uint8_t* const* rows, uint8_t* dst, int32_t count) {
+    constexpr int32_t kOutputs = 8;
+    int32_t i = 0;
+    for (; i + kOutputs <= count; i += kOutputs) {
+        const size_t offset = static_cast<size_t>(i) * 4;
+        uint8x16_t lo[4];
+        uint8x16_t hi[4];
+        for (int32_t r = 0; r < 4; ++r) {
+            lo[r] = vld1q_u8(rows[r] + offset);
+            hi[r] = vld1q_u8(rows[r] + offset + 16);
+        }
+        const uint16x8_t sum = addAdjacentLanes(sumColumnPairs4(lo), sumColumnPairs4(hi));
+        vst1_u8(dst + i, vrshrn_n_u16(sum, 4));
+    }
+    const uint8_t* tail[4];
+    offsetRows<4>(rows, static_cast<size_t>(i) * 4, tail);
+    boxScalar<4>(tail, dst + i, count - i);
+}
+
+void halfPairsNeon(const uint8_t* const* rows, uint8_t* a, uint8_t* b, int32_t count) {
+    constexpr int32_t kOutputs = 8;
+    int32_t i = 0;
+    for (; i + kOutputs <= count; i += kOutputs) {
+        const size_t offset = static_cast<size_t>(i) * 4;
+        const uint8x16x2_t p0 = vld2q_u8(rows[0] + offset);
+        const uint8x16x2_t p1 = vld2q_u8(rows[1] + offset);
+        const uint16x8_t sumA = vpadalq_u8(vpaddlq_u8(p0.val[0]), p1.val[0]);
+        const uint16x8_t sumB = vpadalq_u8(vpaddlq_u8(p0.val[1]), p1.val[1]);
+        vst1_u8(a + i, vrshrn_n_u16(sumA, 2));
+        vst1_u8(b + i, vrshrn_n_u16(sumB, 2));
+    }
+    const uint8_t* tail[2];
+    offsetRows<2>(rows, static_cast<size_t>(i) * 4, tail);
+    boxPairsScalar<2>(tail, a + i, b + i, count - i);
+}
+
+void quarterPairsNeon(const uint8_t* const* rows, uint8_t* a, uint8_t* b, int32_t count) {
+    constexpr int32_t kOutputs = 8;
+    int32_t i = 0;
+    for (; i + kOutputs <= count; i += kOutputs) {
+        const size_t offset = static_cast<size_t>(i) * 8;
+        uint8x16_t loA[4], loB[4], hiA[4], hiB[4];
+        for (int32_t r = 0; r < 4; ++r) {
+            const uint8x16x2_t lo = vld2q_u8(rows[r] + offset);
+            const uint8x16x2_t hi = vld2q_u8(rows[r] + offset + 32);
+            loA[r] = lo.val[0];
+            loB[r] = lo.val[1];
+            hiA[r] = hi.val[0];
+            hiB[r] = hi.val[1];
+        }
+        const uint16x8_t sumA = addAdjacentLanes(sumColumnPairs4(loA), sumColumnPairs4(hiA));
+        const uint16x8_t sumB = addAdjacentLanes(sumColumnPairs4(loB), sumColumnPairs4(hiB));
+        vst1_u8(a + i, vrshrn_n_u16(sumA, 4));
+        vst1_u8(b + i, vrshrn_n_u16(sumB, 4));
+    }
+    const uint8_t* tail[4];
+    offsetRows<4>(rows, static_cast<size_t>(i) * 8, tail);
+    boxPairsScalar<4>(tail, a + i, b + i, count - i);
+}
+
+constexpr ScaleKernels kNeonScaleKernels{
+    halfNeon, quarterNeon, halfPairsNeon, quarterPairsNeon
+};
+
+#endif  // __ARM_NEON
+
+YuvKernelSet detectKernelSet() noexcept {
+#if defined(__aarch64__)
+    // Advanced SIMD is mandatory on ARMv8-A
+    return YuvKernelSet::Neon;
+#elif defined(__ARM_NEON)
+    return (getauxval(AT_HWCAP) & HWCAP_NEON) ? YuvKernelSet::Neon : YuvKernelSet::Scalar;
+#else
+    return YuvKernelSet::Scalar;
+#endif
+}
+
+const ChromaKernels& kernelsFor(YuvKernelSet kernels) noexcept {
+#if defined(__ARM_NEON)
+    if (kernels == YuvKernelSet::Neon && activeYuvKernelSet() == YuvKernelSet::Neon) {
+        return kNeonKernels;
+    }
+#endif
+    (void)kernels;
+    return kScalarKernels;
+}
+
+const ScaleKernels& scaleKernelsFor(YuvKernelSet kernels) noexcept {
+#if defined(__ARM_NEON)
+    if (kernels == YuvKernelSet::Neon && activeYuvKernelSet() == YuvKernelSet::Neon) {
+        return kNeonScaleKernels;
+    }
+#endif
+    (void)kernels;
+    return kScalarScaleKernels;
+}
+
+/// Stride-aware plane copy: one memcpy when rows are contiguous, else per row
+void copyPlane(const uint8_t* src, int32_t srcStride, uint8_t* dst,
+               int32_t width, int32_t height) {
+    if (srcStride == width) {
+        memcpy(dst, src, static_cast<size_t>(width) * static_cast<size_t>(height));
+        return;
+    }
+    for (int32_t row = 0; row < height; ++row) {
+        memcpy(dst + static_cast<size_t>(row) * width,
+               src + static_cast<size_t>(row) * srcStride,
+               static_cast<size_t>(width));
+    }
+}
+
+void convertChromaToI420(const YuvPlanes& src, const ChromaKernels& k,
+                         uint8_t* uDst, uint8_t* vDst) {
+    const int32_t uvWidth = src.width / 2;
+    const int32_t uvHeight = src.height / 2;
+
+    if (src.uvPixelStride == 1) {
+        // Already planar, just copy
+        copyPlane(src.u, src.uvRowStride, uDst, uvWidth, uvHeight);
+        copyPlane(src.v, src.uvRowStride, vDst, uvWidth, uvHeight);
+        return;
+    }
+
+    for (int32_t row = 0; row < uvHeight; ++row) {
+        const size_t srcOffset = static_cast<size_t>(row) * src.uvRowStride;
+        uint8_t* uRow = uDst + static_cast<size_t>(row) * uvWidth;
+        uint8_t* vRow = vDst + static_cast<size_t>(row) * uvWidth;
+
+        if (src.uvPixelStride == 2 && src.v == src.u + 1) {
+            // NV12 memory layout: U and V share one interleaved row
+            k.split(src.u + srcOffset, uRow, vRow, uvWidth);
+        } else if (src.uvPixelStride == 2 && src.u == src.v + 1) {
+            // NV21 memory layout: V first
+            k.split(src.v + srcOffset, vRow, uRow, uvWidth);
+        } else if (src.uvPixelStride == 2) {
+            k.deinterleave(src.u + srcOffset, uRow, uvWidth);
+            k.deinterleave(src.v + srcOffset, vRow, uvWidth);
+        } else {
+            for (int32_t col = 0; col < uvWidth; ++col) {
+                uRow[col] = src.u[srcOffset + static_cast<size_t>(col) * src.uvPixelStride];
+                vRow[col] = src.v[srcOffset + static_cast<size_t>(col) * src.uvPixelStride];
+            }
+        }
+    }
+}
+
+void convertChromaToNv12(const YuvPlanes& src, const ChromaKernels& k, uint8_t* uvDst) {
+    const int32_t uvWidth = src.width / 2;
+    const int32_t uvHeight = src.height / 2;
+
+    for (int32_t row = 0; row < uvHeight; ++row) {
+        const size_t srcOffset = static_cast<size_t>(row) * src.uvRowStride;
+        uint8_t* uvRow = uvDst + static_cast<size_t>(row) * uvWidth * 2;
+
+        if (src.uvPixelStride == 1) {
+            k.interleave(src.u + srcOffset, src.v + srcOffset, uvRow, uvWidth);
+        } else if (src.uvPixelStride == 2 && src.v == src.u + 1) {
+            // Source is already NV12: the row is a straight copy
+            memcpy(uvRow, src.u + srcOffset, static_cast<size_t>(uvWidth) * 2);
+        } else if (src.uvPixelStride == 2) {
+            k.gather(src.u + srcOffset, src.v + srcOffset, uvRow, uvWidth);
+        } else {
+            for (int32_t col = 0; col < uvWidth; ++col) {
+                const size_t offset = srcOffset + static_cast<size_t>(col) * src.uvPixelStride;
+                uvRow[col * 2] = src.u[offset];
+                uvRow[col * 2 + 1] = src.v[offset];
+            }
+        }
+    }
+}
+
+/// Source rows feeding one output row of a downscaled plane
+void gatherRows(const uint8_t* plane, int32_t rowStride, int32_t outputRow, int32_t factor,
+                size_t columnOffset, const uint8_t** rows) {
+    for (int32_t r = 0; r < factor; ++r) {
+        rows[r] = plane + static_cast<size_t>(outputRow * factor + r) * rowStride + columnOffset;
+    }
+}
+
+void scalePlane(const uint8_t* src, int32_t srcStride, int32_t factor, const ScaleKernels& sk,
+                uint8_t* dst, int32_t width, int32_t height) {
+    const auto box = factor == 2 ? sk.half : sk.quarter;
+    const uint8_t* rows[4];
+    for (int32_t row = 0; row < height; ++row) {
+        gatherRows(src, srcStride, row, factor, 0, rows);
+        box(rows, dst + static_cast<size_t>(row) * width, width);
+    }
+}
+
+/// Downscale count chroma samples of one output row, from output column col, into planar U/V
+void scaleChromaSpan(const YuvPlanes& src, int32_t factor, const ScaleKernels& sk,
+                     int32_t row, int32_t col, int32_t count, uint8_t* uOut, uint8_t* vOut) {
+    const size_t columnOffset = static_cast<size_t>(col) * factor * src.uvPixelStride;
+    const uint8_t* uRows[4];
+    const uint8_t* vRows[4];
+    gatherRows(src.u, src.uvRowStride, row, factor, columnOffset, uRows);
+    gatherRows(src.v, src.uvRowStride, row, factor, columnOffset, vRows);
+
+    if (src.uvPixelStride == 1) {
+        const auto box = factor == 2 ? sk.half : sk.quarter;
+        box(uRows, uOut, count);
+        box(vRows, vOut, count);
+    } else if (src.uvPixelStride == 2 && src.v == src.u + 1) {
+        // NV12 memory layout: one interleaved row, read from its first byte
+        (factor == 2 ? sk.halfPairs : sk.quarterPairs)(uRows, uOut, vOut, count);
+    } else if (src.uvPixelStride == 2 && src.u == src.v + 1) {
+        // NV21 memory layout: V first
+        (factor == 2 ? sk.halfPairs : sk.quarterPairs)(vRows, vOut, uOut, count);
+    } else if (factor == 2) {
+        boxStridedScalar<2>(uRows, src.uvPixelStride, uOut, count);
+        boxStridedScalar<2>(vRows, src.uvPixelStride, vOut, count);
+    } else {
+        boxStridedScalar<4>(uRows, src.uvPixelStride, uOut, count);
+        boxStridedScalar<4>(vRows, src.uvPixelStride, vOut, count);
+    }
+}
+
+void scaleChromaToI420(const YuvPlanes& src, int32_t factor, const ScaleKernels& sk,
+                       int32_t uvWidth, int32_t uvHeight, uint8_t* uDst, uint8_t* vDst) {
+    for (int32_t row = 0; row < uvHeight; ++row) {
+        const size_t offset = static_cast<size_t>(row) * uvWidth;
+        scaleChromaSpan(src, factor, sk, row, 0, uvWidth, uDst + offset, vDst + offset);
+    }
+}
+
+void scaleChromaToNv12(const YuvPlanes& src, int32_t factor, const ScaleKernels& sk,
+                       const ChromaKernels& k, int32_t uvWidth, int32_t uvHeight,
+                       uint8_t* uvDst) {
+    // Planar spans on the stack, interleaved into the output; no per-frame allocation
+    constexpr int32_t kSpan = 256;
+    uint8_t uSpan[kSpan];
+    uint8_t vSpan[kSpan];
+    for (int32_t row = 0; row < uvHeight; ++row) {
+        uint8_t* uvRow = uvDst + static_cast<size_t>(row) * uvWidth * 2;
+        for (int32_t col = 0; col < uvWidth; col += kSpan) {
+            const int32_t count = uvWidth - col < kSpan ? uvWidth - col : kSpan;
+            scaleChromaSpan(src, factor, sk, row, col, count, uSpan, vSpan);
+            k.interleave(uSpan, vSpan, uvRow + static_cast<size_t>(col) * 2, count);
+        }
+    }
+}
+
+}  // namespace
+
+size_t yuvBufferSize(YuvOutputFormat format, int32_t width, int32_t height) noexcept {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    const size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    // I420 and NV12 are both 4:2:0 with 12 bits per pixel
+    return format == YuvOutputFormat::Y8 ? pixels : pixels * 3 / 2;
+}
+
+bool cropYuvPlanes(const YuvPlanes& src, const YuvCropRect& rect, YuvPlanes& out) noexcept {
+    const int32_t x = std::clamp(rect.x, 0, src.width) & ~1;
+    const int32_t y = std::clamp(rect.y, 0, src.height) & ~1;
+    const int32_t width = std::min(rect.width, src.width - x) & ~1;
+    const int32_t height = std::min(rect.height, src.height - y) & ~1;
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    const size_t chromaOffset = static_cast<size_t>(y / 2) * src.uvRowStride +
+                                static_cast<size_t>(x / 2) * src.uvPixelStride;
+    YuvPlanes cropped = src;
+    cropped.y = src.y ? src.y + static_cast<size_t>(y) * src.yRowStride + x : nullptr;
+    cropped.u = src.u ? src.u + chromaOffset : nullptr;
+    cropped.v = src.v ? src.v + chromaOffset : nullptr;
+    cropped.width = width;
+    cropped.height = height;
+    out = cropped;
+    return true;
+}
+
+int32_t yuvScaledDimension(int32_t size, YuvScale scale) noexcept {
+    if (size <= 0) {
+        return 0;
+    }
+    return (size >> static_cast<int32_t>(scale)) & ~1;
+}
+
+YuvKernelSet activeYuvKernelSet() noexcept {
+    static const YuvKernelSet kActive = detectKernelSet();
+    return kActive;
+}
+
+const char* yuvKernelSetName(YuvKernelSet kernels) noexcept {
+    switch (kernels) {
+        case YuvKernelSet::Neon:
+            return "neon";
+        case YuvKernelSet::Scalar:
+        default:
+            return "scalar";
+    }
+}
+
+bool convertYuv420888(const YuvPlanes& src, YuvOutputFormat format, uint8_t* dst) noexcept {
+    return convertYuv420888(src, format, dst, activeYuvKernelSet());
+}
+
+bool convertYuv420888(const YuvPlanes& src, YuvOutputFormat format, uint8_t* dst,
+                      YuvKernelSet kernels) noexcept {
+    if (!src.y || !dst || src.width <= 0 || src.height <= 0) {
+        return false;
+    }
+    if (format == YuvOutputFormat::Y8) {
+        copyPlane(src.y, src.yRowStride, dst, src.width, src.height);
+        return true;
+    }
+    if (!src.u || !src.v || src.uvPixelStride <= 0) {
+        return false;
+    }
+
+    const ChromaKernels& k = kernelsFor(kernels);
+    const size_t ySize = static_cast<size_t>(src.width) * static_cast<size_t>(src.height);
+
+    copyPlane(src.y, src.yRowStride, dst, src.width, src.height);
+
+    uint8_t* chromaDst = dst + ySize;
+    if (format == YuvOutputFormat::NV12) {
+        convertChromaToNv12(src, k, chromaDst);
+    } else {
+        const size_t uvSize = static_cast<size_t>(src.width / 2) * static_cast<size_t>(src.height / 2);
+        convertChromaToI420(src, k, chromaDst, chromaDst + uvSize);
+    }
+    return true;
+}
+
+bool convertYuv420888Scaled(const YuvPlanes& src, YuvOutputFormat format, YuvScale scale,
+                            uint8_t* dst) noexcept {
+    return convertYuv420888Scaled(src, format, scale, dst, activeYuvKernelSet());
+}
+
+bool convertYuv420888Scaled(const YuvPlanes& src, YuvOutputFormat format, YuvScale scale,
+                            uint8_t* dst, YuvKernelSet kernels) noexcept {
+    if (scale == YuvScale::Full) {
+        return convertYuv420888(src, format, dst, kernels);
+    }
+
+    const int32_t width = yuvScaledDimension(src.width, scale);
+    const int32_t height = yuvScaledDimension(src.height, scale);
+    if (!src.y || !dst || width <= 0 || height <= 0) {
+        return false;
+    }
+    const bool lumaOnly = format == YuvOutputFormat::Y8;
+    if (!lumaOnly && (!src.u || !src.v || src.uvPixelStride <= 0)) {
+        return false;
+    }
+
+    const int32_t factor = 1 << static_cast<int32_t>(scale);
+    const ScaleKernels& sk = scaleKernelsFor(kernels);
+    const size_t ySize = static_cast<size_t>(width) * static_cast<size_t>(height);
+
+    scalePlane(src.y, src.yRowStride, factor, sk, dst, width, height);
+    if (lumaOnly) {
+        return true;
+    }
+
+    uint8_t* chromaDst = dst + ySize;
+    const int32_t uvWidth = width / 2;
+    const int32_t uvHeight = height / 2;
+    if (format == YuvOutputFormat::NV12) {
+        scaleChromaToNv12(src, factor, sk, kernelsFor(kernels), uvWidth, uvHeight, chromaDst);
+    } else {
+        const size_t uvSize = static_cast<size_t>(uvWidth) * static_cast<size_t>(uvHeight);
+        scaleChromaToI420(src, factor, sk, uvWidth, uvHeight, chromaDst, chromaDst + uvSize);
+    }
+    return true;
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nativesensor {
+
+/// Tightly packed output layouts produced by the repack kernels
+enum class YuvOutputFormat : int32_t {
+    I420 = 0,   // Y plane, U plane, V plane (w*h*3/2)
+    NV12 = 1,   // Y plane, interleaved UV plane (w*h*3/2)
+    Y8 = 2      // Y plane only (w*h), for monochrome IR cameras
+};
+
+/// Kernel implementations selectable for conversion
+enum class YuvKernelSet : int32_t {
+    Scalar = 0,
+    Neon = 1
+};
+
+/// Box-filter downscale applied while repacking; the value is the power-of-two shift
+enum class YuvScale : int32_t {
+    Full = 0,
+    Half = 1,       // 2x2 box average
+    Quarter = 2     // 4x4 box average
+};
+
+/// Source planes of a YUV_420_888 image as reported by AImage
+struct YuvPlanes {
+    const uint8_t* y = nullptr;
+    const uint8_t* u = nullptr;
+    const uint8_t* v = nullptr;
+    int32_t yRowStride = 0;
+    int32_t uvRowStride = 0;
+    int32_t uvPixelStride = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+/// Crop window in image pixels. Origin and size round down to even so chroma stays aligned;
+/// captures treat an empty window as the full image.
+struct YuvCropRect {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+/// Size in bytes of a tightly packed frame in the given format
+[[nodiscard]]
+size_t yuvBufferSize(YuvOutputFormat format, int32_t width, int32_t height) noexcept;
+
+/// Output width or height for a scale: size >> scale, rounded down to even for 4:2:0 chroma
+[[nodiscard]]
+int32_t yuvScaledDimension(int32_t size, YuvScale scale) noexcept;
+
+/// Narrow source planes to a crop window by offsetting the plane pointers (no copy); the
+/// repack then reads only the window. The window is clamped to the image.
+/// @return false if the clamped window is empty (out is left unchanged)
+bool cropYuvPlanes(const YuvPlanes& src, const YuvCropRect& rect, YuvPlanes& out) noexcept;
+
+/// Best kernel set supported by the running CPU (resolved once)
+[[nodiscard]]
+YuvKernelSet activeYuvKernelSet() noexcept;
+
+/// Human-readable kernel set name for logs and benchmarks
+[[nodiscard]]
+const char* yuvKernelSetName(YuvKernelSet kernels) noexcept;
+
+/// Repack YUV_420_888 planes into a tightly packed buffer of yuvBufferSize() bytes.
+/// Handles arbitrary row strides and chroma pixel strides of 1 (planar) or 2 (semi-planar).
+/// Y8 reads only the luma plane; the chroma planes may be null.
+/// @return false if the source planes are missing or the geometry is invalid
+bool convertYuv420888(const YuvPlanes& src, YuvOutputFormat format, uint8_t* dst) noexcept;
+
+/// Same as above with an explicit kernel set (falls back to scalar if unsupported)
+bool convertYuv420888(const YuvPlanes& src, YuvOutputFormat format, uint8_t* dst,
+                      YuvKernelSet kernels) noexcept;
+
+/// Repack and box-downscale YUV_420_888 planes in one pass, so dropped resolution is never
+/// copied at full size. dst holds yuvBufferSize() bytes of the yuvScaledDimension() geometry.
+/// YuvScale::Full is the same as convertYuv420888().
+/// @return false if the source planes are missing or too small for the scale
+bool convertYuv420888Scaled(const YuvPlanes& src, YuvOutputFormat format, YuvScale scale,
+                            uint8_t* dst) noexcept;
+
+/// Same as above with an explicit kernel set (falls back to scalar if unsupported)
+bool convertYuv420888Scaled(const YuvPlanes& src, YuvOutputFormat format, YuvScale scale,
+                            uint8_t* dst, YuvKernelSet kernels) noexcept;
+
+}  // namespace nativesensor
@@ -7,9 +7,11 @@
 
 namespace nativesensor {
 
-/// Thread-safe callback dispatcher for sensor events.
-/// Stores JNI callback references and dispatches to Kotlin/Java.
-/// Reserved for future JNI callback integration.
+/// Thread-safe holder of one registered Kotlin callback object.
+/// Native threads invoke the callback under the handler's lock, so once setCallback() or
+/// reset() returns the previous object is never called again. Method ids are not stored here;
+/// they are resolved once per interface in JNI_OnLoad. A callback must not re-register itself
+/// from inside its own invocation.
 class [[maybe_unused]] CallbackHandler {
 public:
     CallbackHandler() = default;
@@ -20,7 +22,7 @@ public:
     CallbackHandler(CallbackHandler&&) = delete;
     CallbackHandler& operator=(CallbackHandler&&) = delete;
 
-    /// Store a global reference to a Kotlin callback object
+    /// Store a global reference to a Kotlin callback object (nullptr clears it)
     [[maybe_unused]]
     void setCallback(JNIEnv* env, jobject callback) {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -28,33 +30,30 @@ public:
         if (callback) {
             callback_ = env->NewGlobalRef(callback);
         }
+        registered_.store(callback_ != nullptr, std::memory_order_release);
     }
 
-    /// Check if callback is registered
+    /// Check if callback is registered (lock-free; hot paths test this before attaching)
     [[nodiscard]] [[maybe_unused]]
     bool hasCallback() const noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return callback_ != nullptr;
-    }
-
-    /// Get the callback object (caller must hold lock or use invokeCallback)
-    [[nodiscard]] [[maybe_unused]]
-    jobject getCallback() const noexcept {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return callback_;
+        return registered_.load(std::memory_order_acquire);
     }
 
-    /// Thread-safe callback invocation
+    /// Thread-safe callback invocation: func(env, callback) runs only if one is registered
+    /// @return true if func ran
     template<typename Func>
     [[maybe_unused]]
-    void invokeCallback(JNIEnv* env, Func&& func) {
+    bool invokeCallback(JNIEnv* env, Func&& func) {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (callback_) {
-            func(env, callback_);
+        if (!callback_ || !env) {
+            return false;
         }
+        func(env, callback_);
+        return true;
     }
 
-    /// Release the callback reference
+    /// Release the callback reference. Without an env the reference is dropped but not
+    /// deleted (process teardown, when no thread can be attached).
     void reset(JNIEnv* env = nullptr) noexcept {
         std::lock_guard<std::mutex> lock(mutex_);
         reset_internal(env);
@@ -64,13 +63,14 @@ private:
     void reset_internal(JNIEnv* env) {
         if (callback_ && env) {
             env->DeleteGlobalRef(callback_);
-            callback_ = nullptr;
         }
+        callback_ = nullptr;
+        registered_.store(false, std::memory_order_release);
     }
 
     mutable std::mutex mutex_;
     jobject callback_ = nullptr;
+    std::atomic<bool> registered_{false};
 };
 
 }  // namespace nativesensor
-
@@ -0,0 +1,211 @@
+#include "frame_buffer_pool.h"
+
+#include <array>
+#include <new>
+
+namespace nativesensor {
+
+namespace {
+
+// Slot storage alignment (cache line, also satisfies NEON load/store alignment)
+constexpr size_t kSlotAlignment = 64;
+
+constexpr size_t alignUp(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+namespace detail {
+
+/// Per-slot bookkeeping, padded so producer/consumer refcount traffic on
+/// neighbouring slots does not share a cache line
+struct alignas(kSlotAlignment) FramePoolSlot {
+    std::atomic<int32_t> refs{0};
+    size_t size = 0;
+};
+
+/// Shared pool storage. Lives until the pool and every handle have let go:
+/// liveRefs counts one reference for the owning pool plus one per occupied slot.
+struct FramePoolState {
+    std::unique_ptr<uint8_t[]> storage;
+    size_t slotCount = 0;
+    size_t bufferSize = 0;
+    size_t slotStride = 0;
+    uint64_t fullMask = 0;
+
+    std::array<FramePoolSlot, FrameBufferPool::kMaxSlots> slots{};
+    std::atomic<uint64_t> inUseMask{0};
+    std::atomic<int32_t> liveRefs{1};
+    std::atomic<int32_t> peakInUse{0};
+    std::atomic<int64_t> starvationCount{0};
+    MemoryReservation reservation;      // Storage bytes, returned when the state is freed
+};
+
+namespace {
+
+void dropStateRef(FramePoolState* state) noexcept {
+    if (state->liveRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::unique_ptr<FramePoolState> owned(state);
+    }
+}
+
+void releaseSlot(FramePoolState* state, uint32_t slot) noexcept {
+    if (state->slots[slot].refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        state->inUseMask.fetch_and(~(uint64_t{1} << slot), std::memory_order_release);
+        dropStateRef(state);
+    }
+}
+
+}  // namespace
+
+}  // namespace detail
+
+// =============================================================================
+// FrameBufferHandle
+// =============================================================================
+
+FrameBufferHandle::FrameBufferHandle(const FrameBufferHandle& other) noexcept
+    : state_(other.state_), slot_(other.slot_) {
+    if (state_) {
+        state_->slots[slot_].refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+FrameBufferHandle& FrameBufferHandle::operator=(const FrameBufferHandle& other) noexcept {
+    if (this != &other) {
+        FrameBufferHandle copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+FrameBufferHandle::FrameBufferHandle(FrameBufferHandle&& other) noexcept
+    : state_(other.state_), slot_(other.slot_) {
+    other.state_ = nullptr;
+}
+
+FrameBufferHandle& FrameBufferHandle::operator=(FrameBufferHandle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        state_ = other.state_;
+        slot_ = other.slot_;
+        other.state_ = nullptr;
+    }
+    return *this;
+}
+
+void FrameBufferHandle::reset() noexcept {
+    if (state_) {
+        detail::releaseSlot(state_, slot_);
+        state_ = nullptr;
+    }
+}
+
+uint8_t* FrameBufferHandle::data() const noexcept {
+    return state_ ? state_->storage.get() + slot_ * state_->slotStride : nullptr;
+}
+
+size_t FrameBufferHandle::capacity() const noexcept {
+    return state_ ? state_->bufferSize : 0;
+}
+
+size_t FrameBufferHandle::size() const noexcept {
+    return state_ ? state_->slots[slot_].size : 0;
+}
+
+void FrameBufferHandle::setSize(size_t size) noexcept {
+    if (state_) {
+        state_->slots[slot_].size = size <= state_->bufferSize ? size : state_->bufferSize;
+    }
+}
+
+// =============================================================================
+// FrameBufferPool
+// =============================================================================
+
+FrameBufferPool::~FrameBufferPool() {
+    release();
+}
+
+bool FrameBufferPool::allocate(size_t slotCount, size_t bufferSize, MemoryComponent component) {
+    release();
+
+    if (slotCount == 0 || slotCount > kMaxSlots || bufferSize == 0) {
+        return false;
+    }
+
+    auto state = std::make_unique<detail::FramePoolState>();
+    state->slotCount = slotCount;
+    state->bufferSize = bufferSize;
+    state->slotStride = alignUp(bufferSize, kSlotAlignment);
+    state->fullMask = slotCount == kMaxSlots ? ~uint64_t{0} : (uint64_t{1} << slotCount) - 1;
+
+    // Default-initialized: no zero-fill of multi-megabyte frame storage
+    state->storage.reset(new (std::nothrow) uint8_t[state->slotStride * slotCount]);
+    if (!state->storage) {
+        return false;
+    }
+    state->reservation = MemoryReservation(component, state->slotStride * slotCount);
+
+    state_ = state.release();
+    return true;
+}
+
+void FrameBufferPool::release() noexcept {
+    if (state_) {
+        detail::dropStateRef(state_);
+        state_ = nullptr;
+    }
+}
+
+FrameBufferHandle FrameBufferPool::acquire() noexcept {
+    if (!state_) {
+        return {};
+    }
+
+    uint64_t mask = state_->inUseMask.load(std::memory_order_acquire);
+    uint32_t slot = 0;
+    for (;;) {
+        const uint64_t freeMask = ~mask & state_->fullMask;
+        if (freeMask == 0) {
+            state_->starvationCount.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+        slot = static_cast<uint32_t>(__builtin_ctzll(freeMask));
+        if (state_->inUseMask.compare_exchange_weak(mask, mask | (uint64_t{1} << slot),
+                                                   std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    state_->slots[slot].refs.store(1, std::memory_order_relaxed);
+    state_->slots[slot].size = 0;
+    state_->liveRefs.fetch_add(1, std::memory_order_relaxed);
+
+    const auto inUse = static_cast<int32_t>(__builtin_popcountll(mask | (uint64_t{1} << slot)));
+    int32_t peak = state_->peakInUse.load(std::memory_order_relaxed);
+    while (inUse > peak &&
+           !state_->peakInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
+
+    return FrameBufferHandle(state_, slot);
+}
+
+FramePoolStats FrameBufferPool::getStats() const noexcept {
+    FramePoolStats stats;
+    if (!state_) {
+        return stats;
+    }
+
+    stats.capacity = static_cast<int32_t>(state_->slotCount);
+    stats.inUse = static_cast<int32_t>(
+        __builtin_popcountll(state_->inUseMask.load(std::memory_order_acquire)));
+    stats.peakInUse = state_->peakInUse.load(std::memory_order_relaxed);
+    stats.starvationCount = state_->starvationCount.load(std::memory_order_relaxed);
+    stats.bufferSize = state_->bufferSize;
+    return stats;
+}
+
+}  // namespace nativesensor
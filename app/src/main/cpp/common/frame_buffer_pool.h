@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "memory_budget.h"
+
+namespace nativesensor {
+
+/// Frame buffer pool occupancy counters
+struct FramePoolStats {
+    int32_t capacity = 0;           // Number of slots allocated
+    int32_t inUse = 0;              // Slots currently held by handles
+    int32_t peakInUse = 0;          // High-water mark since allocation
+    int64_t starvationCount = 0;    // acquire() calls that found no free slot
+    size_t bufferSize = 0;          // Bytes per slot
+};
+
+namespace detail {
+struct FramePoolState;
+}
+
+/// Ref-counted handle to one pooled frame buffer.
+/// Copies share the slot; it returns to the pool when the last handle is released.
+/// Handles stay valid after the owning pool is released or reallocated.
+class FrameBufferHandle {
+public:
+    FrameBufferHandle() noexcept = default;
+    ~FrameBufferHandle() { reset(); }
+
+    FrameBufferHandle(const FrameBufferHandle& other) noexcept;
+    FrameBufferHandle& operator=(const FrameBufferHandle& other) noexcept;
+    FrameBufferHandle(FrameBufferHandle&& other) noexcept;
+    FrameBufferHandle& operator=(FrameBufferHandle&& other) noexcept;
+
+    /// Drop this handle's reference
+    void reset() noexcept;
+
+    [[nodiscard]] explicit operator bool() const noexcept { return state_ != nullptr; }
+
+    /// Writable storage of capacity() bytes
+    [[nodiscard]] uint8_t* data() const noexcept;
+
+    /// Size of each pool slot in bytes
+    [[nodiscard]] size_t capacity() const noexcept;
+
+    /// Bytes of valid frame data (set by the producer)
+    [[nodiscard]] size_t size() const noexcept;
+    void setSize(size_t size) noexcept;
+
+private:
+    friend class FrameBufferPool;
+    FrameBufferHandle(detail::FramePoolState* state, uint32_t slot) noexcept
+        : state_(state), slot_(slot) {}
+
+    detail::FramePoolState* state_ = nullptr;
+    uint32_t slot_ = 0;
+};
+
+/// Fixed-capacity pool of equally sized frame buffers.
+/// All storage is allocated up front by allocate(); acquire() never touches the heap.
+/// acquire() is intended for a single producer; handles may be released from any thread.
+class FrameBufferPool {
+public:
+    /// Upper bound on slots (occupancy is tracked in a single 64-bit mask)
+    static constexpr size_t kMaxSlots = 64;
+
+    FrameBufferPool() = default;
+    ~FrameBufferPool();
+
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+    /// Allocate slotCount buffers of bufferSize bytes, replacing any previous storage.
+    /// Outstanding handles keep the previous storage alive until released, and it stays
+    /// accounted against component until then.
+    /// @return false if the request is out of range or allocation fails
+    bool allocate(size_t slotCount, size_t bufferSize,
+                  MemoryComponent component = MemoryComponent::FramePools);
+
+    /// Drop the pool's storage (deferred until outstanding handles are released)
+    void release() noexcept;
+
+    /// Take a free slot. Returns an empty handle and counts a starvation when exhausted.
+    [[nodiscard]]
+    FrameBufferHandle acquire() noexcept;
+
+    /// Check if storage is allocated
+    [[nodiscard]]
+    bool isAllocated() const noexcept { return state_ != nullptr; }
+
+    /// Get occupancy statistics
+    [[nodiscard]]
+    FramePoolStats getStats() const noexcept;
+
+private:
+    detail::FramePoolState* state_ = nullptr;
+};
+
+}  // namespace nativesensor
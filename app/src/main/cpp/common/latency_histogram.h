@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace nativesensor {
+
+/// Percentile summary of a LatencyHistogram (microseconds).
+/// Trivially copyable and fixed size so it can be written straight into a JNI snapshot.
+struct LatencySummary {
+    uint64_t count = 0;
+    uint32_t minUs = 0;
+    uint32_t meanUs = 0;
+    uint32_t p50Us = 0;
+    uint32_t p95Us = 0;
+    uint32_t p99Us = 0;
+    uint32_t maxUs = 0;
+};
+static_assert(sizeof(LatencySummary) == 32, "LatencySummary layout is part of the JNI snapshot");
+
+/// Lock-free log-linear latency histogram in the style of HdrHistogram.
+/// Values are bucketed by power of two with 16 linear sub-buckets each, so every recorded
+/// value is reported within 1/16 (6.25%) of its true value across 1 us to ~71 minutes.
+/// Any number of threads may record; readers see a slightly stale but bounded view.
+class LatencyHistogram {
+public:
+    static constexpr uint32_t kSubBucketBits = 4;
+    static constexpr uint32_t kSubBucketCount = 1u << kSubBucketBits;
+    static constexpr size_t kBucketCount = kSubBucketCount * (32 - kSubBucketBits + 1);
+
+    LatencyHistogram() noexcept { reset(); }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /// Record one value (negative values count as 0)
+    void record(int64_t valueUs) noexcept {
+        const uint32_t value = clampValue(valueUs);
+
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        sumUs_.fetch_add(value, std::memory_order_relaxed);
+
+        uint32_t current = maxUs_.load(std::memory_order_relaxed);
+        while (value > current &&
+               !maxUs_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+        current = minUs_.load(std::memory_order_relaxed);
+        while (value < current &&
+               !minUs_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// Clear all counts. Records racing with the reset may survive it.
+    void reset() noexcept {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        sumUs_.store(0, std::memory_order_relaxed);
+        maxUs_.store(0, std::memory_order_relaxed);
+        minUs_.store(std::numeric_limits<uint32_t>::max(), std::memory_order_relaxed);
+    }
+
+    /// Count, mean, min/max and p50/p95/p99 from one pass over the buckets
+    [[nodiscard]]
+    LatencySummary summarize() const noexcept {
+        std::array<uint32_t, kBucketCount> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        LatencySummary summary;
+        if (total == 0) {
+            return summary;
+        }
+
+        summary.count = total;
+        summary.maxUs = maxUs_.load(std::memory_order_relaxed);
+        summary.minUs = minUs_.load(std::memory_order_relaxed);
+        summary.meanUs = static_cast<uint32_t>(sumUs_.load(std::memory_order_relaxed) / total);
+
+        // Ranks are 1-based; a bucket reports its highest equivalent value, capped at max
+        const uint64_t rank50 = (total * 50 + 99) / 100;
+        const uint64_t rank95 = (total * 95 + 99) / 100;
+        const uint64_t rank99 = (total * 99 + 99) / 100;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount && summary.p99Us == 0; ++i) {
+            if (counts[i] == 0) {
+                continue;
+            }
+            const uint64_t before = seen;
+            seen += counts[i];
+            const uint32_t value = std::min(bucketUpperBound(i), summary.maxUs);
+            if (before < rank50 && seen >= rank50) summary.p50Us = value;
+            if (before < rank95 && seen >= rank95) summary.p95Us = value;
+            if (before < rank99 && seen >= rank99) summary.p99Us = value;
+        }
+        return summary;
+    }
+
+private:
+    static uint32_t clampValue(int64_t valueUs) noexcept {
+        if (valueUs <= 0) {
+            return 0;
+        }
+        constexpr auto kMax = static_cast<int64_t>(std::numeric_limits<uint32_t>::max());
+        return static_cast<uint32_t>(valueUs < kMax ? valueUs : kMax);
+    }
+
+    static size_t bucketIndex(uint32_t value) noexcept {
+        if (value < kSubBucketCount) {
+            return value;
+        }
+        // Top bit selects the power of two, the next kSubBucketBits pick the linear sub-bucket
+        const uint32_t msb = 31u - static_cast<uint32_t>(__builtin_clz(value));
+        const uint32_t shift = msb - kSubBucketBits;
+        const uint32_t sub = (value >> shift) & (kSubBucketCount - 1);
+        return kSubBucketCount * (shift + 1) + sub;
+    }
+
+    static uint32_t bucketUpperBound(size_t index) noexcept {
+        if (index < kSubBucketCount) {
+            return static_cast<uint32_t>(index);
+        }
+        const auto shift = static_cast<uint32_t>(index / kSubBucketCount - 1);
+        const auto sub = static_cast<uint32_t>(index % kSubBucketCount);
+        const uint64_t lower = static_cast<uint64_t>(kSubBucketCount + sub) << shift;
+        const uint64_t upper = lower + (uint64_t{1} << shift) - 1;
+        return static_cast<uint32_t>(std::min<uint64_t>(upper, std::numeric_limits<uint32_t>::max()));
+    }
+
+    std::array<std::atomic<uint32_t>, kBucketCount> buckets_;
+    std::atomic<uint64_t> sumUs_{0};
+    std::atomic<uint32_t> maxUs_{0};
+    std::atomic<uint32_t> minUs_{std::numeric_limits<uint32_t>::max()};
+};
+
+}  // namespace nativesensor
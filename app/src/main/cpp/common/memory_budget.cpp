@@ -0,0 +1,134 @@
+#include "memory_budget.h"
+
+#include <android/log.h>
+#include <atomic>
+#include <limits>
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Memory";
+
+constexpr double kBytesToMiB = 1024.0 * 1024.0;
+
+// Process-wide counters; every field is updated lock-free
+struct MemoryAccounting {
+    std::array<std::atomic<int64_t>, nativesensor::kMemoryComponentCount> reserved{};
+    std::array<std::atomic<int64_t>, nativesensor::kMemoryComponentCount> peak{};
+    std::atomic<int64_t> total{0};
+    std::atomic<int64_t> peakTotal{0};
+    std::atomic<int64_t> budget{0};
+    std::atomic<int64_t> degradedStreams{0};
+    std::atomic<int64_t> refusedStreams{0};
+};
+
+MemoryAccounting& accounting() noexcept {
+    static MemoryAccounting instance;
+    return instance;
+}
+
+void raisePeak(std::atomic<int64_t>& peak, int64_t value) noexcept {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current &&
+           !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void addBytes(nativesensor::MemoryComponent component, int64_t delta) noexcept {
+    MemoryAccounting& state = accounting();
+    const auto index = static_cast<size_t>(component);
+    const int64_t reserved =
+        state.reserved[index].fetch_add(delta, std::memory_order_relaxed) + delta;
+    const int64_t total = state.total.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (delta > 0) {
+        raisePeak(state.peak[index], reserved);
+        raisePeak(state.peakTotal, total);
+    }
+}
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+// =============================================================================
+// MemoryReservation
+// =============================================================================
+
+MemoryReservation::MemoryReservation(MemoryComponent component, size_t bytes) noexcept
+    : component_(component), bytes_(bytes) {
+    if (bytes_ > 0) {
+        addBytes(component_, static_cast<int64_t>(bytes_));
+    }
+}
+
+MemoryReservation::MemoryReservation(MemoryReservation&& other) noexcept
+    : component_(other.component_), bytes_(other.bytes_) {
+    other.bytes_ = 0;
+}
+
+MemoryReservation& MemoryReservation::operator=(MemoryReservation&& other) noexcept {
+    if (this != &other) {
+        reset();
+        component_ = other.component_;
+        bytes_ = other.bytes_;
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+void MemoryReservation::reset() noexcept {
+    if (bytes_ > 0) {
+        addBytes(component_, -static_cast<int64_t>(bytes_));
+        bytes_ = 0;
+    }
+}
+
+// =============================================================================
+// Budget
+// =============================================================================
+
+void setMemoryBudget(int64_t bytes) noexcept {
+    MemoryAccounting& state = accounting();
+    state.budget.store(bytes > 0 ? bytes : 0, std::memory_order_release);
+    const int64_t total = state.total.load(std::memory_order_relaxed);
+    LOGI("Native memory budget %.1f MiB (%.1f MiB reserved)",
+         static_cast<double>(bytes) / kBytesToMiB, static_cast<double>(total) / kBytesToMiB);
+    if (bytes > 0 && total > bytes) {
+        LOGW("Reservations already exceed the new budget; new streams will degrade or fail");
+    }
+}
+
+int64_t memoryBudgetAvailable() noexcept {
+    MemoryAccounting& state = accounting();
+    const int64_t budget = state.budget.load(std::memory_order_acquire);
+    if (budget <= 0) {
+        return std::numeric_limits<int64_t>::max();
+    }
+    const int64_t total = state.total.load(std::memory_order_relaxed);
+    return total < budget ? budget - total : 0;
+}
+
+void recordMemoryDegradedStream() noexcept {
+    accounting().degradedStreams.fetch_add(1, std::memory_order_relaxed);
+}
+
+void recordMemoryRefusedStream() noexcept {
+    accounting().refusedStreams.fetch_add(1, std::memory_order_relaxed);
+}
+
+MemoryUsage getMemoryUsage() noexcept {
+    MemoryAccounting& state = accounting();
+    MemoryUsage usage;
+    for (size_t i = 0; i < kMemoryComponentCount; ++i) {
+        usage.components[i].reservedBytes = state.reserved[i].load(std::memory_order_relaxed);
+        usage.components[i].peakBytes = state.peak[i].load(std::memory_order_relaxed);
+    }
+    usage.totalBytes = state.total.load(std::memory_order_relaxed);
+    usage.peakTotalBytes = state.peakTotal.load(std::memory_order_relaxed);
+    usage.budgetBytes = state.budget.load(std::memory_order_acquire);
+    usage.degradedStreams = state.degradedStreams.load(std::memory_order_relaxed);
+    usage.refusedStreams = state.refusedStreams.load(std::memory_order_relaxed);
+    return usage;
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace nativesensor {
+
+/// Pipeline parts whose native memory is accounted. Values are part of the JNI contract.
+enum class MemoryComponent : int32_t {
+    ImageReaders = 0,   // AImageReader queues (gralloc, estimated from geometry and depth)
+    FramePools = 1,     // Packed camera frame pools
+    ImuRings = 2,       // IMU and orientation history rings, direct channel shared memory
+    Recorder = 3        // Session recorder packet pool, mapping window and staging buffers
+};
+
+constexpr size_t kMemoryComponentCount = 4;
+
+/// Bytes held by one component
+struct MemoryComponentUsage {
+    int64_t reservedBytes = 0;
+    int64_t peakBytes = 0;              // High-water mark since process start
+};
+
+/// Snapshot of the process-wide accounting
+struct MemoryUsage {
+    std::array<MemoryComponentUsage, kMemoryComponentCount> components{};
+    int64_t totalBytes = 0;
+    int64_t peakTotalBytes = 0;
+    int64_t budgetBytes = 0;            // 0 = unlimited
+    int64_t degradedStreams = 0;        // Streams started below their requested configuration
+    int64_t refusedStreams = 0;         // Streams that did not fit even fully degraded
+};
+
+/// Bytes counted against a component until reset or destroyed. Move-only, so the owner of an
+/// allocation holds exactly one reservation for it.
+class MemoryReservation {
+public:
+    MemoryReservation() noexcept = default;
+    MemoryReservation(MemoryComponent component, size_t bytes) noexcept;
+    ~MemoryReservation() { reset(); }
+
+    MemoryReservation(const MemoryReservation&) = delete;
+    MemoryReservation& operator=(const MemoryReservation&) = delete;
+    MemoryReservation(MemoryReservation&& other) noexcept;
+    MemoryReservation& operator=(MemoryReservation&& other) noexcept;
+
+    /// Return the bytes to the accounting
+    void reset() noexcept;
+
+    [[nodiscard]]
+    size_t bytes() const noexcept { return bytes_; }
+
+private:
+    MemoryComponent component_ = MemoryComponent::ImageReaders;
+    size_t bytes_ = 0;
+};
+
+/// Set the global budget new streams plan against (0 = unlimited). Lowering it never revokes
+/// existing reservations; it only shapes streams started afterwards.
+void setMemoryBudget(int64_t bytes) noexcept;
+
+/// Bytes a new stream may still reserve (INT64_MAX when unlimited, 0 once over budget).
+/// Planning and reserving are not atomic, so concurrent starts can overshoot by one stream.
+[[nodiscard]]
+int64_t memoryBudgetAvailable() noexcept;
+
+/// Count a stream started in a reduced configuration
+void recordMemoryDegradedStream() noexcept;
+
+/// Count a stream refused because its smallest configuration exceeded the budget
+void recordMemoryRefusedStream() noexcept;
+
+/// Current per-component reservations, peaks and budget counters
+[[nodiscard]]
+MemoryUsage getMemoryUsage() noexcept;
+
+}  // namespace nativesensor
@@ -1,81 +1,226 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace nativesensor {
 
+/// Cache line size assumed for padding shared state (arm64 cores in current XR SoCs)
+constexpr size_t kCacheLineSize = 64;
+
+/// What a RingBuffer does when the producer finds it full
+enum class RingOverflow {
+    Reject,             // push() fails and leaves the queued elements alone
+    OverwriteOldest     // push() always succeeds; the oldest element is lost
+};
+
+namespace detail {
+
+/// Uninitialized storage for one element, constructed in place by the producer
+template<typename T>
+struct RingStorageSlot {
+    alignas(T) unsigned char bytes[sizeof(T)];
+
+    T* get() noexcept { return std::launder(reinterpret_cast<T*>(bytes)); }
+};
+
+/// Element plus sequence number for overwrite mode. The producer may rewrite a slot the
+/// consumer is reading, so the payload is held as relaxed atomic words (as in SeqLock) and
+/// torn reads are detected through the sequence rather than being a data race.
+template<typename T>
+struct RingSequencedSlot {
+    static constexpr size_t kWordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence{0};  // 2 * index + 1 while writing, 2 * index + 2 once written
+    std::array<std::atomic<uint64_t>, kWordCount> words{};
+};
+
+}  // namespace detail
+
 /// Lock-free single-producer single-consumer ring buffer for high-frequency sensor data.
-/// Uses power-of-two size for efficient modulo via bitwise AND.
-template<typename T, size_t Capacity>
+/// Uses power-of-two size for efficient modulo via bitwise AND; all Capacity slots are usable.
+///
+/// Producer and consumer indices live on separate cache lines, each with a private copy of
+/// the opposite index, so the two threads only touch each other's line when the cached copy
+/// says the ring looks full (or empty). Elements are constructed in place by emplace()/push()
+/// and moved out by pop(), so resource-owning payloads such as frame handles are released as
+/// soon as they leave the ring.
+///
+/// In OverwriteOldest mode the producer never waits for the consumer and never writes the
+/// consumer's index: each slot carries a sequence number and the consumer skips ahead when it
+/// finds it has been lapped. That mode requires a trivially copyable payload.
+template<typename T, size_t Capacity, RingOverflow Overflow = RingOverflow::Reject>
 class [[maybe_unused]] RingBuffer {
     static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
     static_assert(Capacity > 0, "Capacity must be positive");
+    static_assert(Overflow == RingOverflow::Reject || std::is_trivially_copyable_v<T>,
+                  "OverwriteOldest requires a trivially copyable payload");
+
+    static constexpr bool kOverwrite = Overflow == RingOverflow::OverwriteOldest;
 
 public:
-    RingBuffer() noexcept : head_(0), tail_(0) {}
+    RingBuffer() noexcept = default;
 
-    /// Push a new element (producer side). Returns false if buffer is full.
+    ~RingBuffer() {
+        if constexpr (!kOverwrite && !std::is_trivially_destructible_v<T>) {
+            const size_t head = producer_.head.load(std::memory_order_acquire);
+            for (size_t i = consumer_.tail.load(std::memory_order_relaxed); i != head; ++i) {
+                slots_[i & kMask].get()->~T();
+            }
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /// Construct an element in place (producer side).
+    /// Reject: returns false if the buffer is full, leaving args untouched.
+    /// OverwriteOldest: always stores; returns false if the oldest element was discarded.
+    template<typename... Args>
     [[maybe_unused]]
-    bool push(const T& item) noexcept {
-        const size_t currentHead = head_.load(std::memory_order_relaxed);
-        const size_t nextHead = (currentHead + 1) & kMask;
+    bool emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        const size_t head = producer_.head.load(std::memory_order_relaxed);
 
-        if (nextHead == tail_.load(std::memory_order_acquire)) {
-            return false;
+        if constexpr (kOverwrite) {
+            const bool displaced = !hasSpace(head, 1);
+            write(head, makeValue(std::forward<Args>(args)...));
+            producer_.head.store(head + 1, std::memory_order_release);
+            return !displaced;
+        } else {
+            if (!hasSpace(head, 1)) {
+                return false;
+            }
+            construct(slots_[head & kMask], std::forward<Args>(args)...);
+            producer_.head.store(head + 1, std::memory_order_release);
+            return true;
         }
+    }
 
-        buffer_[currentHead] = item;
-        head_.store(nextHead, std::memory_order_release);
-        return true;
+    /// Push a copy (producer side); see emplace() for the return value
+    [[maybe_unused]]
+    bool push(const T& item) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        return emplace(item);
     }
 
-    /// Push with overwrite (drops oldest if full)
+    /// Push by move (producer side). When rejected, item is left untouched.
     [[maybe_unused]]
-    void pushOverwrite(const T& item) noexcept {
-        const size_t currentHead = head_.load(std::memory_order_relaxed);
-        const size_t nextHead = (currentHead + 1) & kMask;
+    bool push(T&& item) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        return emplace(std::move(item));
+    }
 
-        if (nextHead == tail_.load(std::memory_order_acquire)) {
-            tail_.store((tail_.load(std::memory_order_relaxed) + 1) & kMask,
-                       std::memory_order_release);
-        }
+    /// Copy up to count elements in with a single index publish (producer side).
+    /// @return Elements stored without loss: Reject stops at the first full slot;
+    ///         OverwriteOldest stores all of them and subtracts those that displaced older ones
+    [[maybe_unused]]
+    size_t pushBulk(const T* items, size_t count) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        const size_t head = producer_.head.load(std::memory_order_relaxed);
 
-        buffer_[currentHead] = item;
-        head_.store(nextHead, std::memory_order_release);
+        if constexpr (kOverwrite) {
+            // Only the newest Capacity items can survive; older ones would be overwritten at once
+            const size_t skipped = count > Capacity ? count - Capacity : 0;
+            const size_t stored = count - skipped;
+            size_t displaced = skipped;
+            if (!hasSpace(head, stored)) {
+                displaced += stored - freeSlots(head);
+            }
+            for (size_t i = 0; i < stored; ++i) {
+                write(head + i, items[skipped + i]);
+            }
+            producer_.head.store(head + stored, std::memory_order_release);
+            return count - displaced;
+        } else {
+            if (!hasSpace(head, count)) {
+                count = freeSlots(head);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                construct(slots_[(head + i) & kMask], items[i]);
+            }
+            producer_.head.store(head + count, std::memory_order_release);
+            return count;
+        }
     }
 
-    /// Pop an element (consumer side). Returns false if buffer is empty.
+    /// Pop the oldest element (consumer side). Returns false if buffer is empty.
     [[maybe_unused]]
-    bool pop(T& item) noexcept {
-        const size_t currentTail = tail_.load(std::memory_order_relaxed);
+    bool pop(T& item) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        if constexpr (kOverwrite) {
+            return popSequenced(item);
+        } else {
+            const size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+            if (available(tail, 1) == 0) {
+                return false;
+            }
 
-        if (currentTail == head_.load(std::memory_order_acquire)) {
-            return false;
+            // Move out so resource-owning payloads (e.g. frame handles) leave the ring at once
+            T* slot = slots_[tail & kMask].get();
+            item = std::move(*slot);
+            slot->~T();
+            consumer_.tail.store(tail + 1, std::memory_order_release);
+            return true;
         }
+    }
 
-        item = buffer_[currentTail];
-        tail_.store((currentTail + 1) & kMask, std::memory_order_release);
-        return true;
+    /// Move up to maxCount of the oldest elements into out, in order (consumer side).
+    /// Reject mode publishes the consumed slots back to the producer once for the whole batch.
+    /// @return Number of elements written
+    [[maybe_unused]]
+    size_t popBulk(T* out, size_t maxCount) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        if constexpr (kOverwrite) {
+            size_t count = 0;
+            while (count < maxCount && popSequenced(out[count])) {
+                ++count;
+            }
+            return count;
+        } else {
+            const size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+            const size_t count = available(tail, maxCount);
+            for (size_t i = 0; i < count; ++i) {
+                T* slot = slots_[(tail + i) & kMask].get();
+                out[i] = std::move(*slot);
+                slot->~T();
+            }
+            consumer_.tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
     }
 
     [[nodiscard]] [[maybe_unused]]
     bool empty() const noexcept {
-        return head_.load(std::memory_order_acquire) ==
-               tail_.load(std::memory_order_acquire);
+        return producer_.head.load(std::memory_order_acquire) ==
+               consumer_.tail.load(std::memory_order_acquire);
     }
 
+    /// Queued element count (approximate while the other side is active)
     [[nodiscard]] [[maybe_unused]]
     size_t size() const noexcept {
-        const size_t h = head_.load(std::memory_order_acquire);
-        const size_t t = tail_.load(std::memory_order_acquire);
-        return (h - t) & kMask;
+        const size_t t = consumer_.tail.load(std::memory_order_acquire);
+        const size_t h = producer_.head.load(std::memory_order_acquire);
+        // A lapped consumer's tail trails by more than Capacity until its next pop
+        return std::min(h - t, Capacity);
     }
 
+    /// Discard every queued element (consumer side)
     [[maybe_unused]]
     void clear() noexcept {
-        tail_.store(head_.load(std::memory_order_relaxed), std::memory_order_release);
+        if constexpr (kOverwrite) {
+            const size_t head = producer_.head.load(std::memory_order_acquire);
+            consumer_.cachedHead = head;
+            consumer_.tail.store(head, std::memory_order_release);
+        } else {
+            const size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+            const size_t count = available(tail, Capacity);
+            for (size_t i = 0; i < count; ++i) {
+                slots_[(tail + i) & kMask].get()->~T();
+            }
+            consumer_.tail.store(tail + count, std::memory_order_release);
+        }
     }
 
     [[nodiscard]] [[maybe_unused]]
@@ -84,10 +229,118 @@ public:
 private:
     static constexpr size_t kMask = Capacity - 1;
 
-    std::array<T, Capacity> buffer_;
-    std::atomic<size_t> head_;
-    std::atomic<size_t> tail_;
+    using Slot = std::conditional_t<kOverwrite, detail::RingSequencedSlot<T>,
+                                    detail::RingStorageSlot<T>>;
+
+    /// Producer-owned line: head and the producer's last view of tail
+    struct alignas(kCacheLineSize) ProducerIndex {
+        std::atomic<size_t> head{0};
+        size_t cachedTail = 0;
+    };
+
+    /// Consumer-owned line: tail and the consumer's last view of head
+    struct alignas(kCacheLineSize) ConsumerIndex {
+        std::atomic<size_t> tail{0};
+        size_t cachedHead = 0;
+    };
+
+    /// Whether count more elements fit after head, refreshing the cached tail only if needed
+    bool hasSpace(size_t head, size_t count) noexcept {
+        if (freeSlots(head) >= count) {
+            return true;
+        }
+        producer_.cachedTail = consumer_.tail.load(std::memory_order_acquire);
+        return freeSlots(head) >= count;
+    }
+
+    /// Free slots per the cached tail (a lapped overwrite-mode consumer counts as full)
+    size_t freeSlots(size_t head) const noexcept {
+        return Capacity - std::min(head - producer_.cachedTail, Capacity);
+    }
+
+    /// Elements (up to wanted) ready after tail, refreshing the cached head only if needed
+    size_t available(size_t tail, size_t wanted) noexcept {
+        size_t ready = consumer_.cachedHead - tail;
+        if (ready < wanted) {
+            consumer_.cachedHead = producer_.head.load(std::memory_order_acquire);
+            ready = consumer_.cachedHead - tail;
+        }
+        return std::min(ready, wanted);
+    }
+
+    template<typename... Args>
+    static void construct(Slot& slot, Args&&... args)
+        noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        if constexpr (std::is_constructible_v<T, Args...>) {
+            ::new (static_cast<void*>(slot.bytes)) T(std::forward<Args>(args)...);
+        } else {
+            // Aggregates such as frame records (parenthesized aggregate init is C++20)
+            ::new (static_cast<void*>(slot.bytes)) T{std::forward<Args>(args)...};
+        }
+    }
+
+    template<typename... Args>
+    static T makeValue(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        if constexpr (std::is_constructible_v<T, Args...>) {
+            return T(std::forward<Args>(args)...);
+        } else {
+            return T{std::forward<Args>(args)...};
+        }
+    }
+
+    /// Overwrite mode: publish value at logical index (seqlock write of one slot)
+    void write(size_t index, const T& value) noexcept {
+        std::array<uint64_t, Slot::kWordCount> staging{};
+        std::memcpy(staging.data(), &value, sizeof(T));
+
+        Slot& slot = slots_[index & kMask];
+        const auto sequence = static_cast<uint64_t>(index) * 2;
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < Slot::kWordCount; ++i) {
+            slot.words[i].store(staging[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /// Overwrite mode: read the oldest intact element, skipping anything the producer lapped
+    bool popSequenced(T& item) noexcept {
+        size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+        for (;;) {
+            if (available(tail, 1) == 0) {
+                consumer_.tail.store(tail, std::memory_order_release);
+                return false;
+            }
+            const size_t head = consumer_.cachedHead;
+            if (head - tail > Capacity) {
+                tail = head - Capacity;
+            }
+
+            const Slot& slot = slots_[tail & kMask];
+            const uint64_t expected = static_cast<uint64_t>(tail) * 2 + 2;
+            std::array<uint64_t, Slot::kWordCount> staging;
+            if (slot.sequence.load(std::memory_order_acquire) == expected) {
+                for (size_t i = 0; i < Slot::kWordCount; ++i) {
+                    staging[i] = slot.words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+                    std::memcpy(&item, staging.data(), sizeof(T));
+                    consumer_.tail.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+
+            // Rewritten under us: the producer is a full lap ahead, so jump past the slot it
+            // may be writing now to the oldest one that is still intact
+            consumer_.cachedHead = producer_.head.load(std::memory_order_acquire);
+            tail = std::max(tail + 1, consumer_.cachedHead - (Capacity - 1));
+        }
+    }
+
+    ProducerIndex producer_;
+    ConsumerIndex consumer_;
+    alignas(kCacheLineSize) std::array<Slot, Capacity> slots_;
 };
 
 }  // namespace nativesensor
-
@@ -11,8 +11,8 @@ using TimestampNs = int64_t;
 enum class SensorType : int32_t {
     Accelerometer = 1,
     Gyroscope = 4,
-    AccelerometerUncalibrated [[maybe_unused]] = 35,  // Reserved for uncalibrated sensor support
-    GyroscopeUncalibrated [[maybe_unused]] = 16       // Reserved for uncalibrated sensor support
+    AccelerometerUncalibrated = 35,
+    GyroscopeUncalibrated = 16
 };
 
 /// Sensor metadata for enumeration
@@ -24,6 +24,7 @@ struct SensorInfo {
     int32_t minDelayUs;
     float maxFrequencyHz;
     int32_t fifoReserved;
+    int32_t directReportRateLevel;  // Highest shared-memory direct report level (0 = unsupported)
 };
 
 }  // namespace nativesensor
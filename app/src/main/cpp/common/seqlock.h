@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace nativesensor {
+
+/// Single-writer sequence lock for publishing small trivially copyable snapshots.
+/// The writer never blocks; readers retry until they observe a consistent copy.
+/// The payload is stored as relaxed atomic words so torn reads are detected
+/// through the sequence counter rather than being a data race.
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock() noexcept {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    explicit SeqLock(const T& initial) noexcept : SeqLock() {
+        store(initial);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /// Publish a new value (single writer only)
+    void store(const T& value) noexcept {
+        std::array<uint64_t, kWordCount> staging{};
+        std::memcpy(staging.data(), &value, sizeof(T));
+
+        const uint32_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < kWordCount; ++i) {
+            words_[i].store(staging[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Read a consistent copy (any number of readers, never blocks the writer)
+    [[nodiscard]]
+    T load() const noexcept {
+        std::array<uint64_t, kWordCount> staging{};
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = sequence_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < kWordCount; ++i) {
+                staging[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+        } while ((before & 1u) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, staging.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t kWordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence_{0};
+    std::array<std::atomic<uint64_t>, kWordCount> words_;
+};
+
+}  // namespace nativesensor
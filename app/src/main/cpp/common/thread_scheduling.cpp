@@ -0,0 +1,178 @@
+#include "thread_scheduling.h"
+
+#include <android/log.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Sched";
+
+constexpr int32_t kMinNice = -20;
+constexpr int32_t kMaxNice = 19;
+constexpr int kMaxMaskCpus = 64;
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+int32_t currentThreadId() noexcept {
+    return static_cast<int32_t>(gettid());
+}
+
+ThreadSchedulingResult applyThreadScheduling(int32_t tid, const ThreadSchedulingConfig& config) {
+    const pid_t target = tid > 0 ? static_cast<pid_t>(tid) : gettid();
+    ThreadSchedulingResult result;
+
+    bool realtime = false;
+    if (config.realtime) {
+        sched_param param{};
+        param.sched_priority = std::clamp(config.realtimePriority,
+                                          sched_get_priority_min(SCHED_FIFO),
+                                          sched_get_priority_max(SCHED_FIFO));
+        // Reset on fork so threads spawned from a realtime thread start out ordinary
+        if (sched_setscheduler(target, SCHED_FIFO | SCHED_RESET_ON_FORK, &param) == 0) {
+            realtime = true;
+            result.appliedMask |= kThreadSchedulingRealtime;
+        } else {
+            result.failedMask |= kThreadSchedulingRealtime;
+            LOGW("SCHED_FIFO refused for tid %d (%s), using nice %d", target,
+                 std::strerror(errno), config.niceValue);
+        }
+    } else {
+        const int policy = sched_getscheduler(target);
+        if (policy == SCHED_FIFO || policy == SCHED_RR) {
+            sched_param param{};
+            sched_setscheduler(target, SCHED_OTHER, &param);
+        }
+    }
+
+    if (!realtime) {
+        const int niceValue = std::clamp(config.niceValue, kMinNice, kMaxNice);
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(target), niceValue) == 0) {
+            result.appliedMask |= kThreadSchedulingNice;
+        } else {
+            result.failedMask |= kThreadSchedulingNice;
+            LOGW("Nice %d refused for tid %d (%s)", niceValue, target, std::strerror(errno));
+        }
+    }
+
+    if (config.cpuMask != 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; cpu < kMaxMaskCpus && cpu < CPU_SETSIZE; ++cpu) {
+            if (config.cpuMask & (1ULL << cpu)) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        if (sched_setaffinity(target, sizeof(cpus), &cpus) == 0) {
+            result.appliedMask |= kThreadSchedulingAffinity;
+        } else {
+            result.failedMask |= kThreadSchedulingAffinity;
+            LOGW("CPU mask 0x%llx refused for tid %d (%s)",
+                 static_cast<unsigned long long>(config.cpuMask), target, std::strerror(errno));
+        }
+    }
+
+    LOGI("Scheduling tid %d: nice=%d realtime=%d cpuMask=0x%llx (applied=0x%x failed=0x%x)",
+         target, config.niceValue, realtime, static_cast<unsigned long long>(config.cpuMask),
+         result.appliedMask, result.failedMask);
+    return result;
+}
+
+bool readThreadSchedulingStats(int32_t tid, ThreadSchedulingStats& out) {
+    if (tid <= 0) {
+        return false;
+    }
+
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/self/task/%d/schedstat", tid);
+    FILE* file = std::fopen(path, "re");
+    if (!file) {
+        return false;
+    }
+    long long runTimeNs = 0;
+    long long waitNs = 0;
+    long long timeslices = 0;
+    const int fields = std::fscanf(file, "%lld %lld %lld", &runTimeNs, &waitNs, &timeslices);
+    std::fclose(file);
+    if (fields != 3) {
+        return false;
+    }
+
+    out.tid = tid;
+    // -1 (thread gone or not visible) is reported as such, not masked into a policy
+    const int policy = sched_getscheduler(tid);
+    out.policy = policy < 0 ? -1 : policy & ~SCHED_RESET_ON_FORK;
+    errno = 0;
+    const int niceValue = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+    out.niceValue = errno == 0 ? niceValue : 0;
+    out.runTimeNs = runTimeNs;
+    out.runQueueWaitNs = waitNs;
+    out.timeslices = timeslices;
+    return true;
+}
+
+bool PerformanceHintSession::open(const std::vector<int32_t>& tids,
+                                  int64_t targetWorkDurationNs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (session_) {
+        APerformanceHint_updateTargetWorkDuration(session_, targetWorkDurationNs);
+        APerformanceHint_setThreads(session_, tids.data(), tids.size());
+        return true;
+    }
+    if (tids.empty()) {
+        return false;
+    }
+
+    APerformanceHintManager* manager = APerformanceHint_getManager();
+    if (!manager || APerformanceHint_getPreferredUpdateRateNanos(manager) < 0) {
+        LOGW("Performance hint sessions are not supported on this device");
+        return false;
+    }
+    session_ = APerformanceHint_createSession(manager, tids.data(), tids.size(),
+                                              targetWorkDurationNs);
+    if (!session_) {
+        LOGW("Failed to create performance hint session for %zu threads", tids.size());
+        return false;
+    }
+    LOGI("Performance hint session opened (%zu threads, target %lld ns)", tids.size(),
+         static_cast<long long>(targetWorkDurationNs));
+    return true;
+}
+
+void PerformanceHintSession::setThreads(const std::vector<int32_t>& tids) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (session_ && !tids.empty()) {
+        APerformanceHint_setThreads(session_, tids.data(), tids.size());
+    }
+}
+
+void PerformanceHintSession::reportActualWorkDuration(int64_t durationNs) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (session_ && durationNs > 0) {
+        APerformanceHint_reportActualWorkDuration(session_, durationNs);
+    }
+}
+
+void PerformanceHintSession::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (session_) {
+        APerformanceHint_closeSession(session_);
+        session_ = nullptr;
+        LOGI("Performance hint session closed");
+    }
+}
+
+bool PerformanceHintSession::isOpen() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return session_ != nullptr;
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <android/performance_hint.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace nativesensor {
+
+/// Scheduling requested for a native worker thread. The default leaves the thread as created.
+struct ThreadSchedulingConfig {
+    int32_t niceValue = 0;              // setpriority() value, -20 (most urgent) to 19
+    bool realtime = false;              // SCHED_FIFO if the process may use it, else niceValue
+    int32_t realtimePriority = 1;       // SCHED_FIFO priority, 1..99
+    uint64_t cpuMask = 0;               // Bit n allows CPU n; 0 keeps the inherited affinity
+
+    /// True if the thread should be left as created
+    [[nodiscard]]
+    bool isDefault() const noexcept { return niceValue == 0 && !realtime && cpuMask == 0; }
+};
+
+/// ThreadSchedulingResult::appliedMask
+constexpr uint32_t kThreadSchedulingNice = 1u << 0;
+constexpr uint32_t kThreadSchedulingRealtime = 1u << 1;
+constexpr uint32_t kThreadSchedulingAffinity = 1u << 2;
+
+/// Parts of a ThreadSchedulingConfig that took effect
+struct ThreadSchedulingResult {
+    uint32_t appliedMask = 0;           // kThreadScheduling* flags
+    uint32_t failedMask = 0;            // Requested but refused by the kernel
+};
+
+/// Scheduler view of one thread. Run-queue wait is the time spent runnable but not running,
+/// i.e. the scheduling latency the thread observed.
+struct ThreadSchedulingStats {
+    int32_t tid = 0;
+    int32_t policy = 0;                 // SCHED_OTHER, SCHED_FIFO, ...; -1 if unreadable
+    int32_t niceValue = 0;
+    int64_t runTimeNs = 0;              // Cumulative on-CPU time
+    int64_t runQueueWaitNs = 0;         // Cumulative runnable-but-waiting time
+    int64_t timeslices = 0;             // Times the thread was scheduled in
+
+    /// Mean scheduling latency per wakeup (microseconds)
+    [[nodiscard]]
+    float meanRunQueueWaitUs() const noexcept {
+        return timeslices > 0
+            ? static_cast<float>(static_cast<double>(runQueueWaitNs) / timeslices / 1000.0)
+            : 0.0f;
+    }
+};
+
+/// Kernel id of the calling thread
+int32_t currentThreadId() noexcept;
+
+/// Apply config to a thread of this process (0 = calling thread). SCHED_FIFO is refused to
+/// ordinary apps on most devices; niceValue is then applied instead, so a realtime request
+/// always degrades to "as urgent as allowed".
+ThreadSchedulingResult applyThreadScheduling(int32_t tid, const ThreadSchedulingConfig& config);
+
+/// Read the policy, nice value and /proc schedstat counters of a thread of this process
+/// @return false if the thread has exited or the kernel exposes no schedstat
+bool readThreadSchedulingStats(int32_t tid, ThreadSchedulingStats& out);
+
+/// APerformanceHint session covering the threads of one pipeline. The owner reports how long
+/// each unit of work took against a target duration so the system can pick CPU frequency and
+/// placement for those threads. Thread-safe; every call is a no-op while closed.
+class PerformanceHintSession {
+public:
+    PerformanceHintSession() = default;
+    ~PerformanceHintSession() { close(); }
+
+    PerformanceHintSession(const PerformanceHintSession&) = delete;
+    PerformanceHintSession& operator=(const PerformanceHintSession&) = delete;
+
+    /// Open (or retarget) the session for the given threads
+    /// @return false if hint sessions are unsupported or tids is empty
+    bool open(const std::vector<int32_t>& tids, int64_t targetWorkDurationNs);
+
+    /// Replace the threads of an open session (the set changed as pipelines start and stop)
+    void setThreads(const std::vector<int32_t>& tids);
+
+    /// Report the duration of one unit of work
+    void reportActualWorkDuration(int64_t durationNs) noexcept;
+
+    void close();
+
+    [[nodiscard]]
+    bool isOpen() const noexcept;
+
+private:
+    mutable std::mutex mutex_;
+    APerformanceHintSession* session_ = nullptr;
+};
+
+}  // namespace nativesensor
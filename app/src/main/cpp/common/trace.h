@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+// Native tracing for Perfetto/systrace via the NDK ATrace API (atrace category "app").
+// Built with NATIVESENSOR_TRACING=1 unless the NATIVESENSOR_ENABLE_TRACING CMake option is
+// off, in which case every macro expands to nothing and its arguments are never evaluated.
+// When compiled in, each macro costs one ATrace_isEnabled() check while no trace is recording.
+//
+//   NS_TRACE_SCOPE(name)            Slice on the calling thread until the end of the scope
+//   NS_TRACE_COUNTER(name, value)   Counter track sample (queue depths, batch sizes, ...)
+//   NS_TRACE_FLOW_BEGIN(name, id)   Start an async slice that may end on another thread;
+//   NS_TRACE_FLOW_END(name, id)     name and id (e.g. frame number) must match at both ends
+//
+// Names must be string literals or otherwise outlive the trace call.
+
+#if NATIVESENSOR_TRACING
+
+#include <android/trace.h>
+
+namespace nativesensor {
+
+/// RAII ATrace section; skips begin/end entirely while tracing is off
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) noexcept : active_(ATrace_isEnabled()) {
+        if (active_) {
+            ATrace_beginSection(name);
+        }
+    }
+
+    ~TraceScope() {
+        if (active_) {
+            ATrace_endSection();
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const bool active_;
+};
+
+/// Async section cookies are 32-bit; frame numbers wrap harmlessly
+inline int32_t traceCookie(int64_t id) noexcept {
+    return static_cast<int32_t>(id & 0x7fffffff);
+}
+
+}  // namespace nativesensor
+
+#define NS_TRACE_CONCAT_INNER(a, b) a##b
+#define NS_TRACE_CONCAT(a, b) NS_TRACE_CONCAT_INNER(a, b)
+
+#define NS_TRACE_SCOPE(name) \
+    ::nativesensor::TraceScope NS_TRACE_CONCAT(nsTraceScope_, __LINE__)(name)
+
+#define NS_TRACE_COUNTER(name, value)                                       \
+    do {                                                                    \
+        if (ATrace_isEnabled()) {                                           \
+            ATrace_setCounter((name), static_cast<int64_t>(value));         \
+        }                                                                   \
+    } while (0)
+
+#define NS_TRACE_FLOW_BEGIN(name, id)                                       \
+    do {                                                                    \
+        if (ATrace_isEnabled()) {                                           \
+            ATrace_beginAsyncSection((name), ::nativesensor::traceCookie(id)); \
+        }                                                                   \
+    } while (0)
+
+#define NS_TRACE_FLOW_END(name, id)                                         \
+    do {                                                                    \
+        if (ATrace_isEnabled()) {                                           \
+            ATrace_endAsyncSection((name), ::nativesensor::traceCookie(id)); \
+        }                                                                   \
+    } while (0)
+
+#else
+
+#define NS_TRACE_SCOPE(name) static_cast<void>(0)
+#define NS_TRACE_COUNTER(name, value) static_cast<void>(0)
+#define NS_TRACE_FLOW_BEGIN(name, id) static_cast<void>(0)
+#define NS_TRACE_FLOW_END(name, id) static_cast<void>(0)
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#include "sensor_types.h"
+
+namespace nativesensor {
+
+/// Attitude estimator run on the sensor thread
+enum class FusionAlgorithm : int32_t {
+    Madgwick = 0,       // Gradient-descent correction toward the measured gravity
+    Mahony = 1          // PI correction of the gyro rate from the gravity error
+};
+
+/// Sensor fusion options (see ImuStartOptions::fusion)
+struct FusionConfig {
+    bool enabled = true;
+    FusionAlgorithm algorithm = FusionAlgorithm::Madgwick;
+    float madgwickBeta = 0.033f;    // Correction gain (rad/s); higher trusts the accelerometer more
+    float mahonyKp = 1.0f;          // Proportional gain
+    float mahonyKi = 0.0f;          // Integral gain (gyro bias estimation), 0 disables it
+};
+
+/// Orientation of the device at one gyroscope sample, also the packed JNI history record
+/// (native byte order, 48 bytes, no padding).
+/// Layout: int64 timestampNs | float qw qx qy qz | float gravity xyz | float linear accel xyz
+///
+/// The quaternion rotates device coordinates into a world frame whose Z axis points up; yaw is
+/// relative to the device heading at start since no magnetometer is fused. Gravity and linear
+/// acceleration are in device coordinates (m/s²) and sum to the latest accelerometer reading.
+/// Kept an aggregate without member initializers so SeqLock and the ring can memcpy it.
+struct OrientationSample {
+    TimestampNs timestampNs;        // Hardware timestamp of the gyroscope sample
+    float qw;
+    float qx;
+    float qy;
+    float qz;
+    float gravityX;
+    float gravityY;
+    float gravityZ;
+    float linearX;
+    float linearY;
+    float linearZ;
+};
+static_assert(sizeof(OrientationSample) == 48, "OrientationSample layout is part of the JNI contract");
+
+}  // namespace nativesensor
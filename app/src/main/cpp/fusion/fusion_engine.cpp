@@ -0,0 +1,53 @@
+#include "fusion_engine.h"
+
+#include "trace.h"
+
+namespace nativesensor {
+
+void FusionEngine::reset(const FusionConfig& config) noexcept {
+    filter_.reset(config);
+    OrientationSample identity{};
+    identity.qw = 1.0f;
+    latest_.store(identity);
+    history_.clear();
+    historyOverflows_.store(0, std::memory_order_release);
+}
+
+void FusionEngine::process(const ImuSample* samples, size_t count) noexcept {
+    NS_TRACE_SCOPE("FusionEngine::process");
+
+    OrientationSample newest{};
+    bool produced = false;
+    int64_t overflows = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ImuSample& sample = samples[i];
+        if (sample.sensorType == SensorType::Accelerometer) {
+            filter_.updateAccel(sample);
+            continue;
+        }
+        if (sample.sensorType != SensorType::Gyroscope || !filter_.updateGyro(sample, newest)) {
+            continue;
+        }
+        produced = true;
+        if (!history_.push(newest)) {
+            overflows++;
+        }
+    }
+
+    // Publish the latest value once per batch, like the raw samples
+    if (produced) {
+        latest_.store(newest);
+    }
+    if (overflows > 0) {
+        historyOverflows_.fetch_add(overflows, std::memory_order_relaxed);
+    }
+}
+
+size_t FusionEngine::drainHistory(OrientationSample* out, size_t capacity) noexcept {
+    if (!out || capacity == 0) {
+        return 0;
+    }
+    return history_.popBulk(out, capacity);
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "fusion_data.h"
+#include "orientation_filter.h"
+#include "ring_buffer.h"
+#include "seqlock.h"
+
+namespace nativesensor {
+
+/// Sensor fusion stage of ImuManager. The IMU writer (sensor thread, or the serialized direct
+/// channel pump) feeds every batch through process(); orientation is published per gyroscope
+/// sample the same way raw samples are: a SeqLock latest value for pollers and an
+/// overwrite-oldest history ring for consumers that want every pose.
+class FusionEngine {
+public:
+    /// History depth (about 4 s at 1 kHz)
+    static constexpr size_t kHistoryCapacity = 4096;
+
+    FusionEngine() = default;
+
+    FusionEngine(const FusionEngine&) = delete;
+    FusionEngine& operator=(const FusionEngine&) = delete;
+
+    /// Reset the filter and drop history. Only while no writer runs.
+    void reset(const FusionConfig& config) noexcept;
+
+    /// Consume a batch in timestamp order (single writer)
+    void process(const ImuSample* samples, size_t count) noexcept;
+
+    /// Latest orientation (lock-free; timestampNs is 0 before the first gyro step)
+    [[nodiscard]]
+    OrientationSample getLatest() const noexcept { return latest_.load(); }
+
+    /// Move every orientation produced since the previous drain into out (timestamp order)
+    /// Consumers must be serialized by the caller.
+    /// @return Number of records written
+    size_t drainHistory(OrientationSample* out, size_t capacity) noexcept;
+
+    /// Orientations overwritten because the history was not drained in time (cumulative)
+    [[nodiscard]]
+    int64_t getHistoryOverflowCount() const noexcept {
+        return historyOverflows_.load(std::memory_order_acquire);
+    }
+
+private:
+    OrientationFilter filter_;      // Writer only
+    SeqLock<OrientationSample> latest_;
+    RingBuffer<OrientationSample, kHistoryCapacity, RingOverflow::OverwriteOldest> history_;
+    std::atomic<int64_t> historyOverflows_{0};
+};
+
+}  // namespace nativesensor
@@ -0,0 +1,186 @@
+#include "orientation_filter.h"
+
+#include <cmath>
+
+namespace {
+
+constexpr double kNsPerSecond = 1e9;
+
+using nativesensor::Vec4f;
+
+inline Vec4f splat(float s) noexcept {
+    return {{s, s, s, s}};
+}
+
+/// a + b * s, lane-wise
+inline Vec4f madd(const Vec4f& a, const Vec4f& b, const Vec4f& s) noexcept {
+    Vec4f r;
+    for (int i = 0; i < 4; ++i) {
+        r.v[i] = a.v[i] + b.v[i] * s.v[i];
+    }
+    return r;
+}
+
+inline float dot(const Vec4f& a, const Vec4f& b) noexcept {
+    float sum = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        sum += a.v[i] * b.v[i];
+    }
+    return sum;
+}
+
+/// a scaled to unit length; a zero vector is returned unchanged
+inline Vec4f normalized(const Vec4f& a) noexcept {
+    const float norm2 = dot(a, a);
+    if (norm2 <= 0.0f) {
+        return a;
+    }
+    return madd(splat(0.0f), a, splat(1.0f / std::sqrt(norm2)));
+}
+
+/// Rate of change of q for body rates (gx, gy, gz): 0.5 * q ⊗ (0, g), as three lane-wise
+/// multiply-adds over permutations of q
+inline Vec4f quaternionRate(const Vec4f& q, float gx, float gy, float gz) noexcept {
+    const float w = q.v[0], x = q.v[1], y = q.v[2], z = q.v[3];
+    const Vec4f byX{{-x, w, z, -y}};
+    const Vec4f byY{{-y, -z, w, x}};
+    const Vec4f byZ{{-z, y, -x, w}};
+    Vec4f rate = madd(splat(0.0f), byX, splat(0.5f * gx));
+    rate = madd(rate, byY, splat(0.5f * gy));
+    return madd(rate, byZ, splat(0.5f * gz));
+}
+
+}  // namespace
+
+namespace nativesensor {
+
+void OrientationFilter::reset(const FusionConfig& config) noexcept {
+    config_ = config;
+    q_ = {{1.0f, 0.0f, 0.0f, 0.0f}};
+    accel_[0] = accel_[1] = accel_[2] = 0.0f;
+    integralError_[0] = integralError_[1] = integralError_[2] = 0.0f;
+    hasAccel_ = false;
+    aligned_ = false;
+    lastGyroNs_ = 0;
+}
+
+void OrientationFilter::updateAccel(const ImuSample& accel) noexcept {
+    accel_[0] = accel.x;
+    accel_[1] = accel.y;
+    accel_[2] = accel.z;
+    hasAccel_ = accel.x != 0.0f || accel.y != 0.0f || accel.z != 0.0f;
+
+    // Level the initial orientation from gravity instead of converging to it over seconds
+    if (hasAccel_ && !aligned_) {
+        alignToGravity(accel.x, accel.y, accel.z);
+        aligned_ = true;
+    }
+}
+
+bool OrientationFilter::updateGyro(const ImuSample& gyro, OrientationSample& out) noexcept {
+    if (lastGyroNs_ == 0) {
+        lastGyroNs_ = gyro.timestampNs;
+        return false;
+    }
+    const float dt = static_cast<float>(
+        static_cast<double>(gyro.timestampNs - lastGyroNs_) / kNsPerSecond);
+    lastGyroNs_ = gyro.timestampNs;
+    if (dt <= 0.0f || dt > kMaxStepSeconds) {
+        // Out of order or a gap (sensor switch, suspend): hold the orientation
+        fillOutput(gyro.timestampNs, out);
+        return true;
+    }
+
+    float gx = gyro.x;
+    float gy = gyro.y;
+    float gz = gyro.z;
+    const float w = q_.v[0], x = q_.v[1], y = q_.v[2], z = q_.v[3];
+
+    float ax = 0.0f, ay = 0.0f, az = 0.0f;
+    if (hasAccel_) {
+        const float inv = 1.0f / std::sqrt(accel_[0] * accel_[0] + accel_[1] * accel_[1] +
+                                           accel_[2] * accel_[2]);
+        ax = accel_[0] * inv;
+        ay = accel_[1] * inv;
+        az = accel_[2] * inv;
+    }
+
+    Vec4f rate;
+    if (config_.algorithm == FusionAlgorithm::Mahony) {
+        if (hasAccel_) {
+            // Half the gravity direction predicted by q, crossed with the measured one
+            const float vx = x * z - w * y;
+            const float vy = w * x + y * z;
+            const float vz = w * w - 0.5f + z * z;
+            const float ex = ay * vz - az * vy;
+            const float ey = az * vx - ax * vz;
+            const float ez = ax * vy - ay * vx;
+
+            if (config_.mahonyKi > 0.0f) {
+                integralError_[0] += 2.0f * config_.mahonyKi * ex * dt;
+                integralError_[1] += 2.0f * config_.mahonyKi * ey * dt;
+                integralError_[2] += 2.0f * config_.mahonyKi * ez * dt;
+                gx += integralError_[0];
+                gy += integralError_[1];
+                gz += integralError_[2];
+            }
+            gx += 2.0f * config_.mahonyKp * ex;
+            gy += 2.0f * config_.mahonyKp * ey;
+            gz += 2.0f * config_.mahonyKp * ez;
+        }
+        rate = quaternionRate(q_, gx, gy, gz);
+    } else {
+        rate = quaternionRate(q_, gx, gy, gz);
+        if (hasAccel_) {
+            // Gradient of the error between predicted and measured gravity direction
+            const float w2 = 2.0f * w, x2 = 2.0f * x, y2 = 2.0f * y, z2 = 2.0f * z;
+            const float w4 = 4.0f * w, x4 = 4.0f * x, y4 = 4.0f * y;
+            const float x8 = 8.0f * x, y8 = 8.0f * y;
+            const float ww = w * w, xx = x * x, yy = y * y, zz = z * z;
+            const Vec4f step{{
+                w4 * yy + y2 * ax + w4 * xx - x2 * ay,
+                x4 * zz - z2 * ax + 4.0f * ww * x - w2 * ay - x4 + x8 * xx + x8 * yy + x4 * az,
+                4.0f * ww * y + w2 * ax + y4 * zz - z2 * ay - y4 + y8 * xx + y8 * yy + y4 * az,
+                4.0f * xx * z - x2 * ax + 4.0f * yy * z - y2 * ay
+            }};
+            rate = madd(rate, normalized(step), splat(-config_.madgwickBeta));
+        }
+    }
+
+    q_ = normalized(madd(q_, rate, splat(dt)));
+    fillOutput(gyro.timestampNs, out);
+    return true;
+}
+
+void OrientationFilter::alignToGravity(float ax, float ay, float az) noexcept {
+    // Roll and pitch that put the measured gravity on the world Z axis, zero yaw
+    const float roll = std::atan2(ay, az);
+    const float pitch = std::atan2(-ax, std::sqrt(ay * ay + az * az));
+    const float cr = std::cos(roll * 0.5f), sr = std::sin(roll * 0.5f);
+    const float cp = std::cos(pitch * 0.5f), sp = std::sin(pitch * 0.5f);
+    q_ = {{cr * cp, sr * cp, cr * sp, -sr * sp}};
+}
+
+void OrientationFilter::fillOutput(TimestampNs timestampNs, OrientationSample& out) const noexcept {
+    const float w = q_.v[0], x = q_.v[1], y = q_.v[2], z = q_.v[3];
+    out.timestampNs = timestampNs;
+    out.qw = w;
+    out.qx = x;
+    out.qy = y;
+    out.qz = z;
+
+    // World Z axis expressed in device coordinates
+    out.gravityX = 2.0f * (x * z - w * y) * kStandardGravity;
+    out.gravityY = 2.0f * (w * x + y * z) * kStandardGravity;
+    out.gravityZ = (w * w - x * x - y * y + z * z) * kStandardGravity;
+
+    if (hasAccel_) {
+        out.linearX = accel_[0] - out.gravityX;
+        out.linearY = accel_[1] - out.gravityY;
+        out.linearZ = accel_[2] - out.gravityZ;
+    } else {
+        out.linearX = out.linearY = out.linearZ = 0.0f;
+    }
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "fusion_data.h"
+#include "imu_data.h"
+
+namespace nativesensor {
+
+/// Four-lane float vector holding a quaternion as (w, x, y, z). The filter math is written as
+/// whole-vector multiply-adds over this type so it maps onto one NEON register per operand.
+struct alignas(16) Vec4f {
+    float v[4];
+};
+
+/// 6-axis attitude filter (Madgwick or Mahony) fed in timestamp order from one thread.
+/// Accelerometer samples only update the gravity reference; every gyroscope sample advances
+/// the orientation by the time since the previous one and yields an OrientationSample.
+class OrientationFilter {
+public:
+    /// Gyro gaps longer than this restart integration instead of extrapolating across them
+    static constexpr float kMaxStepSeconds = 0.1f;
+
+    /// Standard gravity (m/s²) used to scale the estimated gravity vector
+    static constexpr float kStandardGravity = 9.80665f;
+
+    explicit OrientationFilter(const FusionConfig& config = {}) noexcept { reset(config); }
+
+    /// Forget the orientation; the next accelerometer sample re-levels it
+    void reset(const FusionConfig& config) noexcept;
+
+    /// Record the latest accelerometer reading (m/s²)
+    void updateAccel(const ImuSample& accel) noexcept;
+
+    /// Integrate one gyroscope reading (rad/s)
+    /// @return false for the first sample after reset, which only establishes the time base
+    bool updateGyro(const ImuSample& gyro, OrientationSample& out) noexcept;
+
+private:
+    void alignToGravity(float ax, float ay, float az) noexcept;
+    void fillOutput(TimestampNs timestampNs, OrientationSample& out) const noexcept;
+
+    FusionConfig config_;
+    Vec4f q_{{1.0f, 0.0f, 0.0f, 0.0f}};
+    float accel_[3] = {};
+    float integralError_[3] = {};   // Mahony integral term
+    bool hasAccel_ = false;
+    bool aligned_ = false;
+    TimestampNs lastGyroNs_ = 0;
+};
+
+}  // namespace nativesensor
@@ -0,0 +1,163 @@
+#include "direct_sensor_channel.h"
+
+#include <android/log.h>
+#include <android/sharedmem.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Direct";
+constexpr const char* kSharedMemoryName = "nativesensor_imu_direct";
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+namespace {
+
+int32_t loadCounter(const ASensorEvent& event) noexcept {
+    return __atomic_load_n(&event.reserved0, __ATOMIC_ACQUIRE);
+}
+
+}  // namespace
+
+DirectSensorChannel::~DirectSensorChannel() {
+    close();
+}
+
+bool DirectSensorChannel::isSupported(const ASensor* sensor) noexcept {
+    return sensor &&
+           ASensor_isDirectChannelTypeSupported(sensor, ASENSOR_DIRECT_CHANNEL_TYPE_SHARED_MEMORY) &&
+           ASensor_getHighestDirectReportRateLevel(sensor) > ASENSOR_DIRECT_RATE_STOP;
+}
+
+bool DirectSensorChannel::open(ASensorManager* manager, size_t eventCapacity) {
+    close();
+
+    if (!manager || eventCapacity == 0) {
+        return false;
+    }
+
+    manager_ = manager;
+    capacity_ = eventCapacity;
+
+    fd_ = ASharedMemory_create(kSharedMemoryName, sizeBytes());
+    if (fd_ < 0) {
+        LOGE("Failed to create shared memory (%zu bytes)", sizeBytes());
+        close();
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, sizeBytes(), PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        LOGE("Failed to map shared memory");
+        close();
+        return false;
+    }
+    events_ = static_cast<const ASensorEvent*>(mapped);
+
+    channelId_ = ASensorManager_createSharedMemoryDirectChannel(manager_, fd_, sizeBytes());
+    if (channelId_ <= 0) {
+        LOGE("Failed to create direct channel: %d", channelId_);
+        channelId_ = 0;
+        close();
+        return false;
+    }
+
+    readIndex_ = 0;
+    expectedCounter_ = 1;
+    lostEvents_ = 0;
+
+    LOGI("Direct channel %d opened (%zu events)", channelId_, capacity_);
+    return true;
+}
+
+void DirectSensorChannel::close() {
+    if (channelId_ > 0) {
+        ASensorManager_destroyDirectChannel(manager_, channelId_);
+        channelId_ = 0;
+    }
+
+    if (events_) {
+        munmap(const_cast<ASensorEvent*>(events_), sizeBytes());
+        events_ = nullptr;
+    }
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    manager_ = nullptr;
+    capacity_ = 0;
+}
+
+int32_t DirectSensorChannel::enable(const ASensor* sensor, int32_t rateLevel) {
+    if (!isOpen() || !isSupported(sensor)) {
+        return 0;
+    }
+
+    const int32_t highest = ASensor_getHighestDirectReportRateLevel(sensor);
+    const int32_t rate = rateLevel < highest ? rateLevel : highest;
+    const int32_t token = ASensorManager_configureDirectReport(manager_, sensor, channelId_, rate);
+    if (token <= 0) {
+        LOGE("Failed to configure direct report for %s: %d", ASensor_getName(sensor), token);
+        return token;
+    }
+
+    LOGI("Direct report enabled: %s (rate level %d, token %d)", ASensor_getName(sensor), rate, token);
+    return token;
+}
+
+void DirectSensorChannel::disable(const ASensor* sensor) {
+    if (isOpen() && sensor) {
+        ASensorManager_configureDirectReport(manager_, sensor, channelId_, ASENSOR_DIRECT_RATE_STOP);
+    }
+}
+
+size_t DirectSensorChannel::read(ASensorEvent* out, size_t maxEvents) noexcept {
+    if (!events_) {
+        return 0;
+    }
+
+    size_t count = 0;
+    while (count < maxEvents) {
+        const ASensorEvent& slot = events_[readIndex_];
+        const int32_t counter = loadCounter(slot);
+        if (counter == 0) {
+            // Never written
+            break;
+        }
+
+        // Counters are sequential; anything behind expectedCounter_ is last lap's data
+        const uint32_t expected = static_cast<uint32_t>(expectedCounter_);
+        const auto ahead = static_cast<int32_t>(static_cast<uint32_t>(counter) - expected);
+        if (ahead < 0) {
+            break;
+        }
+
+        if (ahead > 0) {
+            // The HAL lapped the reader: this slot holds a newer lap and the oldest surviving
+            // event sits in the next slot. Everything before it is gone.
+            const uint32_t oldest = static_cast<uint32_t>(counter) -
+                                    static_cast<uint32_t>(capacity_ - 1);
+            lostEvents_ += static_cast<int32_t>(oldest - expected);
+            expectedCounter_ = static_cast<int32_t>(oldest);
+            readIndex_ = (readIndex_ + 1) % capacity_;
+            continue;
+        }
+
+        // The acquire load above orders this copy after the HAL's write of the body
+        std::memcpy(&out[count], &slot, sizeof(ASensorEvent));
+
+        expectedCounter_ = static_cast<int32_t>(expected + 1);
+        readIndex_ = (readIndex_ + 1) % capacity_;
+        count++;
+    }
+    return count;
+}
+
+}  // namespace nativesensor
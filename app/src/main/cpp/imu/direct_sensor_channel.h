@@ -0,0 +1,83 @@
+#pragma once
+
+#include <android/sensor.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace nativesensor {
+
+/// Direct-report channel over ASharedMemory.
+/// The sensor HAL writes events straight into a shared ring without going through the
+/// event queue or waking any of our threads; consumers read new events on their own schedule.
+///
+/// Ring layout: capacity() consecutive ASensorEvent records, written cyclically from slot 0.
+/// Each record's reserved0 field is the HAL's atomic counter, incremented once per event and
+/// written last (0 = never written). Reading the counter with acquire semantics before the
+/// body guarantees that event's body is complete, and counters behind or ahead of the
+/// expected one identify stale and overwritten slots. A lap that starts rewriting a slot
+/// while it is being copied is not detectable from the counter, so the ring must be read
+/// well before the HAL wraps it.
+class DirectSensorChannel {
+public:
+    DirectSensorChannel() = default;
+    ~DirectSensorChannel();
+
+    DirectSensorChannel(const DirectSensorChannel&) = delete;
+    DirectSensorChannel& operator=(const DirectSensorChannel&) = delete;
+
+    /// Check if a sensor can report into a shared memory direct channel
+    [[nodiscard]]
+    static bool isSupported(const ASensor* sensor) noexcept;
+
+    /// Create the shared ring and register it with the sensor service
+    /// @param eventCapacity Number of event slots in the ring
+    /// @return false on failure (resources are released)
+    bool open(ASensorManager* manager, size_t eventCapacity);
+
+    /// Stop all reports and release the ring
+    void close();
+
+    /// Start reporting a sensor into the ring
+    /// @param rateLevel ASENSOR_DIRECT_RATE_* level, clamped to the sensor's highest level
+    /// @return Report token written to each event's sensor field, or <= 0 on failure
+    int32_t enable(const ASensor* sensor, int32_t rateLevel);
+
+    /// Stop reporting a sensor
+    void disable(const ASensor* sensor);
+
+    /// Copy events written since the previous read into out, oldest first.
+    /// Not thread-safe; callers serialize reads.
+    /// @return Number of events copied
+    size_t read(ASensorEvent* out, size_t maxEvents) noexcept;
+
+    /// Events overwritten by the HAL before they were read (cumulative)
+    [[nodiscard]]
+    int64_t getLostEventCount() const noexcept { return lostEvents_; }
+
+    [[nodiscard]]
+    bool isOpen() const noexcept { return channelId_ > 0; }
+
+    /// Read-only view of the mapped ring for zero-copy consumers
+    [[nodiscard]]
+    const ASensorEvent* events() const noexcept { return events_; }
+
+    [[nodiscard]]
+    size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]]
+    size_t sizeBytes() const noexcept { return capacity_ * sizeof(ASensorEvent); }
+
+private:
+    ASensorManager* manager_ = nullptr;
+    int fd_ = -1;
+    int channelId_ = 0;
+    const ASensorEvent* events_ = nullptr;
+    size_t capacity_ = 0;
+
+    // Reader cursor
+    size_t readIndex_ = 0;
+    int32_t expectedCounter_ = 1;
+    int64_t lostEvents_ = 0;
+};
+
+}  // namespace nativesensor
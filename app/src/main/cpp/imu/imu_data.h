@@ -1,6 +1,8 @@
 #pragma once
 
+#include "fusion_data.h"
 #include "sensor_types.h"
+#include "thread_scheduling.h"
 
 namespace nativesensor {
 
@@ -10,7 +12,26 @@ struct ImuSample {
     float y;
     float z;
     TimestampNs timestampNs;
-    [[maybe_unused]] SensorType sensorType;  // Reserved for multi-sensor disambiguation
+    SensorType sensorType;  // Accelerometer/Gyroscope, or the *Uncalibrated companion streams
+};
+
+/// Packed history record exported over JNI (native byte order, 24 bytes, no padding).
+/// Layout: int64 timestampNs | float x | float y | float z | int32 sensorType
+struct PackedImuSample {
+    int64_t timestampNs;
+    float x;
+    float y;
+    float z;
+    int32_t sensorType;
+};
+static_assert(sizeof(PackedImuSample) == 24, "PackedImuSample layout is part of the JNI contract");
+
+/// Cumulative IMU event counts and latency sums since start(); diff two reads for a window
+struct ImuEventTotals {
+    int64_t accelCount;
+    int64_t gyroCount;
+    int64_t accelLatencyTotalNs;
+    int64_t gyroLatencyTotalNs;
 };
 
 /// IMU statistics for performance monitoring
@@ -27,9 +48,45 @@ struct ImuSensorMetadata {
     int32_t accelFifoReserved;
     int32_t gyroMinDelayUs;
     int32_t gyroFifoReserved;
+    int32_t accelBatchLatencyUs;  // Effective hardware FIFO report latency (0 = unbatched)
+    int32_t gyroBatchLatencyUs;
+    int32_t accelHandle;          // ASensor_getHandle() of the selected sensor, -1 = none
+    int32_t gyroHandle;
     [[maybe_unused]] const char* accelName;  // Reserved for debugging/logging
     [[maybe_unused]] const char* gyroName;   // Reserved for debugging/logging
 };
 
+/// In-place sensor switch statistics (cumulative since start).
+/// A gap is the hardware-timestamp distance between the last sample of the outgoing sensor and
+/// the first sample of its replacement.
+struct ImuSwitchStats {
+    int64_t switchCount;
+    int64_t lastAccelGapNs;         // 0 until an accelerometer switch has produced a sample
+    int64_t lastGyroGapNs;
+    int64_t maxGapNs;
+    int64_t lastReconfigureNs;      // Sensor thread time spent disabling/enabling sensors
+};
+
+/// Per-sensor sampling rate and hardware FIFO batching request
+struct ImuSensorConfig {
+    int32_t samplingPeriodUs = 0;           // 0 = sensor minDelay (maximum hardware rate)
+    int64_t maxBatchReportLatencyUs = 0;    // 0 = no batching, deliver immediately
+};
+
+/// IMU start options. Batch latency is clamped to what the sensor's reserved FIFO can hold.
+struct ImuStartOptions {
+    ImuSensorConfig accel;
+    ImuSensorConfig gyro;
+    // Shared-memory direct report, falling back to the event queue when unsupported. There is
+    // no sensor thread in this mode: callbacks run on whichever thread reads samples.
+    bool useDirectChannel = false;
+    int32_t directRateLevel = 3;    // ASENSOR_DIRECT_RATE_* (3 = VERY_FAST, ~800 Hz)
+    ThreadSchedulingConfig scheduling;  // Applied to the sensor thread before it registers sensors
+    FusionConfig fusion;                // Orientation estimation on the sensor thread
+    // Also stream the default uncalibrated variant of each selected calibrated sensor on the
+    // same queue and rate. Event queue only; companion samples are tagged *Uncalibrated.
+    bool streamUncalibrated = false;
+};
+
 }  // namespace nativesensor
 
@@ -1,14 +1,19 @@
 #include "imu_manager.h"
 
 #include <android/log.h>
+#include <algorithm>
 #include <ctime>
+#include <iterator>
 #include <sstream>
 
+#include "trace.h"
+
 namespace {
 constexpr const char* kLogTag = "NativeSensor.IMU";
 }
 
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
 
 #ifndef ASENSOR_TYPE_ACCELEROMETER_UNCALIBRATED
@@ -28,9 +33,45 @@ constexpr int64_t kNsPerSecond = 1'000'000'000LL;
 constexpr double kNsToMs = 1'000'000.0;
 constexpr int kMicrosPerSecond = 1'000'000;
 
+// Poll timeout while hardware batching is active, so the thread sleeps between FIFO reports
+constexpr int kBatchingPollTimeoutMs = 250;
+
+// How long a flush keeps the sensors unbatched before restoring the configured latency
+constexpr int64_t kFlushHoldNs = 50'000'000LL;
+
+// Direct mode pump period. With sample/batch callbacks attached (frame sync, recorder, state
+// push) it bounds their delivery delay; without, it only keeps fusion current and reads the
+// ring well before the HAL laps it (2048 events, ~0.6 s at two sensors' fastest direct rate).
+constexpr auto kDirectPumpCallbackInterval = std::chrono::milliseconds(2);
+constexpr auto kDirectPumpIdleInterval = std::chrono::milliseconds(20);
+
+// Fraction of the reserved FIFO a batch may fill, leaving headroom for report jitter
+constexpr int64_t kFifoFillNumerator = 3;
+constexpr int64_t kFifoFillDenominator = 4;
+
+/// Requested sampling period, never faster than the sensor's minDelay
+int32_t resolveSamplingPeriodUs(int32_t requestedUs, int32_t minDelayUs) noexcept {
+    return requestedUs > minDelayUs ? requestedUs : minDelayUs;
+}
+
+/// Requested batch latency clamped so a batch fits in the sensor's reserved FIFO.
+/// Sensors without a dedicated FIFO cannot batch in hardware and report unbatched.
+int32_t resolveBatchLatencyUs(int64_t requestedUs, int32_t periodUs, int32_t fifoReserved) noexcept {
+    if (requestedUs <= 0 || fifoReserved <= 0 || periodUs <= 0) {
+        return 0;
+    }
+    const int64_t fifoSpanUs = static_cast<int64_t>(fifoReserved) * periodUs *
+                               kFifoFillNumerator / kFifoFillDenominator;
+    const int64_t latencyUs = requestedUs < fifoSpanUs ? requestedUs : fifoSpanUs;
+    return static_cast<int32_t>(latencyUs < INT32_MAX ? latencyUs : INT32_MAX);
+}
+
 }  // namespace
 
-ImuManager::ImuManager() {
+ImuManager::ImuManager()
+    : ringReservation_(MemoryComponent::ImuRings,
+                       sizeof(accelHistory_) + sizeof(gyroHistory_) + sizeof(companionHistory_) +
+                       sizeof(fusion_)) {
     sensorManager_ = ASensorManager_getInstanceForPackage(kPackageName);
     if (!sensorManager_) {
         LOGE("Failed to get ASensorManager instance");
@@ -48,6 +89,11 @@ int64_t ImuManager::getBootTimeNs() noexcept {
 }
 
 void ImuManager::start(ImuCallback callback) {
+    start(std::move(callback), nullptr);
+}
+
+void ImuManager::start(ImuCallback callback, ImuBatchCallback batchCallback,
+                       const ImuStartOptions& options) {
     if (running_.load(std::memory_order_acquire)) {
         LOGI("ImuManager already running");
         return;
@@ -59,16 +105,43 @@ void ImuManager::start(ImuCallback callback) {
     }
 
     callback_ = std::move(callback);
+    batchCallback_ = std::move(batchCallback);
+    options_ = options;
+    flushRequested_.store(false, std::memory_order_release);
+    needsSensorSwitch_.store(false, std::memory_order_release);  // Targets are read at start
     running_.store(true, std::memory_order_release);
 
-    // Reset stats
+    // Drop history from a previous run (no producer yet, so clearing from here is safe)
     {
-        std::lock_guard<std::mutex> lock(statsMutex_);
+        std::lock_guard<std::mutex> lock(historyDrainMutex_);
+        accelHistory_.clear();
+        gyroHistory_.clear();
+        companionHistory_.clear();
+        fusion_.reset(options_.fusion);
+    }
+
+    // Reset stats (sensor thread not running yet, so this thread is the only writer)
+    writerCounters_ = {};
+    counters_.store(writerCounters_);
+    writerSwitchStats_ = {};
+    switchStats_.store(writerSwitchStats_);
+    lastAccelTimestampNs_ = 0;
+    lastGyroTimestampNs_ = 0;
+    accelGapFromNs_ = 0;
+    gyroGapFromNs_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(statsWindowMutex_);
         statsWindowStart_ = getBootTimeNs();
-        accelCount_ = 0;
-        gyroCount_ = 0;
-        accelLatencyTotal_ = 0;
-        gyroLatencyTotal_ = 0;
+        statsWindowBase_ = {};
+    }
+
+    if (options_.useDirectChannel) {
+        if (startDirectChannel()) {
+            sensorThread_ = std::thread(&ImuManager::directPumpLoop, this);
+            LOGI("ImuManager started (direct channel)");
+            return;
+        }
+        LOGI("Direct channel unsupported for selected sensors, using event queue");
     }
 
     sensorThread_ = std::thread(&ImuManager::sensorThreadLoop, this);
@@ -82,6 +155,15 @@ void ImuManager::stop() {
 
     running_.store(false, std::memory_order_release);
 
+    if (directMode_.load(std::memory_order_acquire)) {
+        if (sensorThread_.joinable()) {
+            sensorThread_.join();
+        }
+        stopDirectChannel();
+        LOGI("ImuManager stopped");
+        return;
+    }
+
     // Wake up the looper to exit
     if (looper_) {
         ALooper_wake(looper_);
@@ -99,17 +181,325 @@ void ImuManager::switchSensors(int32_t accelHandle, int32_t gyroHandle) {
 
     targetAccelHandle_.store(accelHandle, std::memory_order_release);
     targetGyroHandle_.store(gyroHandle, std::memory_order_release);
-    needsSensorSwitch_.store(true, std::memory_order_release);
+    if (!running_.load(std::memory_order_acquire)) {
+        return;  // Picked up by the next start()
+    }
 
-    // If running, restart to apply new sensors
-    if (running_.load(std::memory_order_acquire)) {
+    if (directMode_.load(std::memory_order_acquire)) {
+        if (switchDirectSensors()) {
+            return;
+        }
+        // A new sensor cannot report directly: restart, which falls back to the event queue
         auto cb = callback_;
+        auto batchCb = batchCallback_;
+        auto options = options_;
         stop();
-        start(cb);
+        start(std::move(cb), std::move(batchCb), options);
+        return;
+    }
+
+    // The sensor thread reconfigures its own queue between polls
+    const uint64_t request = switchRequests_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    needsSensorSwitch_.store(true, std::memory_order_release);
+    if (looper_) {
+        ALooper_wake(looper_);
+    }
+
+    std::unique_lock<std::mutex> lock(switchMutex_);
+    const bool applied = switchCondition_.wait_for(lock, kSwitchWaitTimeout, [&] {
+        return switchesApplied_ >= request || !running_.load(std::memory_order_acquire);
+    });
+    if (!applied) {
+        LOGW("Sensor switch not applied within %lld ms",
+             static_cast<long long>(kSwitchWaitTimeout.count()));
     }
 }
 
+void ImuManager::applySensorSwitch() {
+    NS_TRACE_SCOPE("ImuManager::applySensorSwitch");
+    const int64_t startNs = getBootTimeNs();
+
+    // Deliver what the outgoing sensors already queued while the type mapping still matches
+    drainEvents();
+
+    const ASensor* previous[] = {currentAccel_, currentGyro_, accelCompanion_, gyroCompanion_};
+    selectSensors();
+    selectCompanions();
+    const ASensor* next[] = {currentAccel_, currentGyro_, accelCompanion_, gyroCompanion_};
+
+    // Disable only sensors that leave the set; the rest keep streaming untouched
+    for (const ASensor* sensor : previous) {
+        if (sensor && std::find(std::begin(next), std::end(next), sensor) == std::end(next)) {
+            ASensorEventQueue_disableSensor(eventQueue_, sensor);
+        }
+    }
+
+    if (currentAccel_ != previous[0]) {
+        registerAccel();
+        accelGapFromNs_ = lastAccelTimestampNs_ > 0 ? lastAccelTimestampNs_ : startNs;
+    }
+    if (currentGyro_ != previous[1]) {
+        registerGyro();
+        gyroGapFromNs_ = lastGyroTimestampNs_ > 0 ? lastGyroTimestampNs_ : startNs;
+    }
+    if (accelCompanion_ && accelCompanion_ != previous[2]) {
+        registerCompanion(accelCompanion_, options_.accel, false);
+    }
+    if (gyroCompanion_ && gyroCompanion_ != previous[3]) {
+        registerCompanion(gyroCompanion_, options_.gyro, false);
+    }
+
+    writerSwitchStats_.switchCount++;
+    writerSwitchStats_.lastReconfigureNs = getBootTimeNs() - startNs;
+    switchStats_.store(writerSwitchStats_);
+
+    LOGI("Switched sensors in place in %.2f ms",
+         static_cast<double>(writerSwitchStats_.lastReconfigureNs) / kNsToMs);
+}
+
+bool ImuManager::switchDirectSensors() {
+    std::lock_guard<std::mutex> lock(historyDrainMutex_);
+    if (!directMode_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    const int64_t startNs = getBootTimeNs();
+
+    // Deliver the outgoing sensors' events before the type mapping changes
+    pumpDirectChannel();
+
+    const ASensor* oldAccel = currentAccel_;
+    const ASensor* oldGyro = currentGyro_;
+    selectSensors();
+    if ((currentAccel_ && !DirectSensorChannel::isSupported(currentAccel_)) ||
+        (currentGyro_ && !DirectSensorChannel::isSupported(currentGyro_))) {
+        currentAccel_ = oldAccel;
+        currentGyro_ = oldGyro;
+        return false;
+    }
+
+    bool ok = true;
+    if (currentAccel_ != oldAccel) {
+        directChannel_.disable(oldAccel);
+        ok = !currentAccel_ || directChannel_.enable(currentAccel_, options_.directRateLevel) > 0;
+        accelGapFromNs_ = lastAccelTimestampNs_ > 0 ? lastAccelTimestampNs_ : startNs;
+    }
+    if (ok && currentGyro_ != oldGyro) {
+        directChannel_.disable(oldGyro);
+        ok = !currentGyro_ || directChannel_.enable(currentGyro_, options_.directRateLevel) > 0;
+        gyroGapFromNs_ = lastGyroTimestampNs_ > 0 ? lastGyroTimestampNs_ : startNs;
+    }
+    if (!ok) {
+        LOGW("Direct channel refused a switched sensor");
+        return false;
+    }
+    publishDirectMetadata();
+
+    writerSwitchStats_.switchCount++;
+    writerSwitchStats_.lastReconfigureNs = getBootTimeNs() - startNs;
+    switchStats_.store(writerSwitchStats_);
+    return true;
+}
+
+void ImuManager::flush() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+    if (directMode_.load(std::memory_order_acquire)) {
+        // No FIFO between the HAL and the shared ring; just pull what is there
+        std::lock_guard<std::mutex> lock(historyDrainMutex_);
+        pumpDirectChannel();
+        return;
+    }
+    flushRequested_.store(true, std::memory_order_release);
+    if (looper_) {
+        ALooper_wake(looper_);
+    }
+}
+
+void ImuManager::applyBatchLatency(bool unbatched) {
+    // Re-registering an enabled sensor re-batches it in place without disabling it,
+    // so no buffered events are lost. The NDK has no per-queue flush call.
+    if (currentAccel_) {
+        const int32_t latencyUs = unbatched ? 0 : accelBatchLatency_.load(std::memory_order_relaxed);
+        ASensorEventQueue_registerSensor(eventQueue_, currentAccel_, accelPeriodUs_, latencyUs);
+    }
+    if (currentGyro_) {
+        const int32_t latencyUs = unbatched ? 0 : gyroBatchLatency_.load(std::memory_order_relaxed);
+        ASensorEventQueue_registerSensor(eventQueue_, currentGyro_, gyroPeriodUs_, latencyUs);
+    }
+    if (accelCompanion_) {
+        registerCompanion(accelCompanion_, options_.accel, unbatched);
+    }
+    if (gyroCompanion_) {
+        registerCompanion(gyroCompanion_, options_.gyro, unbatched);
+    }
+}
+
+void ImuManager::selectSensors() {
+    // Get sensor list
+    ASensorList sensorList;
+    int sensorCount = ASensorManager_getSensorList(sensorManager_, &sensorList);
+
+    // Select accelerometer
+    int32_t accelHandle = targetAccelHandle_.load(std::memory_order_acquire);
+    if (accelHandle >= 0 && accelHandle < sensorCount) {
+        currentAccel_ = sensorList[accelHandle];
+    } else {
+        currentAccel_ = ASensorManager_getDefaultSensor(sensorManager_, ASENSOR_TYPE_ACCELEROMETER);
+    }
+
+    // Select gyroscope
+    int32_t gyroHandle = targetGyroHandle_.load(std::memory_order_acquire);
+    if (gyroHandle >= 0 && gyroHandle < sensorCount) {
+        currentGyro_ = sensorList[gyroHandle];
+    } else {
+        currentGyro_ = ASensorManager_getDefaultSensor(sensorManager_, ASENSOR_TYPE_GYROSCOPE);
+    }
+}
+
+void ImuManager::selectCompanions() {
+    accelCompanion_ = nullptr;
+    gyroCompanion_ = nullptr;
+    if (!options_.streamUncalibrated) {
+        return;
+    }
+
+    // Only calibrated selections get a companion; an uncalibrated selection already is one
+    if (currentAccel_ && ASensor_getType(currentAccel_) == ASENSOR_TYPE_ACCELEROMETER) {
+        accelCompanion_ = ASensorManager_getDefaultSensor(
+            sensorManager_, ASENSOR_TYPE_ACCELEROMETER_UNCALIBRATED);
+    }
+    if (currentGyro_ && ASensor_getType(currentGyro_) == ASENSOR_TYPE_GYROSCOPE) {
+        gyroCompanion_ = ASensorManager_getDefaultSensor(
+            sensorManager_, ASENSOR_TYPE_GYROSCOPE_UNCALIBRATED);
+    }
+    LOGI("Uncalibrated companions - Accel: %s, Gyro: %s",
+         accelCompanion_ ? ASensor_getName(accelCompanion_) : "None",
+         gyroCompanion_ ? ASensor_getName(gyroCompanion_) : "None");
+}
+
+bool ImuManager::startDirectChannel() {
+    selectSensors();
+
+    // All selected sensors must support direct report, otherwise use the event queue for both
+    if ((!currentAccel_ && !currentGyro_) ||
+        (currentAccel_ && !DirectSensorChannel::isSupported(currentAccel_)) ||
+        (currentGyro_ && !DirectSensorChannel::isSupported(currentGyro_))) {
+        currentAccel_ = nullptr;
+        currentGyro_ = nullptr;
+        return false;
+    }
+
+    if (!directChannel_.open(sensorManager_, kDirectChannelEvents)) {
+        currentAccel_ = nullptr;
+        currentGyro_ = nullptr;
+        return false;
+    }
+    directChannelReservation_ =
+        MemoryReservation(MemoryComponent::ImuRings, directChannel_.sizeBytes());
+
+    const bool accelOk = !currentAccel_ ||
+                         directChannel_.enable(currentAccel_, options_.directRateLevel) > 0;
+    const bool gyroOk = !currentGyro_ ||
+                        directChannel_.enable(currentGyro_, options_.directRateLevel) > 0;
+    if (!accelOk || !gyroOk) {
+        stopDirectChannel();
+        return false;
+    }
+
+    publishDirectMetadata();
+    directMode_.store(true, std::memory_order_release);
+    return true;
+}
+
+void ImuManager::publishDirectMetadata() {
+    accelMinDelay_.store(currentAccel_ ? ASensor_getMinDelay(currentAccel_) : 0,
+                         std::memory_order_release);
+    accelFifo_.store(currentAccel_ ? ASensor_getFifoReservedEventCount(currentAccel_) : 0,
+                     std::memory_order_release);
+    gyroMinDelay_.store(currentGyro_ ? ASensor_getMinDelay(currentGyro_) : 0,
+                        std::memory_order_release);
+    gyroFifo_.store(currentGyro_ ? ASensor_getFifoReservedEventCount(currentGyro_) : 0,
+                    std::memory_order_release);
+    accelBatchLatency_.store(0, std::memory_order_release);
+    gyroBatchLatency_.store(0, std::memory_order_release);
+    publishSensorSelection();
+}
+
+void ImuManager::publishSensorSelection() {
+    // Names are owned by the sensor list, which lives as long as the sensor manager
+    accelName_.store(currentAccel_ ? ASensor_getName(currentAccel_) : nullptr,
+                     std::memory_order_release);
+    gyroName_.store(currentGyro_ ? ASensor_getName(currentGyro_) : nullptr,
+                    std::memory_order_release);
+    accelHandle_.store(currentAccel_ ? ASensor_getHandle(currentAccel_) : -1,
+                       std::memory_order_release);
+    gyroHandle_.store(currentGyro_ ? ASensor_getHandle(currentGyro_) : -1,
+                      std::memory_order_release);
+}
+
+void ImuManager::stopDirectChannel() {
+    std::lock_guard<std::mutex> lock(historyDrainMutex_);
+    directMode_.store(false, std::memory_order_release);
+    directChannel_.disable(currentAccel_);
+    directChannel_.disable(currentGyro_);
+    directChannel_.close();
+    directChannelReservation_.reset();
+    currentAccel_ = nullptr;
+    currentGyro_ = nullptr;
+    publishSensorSelection();
+}
+
+void ImuManager::pumpDirectChannel() {
+    // Caller holds historyDrainMutex_
+    if (!directMode_.load(std::memory_order_acquire)) {
+        return;
+    }
+    NS_TRACE_SCOPE("ImuManager::pumpDirectChannel");
+
+    ASensorEvent events[kEventBatchSize];
+    const int64_t lostBefore = directChannel_.getLostEventCount();
+    size_t count;
+    while ((count = directChannel_.read(events, kEventBatchSize)) > 0) {
+        processBatch(events, count);
+    }
+
+    const int64_t lost = directChannel_.getLostEventCount() - lostBefore;
+    if (lost > 0) {
+        historyOverflows_.fetch_add(lost, std::memory_order_relaxed);
+    }
+}
+
+void ImuManager::directPumpLoop() {
+    if (!options_.scheduling.isDefault()) {
+        applyThreadScheduling(0, options_.scheduling);
+    }
+    sensorThreadId_.store(currentThreadId(), std::memory_order_release);
+
+    const auto interval = (callback_ || batchCallback_) ? kDirectPumpCallbackInterval
+                                                         : kDirectPumpIdleInterval;
+    auto due = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_acquire)) {
+        {
+            std::lock_guard<std::mutex> lock(historyDrainMutex_);
+            pumpDirectChannel();
+        }
+
+        // Fixed cadence; after a stall, resume from now rather than catching up
+        const auto now = std::chrono::steady_clock::now();
+        due = std::max(due + interval, now);
+        std::this_thread::sleep_until(due);
+    }
+
+    sensorThreadId_.store(0, std::memory_order_release);
+}
+
 void ImuManager::sensorThreadLoop() {
+    // Before the first event so the whole run is scheduled as requested
+    if (!options_.scheduling.isDefault()) {
+        applyThreadScheduling(0, options_.scheduling);
+    }
+
     // Create looper for this thread
     looper_ = ALooper_prepare(ALOOPER_PREPARE_ALLOW_NON_CALLBACKS);
     if (!looper_) {
@@ -130,187 +520,441 @@ void ImuManager::sensorThreadLoop() {
         LOGE("Failed to create sensor event queue");
         return;
     }
+    sensorThreadId_.store(currentThreadId(), std::memory_order_release);
 
-    // Get sensor list
-    ASensorList sensorList;
-    int sensorCount = ASensorManager_getSensorList(sensorManager_, &sensorList);
+    selectSensors();
+    selectCompanions();
 
-    // Select accelerometer
-    int32_t accelHandle = targetAccelHandle_.load(std::memory_order_acquire);
-    if (accelHandle >= 0 && accelHandle < sensorCount) {
-        currentAccel_ = sensorList[accelHandle];
-    } else {
-        currentAccel_ = ASensorManager_getDefaultSensor(sensorManager_, ASENSOR_TYPE_ACCELEROMETER);
+    // Register sensors at the requested rate (minDelay by default for fastest hardware rate)
+    registerAccel();
+    registerGyro();
+    if (accelCompanion_) {
+        registerCompanion(accelCompanion_, options_.accel, false);
+    }
+    if (gyroCompanion_) {
+        registerCompanion(gyroCompanion_, options_.gyro, false);
     }
 
-    // Select gyroscope
-    int32_t gyroHandle = targetGyroHandle_.load(std::memory_order_acquire);
-    if (gyroHandle >= 0 && gyroHandle < sensorCount) {
-        currentGyro_ = sensorList[gyroHandle];
-    } else {
-        currentGyro_ = ASensorManager_getDefaultSensor(sensorManager_, ASENSOR_TYPE_GYROSCOPE);
+    flushHoldUntilNs_ = 0;
+
+    // Main event loop
+    while (running_.load(std::memory_order_acquire)) {
+        const bool batching = accelBatchLatency_.load(std::memory_order_relaxed) > 0 ||
+                              gyroBatchLatency_.load(std::memory_order_relaxed) > 0;
+        const int timeoutMs = (batching && flushHoldUntilNs_ == 0)
+            ? kBatchingPollTimeoutMs : kPollTimeoutMs;
+        int ident = ALooper_pollOnce(timeoutMs, nullptr, nullptr, nullptr);
+        if (ident == kLooperId) {
+            drainEvents();
+        }
+
+        if (flushRequested_.exchange(false, std::memory_order_acq_rel)) {
+            if (batching) {
+                // Drop report latency to zero so the HAL delivers its FIFO contents now
+                applyBatchLatency(true);
+                flushHoldUntilNs_ = getBootTimeNs() + kFlushHoldNs;
+            }
+            drainEvents();
+        } else if (flushHoldUntilNs_ != 0 && getBootTimeNs() >= flushHoldUntilNs_) {
+            drainEvents();
+            applyBatchLatency(false);
+            flushHoldUntilNs_ = 0;
+        }
+
+        if (needsSensorSwitch_.exchange(false, std::memory_order_acq_rel)) {
+            const uint64_t request = switchRequests_.load(std::memory_order_acquire);
+            applySensorSwitch();
+            if (flushHoldUntilNs_ != 0) {
+                applyBatchLatency(true);  // Keep the new sensors unbatched until the hold ends
+            }
+            {
+                std::lock_guard<std::mutex> lock(switchMutex_);
+                switchesApplied_ = request;
+            }
+            switchCondition_.notify_all();
+        }
+    }
+
+    // Cleanup
+    if (currentAccel_) {
+        ASensorEventQueue_disableSensor(eventQueue_, currentAccel_);
     }
+    if (currentGyro_) {
+        ASensorEventQueue_disableSensor(eventQueue_, currentGyro_);
+    }
+    if (accelCompanion_) {
+        ASensorEventQueue_disableSensor(eventQueue_, accelCompanion_);
+    }
+    if (gyroCompanion_) {
+        ASensorEventQueue_disableSensor(eventQueue_, gyroCompanion_);
+    }
+
+    ASensorManager_destroyEventQueue(sensorManager_, eventQueue_);
+    eventQueue_ = nullptr;
+    looper_ = nullptr;
+    currentAccel_ = nullptr;
+    currentGyro_ = nullptr;
+    accelCompanion_ = nullptr;
+    gyroCompanion_ = nullptr;
+    publishSensorSelection();
+    sensorThreadId_.store(0, std::memory_order_release);
+
+    // Release a switchSensors() caller waiting on a thread that is gone
+    switchCondition_.notify_all();
 
-    // Register sensors at MAXIMUM rate using minDelay for fastest hardware rate
+    LOGI("Sensor thread exited");
+}
+
+void ImuManager::registerAccel() {
     if (currentAccel_) {
         int minDelay = ASensor_getMinDelay(currentAccel_);
+        int fifo = ASensor_getFifoReservedEventCount(currentAccel_);
+        accelPeriodUs_ = resolveSamplingPeriodUs(options_.accel.samplingPeriodUs, minDelay);
         accelMinDelay_.store(minDelay, std::memory_order_release);
-        accelFifo_.store(ASensor_getFifoReservedEventCount(currentAccel_), std::memory_order_release);
+        accelFifo_.store(fifo, std::memory_order_release);
+        accelBatchLatency_.store(
+            resolveBatchLatencyUs(options_.accel.maxBatchReportLatencyUs, accelPeriodUs_, fifo),
+            std::memory_order_release);
 
-        // Use registerSensor with minDelay for maximum hardware rate
         // maxBatchReportLatencyUs = 0 means no batching, deliver immediately
-        ASensorEventQueue_registerSensor(eventQueue_, currentAccel_, minDelay, 0);
+        ASensorEventQueue_registerSensor(eventQueue_, currentAccel_, accelPeriodUs_,
+                                         accelBatchLatency_.load(std::memory_order_relaxed));
 
-        LOGI("Registered accelerometer: %s (minDelay=%dμs, fifo=%d)",
+        LOGI("Registered accelerometer: %s (minDelay=%dμs, period=%dμs, fifo=%d, batch=%dμs)",
              ASensor_getName(currentAccel_),
              accelMinDelay_.load(),
-             accelFifo_.load());
+             accelPeriodUs_,
+             accelFifo_.load(),
+             accelBatchLatency_.load());
     } else {
         LOGE("No accelerometer found");
         accelMinDelay_.store(0, std::memory_order_release);
         accelFifo_.store(0, std::memory_order_release);
+        accelBatchLatency_.store(0, std::memory_order_release);
     }
+    publishSensorSelection();
+}
 
+void ImuManager::registerGyro() {
     if (currentGyro_) {
         int minDelay = ASensor_getMinDelay(currentGyro_);
+        int fifo = ASensor_getFifoReservedEventCount(currentGyro_);
+        gyroPeriodUs_ = resolveSamplingPeriodUs(options_.gyro.samplingPeriodUs, minDelay);
         gyroMinDelay_.store(minDelay, std::memory_order_release);
-        gyroFifo_.store(ASensor_getFifoReservedEventCount(currentGyro_), std::memory_order_release);
+        gyroFifo_.store(fifo, std::memory_order_release);
+        gyroBatchLatency_.store(
+            resolveBatchLatencyUs(options_.gyro.maxBatchReportLatencyUs, gyroPeriodUs_, fifo),
+            std::memory_order_release);
 
-        // Use registerSensor with minDelay for maximum hardware rate
-        ASensorEventQueue_registerSensor(eventQueue_, currentGyro_, minDelay, 0);
+        ASensorEventQueue_registerSensor(eventQueue_, currentGyro_, gyroPeriodUs_,
+                                         gyroBatchLatency_.load(std::memory_order_relaxed));
 
-        LOGI("Registered gyroscope: %s (minDelay=%dμs, fifo=%d)",
+        LOGI("Registered gyroscope: %s (minDelay=%dμs, period=%dμs, fifo=%d, batch=%dμs)",
              ASensor_getName(currentGyro_),
              gyroMinDelay_.load(),
-             gyroFifo_.load());
+             gyroPeriodUs_,
+             gyroFifo_.load(),
+             gyroBatchLatency_.load());
     } else {
         LOGE("No gyroscope found");
         gyroMinDelay_.store(0, std::memory_order_release);
         gyroFifo_.store(0, std::memory_order_release);
+        gyroBatchLatency_.store(0, std::memory_order_release);
     }
+    publishSensorSelection();
+}
 
-    // Main event loop
-    while (running_.load(std::memory_order_acquire)) {
-        int ident = ALooper_pollOnce(kPollTimeoutMs, nullptr, nullptr, nullptr);
-        if (ident == kLooperId) {
-            drainEvents();
-        }
-    }
+void ImuManager::registerCompanion(const ASensor* sensor, const ImuSensorConfig& config,
+                                   bool unbatched) {
+    // Same request as the primary, resolved against the companion's own limits
+    const int32_t periodUs =
+        resolveSamplingPeriodUs(config.samplingPeriodUs, ASensor_getMinDelay(sensor));
+    const int32_t latencyUs = unbatched ? 0 : resolveBatchLatencyUs(
+        config.maxBatchReportLatencyUs, periodUs, ASensor_getFifoReservedEventCount(sensor));
+    ASensorEventQueue_registerSensor(eventQueue_, sensor, periodUs, latencyUs);
+}
 
-    // Cleanup
-    if (currentAccel_) {
-        ASensorEventQueue_disableSensor(eventQueue_, currentAccel_);
-    }
-    if (currentGyro_) {
-        ASensorEventQueue_disableSensor(eventQueue_, currentGyro_);
+void ImuManager::drainEvents() {
+    NS_TRACE_SCOPE("ImuManager::drainEvents");
+    ASensorEvent events[kEventBatchSize];
+
+    // Process ALL pending events in the queue, kEventBatchSize per read
+    ssize_t count;
+    while ((count = ASensorEventQueue_getEvents(eventQueue_, events, kEventBatchSize)) > 0) {
+        processBatch(events, static_cast<size_t>(count));
     }
+}
 
-    ASensorManager_destroyEventQueue(sensorManager_, eventQueue_);
-    eventQueue_ = nullptr;
-    looper_ = nullptr;
-    currentAccel_ = nullptr;
-    currentGyro_ = nullptr;
+bool ImuManager::injectEvents(const ASensorEvent* events, size_t count) {
+    if (running_.load(std::memory_order_acquire)) {
+        LOGW("Cannot inject IMU events while the sensor thread is running");
+        return false;
+    }
 
-    LOGI("Sensor thread exited");
+    std::lock_guard<std::mutex> lock(historyDrainMutex_);
+    for (size_t offset = 0; offset < count; offset += kEventBatchSize) {
+        const size_t batch = count - offset < kEventBatchSize ? count - offset : kEventBatchSize;
+        processBatch(events + offset, batch);
+    }
+    return true;
 }
 
-void ImuManager::drainEvents() {
-    ASensorEvent event;
+void ImuManager::processBatch(const ASensorEvent* events, size_t count) {
     const int64_t now = getBootTimeNs();
-
-    // Process ALL pending events in the queue
-    while (ASensorEventQueue_getEvents(eventQueue_, &event, 1) > 0) {
-        ImuSample sample{};
+    const int accelType = currentAccel_ ? ASensor_getType(currentAccel_) : ASENSOR_TYPE_ACCELEROMETER;
+    const int gyroType = currentGyro_ ? ASensor_getType(currentGyro_) : ASENSOR_TYPE_GYROSCOPE;
+    const int accelCompanionType = accelCompanion_ ? ASENSOR_TYPE_ACCELEROMETER_UNCALIBRATED : -1;
+    const int gyroCompanionType = gyroCompanion_ ? ASENSOR_TYPE_GYROSCOPE_UNCALIBRATED : -1;
+
+    ImuSample samples[kEventBatchSize];
+    size_t sampleCount = 0;
+
+    const ImuSample* firstAccel = nullptr;
+    const ImuSample* firstGyro = nullptr;
+    const ImuSample* newestAccel = nullptr;
+    const ImuSample* newestGyro = nullptr;
+    int32_t accelCount = 0;
+    int32_t gyroCount = 0;
+    int64_t accelLatency = 0;
+    int64_t gyroLatency = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        const ASensorEvent& event = events[i];
+        ImuSample& sample = samples[sampleCount];
         sample.timestampNs = event.timestamp;
 
-        bool isAccel = currentAccel_ && event.type == ASensor_getType(currentAccel_);
-        bool isGyro = currentGyro_ && event.type == ASensor_getType(currentGyro_);
-
-        if (isAccel) {
+        if (event.type == accelType) {
             sample.x = event.acceleration.x;
             sample.y = event.acceleration.y;
             sample.z = event.acceleration.z;
             sample.sensorType = SensorType::Accelerometer;
-
-            // Update latest value
-            {
-                std::lock_guard<std::mutex> lock(dataMutex_);
-                latestAccel_ = sample;
-            }
-
-            // Update stats
-            {
-                std::lock_guard<std::mutex> lock(statsMutex_);
-                accelCount_++;
-                accelLatencyTotal_ += (now - event.timestamp);
-            }
-
-        } else if (isGyro) {
+            if (!firstAccel) firstAccel = &sample;
+            newestAccel = &sample;
+            accelCount++;
+            accelLatency += (now - event.timestamp);
+        } else if (event.type == gyroType) {
             sample.x = event.vector.x;
             sample.y = event.vector.y;
             sample.z = event.vector.z;
             sample.sensorType = SensorType::Gyroscope;
+            if (!firstGyro) firstGyro = &sample;
+            newestGyro = &sample;
+            gyroCount++;
+            gyroLatency += (now - event.timestamp);
+        } else if (event.type == accelCompanionType) {
+            sample.x = event.uncalibrated_acceleration.x_uncalib;
+            sample.y = event.uncalibrated_acceleration.y_uncalib;
+            sample.z = event.uncalibrated_acceleration.z_uncalib;
+            sample.sensorType = SensorType::AccelerometerUncalibrated;
+        } else if (event.type == gyroCompanionType) {
+            sample.x = event.uncalibrated_gyro.x_uncalib;
+            sample.y = event.uncalibrated_gyro.y_uncalib;
+            sample.z = event.uncalibrated_gyro.z_uncalib;
+            sample.sensorType = SensorType::GyroscopeUncalibrated;
+        } else {
+            continue;
+        }
+        sampleCount++;
+    }
 
-            // Update latest value
-            {
-                std::lock_guard<std::mutex> lock(dataMutex_);
-                latestGyro_ = sample;
-            }
-
-            // Update stats
-            {
-                std::lock_guard<std::mutex> lock(statsMutex_);
-                gyroCount_++;
-                gyroLatencyTotal_ += (now - event.timestamp);
-            }
+    if (sampleCount == 0) {
+        return;
+    }
+    NS_TRACE_COUNTER("IMU batch size", sampleCount);
+
+    // Publish latest values and stats once per batch
+    if (newestAccel) latestAccel_.store(*newestAccel);
+    if (newestGyro) latestGyro_.store(*newestGyro);
+
+    // First sample from a switched-in sensor closes the gap opened by the switch
+    if (firstAccel && accelGapFromNs_ != 0) {
+        writerSwitchStats_.lastAccelGapNs = firstAccel->timestampNs - accelGapFromNs_;
+        writerSwitchStats_.maxGapNs =
+            std::max(writerSwitchStats_.maxGapNs, writerSwitchStats_.lastAccelGapNs);
+        accelGapFromNs_ = 0;
+        switchStats_.store(writerSwitchStats_);
+    }
+    if (firstGyro && gyroGapFromNs_ != 0) {
+        writerSwitchStats_.lastGyroGapNs = firstGyro->timestampNs - gyroGapFromNs_;
+        writerSwitchStats_.maxGapNs =
+            std::max(writerSwitchStats_.maxGapNs, writerSwitchStats_.lastGyroGapNs);
+        gyroGapFromNs_ = 0;
+        switchStats_.store(writerSwitchStats_);
+    }
+    if (newestAccel) lastAccelTimestampNs_ = newestAccel->timestampNs;
+    if (newestGyro) lastGyroTimestampNs_ = newestGyro->timestampNs;
+
+    writerCounters_.accelCount += accelCount;
+    writerCounters_.gyroCount += gyroCount;
+    writerCounters_.accelLatencyTotalNs += accelLatency;
+    writerCounters_.gyroLatencyTotalNs += gyroLatency;
+    counters_.store(writerCounters_);
+
+    // Record every sample; a false push overwrote the oldest entry of a history nobody drained
+    int64_t overflows = 0;
+    for (size_t i = 0; i < sampleCount; ++i) {
+        const SensorType type = samples[i].sensorType;
+        auto& history = type == SensorType::Accelerometer ? accelHistory_
+                      : type == SensorType::Gyroscope ? gyroHistory_
+                      : companionHistory_;
+        if (!history.push(samples[i])) {
+            overflows++;
         }
+    }
+    if (overflows > 0) {
+        historyOverflows_.fetch_add(overflows, std::memory_order_relaxed);
+    }
+
+    if (options_.fusion.enabled) {
+        fusion_.process(samples, sampleCount);
+    }
+
+    if (batchCallback_) {
+        batchCallback_(samples, sampleCount);
+    }
 
-        // Invoke callback for every sample
-        if (callback_ && (isAccel || isGyro)) {
-            callback_(sample);
+    // Invoke per-sample callback for every sample
+    if (callback_) {
+        for (size_t i = 0; i < sampleCount; ++i) {
+            callback_(samples[i]);
         }
     }
 }
 
-ImuSample ImuManager::getLatestAccel() const {
-    std::lock_guard<std::mutex> lock(dataMutex_);
-    return latestAccel_;
+ImuSample ImuManager::getLatestAccel() {
+    if (directMode_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(historyDrainMutex_);
+        pumpDirectChannel();
+    }
+    return latestAccel_.load();
+}
+
+ImuSample ImuManager::getLatestGyro() {
+    if (directMode_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(historyDrainMutex_);
+        pumpDirectChannel();
+    }
+    return latestGyro_.load();
 }
 
-ImuSample ImuManager::getLatestGyro() const {
-    std::lock_guard<std::mutex> lock(dataMutex_);
-    return latestGyro_;
+OrientationSample ImuManager::getLatestOrientation() {
+    if (directMode_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(historyDrainMutex_);
+        pumpDirectChannel();
+    }
+    return fusion_.getLatest();
 }
 
-ImuStats ImuManager::getStats() {
-    std::lock_guard<std::mutex> lock(statsMutex_);
+size_t ImuManager::drainOrientationHistory(OrientationSample* out, size_t capacity) {
+    std::lock_guard<std::mutex> lock(historyDrainMutex_);
+    pumpDirectChannel();
+    return fusion_.drainHistory(out, capacity);
+}
 
-    const int64_t now = getBootTimeNs();
-    const double dtSeconds = static_cast<double>(now - statsWindowStart_) / kNsPerSecond;
+namespace {
+
+template<typename History>
+size_t drainInto(History& history, PackedImuSample* out, size_t maxCount) noexcept {
+    ImuSample chunk[ImuManager::kEventBatchSize];
+    size_t written = 0;
+    while (written < maxCount) {
+        const size_t wanted = std::min(maxCount - written, ImuManager::kEventBatchSize);
+        const size_t count = history.popBulk(chunk, wanted);
+        for (size_t i = 0; i < count; ++i) {
+            PackedImuSample& record = out[written++];
+            record.timestampNs = chunk[i].timestampNs;
+            record.x = chunk[i].x;
+            record.y = chunk[i].y;
+            record.z = chunk[i].z;
+            record.sensorType = static_cast<int32_t>(chunk[i].sensorType);
+        }
+        if (count < wanted) {
+            break;
+        }
+    }
+    return written;
+}
+
+}  // namespace
+
+size_t ImuManager::drainHistory(PackedImuSample* out, size_t capacity) {
+    if (!out || capacity == 0) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(historyDrainMutex_);
+    pumpDirectChannel();
+
+    // Split capacity so a backlog on one sensor cannot crowd out the other. Companion streams
+    // are held to a third, leaving the calibrated pair the rest.
+    const size_t accelAvailable = accelHistory_.size();
+    const size_t gyroAvailable = gyroHistory_.size();
+    const size_t companionAvailable = companionHistory_.size();
+    size_t primaryCapacity = capacity;
+    if (accelAvailable + gyroAvailable + companionAvailable > capacity) {
+        primaryCapacity = capacity - std::min(companionAvailable, capacity / 3);
+    }
+    size_t accelQuota = accelAvailable;
+    if (accelAvailable + gyroAvailable > primaryCapacity) {
+        const size_t fairShare = primaryCapacity / 2;
+        const size_t gyroTake = gyroAvailable < primaryCapacity - fairShare
+            ? gyroAvailable : primaryCapacity - fairShare;
+        accelQuota = primaryCapacity - gyroTake;
+    }
+
+    size_t written = drainInto(accelHistory_, out, accelQuota);
+    written += drainInto(gyroHistory_, out + written, primaryCapacity - written);
+    return written + drainInto(companionHistory_, out + written, capacity - written);
+}
+
+ImuStats imuStatsBetween(const ImuEventTotals& base, const ImuEventTotals& current,
+                         int64_t windowNs) noexcept {
+    const double dtSeconds = static_cast<double>(windowNs) / kNsPerSecond;
+
+    const int64_t accelCount = current.accelCount - base.accelCount;
+    const int64_t gyroCount = current.gyroCount - base.gyroCount;
+    const int64_t accelLatencyTotal = current.accelLatencyTotalNs - base.accelLatencyTotalNs;
+    const int64_t gyroLatencyTotal = current.gyroLatencyTotalNs - base.gyroLatencyTotalNs;
 
     ImuStats stats{};
 
     if (dtSeconds > 0.0) {
-        stats.accelFrequencyHz = static_cast<float>(accelCount_ / dtSeconds);
-        stats.gyroFrequencyHz = static_cast<float>(gyroCount_ / dtSeconds);
+        stats.accelFrequencyHz = static_cast<float>(static_cast<double>(accelCount) / dtSeconds);
+        stats.gyroFrequencyHz = static_cast<float>(static_cast<double>(gyroCount) / dtSeconds);
     }
 
-    if (accelCount_ > 0) {
+    if (accelCount > 0) {
         stats.accelLatencyMs = static_cast<float>(
-            static_cast<double>(accelLatencyTotal_) / accelCount_ / kNsToMs);
+            static_cast<double>(accelLatencyTotal) / static_cast<double>(accelCount) / kNsToMs);
     }
 
-    if (gyroCount_ > 0) {
+    if (gyroCount > 0) {
         stats.gyroLatencyMs = static_cast<float>(
-            static_cast<double>(gyroLatencyTotal_) / gyroCount_ / kNsToMs);
+            static_cast<double>(gyroLatencyTotal) / static_cast<double>(gyroCount) / kNsToMs);
     }
 
-    // Reset counters
+    return stats;
+}
+
+ImuEventTotals ImuManager::getEventTotals() {
+    if (directMode_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(historyDrainMutex_);
+        pumpDirectChannel();
+    }
+    return counters_.load();
+}
+
+ImuStats ImuManager::getStats() {
+    const ImuCounters current = getEventTotals();
+
+    std::lock_guard<std::mutex> lock(statsWindowMutex_);
+
+    const int64_t now = getBootTimeNs();
+    const ImuStats stats = imuStatsBetween(statsWindowBase_, current, now - statsWindowStart_);
+
+    // Start a new window from the current totals
     statsWindowStart_ = now;
-    accelCount_ = 0;
-    gyroCount_ = 0;
-    accelLatencyTotal_ = 0;
-    gyroLatencyTotal_ = 0;
+    statsWindowBase_ = current;
 
     return stats;
 }
@@ -321,8 +965,14 @@ ImuSensorMetadata ImuManager::getMetadata() const {
     meta.accelFifoReserved = accelFifo_.load(std::memory_order_acquire);
     meta.gyroMinDelayUs = gyroMinDelay_.load(std::memory_order_acquire);
     meta.gyroFifoReserved = gyroFifo_.load(std::memory_order_acquire);
-    meta.accelName = currentAccel_ ? ASensor_getName(currentAccel_) : "None";
-    meta.gyroName = currentGyro_ ? ASensor_getName(currentGyro_) : "None";
+    meta.accelBatchLatencyUs = accelBatchLatency_.load(std::memory_order_acquire);
+    meta.gyroBatchLatencyUs = gyroBatchLatency_.load(std::memory_order_acquire);
+    meta.accelHandle = accelHandle_.load(std::memory_order_acquire);
+    meta.gyroHandle = gyroHandle_.load(std::memory_order_acquire);
+    const char* accelName = accelName_.load(std::memory_order_acquire);
+    const char* gyroName = gyroName_.load(std::memory_order_acquire);
+    meta.accelName = accelName ? accelName : "None";
+    meta.gyroName = gyroName ? gyroName : "None";
     return meta;
 }
 
@@ -356,6 +1006,9 @@ std::vector<SensorInfo> ImuManager::enumerateSensors() {
                 ? (static_cast<float>(kMicrosPerSecond) / static_cast<float>(info.minDelayUs))
                 : 0.0f;
             info.fifoReserved = ASensor_getFifoReservedEventCount(sensor);
+            info.directReportRateLevel = DirectSensorChannel::isSupported(sensor)
+                ? ASensor_getHighestDirectReportRateLevel(sensor)
+                : 0;
 
             sensors.push_back(info);
         }
@@ -6,19 +6,35 @@
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <vector>
 #include <string>
 
+#include "direct_sensor_channel.h"
+#include "fusion_engine.h"
 #include "imu_data.h"
+#include "memory_budget.h"
 #include "ring_buffer.h"
+#include "seqlock.h"
 #include "sensor_types.h"
 
 namespace nativesensor {
 
-/// Callback type for IMU data - called from sensor thread
+/// Callback type for IMU data - called from sensor thread. In direct channel mode a polling
+/// consumer may run it instead (serialized with the pump thread under one lock).
 using ImuCallback = std::function<void(const ImuSample&)>;
 
+/// Callback type for a batch of IMU samples drained in one read - called from sensor thread.
+/// The samples are only valid for the duration of the call.
+using ImuBatchCallback = std::function<void(const ImuSample* samples, size_t count)>;
+
+/// Rates and mean latencies between two ImuEventTotals reads windowNs apart
+[[nodiscard]]
+ImuStats imuStatsBetween(const ImuEventTotals& base, const ImuEventTotals& current,
+                         int64_t windowNs) noexcept;
+
 /// High-frequency, low-latency IMU sensor manager.
 /// Uses ASensorManager with callback-based event queue.
 class ImuManager {
@@ -29,30 +45,118 @@ public:
     ImuManager(const ImuManager&) = delete;
     ImuManager& operator=(const ImuManager&) = delete;
 
+    /// Max events read from the sensor queue per ASensorEventQueue_getEvents call
+    static constexpr size_t kEventBatchSize = 64;
+
+    /// Per-sensor history depth (about 4 s at 1 kHz)
+    static constexpr size_t kHistoryCapacity = 4096;
+
+    /// Event slots in the shared-memory direct channel ring
+    static constexpr size_t kDirectChannelEvents = 2048;
+
+    /// Longest switchSensors() waits for the sensor thread to apply a switch
+    static constexpr std::chrono::milliseconds kSwitchWaitTimeout{500};
+
     /// Start IMU subscription at maximum hardware rate
     void start(ImuCallback callback);
 
+    /// Start IMU subscription with per-sample and/or per-batch delivery (either may be empty)
+    /// @param options Sampling period and hardware FIFO batching per sensor
+    void start(ImuCallback callback, ImuBatchCallback batchCallback,
+               const ImuStartOptions& options = {});
+
+    /// Ask the sensor thread to deliver events buffered in the hardware FIFO now
+    void flush();
+
     /// Stop IMU subscription and release resources
     void stop();
 
-    /// Switch to specific sensors by handle
+    /// Switch to specific sensors by handle (-1 for the default). While running, the sensor
+    /// thread disables only the sensors that change and registers their replacements on the
+    /// same queue, so the other sensor keeps streaming; returns once the switch is applied
+    /// (or after kSwitchWaitTimeout). Direct channel mode switches on the calling thread, and
+    /// restarts on the event queue if a new sensor lacks direct report support.
     void switchSensors(int32_t accelHandle, int32_t gyroHandle);
 
+    /// In-place switch counters and measured sample gaps
+    [[nodiscard]]
+    ImuSwitchStats getSwitchStats() const { return switchStats_.load(); }
+
+    /// Feed events through the same conversion, history and statistics path as the sensor
+    /// queue (benchmarks, replay). Only allowed while stopped, since the sensor thread is
+    /// otherwise the sole writer. With no sensors selected, events are matched against
+    /// ASENSOR_TYPE_ACCELEROMETER and ASENSOR_TYPE_GYROSCOPE.
+    /// @return false if the manager is running
+    bool injectEvents(const ASensorEvent* events, size_t count);
+
     /// Check if sensors are running
     [[nodiscard]]
     bool isRunning() const noexcept { return running_.load(std::memory_order_acquire); }
 
-    /// Get the latest accelerometer sample (thread-safe)
+    /// Kernel id of the sensor thread (the ring pump thread in direct mode, 0 while stopped)
+    [[nodiscard]]
+    int32_t getSensorThreadId() const noexcept {
+        return sensorThreadId_.load(std::memory_order_acquire);
+    }
+
+    /// Check if events arrive through the shared-memory direct channel
+    [[nodiscard]]
+    bool isDirectChannelActive() const noexcept { return directMode_.load(std::memory_order_acquire); }
+
+    /// Read-only view of the direct channel ring (nullptr unless direct mode is active)
+    [[nodiscard]]
+    const DirectSensorChannel* getDirectChannel() const noexcept {
+        return isDirectChannelActive() ? &directChannel_ : nullptr;
+    }
+
+    /// Get the latest accelerometer sample (lock-free, never blocks the sensor thread).
+    /// In direct mode this first pulls new events from the shared ring.
     [[nodiscard]]
-    ImuSample getLatestAccel() const;
+    ImuSample getLatestAccel();
 
-    /// Get the latest gyroscope sample (thread-safe)
+    /// Get the latest gyroscope sample (lock-free, never blocks the sensor thread).
+    /// In direct mode this first pulls new events from the shared ring.
     [[nodiscard]]
-    ImuSample getLatestGyro() const;
+    ImuSample getLatestGyro();
 
-    /// Get sensor statistics (resets counters)
+    /// Move every sample recorded since the previous drain into out (accel first, then gyro,
+    /// each in timestamp order, then uncalibrated companions in arrival order). When out is too
+    /// small the remainder is kept for the next call, with capacity shared between the streams
+    /// so none starves.
+    /// @return Number of records written
+    size_t drainHistory(PackedImuSample* out, size_t capacity);
+
+    /// Oldest samples overwritten because the history (or direct channel ring) was not drained in time
+    /// (cumulative)
+    [[nodiscard]]
+    int64_t getHistoryOverflowCount() const noexcept {
+        return historyOverflows_.load(std::memory_order_acquire);
+    }
+
+    /// Get the latest fused orientation (lock-free, never blocks the sensor thread).
+    /// In direct mode this first pulls new events from the shared ring.
+    [[nodiscard]]
+    OrientationSample getLatestOrientation();
+
+    /// Move every orientation produced since the previous drain into out (timestamp order)
+    /// @return Number of records written
+    size_t drainOrientationHistory(OrientationSample* out, size_t capacity);
+
+    /// Orientations overwritten because drainOrientationHistory() was not called in time
+    [[nodiscard]]
+    int64_t getOrientationOverflowCount() const noexcept {
+        return fusion_.getHistoryOverflowCount();
+    }
+
+    /// Get sensor statistics since the previous call (starts a new window)
     ImuStats getStats();
 
+    /// Cumulative event totals, read without starting a new getStats() window. Pollers that
+    /// keep their own window (the state notifier) diff two reads with imuStatsBetween().
+    /// In direct mode this first pulls new events from the shared ring.
+    [[nodiscard]]
+    ImuEventTotals getEventTotals();
+
     /// Get current sensor metadata
     [[nodiscard]]
     ImuSensorMetadata getMetadata() const;
@@ -62,38 +166,113 @@ public:
 
 private:
     void sensorThreadLoop();
+    /// Direct mode replacement for the sensor thread: pumps the shared ring on a timer
+    void directPumpLoop();
+    void selectSensors();
+    void selectCompanions();
+    void registerAccel();
+    void registerGyro();
+    void registerCompanion(const ASensor* sensor, const ImuSensorConfig& config, bool unbatched);
+    void applySensorSwitch();
+    bool switchDirectSensors();
+    void publishDirectMetadata();
+    /// Publish the selected accel/gyro for getMetadata() (whichever thread changed them)
+    void publishSensorSelection();
+    bool startDirectChannel();
+    void stopDirectChannel();
+    void pumpDirectChannel();
     void drainEvents();
+    void processBatch(const ASensorEvent* events, size_t count);
+    void applyBatchLatency(bool unbatched);
     static int64_t getBootTimeNs() noexcept;
 
     std::atomic<bool> running_{false};
     std::thread sensorThread_;
+    std::atomic<int32_t> sensorThreadId_{0};
     ImuCallback callback_;
+    ImuBatchCallback batchCallback_;
+    ImuStartOptions options_;
 
     std::atomic<int32_t> targetAccelHandle_{-1};
     std::atomic<int32_t> targetGyroHandle_{-1};
     std::atomic<bool> needsSensorSwitch_{false};
+    std::atomic<bool> flushRequested_{false};
+    int64_t flushHoldUntilNs_ = 0;  // Sensor thread only; 0 when batching is in effect
 
     ASensorManager* sensorManager_ = nullptr;
     ALooper* looper_ = nullptr;
     ASensorEventQueue* eventQueue_ = nullptr;
     const ASensor* currentAccel_ = nullptr;
     const ASensor* currentGyro_ = nullptr;
+    const ASensor* accelCompanion_ = nullptr;   // Uncalibrated variants (streamUncalibrated)
+    const ASensor* gyroCompanion_ = nullptr;
+
+    // switchSensors() waits here until the sensor thread has applied its request
+    std::mutex switchMutex_;
+    std::condition_variable switchCondition_;
+    std::atomic<uint64_t> switchRequests_{0};
+    uint64_t switchesApplied_ = 0;  // Guarded by switchMutex_
+
+    /// Cumulative per-sensor event counters, published by the sensor thread
+    using ImuCounters = ImuEventTotals;
+
+    // Written only by the sensor thread, read lock-free by pollers
+    SeqLock<ImuSample> latestAccel_;
+    SeqLock<ImuSample> latestGyro_;
+    SeqLock<ImuCounters> counters_;
+    ImuCounters writerCounters_{};  // Sensor thread's running totals
+
+    // Switch gap measurement (writer only): timestamp a replacement sensor's first sample is
+    // measured from, 0 when no switch is pending
+    SeqLock<ImuSwitchStats> switchStats_;
+    ImuSwitchStats writerSwitchStats_{};
+    int64_t lastAccelTimestampNs_ = 0;
+    int64_t lastGyroTimestampNs_ = 0;
+    int64_t accelGapFromNs_ = 0;
+    int64_t gyroGapFromNs_ = 0;
+
+    // Full-rate history: sensor thread produces, drainHistory() consumes. When the consumer
+    // falls a full history behind the oldest samples are overwritten, so a late drain still
+    // returns the most recent kHistoryCapacity samples.
+    using HistoryRing = RingBuffer<ImuSample, kHistoryCapacity, RingOverflow::OverwriteOldest>;
+    HistoryRing accelHistory_;
+    HistoryRing gyroHistory_;
+    HistoryRing companionHistory_;
+    std::atomic<int64_t> historyOverflows_{0};
+    std::mutex historyDrainMutex_;  // Serializes consumers; the sensor thread never takes it
+
+    // Orientation from the same writer as the raw samples, drained under historyDrainMutex_
+    FusionEngine fusion_;
+
+    // Direct report mode: sensorThread_ runs directPumpLoop(), which pumps the shared ring on a
+    // timer so callbacks and fusion advance without a poller; pollers also pump on demand for
+    // fresh data. Every pump holds historyDrainMutex_, which makes the pumping thread the
+    // (serialized) single writer of the state above.
+    DirectSensorChannel directChannel_;
+    std::atomic<bool> directMode_{false};
 
-    mutable std::mutex dataMutex_;
-    ImuSample latestAccel_{};
-    ImuSample latestGyro_{};
+    // History rings live inside the manager; the direct channel ring only while it is open
+    MemoryReservation ringReservation_;
+    MemoryReservation directChannelReservation_;
 
-    mutable std::mutex statsMutex_;
+    // Reader-side stats window; the sensor thread never takes this lock
+    std::mutex statsWindowMutex_;
     int64_t statsWindowStart_ = 0;
-    int32_t accelCount_ = 0;
-    int32_t gyroCount_ = 0;
-    int64_t accelLatencyTotal_ = 0;
-    int64_t gyroLatencyTotal_ = 0;
+    ImuCounters statsWindowBase_{};
 
     std::atomic<int32_t> accelMinDelay_{0};
     std::atomic<int32_t> accelFifo_{0};
     std::atomic<int32_t> gyroMinDelay_{0};
     std::atomic<int32_t> gyroFifo_{0};
+    std::atomic<int32_t> accelBatchLatency_{0};
+    std::atomic<int32_t> gyroBatchLatency_{0};
+    // Selection as seen by getMetadata(); currentAccel_/currentGyro_ change on the sensor thread
+    std::atomic<const char*> accelName_{nullptr};
+    std::atomic<const char*> gyroName_{nullptr};
+    std::atomic<int32_t> accelHandle_{-1};
+    std::atomic<int32_t> gyroHandle_{-1};
+    int32_t accelPeriodUs_ = 0;     // Registered sampling periods (sensor thread only)
+    int32_t gyroPeriodUs_ = 0;
 
     static constexpr const char* kPackageName = "com.tw0b33rs.nativesensoraccess";
 };
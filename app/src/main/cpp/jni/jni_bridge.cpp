@@ -1,18 +1,36 @@
 #include <jni.h>
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <memory>
 #include <vector>
+#include <functional>
 #include <unordered_map>
 #include <algorithm>
+#include <chrono>
 #include <android/log.h>
 #include <android/native_window_jni.h>
+#include <android/hardware_buffer_jni.h>
+#include <unistd.h>
 
 #include "imu_manager.h"
+#include "callback_handler.h"
 #include "camera_manager.h"
 #include "camera_stream.h"
 #include "camera_encoder_bridge.h"
+#include "camera_session_registry.h"
+#include "device_registry.h"
+#include "multi_camera_capture.h"
+#include "native_encoder.h"
+#include "imu_frame_sync.h"
 #include "jni_helpers.h"
+#include "memory_budget.h"
+#include "session_recorder.h"
+#include "session_replayer.h"
+#include "state_notifier.h"
+#include "state_snapshot_format.h"
+#include "thread_scheduling.h"
+#include "trace.h"
 
 namespace {
 
@@ -27,19 +45,140 @@ constexpr double kNsToMs = 1'000'000.0;
 std::unique_ptr<nativesensor::ImuManager> g_imuManager;
 std::mutex g_imuMutex;
 
-// Camera manager singleton and per-camera streams
+// Camera manager singleton and the registry of shared per-camera sessions
+// (previews and encoder captures on one camera id share a single device)
 std::unique_ptr<nativesensor::CameraManager> g_cameraManager;
-std::unordered_map<std::string, std::unique_ptr<nativesensor::CameraStream>> g_cameraStreams;
+std::unique_ptr<nativesensor::CameraSessionRegistry> g_cameraSessions;
 std::mutex g_cameraMutex;
 
-// Encoder bridge for frame capture (streaming)
-std::unique_ptr<nativesensor::CameraEncoderBridge> g_encoderBridge;
-std::mutex g_encoderMutex;
+// IMU window shared by every frame consumer; fed by the IMU batch callback
+nativesensor::ImuFrameSync g_imuFrameSync;
+
+// Session recording of IMU batches and captured frames; control guarded by g_recordingMutex
+nativesensor::SessionRecorder g_sessionRecorder;
+std::mutex g_recordingMutex;
+
+// Replay of a recorded session into the same consumers as live capture (g_recordingMutex)
+nativesensor::SessionReplayer g_sessionReplayer;
+
+// Binary sensor/camera enumeration snapshot, created on first query
+std::unique_ptr<nativesensor::DeviceRegistry> g_deviceRegistry;
+std::mutex g_deviceRegistryMutex;
+
+// Kotlin DeviceChangeListener, called from the camera service thread
+nativesensor::CallbackHandler g_deviceListener;
+
+// Push-based UI state (StateUpdates). The notifier thread writes each update into the
+// registered direct buffer, which is set before the notifier starts and cleared after it stops.
+nativesensor::StateNotifier g_stateNotifier;
+nativesensor::CallbackHandler g_stateCallback;      // Kotlin NativeStateCallback
+std::mutex g_stateMutex;                            // Serializes start/stop
+jobject g_stateBufferRef = nullptr;                 // Global ref keeping the buffer alive
+nativesensor::StateSnapshot* g_stateBuffer = nullptr;
+nativesensor::StateSnapshot g_lastState;            // Notifier thread only
+bool g_statePublished = false;                      // Notifier thread only
+
+// IMU rate/latency window of the pushed state, kept apart from ImuManager::getStats() so
+// neither resets the other's window. Refreshed once per window, so a steady stream does not
+// republish the stats section on every notifier tick.
+constexpr int64_t kStateImuWindowNs = 1'000'000'000;
+nativesensor::ImuEventTotals g_stateImuBase{};      // Notifier thread only
+int64_t g_stateImuWindowStartNs = 0;                // Notifier thread only
+
+// Native worker thread roles, matching the Kotlin ThreadRole ordinals
+constexpr int kThreadRoleImu = 0;                   // ImuManager sensor thread
+constexpr int kThreadRoleFrameDispatch = 1;         // Capture dispatch threads
+constexpr int kThreadRoleEncoder = 2;               // Hardware encoder output thread
+constexpr int kThreadRoleBackground = 3;            // State notifier, replay
+constexpr int kThreadRoleCount = 4;
+
+/// A thread started with makeJvmThreadHooks, tracked so its role's scheduling can be changed
+/// while it runs and its scheduler counters reported
+struct ManagedThread {
+    int role = kThreadRoleBackground;
+    int32_t tid = 0;
+};
+
+std::mutex g_threadMutex;
+nativesensor::ThreadSchedulingConfig g_threadConfigs[kThreadRoleCount];   // Guarded by g_threadMutex
+std::vector<ManagedThread> g_managedThreads;                            // Guarded by g_threadMutex
+
+// APerformanceHint session over the dispatch and encoder threads, open while a work target
+// is set and any of those threads runs
+nativesensor::PerformanceHintSession g_frameHintSession;
+int64_t g_frameWorkTargetNs = 0;                                        // Guarded by g_threadMutex
+
+// Recording stream ids: encoder captures (one per camera id, in first-capture order), one per
+// multi-capture physical camera, then the hardware encoder
+constexpr uint32_t kEncoderFirstStreamId = 0;
+constexpr uint32_t kMaxEncoderStreams = 4;
+constexpr uint32_t kMultiCaptureFirstStreamId = kEncoderFirstStreamId + kMaxEncoderStreams;
+constexpr uint32_t kNativeEncoderStreamId =
+    kMultiCaptureFirstStreamId + nativesensor::MultiCameraFrameSet::kMaxFrames;
+constexpr uint32_t kNoStreamId = UINT32_MAX;
+static_assert(kNativeEncoderStreamId < nativesensor::SessionRecorder::kMaxStreams,
+              "Recording stream ids exceed SessionRecorder::kMaxStreams");
 
 // JVM reference for encoder callbacks
 JavaVM* g_jvm = nullptr;
-jobject g_frameCallbackObj = nullptr;
-jmethodID g_onFrameMethod = nullptr;
+
+/// Classes and callback method ids resolved once in JNI_OnLoad and read-only afterwards.
+/// Callback methods are resolved on their Kotlin interfaces, so every implementation shares
+/// one id and registration never looks anything up.
+struct JniCache {
+    jclass byteBufferClass = nullptr;       // Global ref
+    jmethodID onFrame = nullptr;            // NativeFrameCallback
+    jmethodID onHardwareBuffer = nullptr;
+    jmethodID onEncodedPacket = nullptr;    // NativeEncodedPacketCallback
+    jmethodID onFrameSet = nullptr;         // MultiCameraFrameCallback
+    jmethodID onCameraReady = nullptr;      // CameraPrewarmCallback
+    jmethodID onDevicesChanged = nullptr;   // DeviceChangeListener
+    jmethodID onStateChanged = nullptr;     // NativeStateCallback
+};
+JniCache g_jni;
+
+/// A NativeFrameCallback. Captures share one target; the global ref is deleted once the
+/// last capture (or in-flight delivery) drops it.
+struct JavaFrameTarget {
+    jobject callback = nullptr;
+
+    JavaFrameTarget() = default;
+    JavaFrameTarget(const JavaFrameTarget&) = delete;
+    JavaFrameTarget& operator=(const JavaFrameTarget&) = delete;
+
+    ~JavaFrameTarget() {
+        if (!callback || !g_jvm) return;
+        nativesensor::JniThreadAttachment attachment(g_jvm);
+        if (JNIEnv* env = attachment.env()) {
+            env->DeleteGlobalRef(callback);
+        }
+    }
+};
+
+using FrameTargetPtr = std::shared_ptr<const JavaFrameTarget>;
+
+/// Delivery state of one camera's encoder capture, captured by its frame callbacks.
+/// Dispatch threads load the target without locking; callback changes swap it.
+struct CaptureRoute {
+    FrameTargetPtr target;                  // std::atomic_load/atomic_store only
+    uint32_t streamId = kNoStreamId;        // Recording stream, kNoStreamId if not recorded
+};
+
+// Frame callback targets and capture routes (guarded by g_frameTargetMutex for updates).
+// The default target serves every capture without a per-camera callback, and session replay.
+std::mutex g_frameTargetMutex;
+FrameTargetPtr g_defaultFrameTarget;        // Also read with std::atomic_load
+std::unordered_map<std::string, FrameTargetPtr> g_cameraFrameTargets;
+std::unordered_map<std::string, std::shared_ptr<CaptureRoute>> g_captureRoutes;
+std::unordered_map<std::string, uint32_t> g_encoderStreamIds;   // Stable for the process
+
+// Hardware encoder control and its packet callback
+std::mutex g_nativeEncoderMutex;
+nativesensor::CallbackHandler g_packetCallback;
+
+// Multi-camera capture control and its frame set callback
+std::mutex g_multiCaptureMutex;
+nativesensor::CallbackHandler g_frameSetCallback;
 
 nativesensor::ImuManager* getImuManager() {
     std::lock_guard<std::mutex> lock(g_imuMutex);
@@ -49,71 +188,458 @@ nativesensor::ImuManager* getImuManager() {
     return g_imuManager.get();
 }
 
-nativesensor::CameraManager* getCameraManager() {
+nativesensor::CameraSessionRegistry& getCameraSessions() {
     std::lock_guard<std::mutex> lock(g_cameraMutex);
     if (!g_cameraManager) {
         g_cameraManager = std::make_unique<nativesensor::CameraManager>();
     }
-    return g_cameraManager.get();
+    if (!g_cameraSessions) {
+        g_cameraSessions = std::make_unique<nativesensor::CameraSessionRegistry>(*g_cameraManager);
+    }
+    return *g_cameraSessions;
 }
 
-nativesensor::CameraStream* getOrCreateCameraStream(const std::string& cameraId) {
-    // Get manager first (uses the same mutex)
-    auto* manager = getCameraManager();
+nativesensor::CameraManager* getCameraManager() {
+    return &getCameraSessions().getManager();
+}
 
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
-    auto it = g_cameraStreams.find(cameraId);
-    if (it == g_cameraStreams.end()) {
-        auto stream = std::make_unique<nativesensor::CameraStream>(*manager);
-        auto* ptr = stream.get();
-        g_cameraStreams[cameraId] = std::move(stream);
-        return ptr;
+nativesensor::DeviceRegistry& getDeviceRegistry() {
+    nativesensor::ImuManager& imu = *getImuManager();
+    nativesensor::CameraManager& cameras = *getCameraManager();
+
+    std::lock_guard<std::mutex> lock(g_deviceRegistryMutex);
+    if (!g_deviceRegistry) {
+        g_deviceRegistry = std::make_unique<nativesensor::DeviceRegistry>(imu, cameras);
+        g_deviceRegistry->setChangeListener([](uint64_t generation) {
+            if (!g_deviceListener.hasCallback() || !g_jni.onDevicesChanged) return;
+
+            JNIEnv* callbackEnv = nativesensor::attachCurrentThreadPermanently(g_jvm);
+            g_deviceListener.invokeCallback(callbackEnv, [generation](JNIEnv* env, jobject listener) {
+                // Call Java listener: onDevicesChanged(long generation)
+                env->CallVoidMethod(listener, g_jni.onDevicesChanged,
+                                    static_cast<jlong>(generation));
+                nativesensor::clearUpcallException(env);
+            });
+        });
     }
-    return it->second.get();
+    return *g_deviceRegistry;
 }
 
-void stopCameraStream(const std::string& cameraId) {
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
-    auto it = g_cameraStreams.find(cameraId);
-    if (it != g_cameraStreams.end()) {
-        it->second->stopPreview();
-        g_cameraStreams.erase(it);
+/// Point the frame pipeline hint session at the running dispatch and encoder threads.
+/// Caller holds g_threadMutex.
+void refreshFrameHintSessionLocked() {
+    std::vector<int32_t> tids;
+    for (const ManagedThread& thread : g_managedThreads) {
+        if (thread.role == kThreadRoleFrameDispatch || thread.role == kThreadRoleEncoder) {
+            tids.push_back(thread.tid);
+        }
+    }
+    if (g_frameWorkTargetNs > 0 && !tids.empty()) {
+        g_frameHintSession.open(tids, g_frameWorkTargetNs);
+    } else {
+        g_frameHintSession.close();
     }
 }
 
-void stopAllCameraStreams() {
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
-    for (auto& [id, stream] : g_cameraStreams) {
-        stream->stopPreview();
+/// Hooks that attach a native worker thread to the JVM once for its whole lifetime (the
+/// thread detaches itself when it exits) and apply its role's scheduling
+nativesensor::DispatcherThreadHooks makeJvmThreadHooks(const char* threadName, int role) {
+    nativesensor::DispatcherThreadHooks hooks;
+    hooks.onThreadStart = [threadName, role] {
+        if (!nativesensor::attachCurrentThreadPermanently(g_jvm, threadName)) {
+            LOGE("Failed to attach %s thread to JVM", threadName);
+        }
+
+        std::lock_guard<std::mutex> lock(g_threadMutex);
+        ManagedThread thread;
+        thread.role = role;
+        thread.tid = nativesensor::currentThreadId();
+        if (!g_threadConfigs[role].isDefault()) {
+            nativesensor::applyThreadScheduling(thread.tid, g_threadConfigs[role]);
+        }
+        g_managedThreads.push_back(thread);
+        refreshFrameHintSessionLocked();
+    };
+    hooks.onThreadStop = [] {
+        const int32_t tid = nativesensor::currentThreadId();
+        std::lock_guard<std::mutex> lock(g_threadMutex);
+        g_managedThreads.erase(
+            std::remove_if(g_managedThreads.begin(), g_managedThreads.end(),
+                           [tid](const ManagedThread& thread) { return thread.tid == tid; }),
+            g_managedThreads.end());
+        refreshFrameHintSessionLocked();
+    };
+    return hooks;
+}
+
+/// Wrap a NativeFrameCallback into a shareable target
+/// @return nullptr if callback is null or the interface was not resolved at load
+FrameTargetPtr makeFrameTarget(JNIEnv* env, jobject callback) {
+    if (!callback) return nullptr;
+    if (!g_jni.onFrame) {
+        LOGE("NativeFrameCallback.onFrame was not resolved at load");
+        return nullptr;
+    }
+
+    auto target = std::make_shared<JavaFrameTarget>();
+    target->callback = env->NewGlobalRef(callback);
+    return target;
+}
+
+/// Per-camera callback if one is set, else the default. Caller holds g_frameTargetMutex.
+FrameTargetPtr effectiveFrameTargetLocked(const std::string& cameraId) {
+    auto it = g_cameraFrameTargets.find(cameraId);
+    return it != g_cameraFrameTargets.end() ? it->second : g_defaultFrameTarget;
+}
+
+/// Route for a camera's capture, created with the camera's recording stream on first use
+std::shared_ptr<CaptureRoute> acquireCaptureRoute(const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(g_frameTargetMutex);
+    auto& route = g_captureRoutes[cameraId];
+    if (!route) {
+        route = std::make_shared<CaptureRoute>();
+        auto stream = g_encoderStreamIds.find(cameraId);
+        if (stream == g_encoderStreamIds.end() && g_encoderStreamIds.size() < kMaxEncoderStreams) {
+            const auto streamId = kEncoderFirstStreamId +
+                                  static_cast<uint32_t>(g_encoderStreamIds.size());
+            stream = g_encoderStreamIds.emplace(cameraId, streamId).first;
+        }
+        if (stream != g_encoderStreamIds.end()) {
+            route->streamId = stream->second;
+        } else {
+            LOGI("Capture of camera %s will not be recorded (stream ids exhausted)",
+                 cameraId.c_str());
+        }
+        std::atomic_store(&route->target, effectiveFrameTargetLocked(cameraId));
+    }
+    return route;
+}
+
+/// Copy a packed frame into a byte array and invoke target.onFrame.
+/// Must run on a thread attached through makeJvmThreadHooks().
+void deliverFrameToJava(const JavaFrameTarget& target, const uint8_t* data, jsize size,
+                        int32_t width, int32_t height, int64_t timestampNs) {
+    if (!g_jvm) return;
+    NS_TRACE_SCOPE("JNI onFrame");
+
+    JNIEnv* callbackEnv = nativesensor::getEnvForCurrentThread(g_jvm);
+    if (!callbackEnv) return;
+
+    // Create byte array and copy frame data
+    jbyteArray jdata = callbackEnv->NewByteArray(size);
+    if (jdata) {
+        callbackEnv->SetByteArrayRegion(jdata, 0, size, reinterpret_cast<const jbyte*>(data));
+
+        // Call Java callback: onFrame(byte[] data, int width, int height, long timestampNs)
+        callbackEnv->CallVoidMethod(target.callback, g_jni.onFrame,
+                                    jdata, width, height, static_cast<jlong>(timestampNs));
+        nativesensor::clearUpcallException(callbackEnv);
+        callbackEnv->DeleteLocalRef(jdata);
+    }
+}
+
+/// Camera id argument of a per-camera StreamingBridge call; empty for null
+std::string optionalCameraId(JNIEnv* env, jstring cameraId) {
+    if (!cameraId) return {};
+    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(cameraId, idStr);
+    return id;
+}
+
+/// Run fn on the camera's encoder capture, or on any capture for an empty id (the single
+/// capture of callers that never name a camera). Runs outside the registry lock.
+bool withCapture(const std::string& cameraId,
+                 const std::function<void(nativesensor::CameraEncoderBridge&)>& fn) {
+    auto& sessions = getCameraSessions();
+    if (!cameraId.empty()) {
+        return sessions.withEncoder(cameraId, fn);
+    }
+    bool found = false;
+    sessions.forEachEncoder([&](const std::string&, nativesensor::CameraEncoderBridge& encoder) {
+        if (!found) {
+            fn(encoder);
+            found = true;
+        }
+    });
+    return found;
+}
+
+/// Kotlin FrameFormat value to the native packed layout (unknown values fall back to I420)
+nativesensor::YuvOutputFormat toYuvOutputFormat(jint value) {
+    switch (value) {
+        case static_cast<jint>(nativesensor::YuvOutputFormat::NV12):
+            return nativesensor::YuvOutputFormat::NV12;
+        case static_cast<jint>(nativesensor::YuvOutputFormat::Y8):
+            return nativesensor::YuvOutputFormat::Y8;
+        default:
+            return nativesensor::YuvOutputFormat::I420;
+    }
+}
+
+/// Combined stats of every streaming preview: mean fps, max latency, total frames and
+/// total dropped frames
+/// @return Number of streaming previews
+int combinedPreviewStats(float out[4]) {
+    float avgFrameRate = 0.0f;
+    float maxLatency = 0.0f;
+    float totalFrameCount = 0.0f;
+    float totalDroppedFrames = 0.0f;
+    int activeStreamCount = 0;
+
+    getCameraSessions().forEachPreview([&](const std::string&, nativesensor::CameraStream& stream) {
+        if (stream.isStreaming()) {
+            auto stats = stream.getStats();
+            avgFrameRate += stats.frameRateHz;
+            maxLatency = std::max(maxLatency, stats.latencyMs);
+            totalFrameCount += static_cast<float>(stats.frameCount);
+            totalDroppedFrames += static_cast<float>(stats.droppedFrames);
+            activeStreamCount++;
+        }
+    });
+
+    // Average frame rate across all streams instead of sum
+    // (individual camera FPS is meaningful, summed FPS is not)
+    if (activeStreamCount > 0) {
+        avgFrameRate /= static_cast<float>(activeStreamCount);
+    }
+
+    out[0] = avgFrameRate;
+    out[1] = maxLatency;
+    out[2] = totalFrameCount;
+    out[3] = totalDroppedFrames;
+    return activeStreamCount;
+}
+
+/// x, y, z and timestamp (ms) of a sample, the layout of the polled IMU getters
+void packSample(const nativesensor::ImuSample& sample, float out[4]) {
+    out[0] = sample.x;
+    out[1] = sample.y;
+    out[2] = sample.z;
+    out[3] = static_cast<float>(static_cast<double>(sample.timestampNs) / kNsToMs);
+}
+
+template <typename T, size_t N>
+bool sectionChanged(const T (&next)[N], const T (&last)[N]) {
+    return std::memcmp(next, last, sizeof(next)) != 0;
+}
+
+/// StateNotifier collection: gather the UI state, diff it against the last update and, if
+/// any section changed, publish it to Kotlin with a single upcall
+/// @return true while sensors, a replay or a preview are live, so their stats keep refreshing
+bool collectState() {
+    auto* manager = getImuManager();
+    const bool replaying = g_sessionReplayer.isRunning();
+
+    // A running replay stands in for the sensors
+    nativesensor::StateSnapshot next;
+    packSample(replaying ? g_sessionReplayer.getLatestAccel() : manager->getLatestAccel(),
+               next.accel);
+    packSample(replaying ? g_sessionReplayer.getLatestGyro() : manager->getLatestGyro(),
+               next.gyro);
+
+    const nativesensor::ImuEventTotals totals = manager->getEventTotals();
+    const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const bool restarted = totals.accelCount < g_stateImuBase.accelCount ||
+                           totals.gyroCount < g_stateImuBase.gyroCount;
+    if (restarted || g_stateImuWindowStartNs == 0) {
+        // Totals restart with each IMU start; open a fresh window and keep the last readout
+        g_stateImuBase = totals;
+        g_stateImuWindowStartNs = nowNs;
+        std::memcpy(next.imuStats, g_lastState.imuStats, sizeof(next.imuStats));
+    } else if (nowNs - g_stateImuWindowStartNs >= kStateImuWindowNs) {
+        const auto stats = nativesensor::imuStatsBetween(g_stateImuBase, totals,
+                                                         nowNs - g_stateImuWindowStartNs);
+        next.imuStats[0] = stats.accelFrequencyHz;
+        next.imuStats[1] = stats.accelLatencyMs;
+        next.imuStats[2] = stats.gyroFrequencyHz;
+        next.imuStats[3] = stats.gyroLatencyMs;
+        g_stateImuBase = totals;
+        g_stateImuWindowStartNs = nowNs;
+    } else {
+        std::memcpy(next.imuStats, g_lastState.imuStats, sizeof(next.imuStats));
+    }
+
+    const auto meta = manager->getMetadata();
+    next.imuMetadata[0] = meta.accelMinDelayUs;
+    next.imuMetadata[1] = meta.accelFifoReserved;
+    next.imuMetadata[2] = meta.gyroMinDelayUs;
+    next.imuMetadata[3] = meta.gyroFifoReserved;
+    next.imuMetadata[4] = meta.accelBatchLatencyUs;
+    next.imuMetadata[5] = meta.gyroBatchLatencyUs;
+    next.imuRunning = manager->isRunning() ? 1 : 0;
+    next.activeCameraStreams = combinedPreviewStats(next.cameraStats);
+
+    const bool live = next.imuRunning != 0 || replaying || next.activeCameraStreams > 0;
+
+    uint32_t changed = 0;
+    if (!g_statePublished) {
+        changed = nativesensor::kStateChangedImuSamples | nativesensor::kStateChangedImuStats |
+                  nativesensor::kStateChangedImuMetadata | nativesensor::kStateChangedCameraStats;
+    } else {
+        if (sectionChanged(next.accel, g_lastState.accel) ||
+            sectionChanged(next.gyro, g_lastState.gyro)) {
+            changed |= nativesensor::kStateChangedImuSamples;
+        }
+        if (sectionChanged(next.imuStats, g_lastState.imuStats)) {
+            changed |= nativesensor::kStateChangedImuStats;
+        }
+        if (sectionChanged(next.imuMetadata, g_lastState.imuMetadata) ||
+            next.imuRunning != g_lastState.imuRunning) {
+            changed |= nativesensor::kStateChangedImuMetadata;
+        }
+        if (sectionChanged(next.cameraStats, g_lastState.cameraStats) ||
+            next.activeCameraStreams != g_lastState.activeCameraStreams) {
+            changed |= nativesensor::kStateChangedCameraStats;
+        }
+    }
+    if (changed == 0) {
+        // Nothing for the UI to redraw; no upcall
+        return live;
+    }
+
+    next.changedMask = changed;
+    next.sequence = g_lastState.sequence + 1;
+    g_lastState = next;
+    g_statePublished = true;
+
+    if (!g_stateBuffer || !g_stateCallback.hasCallback() || !g_jni.onStateChanged) {
+        return live;
+    }
+    std::memcpy(g_stateBuffer, &next, sizeof(next));
+
+    JNIEnv* callbackEnv = nativesensor::getEnvForCurrentThread(g_jvm);
+    g_stateCallback.invokeCallback(callbackEnv, [changed](JNIEnv* env, jobject callback) {
+        // Call Java callback: onStateChanged(int changedMask); the buffer is read before it returns
+        env->CallVoidMethod(callback, g_jni.onStateChanged, static_cast<jint>(changed));
+        nativesensor::clearUpcallException(env);
+    });
+    return live;
+}
+
+/// Copy a latency snapshot into a direct ByteBuffer
+/// @return Bytes written, or 0 if the buffer is not direct or too small
+jint writeLatencySnapshot(JNIEnv* env, jobject buffer,
+                          const nativesensor::FrameLatencySnapshot& snapshot) {
+    if (!buffer) return 0;
+
+    void* address = env->GetDirectBufferAddress(buffer);
+    const jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (!address || capacity < static_cast<jlong>(sizeof(snapshot))) {
+        LOGE("Latency snapshot requires a direct ByteBuffer of %zu bytes", sizeof(snapshot));
+        return 0;
     }
-    g_cameraStreams.clear();
+
+    std::memcpy(address, &snapshot, sizeof(snapshot));
+    return static_cast<jint>(sizeof(snapshot));
 }
 
-// JNI_OnLoad - capture JVM reference for encoder callbacks
+}  // namespace
+
+extern "C" {
+
+// JNI_OnLoad - capture the JVM and resolve the JNI cache for native callbacks
 JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /*reserved*/) {
     JNIEnv* env;
     if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
         return JNI_ERR;
     }
     g_jvm = vm;
+
+    // Resolve every class and callback method used off the calling thread once, here
+    g_jni.byteBufferClass = nativesensor::findGlobalClass(env, "java/nio/ByteBuffer");
+    g_jni.onFrame = nativesensor::findMethod(
+        env, "com/tw0b33rs/nativesensoraccess/streaming/NativeFrameCallback",
+        "onFrame", "([BIIJ)V");
+    g_jni.onHardwareBuffer = nativesensor::findMethod(
+        env, "com/tw0b33rs/nativesensoraccess/streaming/NativeFrameCallback",
+        "onHardwareBuffer", "(Landroid/hardware/HardwareBuffer;IIJJ)V");
+    g_jni.onEncodedPacket = nativesensor::findMethod(
+        env, "com/tw0b33rs/nativesensoraccess/streaming/NativeEncodedPacketCallback",
+        "onEncodedPacket", "(Ljava/nio/ByteBuffer;JI)V");
+    g_jni.onFrameSet = nativesensor::findMethod(
+        env, "com/tw0b33rs/nativesensoraccess/sensor/MultiCameraFrameCallback",
+        "onFrameSet", "(J[Ljava/nio/ByteBuffer;[JII)V");
+    g_jni.onCameraReady = nativesensor::findMethod(
+        env, "com/tw0b33rs/nativesensoraccess/sensor/CameraPrewarmCallback",
+        "onCameraReady", "(Ljava/lang/String;Z)V");
+    g_jni.onDevicesChanged = nativesensor::findMethod(
+        env, "com/tw0b33rs/nativesensoraccess/sensor/DeviceChangeListener",
+        "onDevicesChanged", "(J)V");
+    g_jni.onStateChanged = nativesensor::findMethod(
+        env, "com/tw0b33rs/nativesensoraccess/sensor/NativeStateCallback",
+        "onStateChanged", "(I)V");
+    if (!g_jni.byteBufferClass || !g_jni.onFrame || !g_jni.onHardwareBuffer ||
+        !g_jni.onEncodedPacket || !g_jni.onFrameSet || !g_jni.onCameraReady ||
+        !g_jni.onDevicesChanged || !g_jni.onStateChanged) {
+        LOGE("Failed to resolve some JNI callback methods; those callbacks are disabled");
+    }
+
     LOGI("Native sensor library loaded successfully");
     return JNI_VERSION_1_6;
 }
 
-}  // namespace
-
-extern "C" {
-
 // Package: com.tw0b33rs.nativesensoraccess.sensor
 // Class: NativeSensorBridge
 
 JNIEXPORT void JNICALL
 Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeInit(
     JNIEnv* /* env */,
-    jobject /* thiz */) {
-    LOGI("NativeSensorBridge.nativeInit()");
+    jobject /* thiz */,
+    jint accelPeriodUs,
+    jlong accelBatchLatencyUs,
+    jint gyroPeriodUs,
+    jlong gyroBatchLatencyUs,
+    jboolean useDirectChannel,
+    jint fusionAlgorithm,
+    jfloat fusionGain,
+    jfloat fusionIntegralGain,
+    jboolean streamUncalibrated) {
+    LOGI("NativeSensorBridge.nativeInit(accel=%dμs/%lldμs, gyro=%dμs/%lldμs, direct=%d)",
+         accelPeriodUs, static_cast<long long>(accelBatchLatencyUs),
+         gyroPeriodUs, static_cast<long long>(gyroBatchLatencyUs), useDirectChannel);
+
+    nativesensor::ImuStartOptions options;
+    options.accel.samplingPeriodUs = accelPeriodUs;
+    options.accel.maxBatchReportLatencyUs = accelBatchLatencyUs;
+    options.gyro.samplingPeriodUs = gyroPeriodUs;
+    options.gyro.maxBatchReportLatencyUs = gyroBatchLatencyUs;
+    options.useDirectChannel = useDirectChannel == JNI_TRUE;
+    options.fusion.enabled =
+        fusionAlgorithm == static_cast<jint>(nativesensor::FusionAlgorithm::Madgwick) ||
+        fusionAlgorithm == static_cast<jint>(nativesensor::FusionAlgorithm::Mahony);
+    if (options.fusion.enabled) {
+        options.fusion.algorithm = static_cast<nativesensor::FusionAlgorithm>(fusionAlgorithm);
+    }
+    if (fusionGain > 0.0f) {
+        options.fusion.madgwickBeta = fusionGain;
+        options.fusion.mahonyKp = fusionGain;
+    }
+    options.fusion.mahonyKi = std::max(fusionIntegralGain, 0.0f);
+    options.streamUncalibrated = streamUncalibrated == JNI_TRUE;
+    {
+        std::lock_guard<std::mutex> lock(g_threadMutex);
+        options.scheduling = g_threadConfigs[kThreadRoleImu];
+    }
+
     auto* manager = getImuManager();
-    manager->start([](const nativesensor::ImuSample&) {});
+    manager->start([](const nativesensor::ImuSample&) {},
+                   [](const nativesensor::ImuSample* samples, size_t count) {
+                       g_imuFrameSync.addSamples(samples, count);
+                       g_sessionRecorder.recordImu(samples, count);
+                       g_stateNotifier.post();
+                   },
+                   options);
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeFlush(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    if (g_imuManager) {
+        g_imuManager->flush();
+    }
 }
 
 JNIEXPORT void JNICALL
@@ -126,89 +652,140 @@ Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeStop(
     }
 }
 
-JNIEXPORT jfloatArray JNICALL
+JNIEXPORT void JNICALL
 Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetAccelData(
     JNIEnv* env,
-    jobject /* thiz */) {
-    auto* manager = getImuManager();
-    auto sample = manager->getLatestAccel();
+    jobject /* thiz */,
+    jfloatArray out) {
+    // A running replay stands in for the sensors
+    auto sample = g_sessionReplayer.isRunning() ? g_sessionReplayer.getLatestAccel()
+                                                : getImuManager()->getLatestAccel();
 
-    jfloatArray result = env->NewFloatArray(4);
     float data[4] = {sample.x, sample.y, sample.z,
                      static_cast<float>(static_cast<double>(sample.timestampNs) / kNsToMs)};
-    env->SetFloatArrayRegion(result, 0, 4, data);
-    return result;
+    nativesensor::writeJavaArray(env, out, data, 4);
 }
 
-JNIEXPORT jfloatArray JNICALL
+JNIEXPORT void JNICALL
 Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetGyroData(
     JNIEnv* env,
-    jobject /* thiz */) {
-    auto* manager = getImuManager();
-    auto sample = manager->getLatestGyro();
+    jobject /* thiz */,
+    jfloatArray out) {
+    // A running replay stands in for the sensors
+    auto sample = g_sessionReplayer.isRunning() ? g_sessionReplayer.getLatestGyro()
+                                                : getImuManager()->getLatestGyro();
 
-    jfloatArray result = env->NewFloatArray(4);
     float data[4] = {sample.x, sample.y, sample.z,
                      static_cast<float>(static_cast<double>(sample.timestampNs) / kNsToMs)};
-    env->SetFloatArrayRegion(result, 0, 4, data);
-    return result;
+    nativesensor::writeJavaArray(env, out, data, 4);
 }
 
-JNIEXPORT jfloatArray JNICALL
-Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetStats(
+JNIEXPORT jint JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeDrainImu(
     JNIEnv* env,
+    jobject /* thiz */,
+    jobject buffer) {
+    if (!g_imuManager || !buffer) return 0;
+
+    // Caller-owned direct buffer: no allocation or array copy per poll
+    auto* address = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    const jlong capacityBytes = env->GetDirectBufferCapacity(buffer);
+    if (!address || capacityBytes <= 0) {
+        LOGE("nativeDrainImu requires a direct ByteBuffer");
+        return 0;
+    }
+
+    const size_t capacity = static_cast<size_t>(capacityBytes) / sizeof(nativesensor::PackedImuSample);
+    auto* records = reinterpret_cast<nativesensor::PackedImuSample*>(address);
+    return static_cast<jint>(g_imuManager->drainHistory(records, capacity));
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetImuOverflowCount(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    if (!g_imuManager) return 0;
+    return static_cast<jlong>(g_imuManager->getHistoryOverflowCount());
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetOrientation(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jfloatArray out) {
+    const nativesensor::OrientationSample sample = getImuManager()->getLatestOrientation();
+
+    float data[11] = {
+        sample.qw, sample.qx, sample.qy, sample.qz,
+        sample.gravityX, sample.gravityY, sample.gravityZ,
+        sample.linearX, sample.linearY, sample.linearZ,
+        static_cast<float>(static_cast<double>(sample.timestampNs) / kNsToMs)
+    };
+    nativesensor::writeJavaArray(env, out, data, 11);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeDrainOrientation(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jobject buffer) {
+    if (!g_imuManager || !buffer) return 0;
+
+    auto* address = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    const jlong capacityBytes = env->GetDirectBufferCapacity(buffer);
+    if (!address || capacityBytes <= 0) {
+        LOGE("nativeDrainOrientation requires a direct ByteBuffer");
+        return 0;
+    }
+
+    const size_t capacity =
+        static_cast<size_t>(capacityBytes) / sizeof(nativesensor::OrientationSample);
+    auto* records = reinterpret_cast<nativesensor::OrientationSample*>(address);
+    return static_cast<jint>(g_imuManager->drainOrientationHistory(records, capacity));
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetOrientationOverflowCount(
+    JNIEnv* /* env */,
     jobject /* thiz */) {
+    if (!g_imuManager) return 0;
+    return static_cast<jlong>(g_imuManager->getOrientationOverflowCount());
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jfloatArray out) {
     auto* manager = getImuManager();
     auto stats = manager->getStats();
 
-    jfloatArray result = env->NewFloatArray(4);
     float data[4] = {
         stats.accelFrequencyHz,
         stats.accelLatencyMs,
         stats.gyroFrequencyHz,
         stats.gyroLatencyMs
     };
-    env->SetFloatArrayRegion(result, 0, 4, data);
-    return result;
+    nativesensor::writeJavaArray(env, out, data, 4);
 }
 
-JNIEXPORT jintArray JNICALL
+JNIEXPORT void JNICALL
 Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetMetadata(
     JNIEnv* env,
-    jobject /* thiz */) {
+    jobject /* thiz */,
+    jintArray out) {
     auto* manager = getImuManager();
     auto meta = manager->getMetadata();
 
-    jintArray result = env->NewIntArray(4);
-    int data[4] = {
+    int data[6] = {
         meta.accelMinDelayUs,
         meta.accelFifoReserved,
         meta.gyroMinDelayUs,
-        meta.gyroFifoReserved
+        meta.gyroFifoReserved,
+        meta.accelBatchLatencyUs,
+        meta.gyroBatchLatencyUs
     };
-    env->SetIntArrayRegion(result, 0, 4, data);
-    return result;
-}
-
-JNIEXPORT jstring JNICALL
-Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeEnumerateSensors(
-    JNIEnv* env,
-    jobject /* thiz */) {
-    auto* manager = getImuManager();
-    auto sensors = manager->enumerateSensors();
-
-    std::ostringstream ss;
-    for (const auto& sensor : sensors) {
-        ss << sensor.handle << "|"
-           << static_cast<int>(sensor.type) << "|"
-           << (sensor.name ? sensor.name : "Unknown") << "|"
-           << (sensor.vendor ? sensor.vendor : "Unknown") << "|"
-           << sensor.minDelayUs << "|"
-           << sensor.maxFrequencyHz << "|"
-           << sensor.fifoReserved << "\n";
-    }
-
-    return env->NewStringUTF(ss.str().c_str());
+    nativesensor::writeJavaArray(env, out, data, 6);
 }
 
 JNIEXPORT void JNICALL
@@ -222,6 +799,44 @@ Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeSwitchSenso
     manager->switchSensors(accelHandle, gyroHandle);
 }
 
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetSwitchStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jlongArray out) {
+    const nativesensor::ImuSwitchStats stats = getImuManager()->getSwitchStats();
+
+    jlong data[5] = {
+        stats.switchCount,
+        stats.lastAccelGapNs,
+        stats.lastGyroGapNs,
+        stats.maxGapNs,
+        stats.lastReconfigureNs
+    };
+    nativesensor::writeJavaArray(env, out, data, 5);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeIsDirectChannelActive(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    if (!g_imuManager) return JNI_FALSE;
+    return g_imuManager->isDirectChannelActive() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeGetDirectChannelBuffer(
+    JNIEnv* env,
+    jobject /* thiz */) {
+    if (!g_imuManager) return nullptr;
+    const auto* channel = g_imuManager->getDirectChannel();
+    if (!channel || !channel->events()) return nullptr;
+
+    // Wraps the read-only mapping itself; valid until the IMU is stopped
+    return env->NewDirectByteBuffer(const_cast<ASensorEvent*>(channel->events()),
+                                    static_cast<jlong>(channel->sizeBytes()));
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeIsRunning(
     JNIEnv* /* env */,
@@ -231,121 +846,322 @@ Java_com_tw0b33rs_nativesensoraccess_sensor_NativeSensorBridge_nativeIsRunning(
 }
 
 // =============================================================================
-// Camera JNI Functions (CameraBridge)
+// Device enumeration (DeviceRegistry)
 // =============================================================================
 
-JNIEXPORT jstring JNICALL
-Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeEnumerateCameras(
-    JNIEnv* env,
+JNIEXPORT jlong JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_DeviceRegistry_nativeGetGeneration(
+    JNIEnv* /* env */,
     jobject /* thiz */) {
-    LOGI("CameraBridge.nativeEnumerateCameras()");
-    auto* manager = getCameraManager();
-    auto cameras = manager->enumerateCameras();
+    return static_cast<jlong>(getDeviceRegistry().getGeneration());
+}
 
-    std::ostringstream ss;
-    for (const auto& cam : cameras) {
-        ss << cam.id << "|"
-           << static_cast<int>(cam.facing) << "|"
-           << static_cast<int>(cam.clusterType) << "|"
-           << cam.width << "|"
-           << cam.height << "|"
-           << cam.maxFps << "|"
-           << (cam.isPhysicalCamera ? 1 : 0) << "|"
-           << cam.physicalCameraIds << "\n";
+JNIEXPORT jint JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_DeviceRegistry_nativeExportSnapshot(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jobject buffer) {
+    void* address = buffer ? env->GetDirectBufferAddress(buffer) : nullptr;
+    const jlong capacity = address ? env->GetDirectBufferCapacity(buffer) : 0;
+    const size_t size = getDeviceRegistry().exportTo(
+        address, capacity > 0 ? static_cast<size_t>(capacity) : 0);
+    return static_cast<jint>(size);
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_DeviceRegistry_nativeSetChangeListener(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jobject listener) {
+    if (listener && !g_jni.onDevicesChanged) {
+        LOGE("DeviceChangeListener.onDevicesChanged was not resolved at load");
+        return;
     }
 
-    return env->NewStringUTF(ss.str().c_str());
+    // Create the registry first so the camera listener is installed
+    getDeviceRegistry();
+    g_deviceListener.setCallback(env, listener);
+    LOGI(listener ? "Device change listener registered" : "Device change listener cleared");
 }
 
+// =============================================================================
+// Push-based UI state (StateUpdates)
+// =============================================================================
+
 JNIEXPORT jboolean JNICALL
-Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeStartPreview(
+Java_com_tw0b33rs_nativesensoraccess_sensor_StateUpdates_nativeStart(
     JNIEnv* env,
     jobject /* thiz */,
-    jstring cameraId,
-    jobject surface) {
-    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
-    std::string id(idStr);
-    env->ReleaseStringUTFChars(cameraId, idStr);
-
-    LOGI("CameraBridge.nativeStartPreview(%s)", id.c_str());
+    jobject buffer,
+    jfloat maxRateHz,
+    jobject callback) {
+    LOGI("StateUpdates.nativeStart(max %.1f Hz)", maxRateHz);
 
-    if (!surface) {
-        LOGE("Cannot start preview: null surface");
+    if (!callback || !g_jni.onStateChanged) {
+        LOGE("NativeStateCallback.onStateChanged was not resolved at load");
         return JNI_FALSE;
     }
-
-    ANativeWindow* window = ANativeWindow_fromSurface(env, surface);
-    if (!window) {
-        LOGE("Cannot start preview: failed to get ANativeWindow from surface");
+    void* address = buffer ? env->GetDirectBufferAddress(buffer) : nullptr;
+    if (!address || env->GetDirectBufferCapacity(buffer) <
+                        static_cast<jlong>(sizeof(nativesensor::StateSnapshot))) {
+        LOGE("State updates require a direct ByteBuffer of %zu bytes",
+             sizeof(nativesensor::StateSnapshot));
         return JNI_FALSE;
     }
 
-    auto* stream = getOrCreateCameraStream(id);
-    bool success = stream->startPreview(id, window, nullptr);
-    ANativeWindow_release(window);
+    std::lock_guard<std::mutex> lock(g_stateMutex);
+    if (g_stateNotifier.isRunning()) {
+        LOGI("State updates already running");
+        return JNI_FALSE;
+    }
 
-    return success ? JNI_TRUE : JNI_FALSE;
+    // The notifier thread is stopped, so its state can be reset from here
+    g_stateBufferRef = env->NewGlobalRef(buffer);
+    g_stateBuffer = static_cast<nativesensor::StateSnapshot*>(address);
+    g_lastState = {};
+    g_statePublished = false;
+    g_stateImuBase = {};
+    g_stateImuWindowStartNs = 0;
+    g_stateCallback.setCallback(env, callback);
+
+    if (!g_stateNotifier.start(collectState, maxRateHz, makeJvmThreadHooks("state notifier", kThreadRoleBackground))) {
+        g_stateCallback.reset(env);
+        g_stateBuffer = nullptr;
+        env->DeleteGlobalRef(g_stateBufferRef);
+        g_stateBufferRef = nullptr;
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
 }
 
 JNIEXPORT void JNICALL
-Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeStopPreview(
-    JNIEnv* /* env */,
+Java_com_tw0b33rs_nativesensoraccess_sensor_StateUpdates_nativeStop(
+    JNIEnv* env,
     jobject /* thiz */) {
-    LOGI("CameraBridge.nativeStopPreview() - stopping all cameras");
-    stopAllCameraStreams();
+    LOGI("StateUpdates.nativeStop()");
+
+    std::lock_guard<std::mutex> lock(g_stateMutex);
+    g_stateNotifier.stop();
+    g_stateCallback.reset(env);
+    g_stateBuffer = nullptr;
+    if (g_stateBufferRef) {
+        env->DeleteGlobalRef(g_stateBufferRef);
+        g_stateBufferRef = nullptr;
+    }
 }
 
 JNIEXPORT void JNICALL
-Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeStopCameraPreview(
-    JNIEnv* env,
+Java_com_tw0b33rs_nativesensoraccess_sensor_StateUpdates_nativeSetMaxRate(
+    JNIEnv* /* env */,
     jobject /* thiz */,
-    jstring cameraId) {
-    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
-    std::string id(idStr);
-    env->ReleaseStringUTFChars(cameraId, idStr);
-
-    LOGI("CameraBridge.nativeStopCameraPreview(%s)", id.c_str());
-    stopCameraStream(id);
+    jfloat maxRateHz) {
+    g_stateNotifier.setMaxRate(maxRateHz);
 }
 
-JNIEXPORT jfloatArray JNICALL
-Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetCameraStats(
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_StateUpdates_nativeGetStats(
     JNIEnv* env,
-    jobject /* thiz */) {
-    // Return combined stats from all streams (for backward compatibility)
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
+    jobject /* thiz */,
+    jlongArray out) {
+    const auto stats = g_stateNotifier.getStats();
+    jlong data[3] = {stats.posts, stats.wakeups, stats.collections};
+    nativesensor::writeJavaArray(env, out, data, 3);
+}
 
-    float avgFrameRate = 0.0f;
-    float maxLatency = 0.0f;
-    float totalFrameCount = 0.0f;
-    float totalDroppedFrames = 0.0f;
-    int activeStreamCount = 0;
+// =============================================================================
+// Native thread scheduling (ThreadScheduling)
+// =============================================================================
 
-    for (const auto& [id, stream] : g_cameraStreams) {
-        if (stream && stream->isStreaming()) {
-            auto stats = stream->getStats();
-            avgFrameRate += stats.frameRateHz;
-            maxLatency = std::max(maxLatency, stats.latencyMs);
-            totalFrameCount += static_cast<float>(stats.frameCount);
-            totalDroppedFrames += static_cast<float>(stats.droppedFrames);
-            activeStreamCount++;
+JNIEXPORT jint JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_ThreadScheduling_nativeSetConfig(
+    JNIEnv* /* env */,
+    jobject /* thiz */,
+    jint role,
+    jint niceValue,
+    jboolean realtime,
+    jint realtimePriority,
+    jlong cpuMask) {
+    if (role < 0 || role >= kThreadRoleCount) {
+        LOGE("Unknown thread role %d", role);
+        return -1;
+    }
+
+    nativesensor::ThreadSchedulingConfig config;
+    config.niceValue = niceValue;
+    config.realtime = realtime == JNI_TRUE;
+    config.realtimePriority = realtimePriority;
+    config.cpuMask = static_cast<uint64_t>(cpuMask);
+
+    // Stored for threads started later, and applied now to the role's running threads
+    std::vector<int32_t> tids;
+    {
+        std::lock_guard<std::mutex> lock(g_threadMutex);
+        g_threadConfigs[role] = config;
+        for (const ManagedThread& thread : g_managedThreads) {
+            if (thread.role == role) {
+                tids.push_back(thread.tid);
+            }
+        }
+    }
+    if (role == kThreadRoleImu && g_imuManager) {
+        if (const int32_t tid = g_imuManager->getSensorThreadId()) {
+            tids.push_back(tid);
         }
     }
 
-    // Average frame rate across all streams instead of sum
-    // (individual camera FPS is meaningful, summed FPS is not)
-    if (activeStreamCount > 0) {
-        avgFrameRate /= static_cast<float>(activeStreamCount);
+    uint32_t failedMask = 0;
+    for (const int32_t tid : tids) {
+        failedMask |= nativesensor::applyThreadScheduling(tid, config).failedMask;
     }
+    return static_cast<jint>(failedMask);
+}
 
-    jfloatArray result = env->NewFloatArray(4);
-    float data[4] = {avgFrameRate, maxLatency, totalFrameCount, totalDroppedFrames};
-    env->SetFloatArrayRegion(result, 0, 4, data);
-    return result;
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_ThreadScheduling_nativeSetFrameWorkTarget(
+    JNIEnv* /* env */,
+    jobject /* thiz */,
+    jlong targetWorkDurationNs) {
+    LOGI("ThreadScheduling.nativeSetFrameWorkTarget(%lld ns)",
+         static_cast<long long>(targetWorkDurationNs));
+
+    std::lock_guard<std::mutex> lock(g_threadMutex);
+    g_frameWorkTargetNs = std::max<int64_t>(targetWorkDurationNs, 0);
+    refreshFrameHintSessionLocked();
+    return g_frameHintSession.isOpen() ? JNI_TRUE : JNI_FALSE;
 }
 
-JNIEXPORT jfloatArray JNICALL
-Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetCameraStatsById(
+JNIEXPORT jint JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_ThreadScheduling_nativeGetThreadStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jlongArray out) {
+    // Seven longs per thread: role, tid, policy, nice, run time ns, run-queue wait ns, timeslices
+    constexpr size_t kFieldsPerThread = 7;
+    constexpr size_t kMaxReportedThreads = 16;      // ThreadScheduling.MAX_THREADS
+
+    ManagedThread threads[kMaxReportedThreads];
+    size_t threadCount = 0;
+    if (g_imuManager) {
+        if (const int32_t tid = g_imuManager->getSensorThreadId()) {
+            threads[threadCount++] = {kThreadRoleImu, tid};
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_threadMutex);
+        for (const ManagedThread& thread : g_managedThreads) {
+            if (threadCount == kMaxReportedThreads) {
+                break;
+            }
+            threads[threadCount++] = thread;
+        }
+    }
+
+    const size_t capacity = out ? static_cast<size_t>(env->GetArrayLength(out)) / kFieldsPerThread
+                                : 0;
+    jlong data[kMaxReportedThreads * kFieldsPerThread];
+    size_t count = 0;
+    for (size_t i = 0; i < threadCount && count < capacity; ++i) {
+        nativesensor::ThreadSchedulingStats stats;
+        if (!nativesensor::readThreadSchedulingStats(threads[i].tid, stats)) {
+            continue;
+        }
+        jlong* fields = data + count * kFieldsPerThread;
+        fields[0] = threads[i].role;
+        fields[1] = stats.tid;
+        fields[2] = stats.policy;
+        fields[3] = stats.niceValue;
+        fields[4] = stats.runTimeNs;
+        fields[5] = stats.runQueueWaitNs;
+        fields[6] = stats.timeslices;
+        count++;
+    }
+    nativesensor::writeJavaArray(env, out, data, count * kFieldsPerThread);
+    return static_cast<jint>(count);
+}
+
+// =============================================================================
+// Native memory accounting (MemoryBudget)
+// =============================================================================
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_MemoryBudget_nativeSetBudget(
+    JNIEnv* /* env */,
+    jobject /* thiz */,
+    jlong budgetBytes) {
+    nativesensor::setMemoryBudget(budgetBytes);
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_MemoryBudget_nativeGetUsage(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jlongArray out) {
+    // total, peak total, budget, degraded streams, refused streams, then reserved and peak
+    // bytes per MemoryComponent
+    constexpr size_t kHeaderFields = 5;
+    constexpr size_t kFieldCount = kHeaderFields + 2 * nativesensor::kMemoryComponentCount;
+    const nativesensor::MemoryUsage usage = nativesensor::getMemoryUsage();
+
+    jlong data[kFieldCount] = {
+        usage.totalBytes,
+        usage.peakTotalBytes,
+        usage.budgetBytes,
+        usage.degradedStreams,
+        usage.refusedStreams
+    };
+    for (size_t i = 0; i < nativesensor::kMemoryComponentCount; ++i) {
+        data[kHeaderFields + 2 * i] = usage.components[i].reservedBytes;
+        data[kHeaderFields + 2 * i + 1] = usage.components[i].peakBytes;
+    }
+    nativesensor::writeJavaArray(env, out, data, kFieldCount);
+}
+
+// =============================================================================
+// Camera JNI Functions (CameraBridge)
+// =============================================================================
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeStartPreview(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jobject surface) {
+    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(cameraId, idStr);
+
+    LOGI("CameraBridge.nativeStartPreview(%s)", id.c_str());
+
+    if (!surface) {
+        LOGE("Cannot start preview: null surface");
+        return JNI_FALSE;
+    }
+
+    ANativeWindow* window = ANativeWindow_fromSurface(env, surface);
+    if (!window) {
+        LOGE("Cannot start preview: failed to get ANativeWindow from surface");
+        return JNI_FALSE;
+    }
+
+    auto& stream = getCameraSessions().getOrCreatePreview(id);
+    bool success = stream.startPreview(id, window, nullptr);
+    ANativeWindow_release(window);
+
+    // Wakes an idle notifier so camera stats start flowing
+    g_stateNotifier.post();
+    return success ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeStopPreview(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    LOGI("CameraBridge.nativeStopPreview() - stopping all cameras");
+    getCameraSessions().stopAllPreviews();
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeStopCameraPreview(
     JNIEnv* env,
     jobject /* thiz */,
     jstring cameraId) {
@@ -353,23 +1169,90 @@ Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetCameraStatsByI
     std::string id(idStr);
     env->ReleaseStringUTFChars(cameraId, idStr);
 
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
-    auto it = g_cameraStreams.find(id);
+    LOGI("CameraBridge.nativeStopCameraPreview(%s)", id.c_str());
+    getCameraSessions().stopPreview(id);
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetCameraStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jfloatArray out) {
+    // Return combined stats from all streams (for backward compatibility)
+    float data[4];
+    combinedPreviewStats(data);
+    nativesensor::writeJavaArray(env, out, data, 4);
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetCameraStatsById(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jfloatArray out) {
+    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(cameraId, idStr);
 
     nativesensor::CameraStats stats{};
-    if (it != g_cameraStreams.end() && it->second) {
-        stats = it->second->getStats();
-    }
+    getCameraSessions().withPreview(id, [&](nativesensor::CameraStream& stream) {
+        stats = stream.getStats();
+    });
 
-    jfloatArray result = env->NewFloatArray(4);
     float data[4] = {
         stats.frameRateHz,
         stats.latencyMs,
         static_cast<float>(stats.frameCount),
         static_cast<float>(stats.droppedFrames)
     };
-    env->SetFloatArrayRegion(result, 0, 4, data);
-    return result;
+    nativesensor::writeJavaArray(env, out, data, 4);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeDrainFrameSync(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jobject buffer) {
+    if (!buffer) return 0;
+
+    auto* address = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    const jlong capacityBytes = env->GetDirectBufferCapacity(buffer);
+    if (!address || capacityBytes <= 0) {
+        LOGE("nativeDrainFrameSync requires a direct ByteBuffer");
+        return 0;
+    }
+
+    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(cameraId, idStr);
+
+    const size_t capacity = static_cast<size_t>(capacityBytes) / sizeof(nativesensor::FrameImuSync);
+    auto* records = reinterpret_cast<nativesensor::FrameImuSync*>(address);
+    size_t written = 0;
+    getCameraSessions().withPreview(id, [&](nativesensor::CameraStream& stream) {
+        written = stream.drainFrameSync(g_imuFrameSync, records, capacity);
+    });
+    return static_cast<jint>(written);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetLatencySnapshot(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jobject buffer) {
+    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(cameraId, idStr);
+
+    nativesensor::FrameLatencySnapshot snapshot{};
+    if (!getCameraSessions().withPreview(id, [&](nativesensor::CameraStream& stream) {
+            snapshot = stream.getLatencySnapshot();
+        })) {
+        return 0;
+    }
+    return writeLatencySnapshot(env, buffer, snapshot);
 }
 
 JNIEXPORT jboolean JNICALL
@@ -377,13 +1260,11 @@ Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeIsStreaming(
     JNIEnv* /* env */,
     jobject /* thiz */) {
     // Returns true if any camera is streaming (backward compatibility)
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
-    for (const auto& [id, stream] : g_cameraStreams) {
-        if (stream && stream->isStreaming()) {
-            return JNI_TRUE;
-        }
-    }
-    return JNI_FALSE;
+    bool anyStreaming = false;
+    getCameraSessions().forEachPreview([&](const std::string&, nativesensor::CameraStream& stream) {
+        anyStreaming = anyStreaming || stream.isStreaming();
+    });
+    return anyStreaming ? JNI_TRUE : JNI_FALSE;
 }
 
 JNIEXPORT jboolean JNICALL
@@ -395,12 +1276,11 @@ Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeIsCameraStreaming
     std::string id(idStr);
     env->ReleaseStringUTFChars(cameraId, idStr);
 
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
-    auto it = g_cameraStreams.find(id);
-    if (it != g_cameraStreams.end() && it->second) {
-        return it->second->isStreaming() ? JNI_TRUE : JNI_FALSE;
-    }
-    return JNI_FALSE;
+    bool streaming = false;
+    getCameraSessions().withPreview(id, [&](nativesensor::CameraStream& stream) {
+        streaming = stream.isStreaming();
+    });
+    return streaming ? JNI_TRUE : JNI_FALSE;
 }
 
 JNIEXPORT jstring JNICALL
@@ -408,16 +1288,15 @@ Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetCurrentCameraI
     JNIEnv* env,
     jobject /* thiz */) {
     // Returns comma-separated list of all streaming camera IDs
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
     std::ostringstream ss;
     bool first = true;
-    for (const auto& [id, stream] : g_cameraStreams) {
-        if (stream && stream->isStreaming()) {
+    getCameraSessions().forEachPreview([&](const std::string& id, nativesensor::CameraStream& stream) {
+        if (stream.isStreaming()) {
             if (!first) ss << ",";
             ss << id;
             first = false;
         }
-    }
+    });
     return env->NewStringUTF(ss.str().c_str());
 }
 
@@ -425,16 +1304,212 @@ JNIEXPORT jint JNICALL
 Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetActiveStreamCount(
     JNIEnv* /* env */,
     jobject /* thiz */) {
-    std::lock_guard<std::mutex> lock(g_cameraMutex);
     int count = 0;
-    for (const auto& [id, stream] : g_cameraStreams) {
-        if (stream && stream->isStreaming()) {
+    getCameraSessions().forEachPreview([&](const std::string&, nativesensor::CameraStream& stream) {
+        if (stream.isStreaming()) {
             count++;
         }
-    }
+    });
     return count;
 }
 
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativePrewarmCamera(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jobject callback) {
+    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(cameraId, idStr);
+
+    LOGI("CameraBridge.nativePrewarmCamera(%s)", id.c_str());
+
+    nativesensor::SessionOpenCallback onComplete;
+    if (callback) {
+        if (!g_jni.onCameraReady) {
+            LOGE("CameraPrewarmCallback.onCameraReady was not resolved at load");
+        } else {
+            // One-shot: runs on the open thread (or inline if already open) and drops its ref
+            jobject callbackRef = env->NewGlobalRef(callback);
+            onComplete = [callbackRef, id](bool opened) {
+                JNIEnv* callbackEnv = nativesensor::attachCurrentThreadPermanently(g_jvm);
+                if (!callbackEnv) return;
+
+                nativesensor::ScopedLocalRef<jstring> idString(
+                    callbackEnv, callbackEnv->NewStringUTF(id.c_str()));
+                // Call Java callback: onCameraReady(String cameraId, boolean success)
+                callbackEnv->CallVoidMethod(callbackRef, g_jni.onCameraReady, idString.get(),
+                                            opened ? JNI_TRUE : JNI_FALSE);
+                nativesensor::clearUpcallException(callbackEnv);
+                callbackEnv->DeleteGlobalRef(callbackRef);
+            };
+        }
+    }
+
+    getCameraSessions().prewarm(id, std::move(onComplete));
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeCancelPrewarm(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId) {
+    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(cameraId, idStr);
+
+    LOGI("CameraBridge.nativeCancelPrewarm(%s)", id.c_str());
+    getCameraSessions().cancelPrewarm(id);
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeSetFrameSetCallback(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jobject callback) {
+    if (callback && (!g_jni.onFrameSet || !g_jni.byteBufferClass)) {
+        LOGE("MultiCameraFrameCallback.onFrameSet was not resolved at load");
+        return;
+    }
+
+    g_frameSetCallback.setCallback(env, callback);
+    LOGI(callback ? "Frame set callback registered" : "Frame set callback cleared");
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeStartMultiCapture(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring logicalCameraId,
+    jstring physicalCameraIds,
+    jint width,
+    jint height,
+    jint outputFormat) {
+    const char* idStr = env->GetStringUTFChars(logicalCameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(logicalCameraId, idStr);
+
+    // Comma-separated, empty = every physical camera
+    std::vector<std::string> physicalIds;
+    if (physicalCameraIds) {
+        const char* physicalStr = env->GetStringUTFChars(physicalCameraIds, nullptr);
+        std::stringstream ss(physicalStr);
+        env->ReleaseStringUTFChars(physicalCameraIds, physicalStr);
+        std::string physicalId;
+        while (std::getline(ss, physicalId, ',')) {
+            if (!physicalId.empty()) {
+                physicalIds.push_back(physicalId);
+            }
+        }
+    }
+
+    LOGI("CameraBridge.nativeStartMultiCapture(%s, %zu physical, %dx%d, format=%d)",
+         id.c_str(), physicalIds.size(), width, height, outputFormat);
+
+    // Frame sets arrive on image reader threads; direct buffers are only valid during the call
+    auto frameSetCallback = [](const nativesensor::MultiCameraFrameSet& frameSet) {
+        for (size_t i = 0; i < frameSet.count; ++i) {
+            g_sessionRecorder.recordFrame(kMultiCaptureFirstStreamId + static_cast<uint32_t>(i),
+                                          frameSet.frames[i], frameSet.metadata[i]);
+        }
+
+        if (!g_frameSetCallback.hasCallback()) return;
+        NS_TRACE_SCOPE("JNI onFrameSet");
+
+        // Image reader threads live as long as the capture; attach once, not per frame set
+        JNIEnv* callbackEnv = nativesensor::attachCurrentThreadPermanently(g_jvm);
+        if (!callbackEnv) return;
+
+        const auto count = static_cast<jsize>(frameSet.count);
+        nativesensor::ScopedLocalRef<jobjectArray> buffers(
+            callbackEnv, callbackEnv->NewObjectArray(count, g_jni.byteBufferClass, nullptr));
+        nativesensor::ScopedLocalRef<jlongArray> timestamps(
+            callbackEnv, callbackEnv->NewLongArray(count));
+        if (!buffers.get() || !timestamps.get()) {
+            callbackEnv->ExceptionClear();
+            return;
+        }
+
+        jlong frameTimestamps[nativesensor::MultiCameraFrameSet::kMaxFrames] = {};
+        for (jsize i = 0; i < count; ++i) {
+            const nativesensor::FrameBufferHandle& frame = frameSet.frames[i];
+            nativesensor::ScopedLocalRef<jobject> buffer(
+                callbackEnv, callbackEnv->NewDirectByteBuffer(frame.data(),
+                                                              static_cast<jlong>(frame.size())));
+            callbackEnv->SetObjectArrayElement(buffers.get(), i, buffer.get());
+            frameTimestamps[i] = frameSet.metadata[i].timestampNs;
+        }
+        callbackEnv->SetLongArrayRegion(timestamps.get(), 0, count, frameTimestamps);
+
+        g_frameSetCallback.invokeCallback(callbackEnv, [&](JNIEnv* env, jobject callback) {
+            // Call Java callback: onFrameSet(long timestampNs, ByteBuffer[] frames, long[] frameTimestampsNs, int width, int height)
+            env->CallVoidMethod(callback, g_jni.onFrameSet,
+                                static_cast<jlong>(frameSet.timestampNs), buffers.get(),
+                                timestamps.get(), frameSet.metadata[0].width,
+                                frameSet.metadata[0].height);
+            nativesensor::clearUpcallException(env);
+        });
+    };
+
+    const nativesensor::YuvOutputFormat format = toYuvOutputFormat(outputFormat);
+
+    std::lock_guard<std::mutex> lock(g_multiCaptureMutex);
+    auto& capture = getCameraSessions().getOrCreateMultiCapture();
+    bool success = capture.start(id, physicalIds, width, height, frameSetCallback, format);
+    if (success) {
+        const std::vector<std::string> streamIds = capture.getPhysicalCameraIds();
+        for (size_t i = 0; i < streamIds.size(); ++i) {
+            g_sessionRecorder.describeStream(kMultiCaptureFirstStreamId + static_cast<uint32_t>(i),
+                                             streamIds[i], nativesensor::SessionStreamKind::RawFrames);
+        }
+    }
+    return success ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeStopMultiCapture(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    LOGI("CameraBridge.nativeStopMultiCapture()");
+    std::lock_guard<std::mutex> lock(g_multiCaptureMutex);
+    getCameraSessions().releaseMultiCapture();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeIsMultiCapturing(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    bool capturing = false;
+    getCameraSessions().withMultiCapture([&](nativesensor::MultiCameraCapture& capture) {
+        capturing = capture.isCapturing();
+    });
+    return capturing ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_sensor_CameraBridge_nativeGetMultiCaptureStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jfloatArray out) {
+    nativesensor::MultiCameraStats stats{};
+    getCameraSessions().withMultiCapture([&](nativesensor::MultiCameraCapture& capture) {
+        stats = capture.getStats();
+    });
+
+    float data[8] = {
+        stats.frameSetRateHz,
+        stats.latencyMs,
+        static_cast<float>(stats.frameSetCount),
+        static_cast<float>(stats.incompleteFrameSets),
+        static_cast<float>(stats.droppedFrames),
+        stats.timestampSpreadUs,
+        static_cast<float>(stats.physicalCameraCount),
+        static_cast<float>(stats.syncType)
+    };
+    nativesensor::writeJavaArray(env, out, data, 8);
+}
+
 // =============================================================================
 // Encoder Bridge JNI Functions (StreamingBridge)
 // =============================================================================
@@ -444,30 +1519,49 @@ Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeSetFrameCal
     JNIEnv* env,
     jobject /* thiz */,
     jobject callback) {
-    std::lock_guard<std::mutex> lock(g_encoderMutex);
-
-    // Release previous callback if any
-    if (g_frameCallbackObj) {
-        env->DeleteGlobalRef(g_frameCallbackObj);
-        g_frameCallbackObj = nullptr;
-        g_onFrameMethod = nullptr;
+    FrameTargetPtr target = makeFrameTarget(env, callback);
+
+    // The previous target dies with its last in-flight delivery, outside this lock
+    FrameTargetPtr previous;
+    {
+        std::lock_guard<std::mutex> lock(g_frameTargetMutex);
+        previous = std::atomic_exchange(&g_defaultFrameTarget, target);
+        for (auto& [id, route] : g_captureRoutes) {
+            if (g_cameraFrameTargets.find(id) == g_cameraFrameTargets.end()) {
+                std::atomic_store(&route->target, target);
+            }
+        }
     }
+    LOGI("Frame callback %s", target ? "registered" : "cleared");
+}
 
-    if (callback) {
-        g_frameCallbackObj = env->NewGlobalRef(callback);
-        jclass callbackClass = env->GetObjectClass(callback);
-        g_onFrameMethod = env->GetMethodID(callbackClass, "onFrame", "([BIIJ)V");
-        if (!g_onFrameMethod) {
-            LOGE("Failed to find onFrame method in callback");
-            env->DeleteGlobalRef(g_frameCallbackObj);
-            g_frameCallbackObj = nullptr;
-        } else {
-            LOGI("Frame callback registered");
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeSetCaptureFrameCallback(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jobject callback) {
+    const std::string id = optionalCameraId(env, cameraId);
+    FrameTargetPtr target = makeFrameTarget(env, callback);
+
+    FrameTargetPtr previous;
+    {
+        std::lock_guard<std::mutex> lock(g_frameTargetMutex);
+        auto it = g_cameraFrameTargets.find(id);
+        if (it != g_cameraFrameTargets.end()) {
+            previous = std::move(it->second);
+            g_cameraFrameTargets.erase(it);
+        }
+        if (target) {
+            g_cameraFrameTargets[id] = target;
+        }
+        auto route = g_captureRoutes.find(id);
+        if (route != g_captureRoutes.end()) {
+            std::atomic_store(&route->second->target, effectiveFrameTargetLocked(id));
         }
-        env->DeleteLocalRef(callbackClass);
-    } else {
-        LOGI("Frame callback cleared");
     }
+    LOGI("Frame callback for camera %s %s", id.c_str(),
+         target ? "registered" : "cleared (default callback applies)");
 }
 
 JNIEXPORT jboolean JNICALL
@@ -476,80 +1570,431 @@ Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeStartFrameC
     jobject /* thiz */,
     jstring cameraId,
     jint width,
-    jint height) {
+    jint height,
+    jboolean useHardwareBuffer,
+    jint outputFormat,
+    jint dropPolicy) {
     const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
     std::string id(idStr);
     env->ReleaseStringUTFChars(cameraId, idStr);
 
-    LOGI("StreamingBridge.nativeStartFrameCapture(%s, %dx%d)", id.c_str(), width, height);
+    LOGI("StreamingBridge.nativeStartFrameCapture(%s, %dx%d, hwBuffer=%d, format=%d, drop=%d)",
+         id.c_str(), width, height, useHardwareBuffer, outputFormat, dropPolicy);
+
+    // Each camera has its own capture, dispatch thread and route; starting one camera never
+    // waits on another's device open
+    std::shared_ptr<CaptureRoute> route = acquireCaptureRoute(id);
+    std::shared_ptr<nativesensor::CameraEncoderBridge> encoder =
+        getCameraSessions().getOrCreateEncoder(id);
+    encoder->setImuFrameSync(&g_imuFrameSync);
+
+    if (useHardwareBuffer) {
+        // Zero-copy path: wrap the AHardwareBuffer as android.hardware.HardwareBuffer. Java
+        // owns the frame until StreamingBridge.releaseHardwareBuffer(frameId)
+        auto hardwareBufferCallback = [route](AHardwareBuffer* buffer, int32_t w, int32_t h,
+                                              int64_t timestampNs, uint64_t frameId) {
+            const FrameTargetPtr target = std::atomic_load(&route->target);
+            if (!target || !g_jni.onHardwareBuffer) return false;
+
+            // Image reader threads live as long as the reader; attach once, not per frame
+            JNIEnv* callbackEnv = nativesensor::attachCurrentThreadPermanently(g_jvm);
+            if (!callbackEnv) return false;
+
+            NS_TRACE_SCOPE("JNI onHardwareBuffer");
+            jobject jbuffer = AHardwareBuffer_toHardwareBuffer(callbackEnv, buffer);
+            if (!jbuffer) {
+                nativesensor::clearUpcallException(callbackEnv);
+                return false;
+            }
+            // Call Java callback: onHardwareBuffer(HardwareBuffer buffer, int width, int height,
+            // long timestampNs, long frameId)
+            callbackEnv->CallVoidMethod(target->callback, g_jni.onHardwareBuffer,
+                                        jbuffer, w, h, timestampNs,
+                                        static_cast<jlong>(frameId));
+            // A callback that threw never got to release the frame; releasing twice is harmless
+            const bool threw = nativesensor::clearUpcallException(callbackEnv);
+            callbackEnv->DeleteLocalRef(jbuffer);
+            return !threw;
+        };
+
+        bool success = encoder->startHardwareBufferCapture(id, width, height,
+                                                           hardwareBufferCallback);
+        return success ? JNI_TRUE : JNI_FALSE;
+    }
 
-    auto* manager = getCameraManager();
+    // Attach the dispatch thread to the JVM once for its whole lifetime
+    nativesensor::DispatcherThreadHooks hooks = makeJvmThreadHooks("frame dispatch", kThreadRoleFrameDispatch);
+    auto policy = dropPolicy == static_cast<jint>(nativesensor::FrameDropPolicy::DropNewest)
+        ? nativesensor::FrameDropPolicy::DropNewest
+        : nativesensor::FrameDropPolicy::DropOldest;
+    encoder->setDispatchConfig(policy, std::move(hooks));
+
+    // Create frame callback that records the pooled frame and forwards it to this camera's
+    // Java callback (runs on the capture's attached dispatch thread)
+    auto frameCallback = [route](nativesensor::FrameBufferHandle frame,
+                                 const nativesensor::FrameMetadata& metadata) {
+        const auto workStart = std::chrono::steady_clock::now();
+        if (route->streamId != kNoStreamId) {
+            g_sessionRecorder.recordFrame(route->streamId, frame, metadata);
+        }
+
+        if (const FrameTargetPtr target = std::atomic_load(&route->target)) {
+            deliverFrameToJava(*target, frame.data(), static_cast<jsize>(frame.size()),
+                               metadata.width, metadata.height, metadata.timestampNs);
+        }
 
-    std::lock_guard<std::mutex> lock(g_encoderMutex);
-    if (!g_encoderBridge) {
-        g_encoderBridge = std::make_unique<nativesensor::CameraEncoderBridge>(*manager);
+        // One unit of frame pipeline work for the performance hint session
+        g_frameHintSession.reportActualWorkDuration(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - workStart).count());
+    };
+
+    const nativesensor::YuvOutputFormat format = toYuvOutputFormat(outputFormat);
+    bool success = encoder->startPooledCapture(id, width, height, frameCallback, format);
+    if (success && route->streamId != kNoStreamId) {
+        g_sessionRecorder.describeStream(route->streamId, id,
+                                         nativesensor::SessionStreamKind::RawFrames);
     }
+    return success ? JNI_TRUE : JNI_FALSE;
+}
 
-    // Create frame callback that forwards to Java
-    auto frameCallback = [](const uint8_t* data, int32_t size,
-                            int32_t w, int32_t h, int64_t timestampNs) {
-        if (!g_jvm || !g_frameCallbackObj || !g_onFrameMethod) return;
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeReleaseHardwareBuffer(
+    JNIEnv* /* env */,
+    jobject /* thiz */,
+    jlong frameId,
+    jint releaseFenceFd) {
+    // Frame ids are unique across captures; the capture holding the id takes the fence
+    bool released = false;
+    getCameraSessions().forEachEncoder(
+        [&](const std::string&, nativesensor::CameraEncoderBridge& encoder) {
+            released = released ||
+                encoder.releaseHardwareBuffer(static_cast<uint64_t>(frameId), releaseFenceFd);
+        });
+    // Stopped capture (its frames are already back with the camera): the fence is unused
+    if (!released && releaseFenceFd >= 0) {
+        close(releaseFenceFd);
+    }
+    return released ? JNI_TRUE : JNI_FALSE;
+}
 
-        JNIEnv* callbackEnv = nullptr;
-        bool needDetach = false;
-        int envStatus = g_jvm->GetEnv(reinterpret_cast<void**>(&callbackEnv), JNI_VERSION_1_6);
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeStopFrameCapture(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId) {
+    const std::string id = optionalCameraId(env, cameraId);
+    LOGI("StreamingBridge.nativeStopFrameCapture(%s)", id.empty() ? "all" : id.c_str());
 
-        if (envStatus == JNI_EDETACHED) {
-            if (g_jvm->AttachCurrentThread(&callbackEnv, nullptr) == JNI_OK) {
-                needDetach = true;
-            } else {
-                return;
+    // Destroying the capture joins its dispatch thread; routes go once no callback holds them
+    auto& sessions = getCameraSessions();
+    if (id.empty()) {
+        sessions.releaseAllEncoders();
+    } else {
+        sessions.releaseEncoder(id);
+    }
+
+    std::lock_guard<std::mutex> lock(g_frameTargetMutex);
+    if (id.empty()) {
+        g_captureRoutes.clear();
+    } else {
+        g_captureRoutes.erase(id);
+    }
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeIsCapturing(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId) {
+    const std::string id = optionalCameraId(env, cameraId);
+    bool capturing = false;
+    if (id.empty()) {
+        getCameraSessions().forEachEncoder(
+            [&](const std::string&, nativesensor::CameraEncoderBridge& encoder) {
+                capturing = capturing || encoder.isCapturing();
+            });
+    } else {
+        getCameraSessions().withEncoder(id, [&](nativesensor::CameraEncoderBridge& encoder) {
+            capturing = encoder.isCapturing();
+        });
+    }
+    return capturing ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeGetActiveCaptures(
+    JNIEnv* env,
+    jobject /* thiz */) {
+    // Returns comma-separated list of all capturing camera IDs
+    std::ostringstream ss;
+    bool first = true;
+    getCameraSessions().forEachEncoder(
+        [&](const std::string& id, nativesensor::CameraEncoderBridge& encoder) {
+            if (encoder.isCapturing()) {
+                if (!first) ss << ",";
+                ss << id;
+                first = false;
             }
-        } else if (envStatus != JNI_OK) {
-            return;
-        }
+        });
+    return env->NewStringUTF(ss.str().c_str());
+}
 
-        // Create byte array and copy frame data
-        jbyteArray jdata = callbackEnv->NewByteArray(size);
-        if (jdata) {
-            callbackEnv->SetByteArrayRegion(jdata, 0, size,
-                                             reinterpret_cast<const jbyte*>(data));
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeGetCaptureStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jfloatArray out) {
+    nativesensor::CameraStats stats{};
+    withCapture(optionalCameraId(env, cameraId), [&](nativesensor::CameraEncoderBridge& encoder) {
+        stats = encoder.getStats();
+    });
 
-            // Call Java callback: onFrame(byte[] data, int width, int height, long timestampNs)
-            callbackEnv->CallVoidMethod(g_frameCallbackObj, g_onFrameMethod,
-                                         jdata, w, h, timestampNs);
-            callbackEnv->DeleteLocalRef(jdata);
+    float data[10] = {
+        stats.frameRateHz,
+        stats.latencyMs,
+        static_cast<float>(stats.frameCount),
+        static_cast<float>(stats.droppedFrames),
+        static_cast<float>(stats.bufferPoolCapacity),
+        static_cast<float>(stats.bufferPoolInUse),
+        static_cast<float>(stats.bufferPoolStarvations),
+        static_cast<float>(stats.dispatchQueueDepth),
+        static_cast<float>(stats.decimatedFrames),
+        static_cast<float>(stats.scaleFactor)
+    };
+    nativesensor::writeJavaArray(env, out, data, 10);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeSetCaptureTarget(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jint bitrateBps,
+    jfloat maxFrameRate) {
+    const std::string id = optionalCameraId(env, cameraId);
+    LOGI("StreamingBridge.nativeSetCaptureTarget(%s, %d bps, %.1f fps)",
+         id.empty() ? "all" : id.c_str(), bitrateBps, maxFrameRate);
+
+    bool found = false;
+    auto apply = [&](nativesensor::CameraEncoderBridge& encoder) {
+        encoder.setCaptureTarget(bitrateBps, maxFrameRate);
+        found = true;
+    };
+    if (id.empty()) {
+        getCameraSessions().forEachEncoder(
+            [&](const std::string&, nativesensor::CameraEncoderBridge& encoder) { apply(encoder); });
+    } else {
+        getCameraSessions().withEncoder(id, apply);
+    }
+    return found ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeSetCaptureCrop(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jint x,
+    jint y,
+    jint width,
+    jint height) {
+    nativesensor::YuvCropRect rect;
+    rect.x = x;
+    rect.y = y;
+    rect.width = width;
+    rect.height = height;
+    return getCameraSessions().withEncoder(optionalCameraId(env, cameraId),
+                                           [&](nativesensor::CameraEncoderBridge& encoder) {
+        encoder.setCropRegion(rect);
+    }) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeGetLatencySnapshot(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jobject buffer) {
+    nativesensor::FrameLatencySnapshot snapshot{};
+    const bool found = withCapture(optionalCameraId(env, cameraId),
+                                   [&](nativesensor::CameraEncoderBridge& encoder) {
+        snapshot = encoder.getLatencySnapshot();
+    });
+    return found ? writeLatencySnapshot(env, buffer, snapshot) : 0;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeSetEncodedPacketCallback(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jobject callback) {
+    if (callback && !g_jni.onEncodedPacket) {
+        LOGE("NativeEncodedPacketCallback.onEncodedPacket was not resolved at load");
+        return;
+    }
+
+    g_packetCallback.setCallback(env, callback);
+    LOGI(callback ? "Encoded packet callback registered" : "Encoded packet callback cleared");
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeStartNativeEncoder(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring cameraId,
+    jint width,
+    jint height,
+    jint codec,
+    jint bitrateBps,
+    jint frameRate,
+    jfloat keyFrameIntervalSec,
+    jboolean lowLatency) {
+    const char* idStr = env->GetStringUTFChars(cameraId, nullptr);
+    std::string id(idStr);
+    env->ReleaseStringUTFChars(cameraId, idStr);
+
+    LOGI("StreamingBridge.nativeStartNativeEncoder(%s, %dx%d, codec=%d, %d bps, %d fps, "
+         "GOP=%.1fs, lowLatency=%d)",
+         id.c_str(), width, height, codec, bitrateBps, frameRate, keyFrameIntervalSec, lowLatency);
+
+    nativesensor::NativeEncoderConfig config;
+    config.codec = codec == static_cast<jint>(nativesensor::VideoCodec::Hevc)
+        ? nativesensor::VideoCodec::Hevc
+        : nativesensor::VideoCodec::H264;
+    config.width = width;
+    config.height = height;
+    config.bitrateBps = bitrateBps;
+    config.frameRate = frameRate;
+    config.keyFrameIntervalSec = keyFrameIntervalSec;
+    config.lowLatency = lowLatency == JNI_TRUE;
+
+    // Packets arrive on the encoder's output thread, attached to the JVM for its lifetime.
+    // The direct ByteBuffer aliases the codec's output buffer and is only valid during the call.
+    auto packetCallback = [width, height, codec = config.codec](
+                              const nativesensor::EncodedPacket& packet) {
+        nativesensor::FrameMetadata metadata;
+        metadata.timestampNs = packet.timestampNs;
+        metadata.width = width;
+        metadata.height = height;
+        metadata.format = static_cast<int32_t>(codec);
+        uint32_t recordFlags = 0;
+        if (packet.flags & nativesensor::kEncodedPacketKeyFrame) {
+            recordFlags |= nativesensor::kFrameFlagKeyFrame;
+        }
+        if (packet.flags & nativesensor::kEncodedPacketCodecConfig) {
+            recordFlags |= nativesensor::kFrameFlagCodecConfig;
         }
+        g_sessionRecorder.recordPacket(kNativeEncoderStreamId, packet.data, packet.size,
+                                       metadata, recordFlags);
 
-        if (needDetach) {
-            g_jvm->DetachCurrentThread();
+        if (!g_packetCallback.hasCallback()) return;
+        NS_TRACE_SCOPE("JNI onEncodedPacket");
+
+        // Attached once by the output thread hooks
+        JNIEnv* callbackEnv = nativesensor::getEnvForCurrentThread(g_jvm);
+        if (!callbackEnv) return;
+
+        nativesensor::ScopedLocalRef<jobject> buffer(
+            callbackEnv, callbackEnv->NewDirectByteBuffer(const_cast<uint8_t*>(packet.data),
+                                                          static_cast<jlong>(packet.size)));
+        if (!buffer.get()) {
+            callbackEnv->ExceptionClear();
+            return;
         }
+        g_packetCallback.invokeCallback(callbackEnv, [&](JNIEnv* env, jobject callback) {
+            // Call Java callback: onEncodedPacket(ByteBuffer data, long timestampNs, int flags)
+            env->CallVoidMethod(callback, g_jni.onEncodedPacket, buffer.get(),
+                                static_cast<jlong>(packet.timestampNs),
+                                static_cast<jint>(packet.flags));
+            nativesensor::clearUpcallException(env);
+        });
     };
 
-    bool success = g_encoderBridge->startCapture(id, width, height, frameCallback);
+    std::lock_guard<std::mutex> lock(g_nativeEncoderMutex);
+    auto& encoder = getCameraSessions().getOrCreateNativeEncoder();
+    bool success = encoder.start(id, config, packetCallback,
+                                 makeJvmThreadHooks("encoder output", kThreadRoleEncoder));
+    if (success) {
+        g_sessionRecorder.describeStream(kNativeEncoderStreamId, id,
+                                         nativesensor::SessionStreamKind::EncodedFrames);
+    }
     return success ? JNI_TRUE : JNI_FALSE;
 }
 
 JNIEXPORT void JNICALL
-Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeStopFrameCapture(
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeStopNativeEncoder(
     JNIEnv* /* env */,
     jobject /* thiz */) {
-    LOGI("StreamingBridge.nativeStopFrameCapture()");
-    std::lock_guard<std::mutex> lock(g_encoderMutex);
-    if (g_encoderBridge) {
-        g_encoderBridge->stopCapture();
-    }
+    LOGI("StreamingBridge.nativeStopNativeEncoder()");
+    std::lock_guard<std::mutex> lock(g_nativeEncoderMutex);
+    getCameraSessions().withNativeEncoder([](nativesensor::NativeEncoder& encoder) {
+        encoder.stop();
+    });
 }
 
 JNIEXPORT jboolean JNICALL
-Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeIsCapturing(
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeIsNativeEncoding(
     JNIEnv* /* env */,
     jobject /* thiz */) {
-    std::lock_guard<std::mutex> lock(g_encoderMutex);
-    if (g_encoderBridge) {
-        return g_encoderBridge->isCapturing() ? JNI_TRUE : JNI_FALSE;
+    bool running = false;
+    getCameraSessions().withNativeEncoder([&](nativesensor::NativeEncoder& encoder) {
+        running = encoder.isRunning();
+    });
+    return running ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeRequestKeyFrame(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    std::lock_guard<std::mutex> lock(g_nativeEncoderMutex);
+    bool requested = false;
+    getCameraSessions().withNativeEncoder([&](nativesensor::NativeEncoder& encoder) {
+        requested = encoder.requestKeyFrame();
+    });
+    return requested ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeSetEncoderBitrate(
+    JNIEnv* /* env */,
+    jobject /* thiz */,
+    jint bitrateBps) {
+    std::lock_guard<std::mutex> lock(g_nativeEncoderMutex);
+    bool applied = false;
+    getCameraSessions().withNativeEncoder([&](nativesensor::NativeEncoder& encoder) {
+        applied = encoder.setBitrate(bitrateBps);
+    });
+    return applied ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeGetNativeEncoderStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jfloatArray out) {
+    nativesensor::NativeEncoderStats stats{};
+    {
+        std::lock_guard<std::mutex> lock(g_nativeEncoderMutex);
+        getCameraSessions().withNativeEncoder([&](nativesensor::NativeEncoder& encoder) {
+            stats = encoder.getStats();
+        });
     }
-    return JNI_FALSE;
+
+    constexpr double kUsToMs = 1000.0;
+    float data[8] = {
+        static_cast<float>(stats.packets),
+        static_cast<float>(stats.keyFrames),
+        static_cast<float>(stats.bytes),
+        stats.bitrateKbps,
+        stats.frameRateHz,
+        static_cast<float>(stats.captureToPacket.p50Us / kUsToMs),
+        static_cast<float>(stats.captureToPacket.p95Us / kUsToMs),
+        static_cast<float>(stats.captureToPacket.p99Us / kUsToMs)
+    };
+    nativesensor::writeJavaArray(env, out, data, 8);
 }
 
 JNIEXPORT void JNICALL
@@ -557,16 +2002,141 @@ Java_com_tw0b33rs_nativesensoraccess_streaming_StreamingBridge_nativeReleaseEnco
     JNIEnv* env,
     jobject /* thiz */) {
     LOGI("StreamingBridge.nativeReleaseEncoder()");
-    std::lock_guard<std::mutex> lock(g_encoderMutex);
-    if (g_encoderBridge) {
-        g_encoderBridge->stopCapture();
-        g_encoderBridge.reset();
+    {
+        std::lock_guard<std::mutex> lock(g_nativeEncoderMutex);
+        getCameraSessions().releaseNativeEncoder();
+        g_packetCallback.reset(env);
     }
-    if (g_frameCallbackObj) {
-        env->DeleteGlobalRef(g_frameCallbackObj);
-        g_frameCallbackObj = nullptr;
-        g_onFrameMethod = nullptr;
+    getCameraSessions().releaseAllEncoders();
+
+    // Targets die with the routes' last references, outside the lock
+    std::unordered_map<std::string, std::shared_ptr<CaptureRoute>> routes;
+    std::unordered_map<std::string, FrameTargetPtr> cameraTargets;
+    FrameTargetPtr defaultTarget;
+    {
+        std::lock_guard<std::mutex> lock(g_frameTargetMutex);
+        routes.swap(g_captureRoutes);
+        cameraTargets.swap(g_cameraFrameTargets);
+        defaultTarget = std::atomic_exchange(&g_defaultFrameTarget, FrameTargetPtr{});
     }
 }
 
+
+// Package: com.tw0b33rs.nativesensoraccess.recording
+// Class: SessionRecorder
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_recording_SessionRecorder_nativeStartRecording(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring path) {
+    const char* pathStr = env->GetStringUTFChars(path, nullptr);
+    std::string sessionPath(pathStr);
+    env->ReleaseStringUTFChars(path, pathStr);
+
+    LOGI("SessionRecorder.nativeStartRecording(%s)", sessionPath.c_str());
+    std::lock_guard<std::mutex> lock(g_recordingMutex);
+    return g_sessionRecorder.start(sessionPath) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_recording_SessionRecorder_nativeStopRecording(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    LOGI("SessionRecorder.nativeStopRecording()");
+    std::lock_guard<std::mutex> lock(g_recordingMutex);
+    g_sessionRecorder.stop();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_recording_SessionRecorder_nativeIsRecording(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    return g_sessionRecorder.isRecording() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_recording_SessionRecorder_nativeGetRecordingStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jlongArray out) {
+    const nativesensor::RecorderStats stats = g_sessionRecorder.getStats();
+
+    jlong data[7] = {
+        stats.imuSamples,
+        stats.imuDropped,
+        stats.frames,
+        stats.framesDropped,
+        stats.bytesWritten,
+        stats.chunks,
+        stats.poolStarvations
+    };
+    nativesensor::writeJavaArray(env, out, data, 7);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_recording_SessionRecorder_nativeStartReplay(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jstring path,
+    jdouble speed,
+    jboolean loop,
+    jint frameStreamId) {
+    const char* pathStr = env->GetStringUTFChars(path, nullptr);
+    std::string sessionPath(pathStr);
+    env->ReleaseStringUTFChars(path, pathStr);
+
+    LOGI("SessionRecorder.nativeStartReplay(%s, speed=%.2f, loop=%d, stream=%d)",
+         sessionPath.c_str(), speed, loop, frameStreamId);
+
+    nativesensor::SessionReplayConfig config;
+    config.speed = speed;
+    config.loop = loop == JNI_TRUE;
+    config.frameStreamId = static_cast<uint32_t>(frameStreamId);
+
+    // Same consumers as live capture: the frame sync IMU window and NativeFrameCallback
+    auto imuBatchCallback = [](const nativesensor::ImuSample* samples, size_t count) {
+        g_imuFrameSync.addSamples(samples, count);
+        g_stateNotifier.post();
+    };
+    auto frameCallback = [](const uint8_t* data, int32_t size,
+                            int32_t w, int32_t h, int64_t timestampNs) {
+        if (const FrameTargetPtr target = std::atomic_load(&g_defaultFrameTarget)) {
+            deliverFrameToJava(*target, data, size, w, h, timestampNs);
+        }
+    };
+
+    std::lock_guard<std::mutex> lock(g_recordingMutex);
+    bool success = g_sessionReplayer.start(sessionPath, config, nullptr, imuBatchCallback,
+                                           frameCallback, makeJvmThreadHooks("replay", kThreadRoleBackground));
+    return success ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_recording_SessionRecorder_nativeStopReplay(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    LOGI("SessionRecorder.nativeStopReplay()");
+    std::lock_guard<std::mutex> lock(g_recordingMutex);
+    g_sessionReplayer.stop();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_tw0b33rs_nativesensoraccess_recording_SessionRecorder_nativeIsReplaying(
+    JNIEnv* /* env */,
+    jobject /* thiz */) {
+    return g_sessionReplayer.isRunning() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_tw0b33rs_nativesensoraccess_recording_SessionRecorder_nativeGetReplayStats(
+    JNIEnv* env,
+    jobject /* thiz */,
+    jlongArray out) {
+    const nativesensor::ReplayStats stats = g_sessionReplayer.getStats();
+
+    jlong data[4] = {stats.imuSamples, stats.frames, stats.loops, stats.maxLagNs};
+    nativesensor::writeJavaArray(env, out, data, 4);
+}
+
 }  // extern "C"
\ No newline at end of file
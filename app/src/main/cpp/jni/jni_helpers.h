@@ -1,12 +1,16 @@
 #pragma once
 
 #include <jni.h>
+#include <pthread.h>
+#include <algorithm>
+#include <cstddef>
 
 namespace nativesensor {
 
 /// Get JNIEnv for current thread. Returns nullptr if not attached to JVM.
 [[maybe_unused]]
 inline JNIEnv* getEnvForCurrentThread(JavaVM* jvm) noexcept {
+    if (!jvm) return nullptr;
     JNIEnv* env = nullptr;
     if (jvm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) == JNI_OK) {
         return env;
@@ -14,6 +18,116 @@ inline JNIEnv* getEnvForCurrentThread(JavaVM* jvm) noexcept {
     return nullptr;
 }
 
+namespace detail {
+
+/// Key whose destructor detaches a thread attached by attachCurrentThreadPermanently()
+inline pthread_key_t jvmDetachKey() noexcept {
+    static const pthread_key_t key = [] {
+        pthread_key_t newKey{};
+        pthread_key_create(&newKey, [](void* jvm) {
+            static_cast<JavaVM*>(jvm)->DetachCurrentThread();
+        });
+        return newKey;
+    }();
+    return key;
+}
+
+}  // namespace detail
+
+/// Attach the calling native thread to the JVM for the rest of its life.
+/// The thread is detached by a pthread key destructor when it exits, so long-lived worker and
+/// callback threads pay for AttachCurrentThread once instead of on every upcall.
+/// Threads that are already attached (including Java threads) are returned as-is.
+/// @return nullptr if the JVM is unknown or attaching failed
+[[maybe_unused]]
+inline JNIEnv* attachCurrentThreadPermanently(JavaVM* jvm, const char* threadName = nullptr) noexcept {
+    if (!jvm) return nullptr;
+
+    JNIEnv* env = nullptr;
+    const jint status = jvm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+    if (status == JNI_OK) return env;
+    if (status != JNI_EDETACHED) return nullptr;
+
+    JavaVMAttachArgs args{JNI_VERSION_1_6, threadName, nullptr};
+    if (jvm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        return nullptr;
+    }
+    pthread_setspecific(detail::jvmDetachKey(), jvm);
+    return env;
+}
+
+/// Log and clear an exception thrown by a Java upcall. Callback threads stay attached for
+/// their lifetime, so an exception left pending would break every later JNI call on the
+/// thread and abort the process when it detaches. Call after every Call*Method from native.
+/// @return true if an exception was pending
+[[maybe_unused]]
+inline bool clearUpcallException(JNIEnv* env) noexcept {
+    if (!env->ExceptionCheck()) return false;
+    env->ExceptionDescribe();
+    env->ExceptionClear();
+    return true;
+}
+
+/// Resolve a class to a global reference (for JNI_OnLoad caches)
+/// @return nullptr, with the pending exception cleared, if the class is missing
+[[maybe_unused]]
+inline jclass findGlobalClass(JNIEnv* env, const char* name) noexcept {
+    jclass localClass = env->FindClass(name);
+    if (!localClass) {
+        env->ExceptionClear();
+        return nullptr;
+    }
+    auto globalClass = static_cast<jclass>(env->NewGlobalRef(localClass));
+    env->DeleteLocalRef(localClass);
+    return globalClass;
+}
+
+/// Resolve an instance method of a named class or interface (for JNI_OnLoad caches).
+/// Ids resolved on an interface are valid for every implementation.
+/// @return nullptr, with the pending exception cleared, if the class or method is missing
+[[maybe_unused]]
+inline jmethodID findMethod(JNIEnv* env, const char* className, const char* name,
+                            const char* signature) noexcept {
+    jclass localClass = env->FindClass(className);
+    if (!localClass) {
+        env->ExceptionClear();
+        return nullptr;
+    }
+    jmethodID method = env->GetMethodID(localClass, name, signature);
+    if (!method) {
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(localClass);
+    return method;
+}
+
+/// Copy values into a caller-owned Java array instead of allocating a new one per call.
+/// Writes at most the array's length; the rest of a longer array is left untouched.
+/// @return Number of elements written
+[[maybe_unused]]
+inline jsize writeJavaArray(JNIEnv* env, jfloatArray out, const jfloat* values, size_t count) noexcept {
+    if (!out) return 0;
+    const jsize written = std::min(env->GetArrayLength(out), static_cast<jsize>(count));
+    env->SetFloatArrayRegion(out, 0, written, values);
+    return written;
+}
+
+[[maybe_unused]]
+inline jsize writeJavaArray(JNIEnv* env, jintArray out, const jint* values, size_t count) noexcept {
+    if (!out) return 0;
+    const jsize written = std::min(env->GetArrayLength(out), static_cast<jsize>(count));
+    env->SetIntArrayRegion(out, 0, written, values);
+    return written;
+}
+
+[[maybe_unused]]
+inline jsize writeJavaArray(JNIEnv* env, jlongArray out, const jlong* values, size_t count) noexcept {
+    if (!out) return 0;
+    const jsize written = std::min(env->GetArrayLength(out), static_cast<jsize>(count));
+    env->SetLongArrayRegion(out, 0, written, values);
+    return written;
+}
+
 /// RAII wrapper for attaching/detaching current thread to JVM
 class [[maybe_unused]] JniThreadAttachment {
 public:
@@ -0,0 +1,162 @@
+#include "state_notifier.h"
+
+#include <android/log.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+
+#include "trace.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Notify";
+
+constexpr float kMinRateHz = 1.0f;
+constexpr float kMaxRateHz = 240.0f;
+constexpr int64_t kNsPerMs = 1000000LL;
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+StateNotifier::~StateNotifier() {
+    stop();
+    if (eventFd_ >= 0) {
+        close(eventFd_);
+    }
+}
+
+bool StateNotifier::start(StateCollectCallback collect, float maxRateHz,
+                          DispatcherThreadHooks hooks) {
+    if (running_.load(std::memory_order_acquire)) {
+        LOGI("StateNotifier already running");
+        return false;
+    }
+
+    // Created once and kept until destruction: post() may race stop() from a sensor
+    // thread, and a closed descriptor number could be reused by an unrelated file
+    if (eventFd_ < 0) {
+        eventFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (eventFd_ < 0) {
+            LOGE("Failed to create notifier eventfd");
+            return false;
+        }
+    }
+
+    collect_ = std::move(collect);
+    hooks_ = std::move(hooks);
+    intervalNs_.store(intervalNsFor(maxRateHz), std::memory_order_relaxed);
+    posts_.store(0, std::memory_order_relaxed);
+    wakeups_.store(0, std::memory_order_relaxed);
+    collections_.store(0, std::memory_order_relaxed);
+    pending_.store(false, std::memory_order_release);
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&StateNotifier::threadLoop, this);
+    LOGI("StateNotifier started (max %.1f Hz)", maxRateHz);
+    return true;
+}
+
+void StateNotifier::stop() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    running_.store(false, std::memory_order_release);
+    signal();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    collect_ = nullptr;
+    hooks_ = {};
+    LOGI("StateNotifier stopped");
+}
+
+void StateNotifier::post() noexcept {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+    posts_.fetch_add(1, std::memory_order_relaxed);
+
+    // Only the post that makes state pending wakes the thread; the rest coalesce into it
+    if (!pending_.exchange(true, std::memory_order_acq_rel)) {
+        signal();
+    }
+}
+
+void StateNotifier::setMaxRate(float maxRateHz) noexcept {
+    intervalNs_.store(intervalNsFor(maxRateHz), std::memory_order_relaxed);
+    signal();
+}
+
+StateNotifierStats StateNotifier::getStats() const noexcept {
+    StateNotifierStats stats;
+    stats.posts = posts_.load(std::memory_order_relaxed);
+    stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+    stats.collections = collections_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void StateNotifier::signal() noexcept {
+    if (eventFd_ < 0) {
+        return;
+    }
+    const uint64_t one = 1;
+    // EAGAIN means the counter is already non-zero, which wakes the thread just the same
+    (void)write(eventFd_, &one, sizeof(one));
+}
+
+int64_t StateNotifier::intervalNsFor(float maxRateHz) noexcept {
+    const float rate = std::clamp(maxRateHz, kMinRateHz, kMaxRateHz);
+    return static_cast<int64_t>(1.0e9f / rate);
+}
+
+void StateNotifier::threadLoop() {
+    if (hooks_.onThreadStart) {
+        hooks_.onThreadStart();
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto nextDue = Clock::now();
+    bool ticking = true;    // The first collection publishes the initial state
+
+    while (running_.load(std::memory_order_acquire)) {
+        int timeoutMs = -1;
+        if (ticking || pending_.load(std::memory_order_acquire)) {
+            const auto now = Clock::now();
+            if (now >= nextDue) {
+                // Cleared before collecting so a post racing the collection schedules another
+                pending_.store(false, std::memory_order_release);
+                {
+                    NS_TRACE_SCOPE("StateNotifier::collect");
+                    ticking = collect_();
+                }
+                collections_.fetch_add(1, std::memory_order_relaxed);
+                nextDue = now + std::chrono::nanoseconds(
+                    intervalNs_.load(std::memory_order_relaxed));
+                continue;
+            }
+            const int64_t waitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                nextDue - now).count();
+            timeoutMs = static_cast<int>((waitNs + kNsPerMs - 1) / kNsPerMs);
+        }
+
+        pollfd pfd{eventFd_, POLLIN, 0};
+        if (poll(&pfd, 1, timeoutMs) > 0 && (pfd.revents & POLLIN)) {
+            uint64_t count = 0;
+            (void)read(eventFd_, &count, sizeof(count));
+            wakeups_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (hooks_.onThreadStop) {
+        hooks_.onThreadStop();
+    }
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "frame_dispatcher.h"
+
+namespace nativesensor {
+
+/// Runs on the notifier thread once per wakeup
+/// @return true to keep ticking at the maximum rate without further posts
+using StateCollectCallback = std::function<bool()>;
+
+/// Notifier statistics
+struct StateNotifierStats {
+    int64_t posts = 0;              // post() calls, including coalesced ones
+    int64_t wakeups = 0;            // Times the eventfd woke the thread
+    int64_t collections = 0;        // Collect callback runs
+};
+
+/// Coalesces state changes from producer threads into bounded-rate collections on one
+/// consumer thread. Producers only set a pending flag; the first post after a collection
+/// also signals an eventfd, so the sensor thread never takes a lock or makes a syscall per
+/// sample. The thread collects at most maxRateHz times per second and blocks in poll()
+/// indefinitely while nothing is pending and the last collection asked for no further ticks.
+class StateNotifier {
+public:
+    StateNotifier() = default;
+    ~StateNotifier();
+
+    StateNotifier(const StateNotifier&) = delete;
+    StateNotifier& operator=(const StateNotifier&) = delete;
+
+    /// Start the notifier thread; the first collection runs immediately
+    /// @param collect Invoked on the notifier thread
+    /// @param maxRateHz Upper bound on collections per second
+    /// @param hooks Optional thread start/stop hooks
+    /// @return false if already running or the eventfd could not be created
+    bool start(StateCollectCallback collect, float maxRateHz,
+               DispatcherThreadHooks hooks = {});
+
+    /// Stop the notifier thread; no collection runs once this returns
+    void stop();
+
+    /// Mark state as changed (any thread, lock-free)
+    void post() noexcept;
+
+    /// Change the maximum collection rate while running
+    void setMaxRate(float maxRateHz) noexcept;
+
+    /// Check if the notifier thread is running
+    [[nodiscard]]
+    bool isRunning() const noexcept { return running_.load(std::memory_order_acquire); }
+
+    /// Get notifier statistics
+    [[nodiscard]]
+    StateNotifierStats getStats() const noexcept;
+
+private:
+    void threadLoop();
+    void signal() noexcept;
+
+    static int64_t intervalNsFor(float maxRateHz) noexcept;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> pending_{false};
+    std::atomic<int64_t> intervalNs_{0};
+    int eventFd_ = -1;
+
+    StateCollectCallback collect_;
+    DispatcherThreadHooks hooks_;
+
+    std::atomic<int64_t> posts_{0};
+    std::atomic<int64_t> wakeups_{0};
+    std::atomic<int64_t> collections_{0};
+};
+
+}  // namespace nativesensor
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nativesensor {
+
+// UI state snapshot pushed to Kotlin, native byte order. Written into the direct buffer
+// registered with StateUpdates.start and mirrored by StateUpdates.kt; bump
+// kStateSnapshotVersion on any change. Every section is refreshed on each update and
+// changedMask names the sections that differ from the previous update.
+
+constexpr uint32_t kStateSnapshotVersion = 1;
+
+/// StateSnapshot::changedMask
+constexpr uint32_t kStateChangedImuSamples = 1u << 0;     // accel, gyro
+constexpr uint32_t kStateChangedImuStats = 1u << 1;       // imuStats
+constexpr uint32_t kStateChangedImuMetadata = 1u << 2;    // imuMetadata, imuRunning
+constexpr uint32_t kStateChangedCameraStats = 1u << 3;    // activeCameraStreams, cameraStats
+
+struct StateSnapshot {
+    uint32_t version = kStateSnapshotVersion;
+    uint32_t changedMask = 0;
+    uint64_t sequence = 0;              // Incremented per delivered update
+    float accel[4] = {};                // x, y, z (m/s²), timestamp (ms)
+    float gyro[4] = {};                 // x, y, z (rad/s), timestamp (ms)
+    float imuStats[4] = {};             // accel Hz, accel latency ms, gyro Hz, gyro latency ms
+    int32_t imuMetadata[6] = {};        // Same order as NativeSensorBridge.getMetadata
+    int32_t imuRunning = 0;
+    int32_t activeCameraStreams = 0;
+    float cameraStats[4] = {};          // Mean fps, max latency ms, frames, dropped frames
+};
+static_assert(sizeof(StateSnapshot) == 112, "Update StateUpdates.kt offsets");
+
+}  // namespace nativesensor
@@ -0,0 +1,161 @@
+#include "mapped_file_writer.h"
+
+#include <android/log.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Recorder";
+}
+
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+namespace {
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) noexcept {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+MappedFileWriter::~MappedFileWriter() {
+    close();
+}
+
+bool MappedFileWriter::open(const std::string& path, size_t windowBytes) {
+    close();
+
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    pageSize_ = pageSize > 0 ? static_cast<size_t>(pageSize) : 4096;
+    windowBytes_ = static_cast<size_t>(alignUp(std::max(windowBytes, pageSize_), pageSize_));
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        LOGE("Failed to create %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    offset_ = 0;
+    allocated_ = 0;
+    if (!mapWindow(windowBytes_)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+uint8_t* MappedFileWriter::reserve(size_t bytes) {
+    if (fd_ < 0) {
+        return nullptr;
+    }
+    if (!window_ || offset_ + bytes > windowStart_ + windowLength_) {
+        if (!mapWindow(bytes)) {
+            return nullptr;
+        }
+    }
+    return window_ + (offset_ - windowStart_);
+}
+
+bool MappedFileWriter::mapWindow(size_t minBytes) {
+    unmapWindow();
+
+    // Start on the page holding the write offset so partially written pages stay mapped
+    const uint64_t start = offset_ / pageSize_ * pageSize_;
+    const uint64_t length = alignUp(std::max<uint64_t>(windowBytes_, offset_ - start + minBytes),
+                                    pageSize_);
+    const uint64_t end = start + length;
+
+    if (end > allocated_) {
+        const int error = posix_fallocate(fd_, static_cast<off_t>(allocated_),
+                                          static_cast<off_t>(end - allocated_));
+        if (error != 0) {
+            LOGE("Failed to preallocate %llu bytes: %s",
+                 static_cast<unsigned long long>(end - allocated_), strerror(error));
+            return false;
+        }
+        allocated_ = end;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(length), PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd_, static_cast<off_t>(start));
+    if (mapping == MAP_FAILED) {
+        LOGE("Failed to map %llu bytes at %llu: %s", static_cast<unsigned long long>(length),
+             static_cast<unsigned long long>(start), strerror(errno));
+        return false;
+    }
+    madvise(mapping, static_cast<size_t>(length), MADV_SEQUENTIAL);
+
+    window_ = static_cast<uint8_t*>(mapping);
+    windowStart_ = start;
+    windowLength_ = static_cast<size_t>(length);
+    return true;
+}
+
+void MappedFileWriter::unmapWindow() noexcept {
+    if (!window_) {
+        return;
+    }
+    // Start writeback now rather than when the kernel gets to the dirty pages
+    msync(window_, windowLength_, MS_ASYNC);
+    munmap(window_, windowLength_);
+    window_ = nullptr;
+    windowLength_ = 0;
+}
+
+bool MappedFileWriter::writeAt(uint64_t offset, const void* data, size_t size) {
+    if (fd_ < 0) {
+        return false;
+    }
+    // Keep the mapping coherent when the range is inside the live window
+    if (window_ && offset >= windowStart_ && offset + size <= windowStart_ + windowLength_) {
+        std::memcpy(window_ + (offset - windowStart_), data, size);
+        return true;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const ssize_t written = pwrite(fd_, bytes, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOGE("Failed to write %zu bytes at %llu: %s", size,
+                 static_cast<unsigned long long>(offset), strerror(errno));
+            return false;
+        }
+        bytes += written;
+        offset += static_cast<uint64_t>(written);
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool MappedFileWriter::close() {
+    if (fd_ < 0) {
+        return true;
+    }
+
+    unmapWindow();
+
+    bool ok = true;
+    if (ftruncate(fd_, static_cast<off_t>(offset_)) != 0) {
+        LOGE("Failed to trim recording to %llu bytes: %s",
+             static_cast<unsigned long long>(offset_), strerror(errno));
+        ok = false;
+    }
+    if (fdatasync(fd_) != 0) {
+        LOGE("Failed to flush recording: %s", strerror(errno));
+        ok = false;
+    }
+    ::close(fd_);
+    fd_ = -1;
+    allocated_ = 0;
+    return ok;
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nativesensor {
+
+/// Append-only file writer backed by a sliding shared mapping.
+/// Space is reserved with fallocate ahead of the write position, so stores into the mapping
+/// never hit ENOSPC (SIGBUS) and the filesystem can allocate large extents. Completed windows
+/// are handed to writeback with msync(MS_ASYNC) and unmapped, bounding the mapped footprint.
+/// Not thread-safe: owned by a single I/O thread.
+class MappedFileWriter {
+public:
+    MappedFileWriter() = default;
+    ~MappedFileWriter();
+
+    MappedFileWriter(const MappedFileWriter&) = delete;
+    MappedFileWriter& operator=(const MappedFileWriter&) = delete;
+
+    /// Create (or truncate) path for writing
+    /// @param windowBytes Mapping window and preallocation step (rounded to pages)
+    /// @return false if the file cannot be created or preallocated
+    bool open(const std::string& path, size_t windowBytes);
+
+    /// Writable pointer to `bytes` contiguous bytes at the current offset, remapping if needed
+    /// @return nullptr on I/O failure (e.g. the disk is full)
+    uint8_t* reserve(size_t bytes);
+
+    /// Advance the write offset past data written through reserve()
+    void commit(size_t bytes) noexcept { offset_ += bytes; }
+
+    /// Current write offset (bytes appended so far)
+    [[nodiscard]]
+    uint64_t offset() const noexcept { return offset_; }
+
+    /// Overwrite bytes already appended (e.g. the file header) outside the mapping
+    bool writeAt(uint64_t offset, const void* data, size_t size);
+
+    /// Unmap, trim the preallocated tail to offset(), flush and close
+    /// @return false if the final flush failed
+    bool close();
+
+    [[nodiscard]]
+    bool isOpen() const noexcept { return fd_ >= 0; }
+
+private:
+    bool mapWindow(size_t minBytes);
+    void unmapWindow() noexcept;
+
+    int fd_ = -1;
+    size_t pageSize_ = 4096;
+    size_t windowBytes_ = 0;
+
+    uint8_t* window_ = nullptr;     // Maps [windowStart_, windowStart_ + windowLength_)
+    uint64_t windowStart_ = 0;
+    size_t windowLength_ = 0;
+
+    uint64_t offset_ = 0;           // Next byte to append
+    uint64_t allocated_ = 0;        // File length reserved so far
+};
+
+}  // namespace nativesensor
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nativesensor {
+
+// Session recording container (.nsrec), native byte order (little-endian on every Android ABI).
+//
+//   SessionFileHeader                      offset 0, rewritten when the session is finalized
+//   chunk, chunk, ...                      each a ChunkHeader + payload, kChunkAlignment aligned
+//   SessionIndexEntry[entryCount]          one per chunk, in file order
+//   SessionIndexTrailer                    last bytes of the file
+//
+// Chunk payloads:
+//   StreamInfo  one SessionStreamInfo, written before a stream's first frame
+//   Imu         PackedImuSample[recordCount] (accel and gyro interleaved in timestamp order)
+//   Frame       one SessionFrameHeader followed by dataBytes of frame data
+//
+// A session that was not finalized (crash, power loss) has no index; readers can still walk
+// the chunks from the header until the first invalid ChunkHeader magic.
+
+constexpr uint32_t kSessionMagic = 0x4345524e;          // "NREC"
+constexpr uint32_t kSessionVersion = 1;
+constexpr uint32_t kChunkMagic = 0x4b4e4843;            // "CHNK"
+constexpr uint32_t kSessionIndexMagic = 0x58444e49;     // "INDX"
+constexpr size_t kChunkAlignment = 64;
+
+/// SessionFileHeader::flags
+constexpr uint32_t kSessionFlagFinalized = 1u << 0;    // Index and trailer are present
+
+/// SessionFrameHeader::flags
+constexpr uint32_t kFrameFlagKeyFrame = 1u << 0;       // Encoded frame decodable on its own
+constexpr uint32_t kFrameFlagCodecConfig = 1u << 1;    // Encoded codec configuration (SPS/PPS...)
+
+enum class SessionChunkType : uint32_t {
+    StreamInfo = 1,
+    Imu = 2,
+    Frame = 3
+};
+
+enum class SessionStreamKind : uint32_t {
+    RawFrames = 1,      // Packed YUV (format = YuvOutputFormat)
+    EncodedFrames = 2   // Compressed bitstream (format = codec-specific, e.g. a MIME hash)
+};
+
+struct SessionFileHeader {
+    uint32_t magic = kSessionMagic;
+    uint32_t version = kSessionVersion;
+    uint32_t headerBytes = sizeof(SessionFileHeader);
+    uint32_t flags = 0;
+    int64_t startBootTimeNs = 0;        // CLOCK_BOOTTIME at start (sensor/camera time base)
+    int64_t startRealtimeNs = 0;        // CLOCK_REALTIME at the same instant
+    uint64_t indexOffset = 0;           // 0 until finalized
+    uint64_t dataBytes = 0;             // End of the last chunk, 0 until finalized
+    uint8_t reserved[16] = {};
+};
+static_assert(sizeof(SessionFileHeader) == 64, "SessionFileHeader is part of the file format");
+
+struct SessionChunkHeader {
+    uint32_t magic = kChunkMagic;
+    uint32_t type = 0;                  // SessionChunkType
+    uint32_t streamId = 0;              // Frame/StreamInfo chunks; 0 for IMU
+    uint32_t recordCount = 0;
+    uint64_t payloadBytes = 0;          // Excluding this header and alignment padding
+    int64_t firstTimestampNs = 0;
+    int64_t lastTimestampNs = 0;
+    uint64_t reserved = 0;
+};
+static_assert(sizeof(SessionChunkHeader) == 48, "SessionChunkHeader is part of the file format");
+
+struct SessionStreamInfo {
+    uint32_t streamId = 0;
+    uint32_t kind = 0;                  // SessionStreamKind
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t format = 0;
+    uint32_t reserved = 0;
+    char name[40] = {};                 // Camera id, NUL-terminated
+};
+static_assert(sizeof(SessionStreamInfo) == 64, "SessionStreamInfo is part of the file format");
+
+struct SessionFrameHeader {
+    int64_t timestampNs = 0;            // Sensor start of exposure
+    int64_t frameNumber = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t format = 0;
+    uint32_t flags = 0;                 // kFrameFlag*
+    uint64_t dataBytes = 0;
+};
+static_assert(sizeof(SessionFrameHeader) == 40, "SessionFrameHeader is part of the file format");
+
+struct SessionIndexEntry {
+    uint64_t offset = 0;                // Of the ChunkHeader
+    int64_t firstTimestampNs = 0;
+    int64_t lastTimestampNs = 0;
+    uint32_t type = 0;                  // SessionChunkType
+    uint32_t streamId = 0;
+    uint32_t recordCount = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(SessionIndexEntry) == 40, "SessionIndexEntry is part of the file format");
+
+struct SessionIndexTrailer {
+    uint32_t magic = kSessionIndexMagic;
+    uint32_t entryCount = 0;
+    uint64_t indexOffset = 0;
+};
+static_assert(sizeof(SessionIndexTrailer) == 16, "SessionIndexTrailer is part of the file format");
+
+/// Round a file offset or size up to the chunk alignment
+constexpr uint64_t alignChunk(uint64_t value) noexcept {
+    return (value + kChunkAlignment - 1) & ~static_cast<uint64_t>(kChunkAlignment - 1);
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,179 @@
+#include "session_reader.h"
+
+#include <android/log.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Replay";
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+SessionReader::~SessionReader() {
+    close();
+}
+
+bool SessionReader::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGE("Failed to open %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SessionFileHeader))) {
+        LOGE("%s is not a session file", path.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    const auto size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file referenced
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        LOGE("Failed to map %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = size;
+    std::memcpy(&header_, data_, sizeof(header_));
+
+    if (header_.magic != kSessionMagic || header_.version != kSessionVersion ||
+        header_.headerBytes < sizeof(SessionFileHeader) || header_.headerBytes > size_) {
+        LOGE("%s: unsupported session header (magic=0x%08x version=%u)", path.c_str(),
+             header_.magic, header_.version);
+        close();
+        return false;
+    }
+
+    if (!isFinalized() || !loadIndex()) {
+        LOGW("%s has no usable index, scanning chunks", path.c_str());
+        header_.flags &= ~kSessionFlagFinalized;
+        walkChunks();
+    }
+
+    LOGI("Opened session %s (%zu chunks, %zu bytes%s)", path.c_str(), chunks_.size(), size_,
+         isFinalized() ? "" : ", unfinalized");
+    return true;
+}
+
+void SessionReader::close() noexcept {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    header_ = SessionFileHeader{};
+    chunks_.clear();
+}
+
+const SessionChunkHeader* SessionReader::chunkAt(uint64_t offset) const noexcept {
+    if (offset % alignof(SessionChunkHeader) != 0 || offset > size_ ||
+        size_ - offset < sizeof(SessionChunkHeader)) {
+        return nullptr;
+    }
+    const auto* chunk = reinterpret_cast<const SessionChunkHeader*>(data_ + offset);
+    if (chunk->magic != kChunkMagic ||
+        chunk->payloadBytes > size_ - offset - sizeof(SessionChunkHeader)) {
+        return nullptr;
+    }
+    return chunk;
+}
+
+bool SessionReader::loadIndex() {
+    if (size_ < sizeof(SessionIndexTrailer)) {
+        return false;
+    }
+    SessionIndexTrailer trailer;
+    std::memcpy(&trailer, data_ + size_ - sizeof(trailer), sizeof(trailer));
+
+    const uint64_t indexEnd = size_ - sizeof(trailer);
+    if (trailer.magic != kSessionIndexMagic || trailer.indexOffset != header_.indexOffset ||
+        trailer.indexOffset > indexEnd ||
+        (indexEnd - trailer.indexOffset) / sizeof(SessionIndexEntry) != trailer.entryCount) {
+        return false;
+    }
+
+    chunks_.resize(trailer.entryCount);
+    if (trailer.entryCount > 0) {
+        std::memcpy(chunks_.data(), data_ + trailer.indexOffset,
+                    trailer.entryCount * sizeof(SessionIndexEntry));
+    }
+    return true;
+}
+
+void SessionReader::walkChunks() {
+    chunks_.clear();
+    uint64_t offset = alignChunk(header_.headerBytes);
+    while (const SessionChunkHeader* chunk = chunkAt(offset)) {
+        SessionIndexEntry entry;
+        entry.offset = offset;
+        entry.firstTimestampNs = chunk->firstTimestampNs;
+        entry.lastTimestampNs = chunk->lastTimestampNs;
+        entry.type = chunk->type;
+        entry.streamId = chunk->streamId;
+        entry.recordCount = chunk->recordCount;
+        chunks_.push_back(entry);
+        offset += alignChunk(sizeof(SessionChunkHeader) + chunk->payloadBytes);
+    }
+}
+
+const PackedImuSample* SessionReader::imuSamples(const SessionIndexEntry& entry,
+                                                 size_t& count) const noexcept {
+    count = 0;
+    const SessionChunkHeader* chunk = chunkAt(entry.offset);
+    if (!chunk || chunk->type != static_cast<uint32_t>(SessionChunkType::Imu) ||
+        chunk->payloadBytes / sizeof(PackedImuSample) < chunk->recordCount) {
+        return nullptr;
+    }
+    count = chunk->recordCount;
+    return reinterpret_cast<const PackedImuSample*>(data_ + entry.offset + sizeof(*chunk));
+}
+
+bool SessionReader::frame(const SessionIndexEntry& entry, SessionFrameView& view) const noexcept {
+    const SessionChunkHeader* chunk = chunkAt(entry.offset);
+    if (!chunk || chunk->type != static_cast<uint32_t>(SessionChunkType::Frame) ||
+        chunk->payloadBytes < sizeof(SessionFrameHeader)) {
+        return false;
+    }
+    const uint8_t* payload = data_ + entry.offset + sizeof(*chunk);
+    const auto* header = reinterpret_cast<const SessionFrameHeader*>(payload);
+    if (header->dataBytes > chunk->payloadBytes - sizeof(SessionFrameHeader)) {
+        return false;
+    }
+    view.streamId = chunk->streamId;
+    view.header = header;
+    view.data = payload + sizeof(SessionFrameHeader);
+    return true;
+}
+
+const SessionStreamInfo* SessionReader::streamInfo(uint32_t streamId) const noexcept {
+    for (const SessionIndexEntry& entry : chunks_) {
+        if (entry.type != static_cast<uint32_t>(SessionChunkType::StreamInfo) ||
+            entry.streamId != streamId) {
+            continue;
+        }
+        const SessionChunkHeader* chunk = chunkAt(entry.offset);
+        if (chunk && chunk->payloadBytes >= sizeof(SessionStreamInfo)) {
+            return reinterpret_cast<const SessionStreamInfo*>(data_ + entry.offset +
+                                                              sizeof(*chunk));
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace nativesensor
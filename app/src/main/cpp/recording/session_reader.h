@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "imu_data.h"
+#include "session_format.h"
+
+namespace nativesensor {
+
+/// Zero-copy view of one recorded frame; valid while the reader stays open
+struct SessionFrameView {
+    uint32_t streamId = 0;
+    const SessionFrameHeader* header = nullptr;
+    const uint8_t* data = nullptr;              // header->dataBytes bytes
+};
+
+/// Read-only access to an .nsrec session file through a private mapping.
+/// Every offset and count in the file is bounds-checked against the mapping, so a truncated
+/// or corrupt file yields fewer chunks rather than out-of-bounds reads.
+/// Not thread-safe for open/close; accessors may be called concurrently while open.
+class SessionReader {
+public:
+    SessionReader() = default;
+    ~SessionReader();
+
+    SessionReader(const SessionReader&) = delete;
+    SessionReader& operator=(const SessionReader&) = delete;
+
+    /// Map path and load its chunk index (walking the chunks if it was never finalized)
+    /// @return false if the file cannot be mapped or has no valid session header
+    bool open(const std::string& path);
+
+    /// Unmap the file; outstanding views become invalid
+    void close() noexcept;
+
+    [[nodiscard]]
+    bool isOpen() const noexcept { return data_ != nullptr; }
+
+    [[nodiscard]]
+    const SessionFileHeader& header() const noexcept { return header_; }
+
+    /// True if the index came from the file rather than a chunk walk
+    [[nodiscard]]
+    bool isFinalized() const noexcept { return (header_.flags & kSessionFlagFinalized) != 0; }
+
+    /// Every valid chunk in file order
+    [[nodiscard]]
+    const std::vector<SessionIndexEntry>& chunks() const noexcept { return chunks_; }
+
+    /// IMU records of an Imu chunk
+    /// @return nullptr if entry is not a valid Imu chunk
+    const PackedImuSample* imuSamples(const SessionIndexEntry& entry, size_t& count) const noexcept;
+
+    /// Frame stored in a Frame chunk
+    /// @return false if entry is not a valid Frame chunk
+    bool frame(const SessionIndexEntry& entry, SessionFrameView& view) const noexcept;
+
+    /// Stream description written before the stream's first frame
+    /// @return nullptr if the stream has none
+    const SessionStreamInfo* streamInfo(uint32_t streamId) const noexcept;
+
+private:
+    /// Chunk header at offset, or nullptr if it does not fit the mapping
+    const SessionChunkHeader* chunkAt(uint64_t offset) const noexcept;
+    bool loadIndex();
+    void walkChunks();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    SessionFileHeader header_;
+    std::vector<SessionIndexEntry> chunks_;
+};
+
+}  // namespace nativesensor
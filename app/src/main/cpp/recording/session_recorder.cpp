@@ -0,0 +1,598 @@
+#include "session_recorder.h"
+
+#include <android/log.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+#include "trace.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Recorder";
+
+// IMU chunk is cut at whichever limit is reached first
+constexpr size_t kImuChunkSamples = 1024;
+
+// Samples held back for a later chunk (see writeImuChunks) are bounded by this many chunks;
+// one more popped chunk may join them before they are written
+constexpr size_t kImuPendingChunks = 2;
+constexpr size_t kImuPendingCapacity = (kImuPendingChunks + 1) * kImuChunkSamples;
+
+// Accel, gyro and their uncalibrated companions
+constexpr size_t kMaxImuSensorTypes = 4;
+constexpr int64_t kImuChunkSpanNs = 100'000'000;
+
+// I/O thread wakeup period; longer than a sensor batch, far shorter than the queues
+constexpr auto kPollInterval = std::chrono::milliseconds(2);
+
+// Expected chunk count for a few minutes at 2 x 30 fps; the index grows beyond as needed
+constexpr size_t kInitialIndexEntries = 16384;
+
+// Smallest configuration a memory budget may reduce a session to
+constexpr size_t kMinPacketPoolSlots = 4;
+constexpr size_t kMinFramePoolSlots = 4;
+constexpr size_t kMinWindowBytes = 4u << 20;
+
+int64_t clockNowNs(clockid_t clock) {
+    timespec t{};
+    clock_gettime(clock, &t);
+    return static_cast<int64_t>(t.tv_sec) * 1000000000LL + t.tv_nsec;
+}
+
+/// Serializes producers that share one SPSC queue; held only for the push itself
+class SpinLockGuard {
+public:
+    explicit SpinLockGuard(std::atomic_flag& flag) noexcept : flag_(flag) {
+        while (flag_.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    ~SpinLockGuard() { flag_.clear(std::memory_order_release); }
+
+    SpinLockGuard(const SpinLockGuard&) = delete;
+    SpinLockGuard& operator=(const SpinLockGuard&) = delete;
+
+private:
+    std::atomic_flag& flag_;
+};
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+class SessionRecorder::ProducerGuard {
+public:
+    explicit ProducerGuard(SessionRecorder& recorder) noexcept : recorder_(recorder) {
+        // Sequentially consistent with stop(): either stop() sees this producer or the
+        // producer sees recording_ cleared
+        recorder_.activeProducers_.fetch_add(1, std::memory_order_seq_cst);
+        active_ = recorder_.recording_.load(std::memory_order_seq_cst);
+    }
+    ~ProducerGuard() { recorder_.activeProducers_.fetch_sub(1, std::memory_order_release); }
+
+    ProducerGuard(const ProducerGuard&) = delete;
+    ProducerGuard& operator=(const ProducerGuard&) = delete;
+
+    [[nodiscard]]
+    bool active() const noexcept { return active_; }
+
+private:
+    SessionRecorder& recorder_;
+    bool active_ = false;
+};
+
+SessionRecorder::~SessionRecorder() {
+    stop();
+}
+
+bool SessionRecorder::start(const std::string& path, const SessionRecorderConfig& config) {
+    if (recording_.load(std::memory_order_acquire)) {
+        LOGW("SessionRecorder already recording");
+        return false;
+    }
+
+    // Shrink packets in flight first (only encoded streams use them), then the mapping window
+    const size_t stagingBytes = kInitialIndexEntries * sizeof(SessionIndexEntry) +
+                                kImuChunkSamples * sizeof(ImuSample) +
+                                kImuPendingCapacity * sizeof(PackedImuSample);
+    const int64_t available = memoryBudgetAvailable();
+    size_t packetSlots = config.packetPoolSlots;
+    size_t windowBytes = config.windowBytes;
+    auto sessionBytes = [&] {
+        return static_cast<int64_t>(packetSlots * config.packetBufferBytes + windowBytes +
+                                    stagingBytes);
+    };
+    while (sessionBytes() > available) {
+        if (packetSlots > kMinPacketPoolSlots) {
+            packetSlots = std::max(packetSlots / 2, kMinPacketPoolSlots);
+        } else if (windowBytes > kMinWindowBytes) {
+            windowBytes = std::max(windowBytes / 2, kMinWindowBytes);
+        } else {
+            recordMemoryRefusedStream();
+            LOGE("Recording needs %lld bytes, %lld available under the memory budget",
+                 static_cast<long long>(sessionBytes()), static_cast<long long>(available));
+            return false;
+        }
+    }
+    if (packetSlots != config.packetPoolSlots || windowBytes != config.windowBytes) {
+        recordMemoryDegradedStream();
+        LOGI("Recording degraded to %zu packet slots, %zu byte window", packetSlots, windowBytes);
+    }
+
+    if (!packetPool_.allocate(packetSlots, config.packetBufferBytes, MemoryComponent::Recorder)) {
+        LOGE("Failed to allocate packet pool (%zu x %zu bytes)", packetSlots,
+             config.packetBufferBytes);
+        return false;
+    }
+    if (!writer_.open(path, windowBytes)) {
+        packetPool_.release();
+        return false;
+    }
+    stagingReservation_ = MemoryReservation(MemoryComponent::Recorder, windowBytes + stagingBytes);
+
+    fileHeader_ = SessionFileHeader{};
+    fileHeader_.startBootTimeNs = clockNowNs(CLOCK_BOOTTIME);
+    fileHeader_.startRealtimeNs = clockNowNs(CLOCK_REALTIME);
+    uint8_t* header = writer_.reserve(sizeof(fileHeader_));
+    if (!header) {
+        writer_.close();
+        packetPool_.release();
+        stagingReservation_.reset();
+        return false;
+    }
+    std::memcpy(header, &fileHeader_, sizeof(fileHeader_));
+    writer_.commit(sizeof(fileHeader_));
+
+    index_.clear();
+    index_.reserve(kInitialIndexEntries);
+    imuScratch_.resize(kImuChunkSamples);
+    pendingImu_.clear();
+    pendingImu_.reserve(kImuPendingCapacity);
+    for (StreamQueue& stream : streams_) {
+        stream.infoWritten = false;
+        stream.refusedFrameBytes = 0;
+    }
+    framePoolSlots_ = std::clamp(config.framePoolSlots, kMinFramePoolSlots,
+                                 std::min(kFrameQueueCapacity, FrameBufferPool::kMaxSlots));
+    ioFailed_ = false;
+
+    imuSamples_.store(0, std::memory_order_relaxed);
+    imuDropped_.store(0, std::memory_order_relaxed);
+    frames_.store(0, std::memory_order_relaxed);
+    framesDropped_.store(0, std::memory_order_relaxed);
+    poolStarvations_.store(0, std::memory_order_relaxed);
+    bytesWritten_.store(static_cast<int64_t>(sizeof(fileHeader_)), std::memory_order_relaxed);
+    chunks_.store(0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_ = true;
+    }
+    thread_ = std::thread(&SessionRecorder::threadLoop, this);
+    recording_.store(true, std::memory_order_seq_cst);
+    LOGI("Recording session to %s", path.c_str());
+    return true;
+}
+
+void SessionRecorder::stop() {
+    if (!recording_.exchange(false, std::memory_order_seq_cst)) {
+        return;
+    }
+
+    // Producers that passed the recording_ check may still be pushing
+    while (activeProducers_.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_ = false;
+    }
+    wakeCondition_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // I/O thread has exited; this thread is now the sole consumer
+    drainQueues(true);
+    finalize();
+    if (!writer_.close()) {
+        ioFailed_ = true;
+    }
+    packetPool_.release();
+    for (StreamQueue& stream : streams_) {
+        stream.framePool.release();
+    }
+
+    // Staging storage goes back with its reservation instead of idling until the next session
+    std::vector<SessionIndexEntry>().swap(index_);
+    std::vector<ImuSample>().swap(imuScratch_);
+    std::vector<PackedImuSample>().swap(pendingImu_);
+    stagingReservation_.reset();
+
+    const RecorderStats stats = getStats();
+    LOGI("Recording stopped: %lld IMU samples (%lld dropped), %lld frames (%lld dropped), "
+         "%lld bytes%s",
+         static_cast<long long>(stats.imuSamples), static_cast<long long>(stats.imuDropped),
+         static_cast<long long>(stats.frames), static_cast<long long>(stats.framesDropped),
+         static_cast<long long>(stats.bytesWritten), ioFailed_ ? " (I/O failed)" : "");
+}
+
+void SessionRecorder::describeStream(uint32_t streamId, const std::string& name,
+                                     SessionStreamKind kind) {
+    if (streamId >= kMaxStreams) {
+        LOGW("Stream id %u out of range", streamId);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(descriptionMutex_);
+    descriptions_[streamId].name = name;
+    descriptions_[streamId].kind = kind;
+}
+
+bool SessionRecorder::recordImu(const ImuSample* samples, size_t count) {
+    ProducerGuard guard(*this);
+    if (!guard.active() || count == 0) {
+        return false;
+    }
+
+    size_t pushed;
+    {
+        SpinLockGuard lock(imuProducerLock_);
+        pushed = imuQueue_.pushBulk(samples, count);
+    }
+    if (pushed < count) {
+        imuDropped_.fetch_add(static_cast<int64_t>(count - pushed), std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool SessionRecorder::recordFrame(uint32_t streamId, const FrameBufferHandle& buffer,
+                                  const FrameMetadata& metadata) {
+    ProducerGuard guard(*this);
+    if (!guard.active() || !buffer) {
+        return false;
+    }
+    if (streamId >= kMaxStreams) {
+        framesDropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Copy out so the capture slot goes straight back to its pool; holding it until the
+    // I/O thread writes would starve the camera whenever storage stalls
+    StreamQueue& stream = streams_[streamId];
+    FrameBufferHandle copy;
+    {
+        SpinLockGuard lock(stream.producerLock);
+        copy = acquireFrameSlot(streamId, stream, buffer.size());
+    }
+    if (!copy) {
+        framesDropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::memcpy(copy.data(), buffer.data(), buffer.size());
+    copy.setSize(buffer.size());
+    return enqueueFrame(streamId, std::move(copy), metadata, 0);
+}
+
+FrameBufferHandle SessionRecorder::acquireFrameSlot(uint32_t streamId, StreamQueue& stream,
+                                                    size_t frameBytes) {
+    if (frameBytes == 0 || frameBytes == stream.refusedFrameBytes) {
+        return {};
+    }
+    const FramePoolStats poolStats = stream.framePool.getStats();
+    if (!stream.framePool.isAllocated() || poolStats.bufferSize < frameBytes) {
+        // One allocation per stream (per size increase), on the first frame that needs it.
+        // Storage of a replaced pool stays alive until its queued frames are written.
+        size_t slots = framePoolSlots_;
+        const int64_t available = memoryBudgetAvailable();
+        while (static_cast<int64_t>(slots * frameBytes) > available && slots > kMinFramePoolSlots) {
+            slots = std::max(slots / 2, kMinFramePoolSlots);
+        }
+        if (static_cast<int64_t>(slots * frameBytes) > available) {
+            if (stream.framePool.isAllocated()) {
+                stream.framePool.release();
+            }
+            stream.refusedFrameBytes = frameBytes;
+            recordMemoryRefusedStream();
+            LOGE("Stream %u frame pool (%zu x %zu bytes) exceeds the memory budget", streamId,
+                 slots, frameBytes);
+            return {};
+        }
+        if (slots < framePoolSlots_) {
+            recordMemoryDegradedStream();
+        }
+        if (!stream.framePool.allocate(slots, frameBytes, MemoryComponent::Recorder)) {
+            stream.refusedFrameBytes = frameBytes;
+            LOGE("Failed to allocate stream %u frame pool (%zu x %zu bytes)", streamId, slots,
+                 frameBytes);
+            return {};
+        }
+        LOGI("Stream %u frame pool: %zu x %zu bytes", streamId, slots, frameBytes);
+    }
+
+    FrameBufferHandle slot = stream.framePool.acquire();
+    if (!slot) {
+        // Every copy is still queued for the I/O thread
+        poolStarvations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return slot;
+}
+
+bool SessionRecorder::recordPacket(uint32_t streamId, const uint8_t* data, size_t size,
+                                   const FrameMetadata& metadata, uint32_t flags) {
+    ProducerGuard guard(*this);
+    if (!guard.active() || data == nullptr || size == 0) {
+        return false;
+    }
+
+    FrameBufferHandle buffer = packetPool_.acquire();
+    if (!buffer) {
+        poolStarvations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!buffer || size > buffer.capacity()) {
+        framesDropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::memcpy(buffer.data(), data, size);
+    buffer.setSize(size);
+    return enqueueFrame(streamId, std::move(buffer), metadata, flags);
+}
+
+bool SessionRecorder::enqueueFrame(uint32_t streamId, FrameBufferHandle buffer,
+                                   const FrameMetadata& metadata, uint32_t flags) {
+    if (streamId >= kMaxStreams) {
+        framesDropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    SessionFrameHeader header;
+    header.timestampNs = metadata.timestampNs;
+    header.frameNumber = metadata.frameNumber;
+    header.width = metadata.width;
+    header.height = metadata.height;
+    header.format = metadata.format;
+    header.flags = flags;
+    header.dataBytes = buffer.size();
+
+    StreamQueue& stream = streams_[streamId];
+    bool queued;
+    {
+        SpinLockGuard lock(stream.producerLock);
+        queued = stream.frames.emplace(std::move(buffer), header);
+    }
+    if (!queued) {
+        framesDropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return queued;
+}
+
+RecorderStats SessionRecorder::getStats() const noexcept {
+    RecorderStats stats;
+    stats.imuSamples = imuSamples_.load(std::memory_order_relaxed);
+    stats.imuDropped = imuDropped_.load(std::memory_order_relaxed);
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.framesDropped = framesDropped_.load(std::memory_order_relaxed);
+    stats.poolStarvations = poolStarvations_.load(std::memory_order_relaxed);
+    stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+    stats.chunks = chunks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SessionRecorder::threadLoop() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    while (running_) {
+        lock.unlock();
+        drainQueues(false);
+        lock.lock();
+        wakeCondition_.wait_for(lock, kPollInterval, [this] { return !running_; });
+    }
+}
+
+void SessionRecorder::drainQueues(bool flush) {
+    NS_TRACE_SCOPE("SessionRecorder::drainQueues");
+
+    size_t count;
+    while ((count = imuQueue_.popBulk(imuScratch_.data(), imuScratch_.size())) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            const ImuSample& sample = imuScratch_[i];
+            pendingImu_.push_back({sample.timestampNs, sample.x, sample.y, sample.z,
+                                   static_cast<int32_t>(sample.sensorType)});
+        }
+        if (pendingImu_.size() >= kImuChunkSamples) {
+            writeImuChunks(false);
+        }
+    }
+    if (!pendingImu_.empty()) {
+        const auto [oldest, newest] = std::minmax_element(
+            pendingImu_.begin(), pendingImu_.end(),
+            [](const PackedImuSample& a, const PackedImuSample& b) {
+                return a.timestampNs < b.timestampNs;
+            });
+        if (flush || newest->timestampNs - oldest->timestampNs >= kImuChunkSpanNs) {
+            writeImuChunks(flush);
+        }
+    }
+
+    for (uint32_t streamId = 0; streamId < kMaxStreams; ++streamId) {
+        StreamQueue& stream = streams_[streamId];
+        RecordedFrame frame;
+        while (stream.frames.pop(frame)) {
+            writeFrame(streamId, stream, frame);
+            // Return the slot to the camera's pool as soon as it is on disk
+            frame.buffer.reset();
+        }
+    }
+}
+
+void SessionRecorder::writeImuChunks(bool flush) {
+    // Accel and gyro arrive in separate runs per sensor batch; interleave them in time
+    std::stable_sort(pendingImu_.begin(), pendingImu_.end(),
+                     [](const PackedImuSample& a, const PackedImuSample& b) {
+                         return a.timestampNs < b.timestampNs;
+                     });
+
+    // A later batch continues each sensor after its newest sample here, so only samples up to
+    // the oldest of those per-sensor maxima are final. Holding the rest back keeps chunk time
+    // ranges from overlapping, so a timestamp seek through the index never skips samples.
+    size_t ready = pendingImu_.size();
+    if (!flush && ready < kImuPendingChunks * kImuChunkSamples) {
+        int32_t types[kMaxImuSensorTypes] = {};
+        int64_t newest[kMaxImuSensorTypes] = {};
+        size_t typeCount = 0;
+        for (const PackedImuSample& sample : pendingImu_) {
+            size_t t = 0;
+            while (t < typeCount && types[t] != sample.sensorType) {
+                ++t;
+            }
+            if (t == typeCount) {
+                if (typeCount == kMaxImuSensorTypes) {
+                    continue;
+                }
+                types[typeCount++] = sample.sensorType;
+            }
+            newest[t] = std::max(newest[t], sample.timestampNs);
+        }
+        const int64_t finalNs = *std::min_element(newest, newest + typeCount);
+        ready = static_cast<size_t>(
+            std::upper_bound(pendingImu_.begin(), pendingImu_.end(), finalNs,
+                             [](int64_t timestampNs, const PackedImuSample& sample) {
+                                 return timestampNs < sample.timestampNs;
+                             }) -
+            pendingImu_.begin());
+    }
+
+    for (size_t first = 0; first < ready; first += kImuChunkSamples) {
+        const size_t count = std::min(kImuChunkSamples, ready - first);
+        const PackedImuSample* samples = pendingImu_.data() + first;
+        if (writeChunk(SessionChunkType::Imu, 0, static_cast<uint32_t>(count),
+                       samples[0].timestampNs, samples[count - 1].timestampNs,
+                       samples, count * sizeof(PackedImuSample), nullptr, 0)) {
+            imuSamples_.fetch_add(static_cast<int64_t>(count), std::memory_order_relaxed);
+        } else {
+            imuDropped_.fetch_add(static_cast<int64_t>(count), std::memory_order_relaxed);
+        }
+    }
+    pendingImu_.erase(pendingImu_.begin(), pendingImu_.begin() + static_cast<ptrdiff_t>(ready));
+}
+
+void SessionRecorder::writeFrame(uint32_t streamId, StreamQueue& stream,
+                                 const RecordedFrame& frame) {
+    if (!stream.infoWritten) {
+        SessionStreamInfo info;
+        info.streamId = streamId;
+        info.width = frame.header.width;
+        info.height = frame.header.height;
+        info.format = frame.header.format;
+        {
+            std::lock_guard<std::mutex> lock(descriptionMutex_);
+            const StreamDescription& description = descriptions_[streamId];
+            info.kind = static_cast<uint32_t>(description.kind);
+            std::strncpy(info.name, description.name.c_str(), sizeof(info.name) - 1);
+        }
+        stream.infoWritten = writeChunk(SessionChunkType::StreamInfo, streamId, 1,
+                                        frame.header.timestampNs, frame.header.timestampNs,
+                                        &info, sizeof(info), nullptr, 0);
+    }
+
+    if (writeChunk(SessionChunkType::Frame, streamId, 1, frame.header.timestampNs,
+                   frame.header.timestampNs, &frame.header, sizeof(frame.header),
+                   frame.buffer.data(), static_cast<size_t>(frame.header.dataBytes))) {
+        frames_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        framesDropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool SessionRecorder::writeChunk(SessionChunkType type, uint32_t streamId, uint32_t recordCount,
+                                 int64_t firstTimestampNs, int64_t lastTimestampNs,
+                                 const void* head, size_t headBytes,
+                                 const void* body, size_t bodyBytes) {
+    if (ioFailed_) {
+        return false;
+    }
+
+    const size_t payloadBytes = headBytes + bodyBytes;
+    const size_t usedBytes = sizeof(SessionChunkHeader) + payloadBytes;
+    const auto totalBytes = static_cast<size_t>(alignChunk(usedBytes));
+
+    const uint64_t offset = writer_.offset();
+    uint8_t* dst = writer_.reserve(totalBytes);
+    if (!dst) {
+        LOGE("Session write failed at %llu bytes; dropping further data",
+             static_cast<unsigned long long>(offset));
+        ioFailed_ = true;
+        return false;
+    }
+
+    SessionChunkHeader chunk;
+    chunk.type = static_cast<uint32_t>(type);
+    chunk.streamId = streamId;
+    chunk.recordCount = recordCount;
+    chunk.payloadBytes = payloadBytes;
+    chunk.firstTimestampNs = firstTimestampNs;
+    chunk.lastTimestampNs = lastTimestampNs;
+
+    std::memcpy(dst, &chunk, sizeof(chunk));
+    if (headBytes > 0) {
+        std::memcpy(dst + sizeof(chunk), head, headBytes);
+    }
+    if (bodyBytes > 0) {
+        std::memcpy(dst + sizeof(chunk) + headBytes, body, bodyBytes);
+    }
+    std::memset(dst + usedBytes, 0, totalBytes - usedBytes);
+    writer_.commit(totalBytes);
+
+    SessionIndexEntry entry;
+    entry.offset = offset;
+    entry.firstTimestampNs = firstTimestampNs;
+    entry.lastTimestampNs = lastTimestampNs;
+    entry.type = chunk.type;
+    entry.streamId = streamId;
+    entry.recordCount = recordCount;
+    index_.push_back(entry);
+
+    bytesWritten_.fetch_add(static_cast<int64_t>(totalBytes), std::memory_order_relaxed);
+    chunks_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void SessionRecorder::finalize() {
+    if (ioFailed_) {
+        // Header stays unfinalized; readers fall back to walking the chunks
+        return;
+    }
+
+    const uint64_t indexOffset = writer_.offset();
+    const size_t indexBytes = index_.size() * sizeof(SessionIndexEntry);
+    const size_t totalBytes = indexBytes + sizeof(SessionIndexTrailer);
+    uint8_t* dst = writer_.reserve(totalBytes);
+    if (!dst) {
+        LOGE("Failed to write session index (%zu entries)", index_.size());
+        ioFailed_ = true;
+        return;
+    }
+
+    SessionIndexTrailer trailer;
+    trailer.entryCount = static_cast<uint32_t>(index_.size());
+    trailer.indexOffset = indexOffset;
+    if (indexBytes > 0) {
+        std::memcpy(dst, index_.data(), indexBytes);
+    }
+    std::memcpy(dst + indexBytes, &trailer, sizeof(trailer));
+    writer_.commit(totalBytes);
+    bytesWritten_.fetch_add(static_cast<int64_t>(totalBytes), std::memory_order_relaxed);
+
+    fileHeader_.flags |= kSessionFlagFinalized;
+    fileHeader_.indexOffset = indexOffset;
+    fileHeader_.dataBytes = indexOffset;
+    if (!writer_.writeAt(0, &fileHeader_, sizeof(fileHeader_))) {
+        ioFailed_ = true;
+    }
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_data.h"
+#include "frame_buffer_pool.h"
+#include "imu_data.h"
+#include "mapped_file_writer.h"
+#include "memory_budget.h"
+#include "ring_buffer.h"
+#include "session_format.h"
+
+namespace nativesensor {
+
+/// Session recorder tuning
+struct SessionRecorderConfig {
+    size_t windowBytes = 32u << 20;         // Mapping window and preallocation step
+    size_t packetPoolSlots = 16;            // Encoded packets in flight (recordPacket)
+    size_t packetBufferBytes = 2u << 20;    // Largest encoded packet accepted (4K IDR frames)
+    size_t framePoolSlots = 16;             // Raw frames in flight per stream (recordFrame)
+};
+
+/// Session recorder counters
+struct RecorderStats {
+    int64_t imuSamples = 0;         // Written to the file
+    int64_t imuDropped = 0;         // IMU queue full or I/O failed
+    int64_t frames = 0;             // Written to the file
+    int64_t framesDropped = 0;      // Stream queue/packet pool full or I/O failed
+    int64_t poolStarvations = 0;    // Frames or packets dropped because every recorder slot
+                                    // was waiting on the I/O thread (included in framesDropped)
+    int64_t bytesWritten = 0;
+    int64_t chunks = 0;
+};
+
+/// Records IMU samples and camera frames into an .nsrec session file (see session_format.h).
+/// Producers (sensor and camera threads) only enqueue: IMU samples are copied into a
+/// lock-free ring and raw frames and packets into recorder-owned pools, so capture threads
+/// never wait on storage and an I/O stall never holds a capture pool's buffers. A dedicated
+/// I/O thread drains the queues into a MappedFileWriter and writes the chunk index when the
+/// session stops.
+class SessionRecorder {
+public:
+    /// Stream ids accepted by recordFrame/recordPacket are [0, kMaxStreams)
+    static constexpr size_t kMaxStreams = 16;
+    /// ~2 s of accel + gyro at 2 kHz
+    static constexpr size_t kImuQueueCapacity = 8192;
+    /// Frames per stream the I/O thread may fall behind by before frames drop
+    static constexpr size_t kFrameQueueCapacity = 16;
+
+    SessionRecorder() = default;
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    /// Create the session file and start the I/O thread. Under a memory budget the packet
+    /// pool, then the mapping window, are halved (to a floor) until the session fits.
+    /// @return false if already recording, the session cannot fit the budget, or the file
+    ///         cannot be created
+    bool start(const std::string& path, const SessionRecorderConfig& config = {});
+
+    /// Stop accepting data, drain the queues, write the index and close the file
+    void stop();
+
+    /// Name a stream before (or while) recording; written with the stream's first frame
+    void describeStream(uint32_t streamId, const std::string& name, SessionStreamKind kind);
+
+    /// Queue IMU samples (any thread, never blocks)
+    /// @return false if not recording or some samples were dropped
+    bool recordImu(const ImuSample* samples, size_t count);
+
+    /// Copy and queue a raw pooled frame (any thread, never blocks). The caller's handle is
+    /// not retained. The stream's copy pool is allocated with its first frame (and again if a
+    /// larger frame arrives), sized down under the memory budget.
+    /// @return false if not recording or the frame was dropped
+    bool recordFrame(uint32_t streamId, const FrameBufferHandle& buffer,
+                     const FrameMetadata& metadata);
+
+    /// Copy and queue an encoded packet (any thread, never blocks)
+    /// @param flags kFrameFlag* bits
+    /// @return false if not recording or the packet was dropped
+    bool recordPacket(uint32_t streamId, const uint8_t* data, size_t size,
+                      const FrameMetadata& metadata, uint32_t flags);
+
+    [[nodiscard]]
+    bool isRecording() const noexcept { return recording_.load(std::memory_order_acquire); }
+
+    [[nodiscard]]
+    RecorderStats getStats() const noexcept;
+
+private:
+    struct RecordedFrame {
+        FrameBufferHandle buffer;
+        SessionFrameHeader header;
+    };
+
+    /// Per-stream queue. Multi-camera callbacks for one stream can run on different reader
+    /// threads, so producers serialize on a spinlock held only for the push.
+    struct alignas(kCacheLineSize) StreamQueue {
+        RingBuffer<RecordedFrame, kFrameQueueCapacity> frames;
+        FrameBufferPool framePool;          // recordFrame copies; acquired under producerLock
+        size_t refusedFrameBytes = 0;       // Frame size the budget refused (producerLock)
+        std::atomic_flag producerLock = ATOMIC_FLAG_INIT;
+        bool infoWritten = false;           // I/O thread only
+    };
+
+    struct StreamDescription {
+        std::string name;
+        SessionStreamKind kind = SessionStreamKind::RawFrames;
+    };
+
+    /// Counts a producer in for the duration of one record call, so stop() can wait it out
+    class ProducerGuard;
+
+    bool enqueueFrame(uint32_t streamId, FrameBufferHandle buffer, const FrameMetadata& metadata,
+                      uint32_t flags);
+
+    /// Take a slot of the stream's copy pool for a frame of frameBytes, allocating the pool
+    /// first if needed. Caller holds the stream's producerLock.
+    FrameBufferHandle acquireFrameSlot(uint32_t streamId, StreamQueue& stream, size_t frameBytes);
+
+    void threadLoop();
+    /// Move queued data into the file. flush writes a partial IMU chunk.
+    void drainQueues(bool flush);
+    /// Sort pending IMU samples and write those no later batch can precede, in chunks of at
+    /// most kImuChunkSamples. flush writes everything.
+    void writeImuChunks(bool flush);
+    void writeFrame(uint32_t streamId, StreamQueue& stream, const RecordedFrame& frame);
+    bool writeChunk(SessionChunkType type, uint32_t streamId, uint32_t recordCount,
+                    int64_t firstTimestampNs, int64_t lastTimestampNs,
+                    const void* head, size_t headBytes, const void* body, size_t bodyBytes);
+    void finalize();
+
+    std::atomic<bool> recording_{false};
+    std::atomic<int32_t> activeProducers_{0};
+
+    RingBuffer<ImuSample, kImuQueueCapacity> imuQueue_;
+    std::atomic_flag imuProducerLock_ = ATOMIC_FLAG_INIT;
+    std::array<StreamQueue, kMaxStreams> streams_;
+    FrameBufferPool packetPool_;
+
+    std::mutex descriptionMutex_;
+    std::array<StreamDescription, kMaxStreams> descriptions_;
+
+    // I/O thread state
+    std::thread thread_;
+    bool running_ = false;                  // Guarded by wakeMutex_
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    MappedFileWriter writer_;
+    SessionFileHeader fileHeader_;
+    std::vector<SessionIndexEntry> index_;
+    std::vector<ImuSample> imuScratch_;
+    std::vector<PackedImuSample> pendingImu_;
+    MemoryReservation stagingReservation_;  // Mapping window and the staging vectors above
+    bool ioFailed_ = false;
+
+    std::atomic<int64_t> imuSamples_{0};
+    std::atomic<int64_t> imuDropped_{0};
+    std::atomic<int64_t> frames_{0};
+    std::atomic<int64_t> framesDropped_{0};
+    std::atomic<int64_t> poolStarvations_{0};
+    size_t framePoolSlots_ = 0;             // From the config; read by producers after start()
+    std::atomic<int64_t> bytesWritten_{0};
+    std::atomic<int64_t> chunks_{0};
+};
+
+}  // namespace nativesensor
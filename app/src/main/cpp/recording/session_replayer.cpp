@@ -0,0 +1,274 @@
+#include "session_replayer.h"
+
+#include <android/log.h>
+#include <algorithm>
+#include <ctime>
+#include <limits>
+
+#include "trace.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Replay";
+
+// Samples closer together than this are delivered as one batch, like a sensor looper wakeup
+constexpr int64_t kImuBatchSpanNs = 4'000'000;
+
+// Gap inserted between the end of one pass and the start of the next when looping
+constexpr int64_t kLoopGapNs = 1'000'000;
+
+int64_t bootTimeNowNs() {
+    timespec t{};
+    clock_gettime(CLOCK_BOOTTIME, &t);
+    return static_cast<int64_t>(t.tv_sec) * 1000000000LL + t.tv_nsec;
+}
+
+bool earlierChunk(const nativesensor::SessionIndexEntry& a,
+                  const nativesensor::SessionIndexEntry& b) {
+    return a.firstTimestampNs < b.firstTimestampNs;
+}
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+SessionReplayer::~SessionReplayer() {
+    stop();
+}
+
+bool SessionReplayer::start(const std::string& path, const SessionReplayConfig& config,
+                            ImuCallback imuCallback, ImuBatchCallback imuBatchCallback,
+                            FrameDataCallback frameCallback, DispatcherThreadHooks hooks) {
+    if (isRunning()) {
+        LOGI("SessionReplayer already running");
+        return false;
+    }
+    // Join a replay that ran to completion
+    stop();
+
+    if (!reader_.open(path)) {
+        return false;
+    }
+
+    imuChunks_.clear();
+    frameChunks_.clear();
+    firstTimestampNs_ = std::numeric_limits<int64_t>::max();
+    lastTimestampNs_ = std::numeric_limits<int64_t>::min();
+    for (const SessionIndexEntry& entry : reader_.chunks()) {
+        const auto type = static_cast<SessionChunkType>(entry.type);
+        if (type == SessionChunkType::Imu) {
+            imuChunks_.push_back(entry);
+        } else if (type == SessionChunkType::Frame && entry.streamId == config.frameStreamId) {
+            frameChunks_.push_back(entry);
+        } else {
+            continue;
+        }
+        firstTimestampNs_ = std::min(firstTimestampNs_, entry.firstTimestampNs);
+        lastTimestampNs_ = std::max(lastTimestampNs_, entry.lastTimestampNs);
+    }
+    if (imuChunks_.empty() && frameChunks_.empty()) {
+        LOGE("Session %s has no IMU data or frames on stream %u", path.c_str(),
+             config.frameStreamId);
+        reader_.close();
+        return false;
+    }
+    // File order is write order; the I/O thread may commit an IMU chunk after later frames
+    std::stable_sort(imuChunks_.begin(), imuChunks_.end(), earlierChunk);
+    std::stable_sort(frameChunks_.begin(), frameChunks_.end(), earlierChunk);
+
+    config_ = config;
+    imuCallback_ = std::move(imuCallback);
+    imuBatchCallback_ = std::move(imuBatchCallback);
+    frameCallback_ = std::move(frameCallback);
+    hooks_ = std::move(hooks);
+    imuScratch_.resize(kImuBatchSize);
+
+    imuSamples_.store(0, std::memory_order_relaxed);
+    frames_.store(0, std::memory_order_relaxed);
+    loops_.store(0, std::memory_order_relaxed);
+    maxLagNs_.store(0, std::memory_order_relaxed);
+
+    running_.store(true, std::memory_order_release);
+    active_.store(true, std::memory_order_release);
+    thread_ = std::thread(&SessionReplayer::threadLoop, this);
+    LOGI("Replaying %s (%zu IMU chunks, %zu frames, speed=%.2f, loop=%d)", path.c_str(),
+         imuChunks_.size(), frameChunks_.size(), config_.speed, config_.loop);
+    return true;
+}
+
+void SessionReplayer::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_.store(false, std::memory_order_release);
+    }
+    wakeCondition_.notify_one();
+    thread_.join();
+
+    imuCallback_ = nullptr;
+    imuBatchCallback_ = nullptr;
+    frameCallback_ = nullptr;
+    hooks_ = {};
+    reader_.close();
+    LOGI("SessionReplayer stopped");
+}
+
+ReplayStats SessionReplayer::getStats() const noexcept {
+    ReplayStats stats;
+    stats.imuSamples = imuSamples_.load(std::memory_order_relaxed);
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.loops = loops_.load(std::memory_order_relaxed);
+    stats.maxLagNs = maxLagNs_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SessionReplayer::threadLoop() {
+    if (hooks_.onThreadStart) {
+        hooks_.onThreadStart();
+    }
+
+    int64_t timestampOffsetNs = config_.rebaseTimestamps ? bootTimeNowNs() - firstTimestampNs_ : 0;
+    paceStart_ = std::chrono::steady_clock::now();
+    while (replayPass(timestampOffsetNs)) {
+        loops_.fetch_add(1, std::memory_order_relaxed);
+        if (!config_.loop) {
+            break;
+        }
+        // Next pass continues the timeline instead of jumping back in time
+        const int64_t passNs = lastTimestampNs_ - firstTimestampNs_ + kLoopGapNs;
+        timestampOffsetNs += passNs;
+        if (config_.speed > 0.0) {
+            paceStart_ += std::chrono::nanoseconds(
+                static_cast<int64_t>(static_cast<double>(passNs) / config_.speed));
+        }
+    }
+
+    active_.store(false, std::memory_order_release);
+    if (hooks_.onThreadStop) {
+        hooks_.onThreadStop();
+    }
+}
+
+bool SessionReplayer::replayPass(int64_t timestampOffsetNs) {
+    size_t imuIndex = 0;
+    const PackedImuSample* samples = nullptr;
+    size_t sampleCount = 0;
+    size_t sampleIndex = 0;
+
+    size_t frameIndex = 0;
+    SessionFrameView frame;
+    bool framePending = false;
+
+    while (true) {
+        while (sampleIndex >= sampleCount && imuIndex < imuChunks_.size()) {
+            samples = reader_.imuSamples(imuChunks_[imuIndex++], sampleCount);
+            sampleIndex = 0;
+        }
+        while (!framePending && frameIndex < frameChunks_.size()) {
+            framePending = reader_.frame(frameChunks_[frameIndex++], frame);
+        }
+
+        const bool imuPending = sampleIndex < sampleCount;
+        if (!imuPending && !framePending) {
+            return true;
+        }
+
+        const int64_t frameNs = framePending ? frame.header->timestampNs
+                                             : std::numeric_limits<int64_t>::max();
+        if (imuPending && samples[sampleIndex].timestampNs <= frameNs) {
+            // Batch up consecutive samples that fall before the next frame
+            const int64_t batchStartNs = samples[sampleIndex].timestampNs;
+            size_t end = sampleIndex + 1;
+            while (end < sampleCount && end - sampleIndex < kImuBatchSize &&
+                   samples[end].timestampNs <= frameNs &&
+                   samples[end].timestampNs - batchStartNs <= kImuBatchSpanNs) {
+                ++end;
+            }
+            if (!waitUntilDue(samples[end - 1].timestampNs)) {
+                return false;
+            }
+            deliverImu(samples + sampleIndex, end - sampleIndex, timestampOffsetNs);
+            sampleIndex = end;
+        } else {
+            if (!waitUntilDue(frameNs)) {
+                return false;
+            }
+            deliverFrame(frame, timestampOffsetNs);
+            framePending = false;
+        }
+    }
+}
+
+bool SessionReplayer::waitUntilDue(int64_t recordedNs) {
+    if (config_.speed <= 0.0) {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    const auto due = paceStart_ + std::chrono::nanoseconds(static_cast<int64_t>(
+        static_cast<double>(recordedNs - firstTimestampNs_) / config_.speed));
+    {
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCondition_.wait_until(lock, due, [this] {
+            return !running_.load(std::memory_order_acquire);
+        });
+        if (!running_.load(std::memory_order_acquire)) {
+            return false;
+        }
+    }
+
+    const int64_t lagNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - due).count();
+    if (lagNs > maxLagNs_.load(std::memory_order_relaxed)) {
+        maxLagNs_.store(lagNs, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void SessionReplayer::deliverImu(const PackedImuSample* samples, size_t count,
+                                 int64_t timestampOffsetNs) {
+    NS_TRACE_SCOPE("SessionReplayer::deliverImu");
+
+    const ImuSample* newestAccel = nullptr;
+    const ImuSample* newestGyro = nullptr;
+    for (size_t i = 0; i < count; ++i) {
+        const PackedImuSample& record = samples[i];
+        ImuSample& sample = imuScratch_[i];
+        sample = ImuSample{record.x, record.y, record.z, record.timestampNs + timestampOffsetNs,
+                           static_cast<SensorType>(record.sensorType)};
+        if (sample.sensorType == SensorType::Accelerometer) {
+            newestAccel = &sample;
+        } else if (sample.sensorType == SensorType::Gyroscope) {
+            newestGyro = &sample;
+        }
+    }
+    if (newestAccel) latestAccel_.store(*newestAccel);
+    if (newestGyro) latestGyro_.store(*newestGyro);
+
+    if (imuCallback_) {
+        for (size_t i = 0; i < count; ++i) {
+            imuCallback_(imuScratch_[i]);
+        }
+    }
+    if (imuBatchCallback_) {
+        imuBatchCallback_(imuScratch_.data(), count);
+    }
+    imuSamples_.fetch_add(static_cast<int64_t>(count), std::memory_order_relaxed);
+}
+
+void SessionReplayer::deliverFrame(const SessionFrameView& frame, int64_t timestampOffsetNs) {
+    NS_TRACE_SCOPE("SessionReplayer::deliverFrame");
+
+    if (frameCallback_) {
+        // Straight from the mapping; the callback sees recorded bytes without a copy
+        frameCallback_(frame.data, static_cast<int32_t>(frame.header->dataBytes),
+                       frame.header->width, frame.header->height,
+                       frame.header->timestampNs + timestampOffsetNs);
+    }
+    frames_.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_encoder_bridge.h"
+#include "frame_dispatcher.h"
+#include "imu_manager.h"
+#include "seqlock.h"
+#include "session_reader.h"
+
+namespace nativesensor {
+
+/// Replay pacing and delivery options
+struct SessionReplayConfig {
+    double speed = 1.0;                 // Playback rate; <= 0 delivers as fast as possible
+    bool loop = false;                  // Restart at the end (timestamps keep increasing)
+    bool rebaseTimestamps = true;       // Shift timestamps so playback starts at CLOCK_BOOTTIME now
+    uint32_t frameStreamId = 0;         // Recorded stream delivered to the frame callback
+};
+
+/// Replay counters
+struct ReplayStats {
+    int64_t imuSamples = 0;
+    int64_t frames = 0;
+    int64_t loops = 0;                  // Completed passes over the session
+    int64_t maxLagNs = 0;               // Worst delivery delay behind the paced schedule
+};
+
+/// Delivers a recorded session through the same callbacks as ImuManager and
+/// CameraEncoderBridge, so downstream consumers cannot tell replay from live capture.
+/// IMU samples and frames of one stream are merged in timestamp order on a single replay
+/// thread and paced from the recorded timestamps (or delivered back to back). Frame data
+/// points straight into the mapped file, so replay cost is the consumer's alone.
+class SessionReplayer {
+public:
+    /// IMU samples per batch callback, matching the sensor queue read size
+    static constexpr size_t kImuBatchSize = ImuManager::kEventBatchSize;
+
+    SessionReplayer() = default;
+    ~SessionReplayer();
+
+    SessionReplayer(const SessionReplayer&) = delete;
+    SessionReplayer& operator=(const SessionReplayer&) = delete;
+
+    /// Open a session file and start the replay thread
+    /// @param imuCallback Per-sample delivery (may be empty)
+    /// @param imuBatchCallback Per-batch delivery (may be empty)
+    /// @param frameCallback Frames of config.frameStreamId (may be empty); data is valid until
+    ///        the callback returns
+    /// @param hooks Optional replay thread start/stop hooks (e.g. JVM attach)
+    /// @return false if already running or the file cannot be opened
+    bool start(const std::string& path, const SessionReplayConfig& config,
+               ImuCallback imuCallback, ImuBatchCallback imuBatchCallback,
+               FrameDataCallback frameCallback, DispatcherThreadHooks hooks = {});
+
+    /// Stop the replay thread and unmap the session
+    void stop();
+
+    /// Check if the replay thread is still delivering (false once a non-looping replay ends)
+    [[nodiscard]]
+    bool isRunning() const noexcept { return active_.load(std::memory_order_acquire); }
+
+    /// Latest replayed accelerometer sample (lock-free)
+    [[nodiscard]]
+    ImuSample getLatestAccel() const noexcept { return latestAccel_.load(); }
+
+    /// Latest replayed gyroscope sample (lock-free)
+    [[nodiscard]]
+    ImuSample getLatestGyro() const noexcept { return latestGyro_.load(); }
+
+    [[nodiscard]]
+    ReplayStats getStats() const noexcept;
+
+private:
+    void threadLoop();
+    /// One pass over the session. Returns false if stopped.
+    bool replayPass(int64_t timestampOffsetNs);
+    void deliverImu(const PackedImuSample* samples, size_t count, int64_t timestampOffsetNs);
+    void deliverFrame(const SessionFrameView& frame, int64_t timestampOffsetNs);
+    /// Sleep until the recorded timestamp is due. Returns false if stopped while waiting.
+    bool waitUntilDue(int64_t recordedNs);
+
+    SessionReader reader_;
+    SessionReplayConfig config_;
+    ImuCallback imuCallback_;
+    ImuBatchCallback imuBatchCallback_;
+    FrameDataCallback frameCallback_;
+    DispatcherThreadHooks hooks_;
+
+    // Session timeline, built once at start
+    std::vector<SessionIndexEntry> imuChunks_;
+    std::vector<SessionIndexEntry> frameChunks_;
+    int64_t firstTimestampNs_ = 0;
+    int64_t lastTimestampNs_ = 0;
+
+    // Pacing: recorded firstTimestampNs_ plays at paceStart_ (advanced per loop)
+    std::chrono::steady_clock::time_point paceStart_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};  // Cleared by stop() under wakeMutex_
+    std::atomic<bool> active_{false};
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    std::vector<ImuSample> imuScratch_;
+    SeqLock<ImuSample> latestAccel_;
+    SeqLock<ImuSample> latestGyro_;
+
+    std::atomic<int64_t> imuSamples_{0};
+    std::atomic<int64_t> frames_{0};
+    std::atomic<int64_t> loops_{0};
+    std::atomic<int64_t> maxLagNs_{0};
+};
+
+}  // namespace nativesensor
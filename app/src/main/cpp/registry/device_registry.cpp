@@ -0,0 +1,175 @@
+#include "device_registry.h"
+
+#include <android/log.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+#include "trace.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.Registry";
+
+// Longest string the uint16 length prefix can describe
+constexpr size_t kMaxStringBytes = std::numeric_limits<uint16_t>::max();
+
+size_t alignUp4(size_t value) {
+    return (value + 3) & ~static_cast<size_t>(3);
+}
+
+/// Length-prefixed string table of the snapshot
+class StringTable {
+public:
+    /// @return Offset of the string within the table
+    uint32_t add(std::string_view text) {
+        const auto offset = static_cast<uint32_t>(bytes_.size());
+        const auto length = static_cast<uint16_t>(std::min(text.size(), kMaxStringBytes));
+        bytes_.push_back(static_cast<uint8_t>(length & 0xff));
+        bytes_.push_back(static_cast<uint8_t>(length >> 8));
+        bytes_.insert(bytes_.end(), text.begin(), text.begin() + length);
+        return offset;
+    }
+
+    [[nodiscard]] const std::vector<uint8_t>& bytes() const noexcept { return bytes_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+};
+
+template <typename T>
+void writeRecords(std::vector<uint8_t>& out, uint32_t offset, const std::vector<T>& records) {
+    if (!records.empty()) {
+        std::memcpy(out.data() + offset, records.data(), records.size() * sizeof(T));
+    }
+}
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+DeviceRegistry::DeviceRegistry(ImuManager& imu, CameraManager& cameras)
+    : imu_(imu), cameras_(cameras) {}
+
+DeviceRegistry::~DeviceRegistry() {
+    cameras_.setChangeListener(nullptr);
+}
+
+DeviceRegistry::Snapshot DeviceRegistry::snapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Read before enumerating: a change that races the build leaves the snapshot tagged
+    // with the older generation, so the next call rebuilds it
+    const uint64_t generation = cameras_.getGeneration();
+    if (cached_) {
+        DeviceRegistryHeader header;
+        std::memcpy(&header, cached_->data(), sizeof(header));
+        if (header.generation == generation) {
+            return cached_;
+        }
+    }
+
+    cached_ = build(generation);
+    return cached_;
+}
+
+size_t DeviceRegistry::exportTo(void* dst, size_t capacity) {
+    const Snapshot current = snapshot();
+    if (dst && current->size() <= capacity) {
+        std::memcpy(dst, current->data(), current->size());
+    }
+    return current->size();
+}
+
+void DeviceRegistry::setChangeListener(CameraChangeListener listener) {
+    cameras_.setChangeListener(std::move(listener));
+}
+
+DeviceRegistry::Snapshot DeviceRegistry::build(uint64_t generation) {
+    NS_TRACE_SCOPE("DeviceRegistry::build");
+
+    const std::vector<SensorInfo> sensorInfos = imu_.enumerateSensors();
+    const std::vector<CameraInfo> cameraInfos = cameras_.enumerateCameras();
+
+    StringTable strings;
+    std::vector<DeviceSensorRecord> sensors;
+    sensors.reserve(sensorInfos.size());
+    for (const SensorInfo& info : sensorInfos) {
+        DeviceSensorRecord record;
+        record.handle = info.handle;
+        record.type = static_cast<int32_t>(info.type);
+        // Copied out of the NDK sensor list so the snapshot owns every byte it exports
+        record.nameString = strings.add(info.name ? info.name : "Unknown");
+        record.vendorString = strings.add(info.vendor ? info.vendor : "Unknown");
+        record.minDelayUs = info.minDelayUs;
+        record.maxFrequencyHz = info.maxFrequencyHz;
+        record.fifoReserved = info.fifoReserved;
+        record.directReportRateLevel = info.directReportRateLevel;
+        sensors.push_back(record);
+    }
+
+    std::vector<DeviceCameraRecord> cameras;
+    std::vector<DeviceStreamConfigRecord> streamConfigs;
+    std::vector<DeviceFpsRangeRecord> fpsRanges;
+    cameras.reserve(cameraInfos.size());
+    for (const CameraInfo& info : cameraInfos) {
+        DeviceCameraRecord record;
+        record.idString = strings.add(info.id);
+        record.facing = static_cast<int32_t>(info.facing);
+        record.clusterType = static_cast<int32_t>(info.clusterType);
+        record.width = info.width;
+        record.height = info.height;
+        record.maxFps = info.maxFps;
+        record.flags = info.isPhysicalCamera ? kDeviceCameraFlagPhysical : 0;
+        record.physicalIdsString = strings.add(info.physicalCameraIds);
+
+        record.firstStreamConfig = static_cast<uint32_t>(streamConfigs.size());
+        record.streamConfigCount = static_cast<uint32_t>(info.streamConfigurations.size());
+        for (const StreamConfiguration& config : info.streamConfigurations) {
+            streamConfigs.push_back({config.format, config.width, config.height});
+        }
+        record.firstFpsRange = static_cast<uint32_t>(fpsRanges.size());
+        record.fpsRangeCount = static_cast<uint32_t>(info.fpsRanges.size());
+        for (const FpsRange& range : info.fpsRanges) {
+            fpsRanges.push_back({range.min, range.max});
+        }
+        cameras.push_back(record);
+    }
+
+    DeviceRegistryHeader header;
+    header.generation = generation;
+    header.sensorCount = static_cast<uint32_t>(sensors.size());
+    header.cameraCount = static_cast<uint32_t>(cameras.size());
+    header.streamConfigCount = static_cast<uint32_t>(streamConfigs.size());
+    header.fpsRangeCount = static_cast<uint32_t>(fpsRanges.size());
+    header.stringBytes = static_cast<uint32_t>(strings.bytes().size());
+
+    size_t offset = sizeof(DeviceRegistryHeader);
+    header.sensorsOffset = static_cast<uint32_t>(offset);
+    offset += sensors.size() * sizeof(DeviceSensorRecord);
+    header.camerasOffset = static_cast<uint32_t>(offset);
+    offset += cameras.size() * sizeof(DeviceCameraRecord);
+    header.streamConfigsOffset = static_cast<uint32_t>(offset);
+    offset += streamConfigs.size() * sizeof(DeviceStreamConfigRecord);
+    header.fpsRangesOffset = static_cast<uint32_t>(offset);
+    offset += fpsRanges.size() * sizeof(DeviceFpsRangeRecord);
+    header.stringsOffset = static_cast<uint32_t>(offset);
+    offset = alignUp4(offset + strings.bytes().size());
+    header.totalBytes = static_cast<uint32_t>(offset);
+
+    auto blob = std::make_shared<std::vector<uint8_t>>(offset, 0);
+    std::memcpy(blob->data(), &header, sizeof(header));
+    writeRecords(*blob, header.sensorsOffset, sensors);
+    writeRecords(*blob, header.camerasOffset, cameras);
+    writeRecords(*blob, header.streamConfigsOffset, streamConfigs);
+    writeRecords(*blob, header.fpsRangesOffset, fpsRanges);
+    writeRecords(*blob, header.stringsOffset, strings.bytes());
+
+    LOGI("Device registry generation %llu: %zu sensors, %zu cameras, %zu stream configs, "
+         "%zu bytes", static_cast<unsigned long long>(generation), sensors.size(),
+         cameras.size(), streamConfigs.size(), blob->size());
+    return blob;
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "camera_manager.h"
+#include "device_registry_format.h"
+#include "imu_manager.h"
+
+namespace nativesensor {
+
+/// Sensors and cameras of the device as one versioned binary snapshot (see
+/// device_registry_format.h). The snapshot is built on first use and reused until the
+/// CameraManager generation moves, so repeated queries are a copy into the caller's buffer
+/// instead of re-walking the sensor list and camera characteristics.
+class DeviceRegistry {
+public:
+    /// Immutable serialized snapshot
+    using Snapshot = std::shared_ptr<const std::vector<uint8_t>>;
+
+    DeviceRegistry(ImuManager& imu, CameraManager& cameras);
+    ~DeviceRegistry();
+
+    DeviceRegistry(const DeviceRegistry&) = delete;
+    DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+    /// Current snapshot, rebuilt only if the device set changed since the last call
+    Snapshot snapshot();
+
+    /// Copy the current snapshot into dst
+    /// @return Snapshot size in bytes; nothing is copied if it exceeds capacity
+    size_t exportTo(void* dst, size_t capacity);
+
+    /// Generation the next snapshot will carry; unchanged means a held snapshot is current
+    [[nodiscard]]
+    uint64_t getGeneration() const noexcept { return cameras_.getGeneration(); }
+
+    /// Register (or clear, with nullptr) the listener called when the device set changes.
+    /// Runs on the camera service thread; call snapshot() from there or later to refresh.
+    void setChangeListener(CameraChangeListener listener);
+
+private:
+    Snapshot build(uint64_t generation);
+
+    ImuManager& imu_;
+    CameraManager& cameras_;
+
+    std::mutex mutex_;
+    Snapshot cached_;                   // Guarded by mutex_; null until first use
+};
+
+}  // namespace nativesensor
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nativesensor {
+
+// Device registry snapshot exported to Kotlin, native byte order (little-endian on every
+// Android ABI). Mirrored by DeviceRegistry.kt; bump kDeviceRegistryVersion on any change.
+//
+//   DeviceRegistryHeader                       offset 0
+//   DeviceSensorRecord[sensorCount]            sensorsOffset
+//   DeviceCameraRecord[cameraCount]            camerasOffset
+//   DeviceStreamConfigRecord[streamConfigCount] streamConfigsOffset, grouped by camera
+//   DeviceFpsRangeRecord[fpsRangeCount]        fpsRangesOffset, grouped by camera
+//   string table (stringBytes)                 stringsOffset
+//
+// Strings are referenced by offset into the string table and stored as a uint16 byte length
+// followed by that many bytes of UTF-8, without a terminator. Every section starts
+// 4-byte aligned.
+
+constexpr uint32_t kDeviceRegistryMagic = 0x5244534e;   // "NSDR"
+constexpr uint32_t kDeviceRegistryVersion = 1;
+
+/// DeviceCameraRecord::flags
+constexpr uint32_t kDeviceCameraFlagPhysical = 1u << 0;   // Not a logical multi-camera
+
+struct DeviceRegistryHeader {
+    uint32_t magic = kDeviceRegistryMagic;
+    uint32_t version = kDeviceRegistryVersion;
+    uint64_t generation = 0;            // CameraManager generation the snapshot was built from
+    uint32_t totalBytes = 0;
+    uint32_t sensorCount = 0;
+    uint32_t sensorsOffset = 0;
+    uint32_t cameraCount = 0;
+    uint32_t camerasOffset = 0;
+    uint32_t streamConfigCount = 0;
+    uint32_t streamConfigsOffset = 0;
+    uint32_t fpsRangeCount = 0;
+    uint32_t fpsRangesOffset = 0;
+    uint32_t stringBytes = 0;
+    uint32_t stringsOffset = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(DeviceRegistryHeader) == 64, "Update DeviceRegistry.kt header offsets");
+
+struct DeviceSensorRecord {
+    int32_t handle = 0;                 // Index passed to switchSensors
+    int32_t type = 0;                   // ASENSOR_TYPE_*
+    uint32_t nameString = 0;
+    uint32_t vendorString = 0;
+    int32_t minDelayUs = 0;
+    float maxFrequencyHz = 0.0f;
+    int32_t fifoReserved = 0;
+    int32_t directReportRateLevel = 0;
+};
+static_assert(sizeof(DeviceSensorRecord) == 32, "Update DeviceRegistry.kt sensor offsets");
+
+struct DeviceCameraRecord {
+    uint32_t idString = 0;
+    int32_t facing = 0;                 // CameraFacing
+    int32_t clusterType = 0;            // CameraClusterType
+    int32_t width = 0;                  // Largest YUV/private output
+    int32_t height = 0;
+    int32_t maxFps = 0;
+    uint32_t flags = 0;                 // kDeviceCameraFlag*
+    uint32_t physicalIdsString = 0;     // Comma-separated, empty for physical cameras
+    uint32_t firstStreamConfig = 0;     // Index into the stream configuration section
+    uint32_t streamConfigCount = 0;
+    uint32_t firstFpsRange = 0;         // Index into the FPS range section
+    uint32_t fpsRangeCount = 0;
+};
+static_assert(sizeof(DeviceCameraRecord) == 48, "Update DeviceRegistry.kt camera offsets");
+
+struct DeviceStreamConfigRecord {
+    int32_t format = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+static_assert(sizeof(DeviceStreamConfigRecord) == 12, "Update DeviceRegistry.kt stream offsets");
+
+struct DeviceFpsRangeRecord {
+    int32_t min = 0;
+    int32_t max = 0;
+};
+static_assert(sizeof(DeviceFpsRangeRecord) == 8, "Update DeviceRegistry.kt FPS range offsets");
+
+}  // namespace nativesensor
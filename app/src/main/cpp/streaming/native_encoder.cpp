@@ -0,0 +1,342 @@
+#include "native_encoder.h"
+
+#include <android/log.h>
+#include <media/NdkMediaFormat.h>
+#include <chrono>
+#include <ctime>
+
+#include "camera_session.h"
+#include "camera_session_registry.h"
+#include "trace.h"
+
+namespace {
+constexpr const char* kLogTag = "NativeSensor.NativeEncoder";
+
+// MediaCodecInfo.CodecCapabilities.COLOR_FormatSurface
+constexpr int32_t kColorFormatSurface = 0x7F000789;
+
+// Output thread wakes at least this often to notice stop requests
+constexpr int64_t kDequeueTimeoutUs = 10'000;
+
+// Bound on draining in-flight frames after end of stream is signalled
+constexpr auto kDrainTimeout = std::chrono::milliseconds(500);
+
+// A codec in the error state fails every dequeue at once; back off, then give up
+constexpr int kMaxConsecutiveOutputErrors = 5;
+constexpr auto kOutputErrorBackoff = std::chrono::milliseconds(20);
+
+const char* mimeType(nativesensor::VideoCodec codec) {
+    return codec == nativesensor::VideoCodec::Hevc ? "video/hevc" : "video/avc";
+}
+
+int64_t getBootTimeNs() {
+    timespec t{};
+    clock_gettime(CLOCK_BOOTTIME, &t);
+    return static_cast<int64_t>(t.tv_sec) * 1000000000LL + t.tv_nsec;
+}
+}
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, kLogTag, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, kLogTag, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, kLogTag, __VA_ARGS__)
+
+namespace nativesensor {
+
+NativeEncoder::NativeEncoder(CameraSessionRegistry& sessions)
+    : sessions_(sessions) {
+}
+
+NativeEncoder::~NativeEncoder() {
+    stop();
+}
+
+bool NativeEncoder::start(const std::string& cameraId, const NativeEncoderConfig& config,
+                          EncodedPacketCallback callback, DispatcherThreadHooks hooks) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (codec_) {
+        LOGI("Restarting native encoder (camera %s -> %s)", cameraId_.c_str(), cameraId.c_str());
+        cleanup();
+    }
+
+    cameraId_ = cameraId;
+    config_ = config;
+    callback_ = std::move(callback);
+    hooks_ = std::move(hooks);
+
+    codec_ = AMediaCodec_createEncoderByType(mimeType(config.codec));
+    if (!codec_) {
+        LOGE("No hardware encoder for %s", mimeType(config.codec));
+        cleanup();
+        return false;
+    }
+
+    AMediaFormat* format = AMediaFormat_new();
+    AMediaFormat_setString(format, AMEDIAFORMAT_KEY_MIME, mimeType(config.codec));
+    AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_WIDTH, config.width);
+    AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_HEIGHT, config.height);
+    AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_COLOR_FORMAT, kColorFormatSurface);
+    AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_BIT_RATE, config.bitrateBps);
+    AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_BITRATE_MODE,
+                          static_cast<int32_t>(config.bitrateMode));
+    AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_FRAME_RATE, config.frameRate);
+    AMediaFormat_setFloat(format, AMEDIAFORMAT_KEY_I_FRAME_INTERVAL, config.keyFrameIntervalSec);
+    // Every IDR is decodable on its own, so late joiners never wait for the first config packet
+    AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_PREPEND_HEADER_TO_SYNC_FRAMES, 1);
+    if (config.lowLatency) {
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_LOW_LATENCY, 1);
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_PRIORITY, 0);     // Realtime
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_OPERATING_RATE, config.frameRate);
+        // B-frames reorder output and add a frame of delay per reference
+        AMediaFormat_setInt32(format, "max-bframes", 0);
+    }
+
+    media_status_t status = AMediaCodec_configure(codec_, format, nullptr, nullptr,
+                                                  AMEDIACODEC_CONFIGURE_FLAG_ENCODE);
+    AMediaFormat_delete(format);
+    if (status != AMEDIA_OK) {
+        LOGE("Failed to configure %s encoder (%dx%d @ %d bps): %d", mimeType(config.codec),
+             config.width, config.height, config.bitrateBps, status);
+        cleanup();
+        return false;
+    }
+
+    status = AMediaCodec_createInputSurface(codec_, &inputSurface_);
+    if (status != AMEDIA_OK || !inputSurface_) {
+        LOGE("Failed to create encoder input surface: %d", status);
+        cleanup();
+        return false;
+    }
+
+    status = AMediaCodec_start(codec_);
+    if (status != AMEDIA_OK) {
+        LOGE("Failed to start encoder: %d", status);
+        cleanup();
+        return false;
+    }
+
+    packets_.store(0, std::memory_order_relaxed);
+    keyFrames_.store(0, std::memory_order_relaxed);
+    bytes_.store(0, std::memory_order_relaxed);
+    captureToPacket_.reset();
+    {
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
+        statsWindowStartNs_ = getBootTimeNs();
+        statsWindowPackets_ = 0;
+        statsWindowBytes_ = 0;
+    }
+
+    // Drain output from the first frame on
+    stopRequested_.store(false, std::memory_order_release);
+    failed_.store(false, std::memory_order_release);
+    outputThread_ = std::thread(&NativeEncoder::outputLoop, this);
+
+    session_ = sessions_.acquireSession(cameraId);
+    SessionOutputCallbacks callbacks;
+    callbacks.onDeviceLost = [this] {
+        LOGI("Native encoder camera device lost");
+        running_.store(false, std::memory_order_release);
+    };
+    if (!session_->attachOutput(SessionOutputRole::VideoEncoder, inputSurface_,
+                                std::move(callbacks))) {
+        LOGE("Failed to attach encoder surface to camera %s", cameraId.c_str());
+        cleanup();
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    LOGI("Native encoder started: camera %s, %s %dx%d @ %d fps, %d kbps, GOP %.1f s%s",
+         cameraId.c_str(), mimeType(config.codec), config.width, config.height,
+         config.frameRate, config.bitrateBps / 1000, config.keyFrameIntervalSec,
+         config.lowLatency ? ", low latency" : "");
+    return true;
+}
+
+void NativeEncoder::stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!codec_) {
+        return;
+    }
+    LOGI("Stopping native encoder");
+    cleanup();
+}
+
+void NativeEncoder::cleanup() {
+    running_.store(false, std::memory_order_release);
+
+    // Stop the camera producing into the surface first; other outputs keep streaming
+    if (session_) {
+        session_->detachOutput(SessionOutputRole::VideoEncoder);
+        session_.reset();
+    }
+
+    if (outputThread_.joinable()) {
+        // Let the output thread drain frames already queued in the codec
+        AMediaCodec_signalEndOfInputStream(codec_);
+        stopRequested_.store(true, std::memory_order_release);
+        outputThread_.join();
+    }
+
+    if (codec_) {
+        AMediaCodec_stop(codec_);
+        AMediaCodec_delete(codec_);
+        codec_ = nullptr;
+    }
+
+    if (inputSurface_) {
+        ANativeWindow_release(inputSurface_);
+        inputSurface_ = nullptr;
+    }
+
+    callback_ = nullptr;
+    hooks_ = {};
+}
+
+bool NativeEncoder::requestKeyFrame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!codec_) {
+        return false;
+    }
+    AMediaFormat* params = AMediaFormat_new();
+    AMediaFormat_setInt32(params, AMEDIAFORMAT_KEY_REQUEST_SYNC_FRAME, 0);
+    const media_status_t status = AMediaCodec_setParameters(codec_, params);
+    AMediaFormat_delete(params);
+    if (status != AMEDIA_OK) {
+        LOGW("Key frame request failed: %d", status);
+        return false;
+    }
+    return true;
+}
+
+bool NativeEncoder::setBitrate(int32_t bitrateBps) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!codec_ || bitrateBps <= 0) {
+        return false;
+    }
+    AMediaFormat* params = AMediaFormat_new();
+    AMediaFormat_setInt32(params, AMEDIAFORMAT_KEY_VIDEO_BITRATE, bitrateBps);
+    const media_status_t status = AMediaCodec_setParameters(codec_, params);
+    AMediaFormat_delete(params);
+    if (status != AMEDIA_OK) {
+        LOGW("Bitrate change to %d bps failed: %d", bitrateBps, status);
+        return false;
+    }
+    config_.bitrateBps = bitrateBps;
+    LOGI("Encoder bitrate set to %d kbps", bitrateBps / 1000);
+    return true;
+}
+
+NativeEncoderStats NativeEncoder::getStats() {
+    NativeEncoderStats stats;
+    stats.packets = packets_.load(std::memory_order_relaxed);
+    stats.keyFrames = keyFrames_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.captureToPacket = captureToPacket_.summarize();
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    const int64_t nowNs = getBootTimeNs();
+    const double seconds = static_cast<double>(nowNs - statsWindowStartNs_) / 1e9;
+    if (seconds > 0.0) {
+        stats.frameRateHz = static_cast<float>(
+            static_cast<double>(stats.packets - statsWindowPackets_) / seconds);
+        stats.bitrateKbps = static_cast<float>(
+            static_cast<double>(stats.bytes - statsWindowBytes_) * 8.0 / 1000.0 / seconds);
+    }
+    statsWindowStartNs_ = nowNs;
+    statsWindowPackets_ = stats.packets;
+    statsWindowBytes_ = stats.bytes;
+    return stats;
+}
+
+void NativeEncoder::outputLoop() {
+    if (hooks_.onThreadStart) {
+        hooks_.onThreadStart();
+    }
+
+    std::chrono::steady_clock::time_point drainDeadline{};
+    int consecutiveErrors = 0;
+    while (true) {
+        if (stopRequested_.load(std::memory_order_acquire)) {
+            const auto now = std::chrono::steady_clock::now();
+            if (drainDeadline == std::chrono::steady_clock::time_point{}) {
+                drainDeadline = now + kDrainTimeout;
+            } else if (now >= drainDeadline) {
+                LOGW("Encoder did not reach end of stream in time");
+                break;
+            }
+        }
+
+        AMediaCodecBufferInfo info{};
+        const ssize_t index = AMediaCodec_dequeueOutputBuffer(codec_, &info, kDequeueTimeoutUs);
+        if (index == AMEDIACODEC_INFO_TRY_AGAIN_LATER ||
+            index == AMEDIACODEC_INFO_OUTPUT_BUFFERS_CHANGED) {
+            continue;
+        }
+        if (index == AMEDIACODEC_INFO_OUTPUT_FORMAT_CHANGED) {
+            AMediaFormat* format = AMediaCodec_getOutputFormat(codec_);
+            if (format) {
+                LOGI("Encoder output format: %s", AMediaFormat_toString(format));
+                AMediaFormat_delete(format);
+            }
+            continue;
+        }
+        if (index < 0) {
+            if (++consecutiveErrors >= kMaxConsecutiveOutputErrors) {
+                LOGE("dequeueOutputBuffer failed %d times in a row (%zd), stopping output",
+                     consecutiveErrors, index);
+                failed_.store(true, std::memory_order_release);
+                running_.store(false, std::memory_order_release);
+                break;
+            }
+            LOGW("dequeueOutputBuffer failed: %zd", index);
+            std::this_thread::sleep_for(kOutputErrorBackoff);
+            continue;
+        }
+        consecutiveErrors = 0;
+
+        size_t capacity = 0;
+        uint8_t* buffer = AMediaCodec_getOutputBuffer(codec_, static_cast<size_t>(index),
+                                                      &capacity);
+        if (buffer && info.size > 0 &&
+            static_cast<size_t>(info.offset) + static_cast<size_t>(info.size) <= capacity) {
+            NS_TRACE_SCOPE("NativeEncoder::deliverPacket");
+
+            EncodedPacket packet;
+            packet.data = buffer + info.offset;
+            packet.size = static_cast<size_t>(info.size);
+            packet.timestampNs = info.presentationTimeUs * 1000;
+            const bool codecConfig = (info.flags & AMEDIACODEC_BUFFER_FLAG_CODEC_CONFIG) != 0;
+            if (codecConfig) {
+                packet.flags |= kEncodedPacketCodecConfig;
+            }
+            if ((info.flags & AMEDIACODEC_BUFFER_FLAG_KEY_FRAME) != 0) {
+                packet.flags |= kEncodedPacketKeyFrame;
+            }
+
+            if (callback_) {
+                callback_(packet);
+            }
+
+            bytes_.fetch_add(static_cast<int64_t>(packet.size), std::memory_order_relaxed);
+            if (!codecConfig) {
+                packets_.fetch_add(1, std::memory_order_relaxed);
+                if ((packet.flags & kEncodedPacketKeyFrame) != 0) {
+                    keyFrames_.fetch_add(1, std::memory_order_relaxed);
+                }
+                // Surface input carries the camera's sensor timestamp (CLOCK_BOOTTIME)
+                captureToPacket_.record((getBootTimeNs() - packet.timestampNs) / 1000);
+            }
+        }
+
+        AMediaCodec_releaseOutputBuffer(codec_, static_cast<size_t>(index), false);
+        if ((info.flags & AMEDIACODEC_BUFFER_FLAG_END_OF_STREAM) != 0) {
+            break;
+        }
+    }
+
+    if (hooks_.onThreadStop) {
+        hooks_.onThreadStop();
+    }
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <media/NdkMediaCodec.h>
+#include <android/native_window.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "frame_dispatcher.h"
+#include "latency_histogram.h"
+
+namespace nativesensor {
+
+class CameraSession;
+class CameraSessionRegistry;
+
+/// Hardware video codecs, matching Kotlin VideoCodec
+enum class VideoCodec : int32_t {
+    H264 = 0,
+    Hevc = 1
+};
+
+/// Rate control, matching MediaCodecInfo.EncoderCapabilities.BITRATE_MODE_*
+enum class EncoderBitrateMode : int32_t {
+    ConstantQuality = 0,
+    Variable = 1,
+    Constant = 2
+};
+
+/// EncodedPacket::flags
+constexpr uint32_t kEncodedPacketKeyFrame = 1u << 0;       // IDR / sync frame
+constexpr uint32_t kEncodedPacketCodecConfig = 1u << 1;    // SPS/PPS (VPS) only, no picture data
+
+/// Encoder configuration
+struct NativeEncoderConfig {
+    VideoCodec codec = VideoCodec::H264;
+    int32_t width = 1920;
+    int32_t height = 1080;
+    int32_t bitrateBps = 8'000'000;
+    EncoderBitrateMode bitrateMode = EncoderBitrateMode::Variable;
+    int32_t frameRate = 30;
+    float keyFrameIntervalSec = 1.0f;       // GOP length; 0 = every frame is a key frame
+    bool lowLatency = true;                 // Codec low-latency mode, realtime priority, no B-frames
+};
+
+/// One encoded access unit in Annex-B format; data is valid until the callback returns
+struct EncodedPacket {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    int64_t timestampNs = 0;                // Sensor timestamp of the source frame
+    uint32_t flags = 0;                     // kEncodedPacket*
+};
+
+/// Callback invoked on the encoder's output thread for every encoded packet
+using EncodedPacketCallback = std::function<void(const EncodedPacket& packet)>;
+
+/// Encoder statistics
+struct NativeEncoderStats {
+    int64_t packets = 0;
+    int64_t keyFrames = 0;
+    int64_t bytes = 0;
+    float bitrateKbps = 0.0f;               // Output rate since the previous call
+    float frameRateHz = 0.0f;               // Encoded pictures since the previous call
+    LatencySummary captureToPacket{};       // Start of exposure to encoded output
+};
+
+/// Hardware H.264/HEVC encoder fed directly by the camera.
+/// The codec's input surface is attached to the camera's shared session as the
+/// VideoEncoder output, so pixels travel camera -> codec through gralloc buffers and are
+/// never touched by the CPU. A dedicated output thread drains the codec and hands encoded
+/// packets to the callback.
+class NativeEncoder {
+public:
+    explicit NativeEncoder(CameraSessionRegistry& sessions);
+    ~NativeEncoder();
+
+    NativeEncoder(const NativeEncoder&) = delete;
+    NativeEncoder& operator=(const NativeEncoder&) = delete;
+
+    /// Configure the codec and start encoding a camera
+    /// @param callback Packet consumer, invoked on the output thread
+    /// @param hooks Optional output thread start/stop hooks (e.g. JVM attach)
+    /// @return false if the codec cannot be configured or attached to the camera
+    bool start(const std::string& cameraId, const NativeEncoderConfig& config,
+               EncodedPacketCallback callback, DispatcherThreadHooks hooks = {});
+
+    /// Detach from the camera, drain the codec and release it
+    void stop();
+
+    /// Ask for an IDR frame as soon as possible (e.g. a new viewer joined)
+    bool requestKeyFrame();
+
+    /// Change the target bitrate without restarting the codec
+    bool setBitrate(int32_t bitrateBps);
+
+    [[nodiscard]]
+    bool isRunning() const noexcept { return running_.load(std::memory_order_acquire); }
+
+    /// True once the codec stopped producing output after repeated errors. isRunning() is
+    /// false from then on; stop() still releases the codec.
+    [[nodiscard]]
+    bool hasFailed() const noexcept { return failed_.load(std::memory_order_acquire); }
+
+    [[nodiscard]]
+    const std::string& getCameraId() const noexcept { return cameraId_; }
+
+    /// Get statistics (rates cover the window since the previous call)
+    NativeEncoderStats getStats();
+
+private:
+    void outputLoop();
+    void cleanup();
+
+    CameraSessionRegistry& sessions_;
+    std::mutex mutex_;                      // Serializes control calls
+    std::shared_ptr<CameraSession> session_;
+    std::string cameraId_;
+    NativeEncoderConfig config_;
+
+    AMediaCodec* codec_ = nullptr;
+    ANativeWindow* inputSurface_ = nullptr;
+
+    std::thread outputThread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopRequested_{false};    // Output thread drains to end of stream
+    std::atomic<bool> failed_{false};           // Output thread gave up on codec errors
+    EncodedPacketCallback callback_;
+    DispatcherThreadHooks hooks_;
+
+    std::atomic<int64_t> packets_{0};
+    std::atomic<int64_t> keyFrames_{0};
+    std::atomic<int64_t> bytes_{0};
+    LatencyHistogram captureToPacket_;
+
+    // Reader-side rate window
+    std::mutex statsMutex_;
+    int64_t statsWindowStartNs_ = 0;
+    int64_t statsWindowPackets_ = 0;
+    int64_t statsWindowBytes_ = 0;
+};
+
+}  // namespace nativesensor
@@ -0,0 +1,261 @@
+#include "imu_frame_sync.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace nativesensor {
+
+namespace {
+
+constexpr double kNsToSeconds = 1e-9;
+
+// Below this rotation angle (rad) the quaternion exponential uses its first-order form
+constexpr double kSmallAngleRad = 1e-9;
+
+void setIdentity(float q[4]) noexcept {
+    q[0] = 1.0f;
+    q[1] = 0.0f;
+    q[2] = 0.0f;
+    q[3] = 0.0f;
+}
+
+/// q = q * exp(0.5 * omega * dt), body-frame angular velocity
+void applyAngularVelocity(double q[4], const double omega[3], double dtSeconds) noexcept {
+    const double wx = omega[0] * dtSeconds;
+    const double wy = omega[1] * dtSeconds;
+    const double wz = omega[2] * dtSeconds;
+    const double angle = std::sqrt(wx * wx + wy * wy + wz * wz);
+
+    double dw;
+    double dx;
+    double dy;
+    double dz;
+    if (angle < kSmallAngleRad) {
+        dw = 1.0;
+        dx = 0.5 * wx;
+        dy = 0.5 * wy;
+        dz = 0.5 * wz;
+    } else {
+        const double s = std::sin(0.5 * angle) / angle;
+        dw = std::cos(0.5 * angle);
+        dx = wx * s;
+        dy = wy * s;
+        dz = wz * s;
+    }
+
+    const double w = q[0] * dw - q[1] * dx - q[2] * dy - q[3] * dz;
+    const double x = q[0] * dx + q[1] * dw + q[2] * dz - q[3] * dy;
+    const double y = q[0] * dy - q[1] * dz + q[2] * dw + q[3] * dx;
+    const double z = q[0] * dz + q[1] * dy - q[2] * dx + q[3] * dw;
+    q[0] = w;
+    q[1] = x;
+    q[2] = y;
+    q[3] = z;
+}
+
+}  // namespace
+
+uint64_t ImuFrameSync::Window::lowerBound(int64_t timestampNs) const noexcept {
+    uint64_t lo = begin();
+    uint64_t hi = total;
+    while (lo < hi) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        if (at(mid).timestampNs < timestampNs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void ImuFrameSync::addSamples(const ImuSample* samples, size_t count) {
+    if (!samples || count == 0) {
+        return;
+    }
+
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            const ImuSample& sample = samples[i];
+            if (sample.sensorType == SensorType::Accelerometer) {
+                accel_.push(sample);
+            } else if (sample.sensorType == SensorType::Gyroscope) {
+                gyro_.push(sample);
+            }
+        }
+        notify = waiters_ > 0;
+    }
+
+    // Only pay for the wakeup when a frame is actually waiting on this batch
+    if (notify) {
+        samplesArrived_.notify_all();
+    }
+}
+
+void ImuFrameSync::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    accel_.total = 0;
+    gyro_.total = 0;
+}
+
+bool ImuFrameSync::caughtUp(int64_t timestampNs) const noexcept {
+    if (accel_.empty() && gyro_.empty()) {
+        return false;
+    }
+    return (accel_.empty() || accel_.newest().timestampNs >= timestampNs) &&
+           (gyro_.empty() || gyro_.newest().timestampNs >= timestampNs);
+}
+
+void ImuFrameSync::interpolateAt(const Window& window, int64_t timestampNs, float out[3]) noexcept {
+    const uint64_t index = window.lowerBound(timestampNs);
+    if (index == window.total) {
+        const ImuSample& last = window.newest();
+        out[0] = last.x;
+        out[1] = last.y;
+        out[2] = last.z;
+        return;
+    }
+
+    const ImuSample& after = window.at(index);
+    if (index == window.begin() || after.timestampNs == timestampNs) {
+        out[0] = after.x;
+        out[1] = after.y;
+        out[2] = after.z;
+        return;
+    }
+
+    const ImuSample& before = window.at(index - 1);
+    const auto alpha = static_cast<float>(
+        static_cast<double>(timestampNs - before.timestampNs) /
+        static_cast<double>(after.timestampNs - before.timestampNs));
+    out[0] = before.x + (after.x - before.x) * alpha;
+    out[1] = before.y + (after.y - before.y) * alpha;
+    out[2] = before.z + (after.z - before.z) * alpha;
+}
+
+void ImuFrameSync::fillBracket(const Window& window, int64_t timestampNs, ImuBracket& out) noexcept {
+    out = {};
+    if (window.empty()) {
+        return;
+    }
+
+    const uint64_t index = window.lowerBound(timestampNs);
+    if (index == window.total) {
+        return;     // IMU has not reached the frame yet
+    }
+
+    const ImuSample& after = window.at(index);
+    if (after.timestampNs != timestampNs && index == window.begin()) {
+        return;     // Frame predates the window
+    }
+    const ImuSample& before = after.timestampNs == timestampNs ? after : window.at(index - 1);
+
+    out.beforeTimestampNs = before.timestampNs;
+    out.afterTimestampNs = after.timestampNs;
+    out.before[0] = before.x;
+    out.before[1] = before.y;
+    out.before[2] = before.z;
+    out.after[0] = after.x;
+    out.after[1] = after.y;
+    out.after[2] = after.z;
+    interpolateAt(window, timestampNs, out.interpolated);
+    out.valid = 1;
+}
+
+int32_t ImuFrameSync::integrateRotation(const Window& window, int64_t fromNs, int64_t toNs,
+                                        float quaternion[4], int64_t& actualFromNs) noexcept {
+    setIdentity(quaternion);
+    actualFromNs = 0;
+    if (window.empty() || fromNs <= 0 || fromNs >= toNs) {
+        return 0;
+    }
+
+    // Integrate from the oldest retained sample if the previous frame fell out of the window
+    const int64_t oldestNs = window.at(window.begin()).timestampNs;
+    const int64_t startNs = fromNs > oldestNs ? fromNs : oldestNs;
+    if (startNs >= toNs) {
+        return 0;
+    }
+    actualFromNs = startNs;
+
+    // Trapezoidal integration over piecewise-linear angular velocity, endpoints interpolated
+    double q[4] = {1.0, 0.0, 0.0, 0.0};
+    float startOmega[3];
+    interpolateAt(window, startNs, startOmega);
+    double prevOmega[3] = {startOmega[0], startOmega[1], startOmega[2]};
+    int64_t prevNs = startNs;
+    int32_t integrated = 0;
+
+    for (uint64_t i = window.lowerBound(startNs + 1); i < window.total; ++i) {
+        const ImuSample& sample = window.at(i);
+        if (sample.timestampNs >= toNs) {
+            break;
+        }
+        const double omega[3] = {sample.x, sample.y, sample.z};
+        const double mean[3] = {0.5 * (prevOmega[0] + omega[0]),
+                                0.5 * (prevOmega[1] + omega[1]),
+                                0.5 * (prevOmega[2] + omega[2])};
+        applyAngularVelocity(q, mean, static_cast<double>(sample.timestampNs - prevNs) * kNsToSeconds);
+        prevOmega[0] = omega[0];
+        prevOmega[1] = omega[1];
+        prevOmega[2] = omega[2];
+        prevNs = sample.timestampNs;
+        integrated++;
+    }
+
+    float endOmega[3];
+    interpolateAt(window, toNs, endOmega);
+    const double mean[3] = {0.5 * (prevOmega[0] + endOmega[0]),
+                            0.5 * (prevOmega[1] + endOmega[1]),
+                            0.5 * (prevOmega[2] + endOmega[2])};
+    applyAngularVelocity(q, mean, static_cast<double>(toNs - prevNs) * kNsToSeconds);
+
+    const double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int i = 0; i < 4; ++i) {
+        quaternion[i] = static_cast<float>(q[i] / norm);
+    }
+    return integrated;
+}
+
+ImuAlignStatus ImuFrameSync::alignFrame(int64_t frameTimestampNs, int64_t previousFrameTimestampNs,
+                                        FrameImuSync& out, int64_t maxWaitNs) {
+    out = {};
+    out.frameTimestampNs = frameTimestampNs;
+    setIdentity(out.deltaRotation);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (maxWaitNs > 0 && !caughtUp(frameTimestampNs)) {
+        waiters_++;
+        samplesArrived_.wait_for(lock, std::chrono::nanoseconds(maxWaitNs),
+                                 [&] { return caughtUp(frameTimestampNs); });
+        waiters_--;
+    }
+
+    ImuAlignStatus status;
+    if (accel_.empty() && gyro_.empty()) {
+        status = ImuAlignStatus::NoData;
+    } else if (!caughtUp(frameTimestampNs)) {
+        status = ImuAlignStatus::Pending;
+    } else {
+        fillBracket(accel_, frameTimestampNs, out.accel);
+        fillBracket(gyro_, frameTimestampNs, out.gyro);
+        const bool accelMissing = !accel_.empty() && !out.accel.valid;
+        const bool gyroMissing = !gyro_.empty() && !out.gyro.valid;
+        status = (accelMissing || gyroMissing) ? ImuAlignStatus::OutOfWindow
+                                               : ImuAlignStatus::Aligned;
+    }
+
+    if (status == ImuAlignStatus::Aligned) {
+        out.gyroSamplesIntegrated = integrateRotation(gyro_, previousFrameTimestampNs,
+                                                      frameTimestampNs, out.deltaRotation,
+                                                      out.previousFrameTimestampNs);
+    }
+
+    out.status = static_cast<int32_t>(status);
+    return status;
+}
+
+}  // namespace nativesensor
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "imu_data.h"
+#include "sync_data.h"
+
+namespace nativesensor {
+
+/// Time-indexed IMU window for pairing camera frames with IMU samples.
+/// The IMU side appends whole batches; any number of frame consumers align against it.
+/// Critical sections are a batch copy or a binary search plus the few samples between
+/// two frames, so the sensor thread is never held up by alignment work.
+class ImuFrameSync {
+public:
+    /// Samples retained per sensor (about 2 s at 1 kHz)
+    static constexpr size_t kWindowCapacity = 2048;
+
+    ImuFrameSync() = default;
+
+    ImuFrameSync(const ImuFrameSync&) = delete;
+    ImuFrameSync& operator=(const ImuFrameSync&) = delete;
+
+    /// Append a batch of samples (timestamp order per sensor), e.g. from ImuBatchCallback
+    void addSamples(const ImuSample* samples, size_t count);
+
+    /// Drop all retained samples
+    void reset();
+
+    /// Align a frame against the IMU window
+    /// @param frameTimestampNs Frame timestamp (CLOCK_BOOTTIME)
+    /// @param previousFrameTimestampNs Previous frame of the same stream, or 0 to skip integration
+    /// @param out Filled with brackets, interpolation and integrated rotation
+    /// @param maxWaitNs How long to wait for the IMU to reach the frame time (0 = don't wait)
+    /// @return out.status
+    ImuAlignStatus alignFrame(int64_t frameTimestampNs, int64_t previousFrameTimestampNs,
+                              FrameImuSync& out, int64_t maxWaitNs = 0);
+
+private:
+    /// Fixed-capacity history for one sensor, indexed by a monotonically increasing count
+    struct Window {
+        std::array<ImuSample, kWindowCapacity> samples{};
+        uint64_t total = 0;     // Samples ever appended
+
+        [[nodiscard]] uint64_t begin() const noexcept {
+            return total > kWindowCapacity ? total - kWindowCapacity : 0;
+        }
+        [[nodiscard]] bool empty() const noexcept { return total == 0; }
+        [[nodiscard]] const ImuSample& at(uint64_t index) const noexcept {
+            return samples[index % kWindowCapacity];
+        }
+        [[nodiscard]] const ImuSample& newest() const noexcept { return at(total - 1); }
+
+        void push(const ImuSample& sample) noexcept {
+            samples[total % kWindowCapacity] = sample;
+            total++;
+        }
+
+        /// First index whose timestamp is >= timestampNs (total if none)
+        [[nodiscard]] uint64_t lowerBound(int64_t timestampNs) const noexcept;
+    };
+
+    /// True once every sensor with data has reached timestampNs
+    [[nodiscard]] bool caughtUp(int64_t timestampNs) const noexcept;
+
+    /// Linear interpolation at timestampNs, clamped to the window ends. Window must be non-empty.
+    static void interpolateAt(const Window& window, int64_t timestampNs, float out[3]) noexcept;
+    static void fillBracket(const Window& window, int64_t timestampNs, ImuBracket& out) noexcept;
+    static int32_t integrateRotation(const Window& window, int64_t fromNs, int64_t toNs,
+                                     float quaternion[4], int64_t& actualFromNs) noexcept;
+
+    std::mutex mutex_;
+    std::condition_variable samplesArrived_;
+    int32_t waiters_ = 0;
+
+    Window accel_;
+    Window gyro_;
+};
+
+}  // namespace nativesensor
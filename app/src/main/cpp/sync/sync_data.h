@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nativesensor {
+
+/// Outcome of aligning a frame timestamp against the IMU window
+enum class ImuAlignStatus : int32_t {
+    NoData = 0,         // No IMU samples recorded yet
+    Aligned = 1,        // Frame bracketed by IMU samples on both sides
+    Pending = 2,        // IMU has not yet reached the frame time (retry later)
+    OutOfWindow = 3     // Frame is older than the retained IMU window
+};
+
+/// IMU samples either side of a frame timestamp plus the linear interpolation between them
+struct ImuBracket {
+    int64_t beforeTimestampNs;
+    int64_t afterTimestampNs;
+    float before[3];
+    float after[3];
+    float interpolated[3];
+    int32_t valid;              // Non-zero when both neighbours were found
+};
+static_assert(sizeof(ImuBracket) == 56, "ImuBracket layout is part of the JNI contract");
+
+/// IMU state aligned to one camera frame (CLOCK_BOOTTIME on both sides).
+/// Packed for export over JNI in native byte order.
+struct FrameImuSync {
+    int64_t frameTimestampNs;
+    int64_t previousFrameTimestampNs;   // Start of the rotation integration (0 = none)
+    ImuBracket accel;
+    ImuBracket gyro;
+    float deltaRotation[4];             // Integrated gyro rotation since the previous frame (w, x, y, z)
+    int32_t gyroSamplesIntegrated;
+    int32_t status;                     // ImuAlignStatus
+};
+static_assert(sizeof(FrameImuSync) == 152, "FrameImuSync layout is part of the JNI contract");
+
+}  // namespace nativesensor
@@ -0,0 +1,180 @@
+package com.tw0b33rs.nativesensoraccess.recording
+
+import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
+
+/**
+ * Session recording counters.
+ * Dropped counts cover full native queues and data discarded after a storage failure.
+ * @property poolStarvations Frames or packets dropped because every recorder buffer was still
+ *   waiting to be written (included in [framesDropped]); capture itself is never starved
+ */
+data class RecordingStats(
+    val imuSamples: Long,
+    val imuDropped: Long,
+    val frames: Long,
+    val framesDropped: Long,
+    val bytesWritten: Long,
+    val chunks: Long,
+    val poolStarvations: Long
+)
+
+/**
+ * Session replay counters.
+ * @property maxLagNs Worst delay behind the paced schedule; grows when consumers cannot keep up
+ */
+data class ReplayStats(
+    val imuSamples: Long,
+    val frames: Long,
+    val loops: Long,
+    val maxLagNs: Long
+)
+
+/**
+ * JNI bridge to the native session recorder and replayer.
+ * Records the IMU stream and captured camera frames (encoder captures as streams 0-3, one per
+ * camera id in first-capture order; multi-camera physical cameras as streams 4-7; hardware
+ * encoder packets as stream 8) into a binary .nsrec file written by a native I/O thread.
+ * Recorded sessions replay through the same native consumers as live capture: IMU batches feed
+ * frame sync and the latest-sample getters, frames go to the registered
+ * [com.tw0b33rs.nativesensoraccess.streaming.NativeFrameCallback].
+ */
+object SessionRecorder {
+
+    private val log = SensorLogger.Logger("NativeSensor.Recorder")
+
+    init {
+        try {
+            System.loadLibrary("nativesensor")
+            log.info("Recorder native library ready")
+        } catch (e: UnsatisfiedLinkError) {
+            log.error("Failed to load native library for recording", throwable = e)
+        }
+    }
+
+    // Reused by the polled getters so a poll allocates no JNI arrays (each locked while in use)
+    private val recordingStatsScratch = LongArray(7)
+    private val replayStatsScratch = LongArray(4)
+
+    // Native method declarations
+    private external fun nativeStartRecording(path: String): Boolean
+    private external fun nativeStopRecording()
+    private external fun nativeIsRecording(): Boolean
+    private external fun nativeGetRecordingStats(out: LongArray)
+    private external fun nativeStartReplay(
+        path: String,
+        speed: Double,
+        loop: Boolean,
+        frameStreamId: Int
+    ): Boolean
+    private external fun nativeStopReplay()
+    private external fun nativeIsReplaying(): Boolean
+    private external fun nativeGetReplayStats(out: LongArray)
+
+    /**
+     * Start recording a session.
+     * @param path Absolute path of the .nsrec file to create (replaced if it exists)
+     * @return true if the file was created and recording started
+     */
+    fun startRecording(path: String): Boolean {
+        log.info("Starting session recording", mapOf("path" to path))
+        return nativeStartRecording(path).also { success ->
+            if (!success) {
+                log.error("Failed to start session recording: $path")
+            }
+        }
+    }
+
+    /**
+     * Stop recording, flush the queued data and write the session index.
+     */
+    fun stopRecording() {
+        log.info("Stopping session recording")
+        nativeStopRecording()
+    }
+
+    /**
+     * Check if a session is being recorded.
+     */
+    fun isRecording(): Boolean = nativeIsRecording()
+
+    /**
+     * Get counters for the current (or last) session.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getStats(): RecordingStats {
+        val data = recordingStatsScratch
+        synchronized(data) {
+            nativeGetRecordingStats(data)
+            return RecordingStats(
+                imuSamples = data.getOrElse(0) { 0L },
+                imuDropped = data.getOrElse(1) { 0L },
+                frames = data.getOrElse(2) { 0L },
+                framesDropped = data.getOrElse(3) { 0L },
+                bytesWritten = data.getOrElse(4) { 0L },
+                chunks = data.getOrElse(5) { 0L },
+                poolStarvations = data.getOrElse(6) { 0L }
+            )
+        }
+    }
+
+    /**
+     * Replay a recorded session.
+     * @param path Session file written by [startRecording]
+     * @param speed Playback rate relative to the recording; 0 delivers as fast as possible
+     * @param loop Restart at the end with timestamps continuing forward
+     * @param frameStreamId Recorded stream delivered to the frame callback
+     *        (0-3 = encoder captures, 4-7 = multi-capture physical cameras)
+     * @return true if the session was opened and replay started
+     */
+    @Suppress("unused")  // Part of public API
+    fun startReplay(
+        path: String,
+        speed: Double = 1.0,
+        loop: Boolean = false,
+        frameStreamId: Int = 0
+    ): Boolean {
+        log.info("Starting session replay", mapOf(
+            "path" to path,
+            "speed" to speed,
+            "loop" to loop,
+            "frameStreamId" to frameStreamId
+        ))
+        return nativeStartReplay(path, speed, loop, frameStreamId).also { success ->
+            if (!success) {
+                log.error("Failed to start session replay: $path")
+            }
+        }
+    }
+
+    /**
+     * Stop a running replay.
+     */
+    @Suppress("unused")  // Part of public API
+    fun stopReplay() {
+        log.info("Stopping session replay")
+        nativeStopReplay()
+    }
+
+    /**
+     * Check if a replay is still delivering (false once a non-looping replay reaches the end).
+     */
+    @Suppress("unused")  // Part of public API
+    fun isReplaying(): Boolean = nativeIsReplaying()
+
+    /**
+     * Get counters for the current (or last) replay.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getReplayStats(): ReplayStats {
+        val data = replayStatsScratch
+        synchronized(data) {
+            nativeGetReplayStats(data)
+            return ReplayStats(
+                imuSamples = data.getOrElse(0) { 0L },
+                frames = data.getOrElse(1) { 0L },
+                loops = data.getOrElse(2) { 0L },
+                maxLagNs = data.getOrElse(3) { 0L }
+            )
+        }
+    }
+}
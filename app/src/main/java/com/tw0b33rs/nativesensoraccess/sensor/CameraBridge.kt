@@ -2,6 +2,9 @@ package com.tw0b33rs.nativesensoraccess.sensor
 
 import android.view.Surface
 import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
+import com.tw0b33rs.nativesensoraccess.streaming.FrameFormat
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 /**
  * Camera cluster types matching C++ CameraClusterType enum.
@@ -45,7 +48,10 @@ data class CameraInfo(
     val height: Int,
     val maxFps: Int,
     val isPhysicalCamera: Boolean,
-    val physicalCameraIds: String
+    val physicalCameraIds: String,
+    /** Every output configuration reported by the camera */
+    val streamConfigurations: List<StreamConfiguration> = emptyList(),
+    val fpsRanges: List<FpsRange> = emptyList()
 ) {
     val resolution: String
         get() = "${width}x${height}"
@@ -73,6 +79,171 @@ data class CameraStats(
     val droppedFrames: Long
 )
 
+/**
+ * Latency distribution of one pipeline stage, matching C++ LatencySummary (microseconds).
+ */
+data class LatencySummary(
+    val count: Long,
+    val minUs: Long,
+    val meanUs: Long,
+    val p50Us: Long,
+    val p95Us: Long,
+    val p99Us: Long,
+    val maxUs: Long
+) {
+    internal companion object {
+        const val SIZE_BYTES = 32
+
+        fun read(buffer: ByteBuffer, offset: Int) = LatencySummary(
+            count = buffer.getLong(offset),
+            minUs = buffer.getInt(offset + 8).toUInt().toLong(),
+            meanUs = buffer.getInt(offset + 12).toUInt().toLong(),
+            p50Us = buffer.getInt(offset + 16).toUInt().toLong(),
+            p95Us = buffer.getInt(offset + 20).toUInt().toLong(),
+            p99Us = buffer.getInt(offset + 24).toUInt().toLong(),
+            maxUs = buffer.getInt(offset + 28).toUInt().toLong()
+        )
+    }
+}
+
+/**
+ * Per-frame latency, jitter and drop statistics of a camera consumer, parsed from the
+ * binary snapshot of C++ FrameLatencySnapshot. Latencies are measured from the sensor
+ * start-of-exposure timestamp.
+ */
+data class FrameLatencySnapshot(
+    /** Captures started */
+    val frameCount: Long,
+    /** Sum of [frameNumberGaps], [captureFailures] and [buffersLost] */
+    val droppedFrames: Long,
+    /** Frame numbers skipped between consecutive captures */
+    val frameNumberGaps: Long,
+    val captureFailures: Long,
+    /** Buffers the camera dropped for this consumer's output */
+    val buffersLost: Long,
+    /** RFC 3550 interarrival jitter of sensor timestamps */
+    val jitterUs: Float,
+    val frameRateHz: Float,
+    val frameInterval: LatencySummary,
+    /** Result metadata delivered */
+    val captureCompleted: LatencySummary,
+    /** Image reader listener fired (encoder captures only) */
+    val imageAvailable: LatencySummary,
+    /** Frame callback returned, including the JNI upcall (encoder captures only) */
+    val jniDelivered: LatencySummary
+) {
+    companion object {
+        /** Size of the snapshot written by the native layer */
+        const val SIZE_BYTES = 184
+
+        private const val VERSION = 1
+        private const val INTERVAL_OFFSET = 56
+        private const val STAGES_OFFSET = 88
+
+        /** Allocate a reusable buffer for the snapshot getters */
+        fun allocateBuffer(): ByteBuffer =
+            ByteBuffer.allocateDirect(SIZE_BYTES).order(ByteOrder.nativeOrder())
+
+        /**
+         * Parse a snapshot written into [buffer] by the native layer.
+         * @param bytesWritten Return value of the native getter
+         * @return null if nothing was written or the layout version differs
+         */
+        fun parse(buffer: ByteBuffer, bytesWritten: Int): FrameLatencySnapshot? {
+            buffer.order(ByteOrder.nativeOrder())
+            if (bytesWritten < SIZE_BYTES || buffer.getInt(0) != VERSION) {
+                return null
+            }
+            fun stage(index: Int) =
+                LatencySummary.read(buffer, STAGES_OFFSET + index * LatencySummary.SIZE_BYTES)
+            return FrameLatencySnapshot(
+                frameCount = buffer.getLong(8),
+                droppedFrames = buffer.getLong(16),
+                frameNumberGaps = buffer.getLong(24),
+                captureFailures = buffer.getLong(32),
+                buffersLost = buffer.getLong(40),
+                jitterUs = buffer.getFloat(48),
+                frameRateHz = buffer.getFloat(52),
+                frameInterval = LatencySummary.read(buffer, INTERVAL_OFFSET),
+                captureCompleted = stage(0),
+                imageAvailable = stage(1),
+                jniDelivered = stage(2)
+            )
+        }
+    }
+}
+
+/**
+ * Start-of-exposure alignment between the physical cameras of a logical camera,
+ * matching C++ MultiCameraSyncType.
+ */
+enum class MultiCameraSyncType(val value: Int) {
+    UNKNOWN(-1),
+    /** Software-synchronized; physical timestamps only approximate */
+    APPROXIMATE(0),
+    /** Hardware-synchronized; physical timestamps match per exposure */
+    CALIBRATED(1);
+
+    companion object {
+        fun fromValue(value: Int): MultiCameraSyncType =
+            entries.find { it.value == value } ?: UNKNOWN
+    }
+}
+
+/**
+ * Synchronized multi-camera capture statistics.
+ */
+data class MultiCameraStats(
+    val frameSetRateHz: Float,
+    val latencyMs: Float,
+    val frameSetCount: Long,
+    /** Sets evicted before every physical camera delivered */
+    val incompleteFrameSets: Long,
+    /** Images dropped before grouping (buffer pool exhausted or repack failure) */
+    val droppedFrames: Long,
+    /** Latest minus earliest exposure of the last set */
+    val timestampSpreadUs: Float,
+    val physicalCameraCount: Int,
+    val syncType: MultiCameraSyncType
+)
+
+/**
+ * Callback for hardware-synchronized frame sets from a logical multi-camera.
+ * Implemented in Java/Kotlin and called from C++ via JNI.
+ */
+fun interface MultiCameraFrameCallback {
+    /**
+     * Called once per exposure with one frame from every physical camera.
+     * Invoked on a native image reader thread. The buffers wrap native pooled memory and are
+     * only valid until this returns; copy anything needed later.
+     * @param timestampNs Earliest start of exposure in the set
+     * @param frames Tightly packed YUV frames in [CameraBridge.startMultiCapture] camera order
+     * @param frameTimestampsNs Start of exposure of each frame
+     * @param width Frame width in pixels
+     * @param height Frame height in pixels
+     */
+    fun onFrameSet(
+        timestampNs: Long,
+        frames: Array<ByteBuffer>,
+        frameTimestampsNs: LongArray,
+        width: Int,
+        height: Int
+    )
+}
+
+/**
+ * Callback for [CameraBridge.prewarm] completion.
+ * Implemented in Java/Kotlin and called from C++ via JNI.
+ */
+fun interface CameraPrewarmCallback {
+    /**
+     * Called once the device open settles, on a native thread.
+     * @param cameraId Camera that was prewarmed
+     * @param success true if the device is open and ready for [CameraBridge.startPreview]
+     */
+    fun onCameraReady(cameraId: String, success: Boolean)
+}
+
 /**
  * JNI bridge to native camera layer.
  * Provides zero-copy camera preview via ANativeWindow/Surface.
@@ -81,6 +252,31 @@ object CameraBridge {
 
     private val log = SensorLogger.camera
 
+    /** Size of one packed frame/IMU sync record written by [drainFrameSync] */
+    const val FRAME_SYNC_RECORD_BYTES = 152
+
+    /** Byte offsets within a frame sync record (native byte order) */
+    const val FRAME_SYNC_FRAME_TIMESTAMP_NS = 0     // Long
+    const val FRAME_SYNC_PREVIOUS_FRAME_NS = 8      // Long, start of rotation integration (0 = none)
+    const val FRAME_SYNC_ACCEL = 16                 // Bracket
+    const val FRAME_SYNC_GYRO = 72                  // Bracket
+    const val FRAME_SYNC_DELTA_ROTATION = 128       // Float w, x, y, z since the previous frame
+    const val FRAME_SYNC_GYRO_SAMPLES = 144         // Int, gyro samples integrated
+    const val FRAME_SYNC_STATUS = 148               // Int, FRAME_SYNC_STATUS_*
+
+    /** Byte offsets within a bracket, relative to [FRAME_SYNC_ACCEL] or [FRAME_SYNC_GYRO] */
+    const val BRACKET_BEFORE_TIMESTAMP_NS = 0       // Long
+    const val BRACKET_AFTER_TIMESTAMP_NS = 8        // Long
+    const val BRACKET_BEFORE = 16                   // Float x, y, z
+    const val BRACKET_AFTER = 28                    // Float x, y, z
+    const val BRACKET_INTERPOLATED = 40             // Float x, y, z at the frame timestamp
+    const val BRACKET_VALID = 52                    // Int, non-zero when both neighbours exist
+
+    /** Alignment status values, matching C++ ImuAlignStatus */
+    const val FRAME_SYNC_STATUS_NO_DATA = 0
+    const val FRAME_SYNC_STATUS_ALIGNED = 1
+    const val FRAME_SYNC_STATUS_OUT_OF_WINDOW = 3
+
     init {
         try {
             System.loadLibrary("nativesensor")
@@ -90,32 +286,51 @@ object CameraBridge {
         }
     }
 
+    // Reused by the polled getters so a poll allocates no JNI arrays (each locked while in use)
+    private val statsScratch = FloatArray(4)
+    private val cameraStatsScratch = FloatArray(4)
+    private val multiCaptureStatsScratch = FloatArray(8)
+
     // Native method declarations
-    private external fun nativeEnumerateCameras(): String
     private external fun nativeStartPreview(cameraId: String, surface: Surface): Boolean
     private external fun nativeStopPreview()
     private external fun nativeStopCameraPreview(cameraId: String)
-    private external fun nativeGetCameraStats(): FloatArray
-    private external fun nativeGetCameraStatsById(cameraId: String): FloatArray
+    private external fun nativeGetCameraStats(out: FloatArray)
+    private external fun nativeGetCameraStatsById(cameraId: String, out: FloatArray)
     private external fun nativeIsStreaming(): Boolean
     private external fun nativeIsCameraStreaming(cameraId: String): Boolean
     private external fun nativeGetCurrentCameraId(): String
     private external fun nativeGetActiveStreamCount(): Int
+    private external fun nativeDrainFrameSync(cameraId: String, buffer: ByteBuffer): Int
+    private external fun nativeGetLatencySnapshot(cameraId: String, buffer: ByteBuffer): Int
+    private external fun nativePrewarmCamera(cameraId: String, callback: CameraPrewarmCallback?)
+    private external fun nativeCancelPrewarm(cameraId: String)
+    private external fun nativeSetFrameSetCallback(callback: MultiCameraFrameCallback?)
+    private external fun nativeStartMultiCapture(
+        logicalCameraId: String,
+        physicalCameraIds: String,
+        width: Int,
+        height: Int,
+        outputFormat: Int
+    ): Boolean
+    private external fun nativeStopMultiCapture()
+    private external fun nativeIsMultiCapturing(): Boolean
+    private external fun nativeGetMultiCaptureStats(out: FloatArray)
 
     /**
      * Enumerate all available cameras with metadata.
+     * Served from the [DeviceRegistry] snapshot, so repeated calls are cheap until a camera
+     * is added or removed.
      * @return List of CameraInfo for all detected cameras
      */
     fun enumerateCameras(): List<CameraInfo> {
-        val rawData = nativeEnumerateCameras()
-        if (rawData.isEmpty()) {
+        val cameras = DeviceRegistry.snapshot().cameras
+        if (cameras.isEmpty()) {
             log.warn("No cameras returned from native layer")
-            return emptyList()
+            return cameras
         }
 
-        return rawData.trim().split("\n").mapNotNull { line ->
-            parseCameraInfo(line)
-        }.also { cameras ->
+        return cameras.also {
             log.info("Enumerated ${cameras.size} cameras", mapOf(
                 "passthrough" to cameras.count { it.clusterType == CameraClusterType.PASSTHROUGH },
                 "avatar" to cameras.count { it.clusterType == CameraClusterType.AVATAR },
@@ -143,6 +358,27 @@ object CameraBridge {
         }
     }
 
+    /**
+     * Open a camera device before its surface exists, so a later [startPreview] or encoder
+     * capture on the same id only has to configure the session.
+     * @param cameraId Camera ID from enumeration
+     * @param callback Optional completion callback
+     */
+    @Suppress("unused")  // Part of public API
+    fun prewarm(cameraId: String, callback: CameraPrewarmCallback? = null) {
+        log.info("Prewarming camera", mapOf("cameraId" to cameraId))
+        nativePrewarmCamera(cameraId, callback)
+    }
+
+    /**
+     * Release a prewarmed camera that was never started.
+     * @param cameraId Camera ID passed to [prewarm]
+     */
+    @Suppress("unused")  // Part of public API
+    fun cancelPrewarm(cameraId: String) {
+        nativeCancelPrewarm(cameraId)
+    }
+
     /**
      * Stop all camera previews and release resources.
      */
@@ -188,13 +424,16 @@ object CameraBridge {
      */
     @Suppress("unused")  // Part of public API
     fun getStats(): CameraStats {
-        val data = nativeGetCameraStats()
-        return CameraStats(
-            frameRateHz = data.getOrElse(0) { 0f },
-            latencyMs = data.getOrElse(1) { 0f },
-            frameCount = data.getOrElse(2) { 0f }.toLong(),
-            droppedFrames = data.getOrElse(3) { 0f }.toLong()
-        )
+        val data = statsScratch
+        synchronized(data) {
+            nativeGetCameraStats(data)
+            return CameraStats(
+                frameRateHz = data.getOrElse(0) { 0f },
+                latencyMs = data.getOrElse(1) { 0f },
+                frameCount = data.getOrElse(2) { 0f }.toLong(),
+                droppedFrames = data.getOrElse(3) { 0f }.toLong()
+            )
+        }
     }
 
     /**
@@ -203,13 +442,131 @@ object CameraBridge {
      */
     @Suppress("unused")  // Part of public API
     fun getStats(cameraId: String): CameraStats {
-        val data = nativeGetCameraStatsById(cameraId)
-        return CameraStats(
-            frameRateHz = data.getOrElse(0) { 0f },
-            latencyMs = data.getOrElse(1) { 0f },
-            frameCount = data.getOrElse(2) { 0f }.toLong(),
-            droppedFrames = data.getOrElse(3) { 0f }.toLong()
-        )
+        val data = cameraStatsScratch
+        synchronized(data) {
+            nativeGetCameraStatsById(cameraId, data)
+            return CameraStats(
+                frameRateHz = data.getOrElse(0) { 0f },
+                latencyMs = data.getOrElse(1) { 0f },
+                frameCount = data.getOrElse(2) { 0f }.toLong(),
+                droppedFrames = data.getOrElse(3) { 0f }.toLong()
+            )
+        }
+    }
+
+    /**
+     * Get latency percentiles, jitter and drop counters for a camera preview.
+     * @param cameraId Streaming camera
+     * @param buffer Reusable buffer from [FrameLatencySnapshot.allocateBuffer]
+     * @return null if the camera has no preview
+     */
+    @Suppress("unused")  // Part of public API
+    fun getLatencySnapshot(
+        cameraId: String,
+        buffer: ByteBuffer = FrameLatencySnapshot.allocateBuffer()
+    ): FrameLatencySnapshot? {
+        require(buffer.isDirect) { "getLatencySnapshot requires a direct ByteBuffer" }
+        return FrameLatencySnapshot.parse(buffer, nativeGetLatencySnapshot(cameraId, buffer))
+    }
+
+    /**
+     * Allocate a reusable buffer for [drainFrameSync].
+     * @param maxRecords Records the buffer can hold per drain
+     */
+    @Suppress("unused")  // Part of public API
+    fun allocateFrameSyncBuffer(maxRecords: Int): ByteBuffer =
+        ByteBuffer.allocateDirect(maxRecords * FRAME_SYNC_RECORD_BYTES).order(ByteOrder.nativeOrder())
+
+    /**
+     * Pair every preview frame started since the previous call with the native IMU window.
+     * Each [FRAME_SYNC_RECORD_BYTES] record holds the bracketing accel/gyro samples, their
+     * interpolation at the frame timestamp and the gyro rotation integrated since the previous
+     * frame. Frames the IMU has not caught up with yet are returned by a later call.
+     * @param cameraId Streaming camera to drain
+     * @param buffer Direct buffer from [allocateFrameSyncBuffer]
+     * @return Number of records written
+     */
+    @Suppress("unused")  // Part of public API
+    fun drainFrameSync(cameraId: String, buffer: ByteBuffer): Int {
+        require(buffer.isDirect) { "drainFrameSync requires a direct ByteBuffer" }
+        return nativeDrainFrameSync(cameraId, buffer)
+    }
+
+    /**
+     * Set the receiver of synchronized frame sets from [startMultiCapture].
+     * @param callback Receiver, or null to stop delivery
+     */
+    @Suppress("unused")  // Part of public API
+    fun setFrameSetCallback(callback: MultiCameraFrameCallback?) {
+        nativeSetFrameSetCallback(callback)
+    }
+
+    /**
+     * Open a logical camera once and stream its physical cameras through one session.
+     * Frames of the same exposure are delivered together to the [setFrameSetCallback] receiver.
+     * @param logicalCameraId Logical multi-camera from enumeration (non-empty physicalCameraIds)
+     * @param physicalCameraIds Physical cameras to stream, or empty for all (up to 4)
+     * @param width Capture width of every physical stream
+     * @param height Capture height of every physical stream
+     * @param format Packed layout of each frame
+     * @return true if capture started successfully
+     */
+    @Suppress("unused")  // Part of public API
+    fun startMultiCapture(
+        logicalCameraId: String,
+        physicalCameraIds: List<String> = emptyList(),
+        width: Int,
+        height: Int,
+        format: FrameFormat = FrameFormat.I420
+    ): Boolean {
+        log.info("Starting multi-camera capture", mapOf(
+            "logicalCameraId" to logicalCameraId,
+            "physicalCameraIds" to physicalCameraIds.joinToString(","),
+            "resolution" to "${width}x${height}"
+        ))
+        return nativeStartMultiCapture(
+            logicalCameraId, physicalCameraIds.joinToString(","), width, height, format.value
+        ).also { success ->
+            if (!success) {
+                log.error("Failed to start multi-camera capture: $logicalCameraId")
+            }
+        }
+    }
+
+    /**
+     * Stop synchronized multi-camera capture and release its device.
+     */
+    @Suppress("unused")  // Part of public API
+    fun stopMultiCapture() {
+        log.info("Stopping multi-camera capture")
+        nativeStopMultiCapture()
+    }
+
+    /**
+     * Check if synchronized multi-camera capture is running.
+     */
+    @Suppress("unused")  // Part of public API
+    fun isMultiCapturing(): Boolean = nativeIsMultiCapturing()
+
+    /**
+     * Get synchronized multi-camera capture statistics.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getMultiCaptureStats(): MultiCameraStats {
+        val data = multiCaptureStatsScratch
+        synchronized(data) {
+            nativeGetMultiCaptureStats(data)
+            return MultiCameraStats(
+                frameSetRateHz = data.getOrElse(0) { 0f },
+                latencyMs = data.getOrElse(1) { 0f },
+                frameSetCount = data.getOrElse(2) { 0f }.toLong(),
+                incompleteFrameSets = data.getOrElse(3) { 0f }.toLong(),
+                droppedFrames = data.getOrElse(4) { 0f }.toLong(),
+                timestampSpreadUs = data.getOrElse(5) { 0f },
+                physicalCameraCount = data.getOrElse(6) { 0f }.toInt(),
+                syncType = MultiCameraSyncType.fromValue(data.getOrElse(7) { -1f }.toInt())
+            )
+        }
     }
 
     // Extension functions for cluster grouping
@@ -249,28 +606,4 @@ object CameraBridge {
     fun getDepthCameras(): List<CameraInfo> =
         enumerateCameras().filter { it.clusterType == CameraClusterType.DEPTH }
 
-    private fun parseCameraInfo(line: String): CameraInfo? {
-        // Format: id|facing|clusterType|width|height|maxFps|isPhysical|physicalIds
-        val parts = line.split("|")
-        if (parts.size < 7) {
-            log.debug("Skipping malformed camera line", mapOf("line" to line, "parts" to parts.size))
-            return null
-        }
-
-        return try {
-            CameraInfo(
-                id = parts[0],
-                facing = CameraFacing.fromValue(parts[1].toInt()),
-                clusterType = CameraClusterType.fromValue(parts[2].toInt()),
-                width = parts[3].toInt(),
-                height = parts[4].toInt(),
-                maxFps = parts[5].toInt(),
-                isPhysicalCamera = parts[6] == "1",
-                physicalCameraIds = parts.getOrElse(7) { "" }
-            )
-        } catch (e: Exception) {
-            log.warn("Failed to parse camera info: $line", throwable = e)
-            null
-        }
-    }
 }
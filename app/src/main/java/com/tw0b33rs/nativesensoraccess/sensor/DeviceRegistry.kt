@@ -0,0 +1,190 @@
+package com.tw0b33rs.nativesensoraccess.sensor
+
+import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * One camera output stream configuration.
+ * @property format AIMAGE_FORMAT_* / ImageFormat constant (e.g. 0x23 = YUV_420_888)
+ */
+data class StreamConfiguration(
+    val format: Int,
+    val width: Int,
+    val height: Int
+)
+
+/**
+ * One auto-exposure target frame-rate range supported by a camera.
+ */
+data class FpsRange(
+    val min: Int,
+    val max: Int
+)
+
+/**
+ * Sensors and cameras of the device at one registry generation.
+ */
+data class DeviceSnapshot(
+    val generation: Long,
+    val sensors: List<SensorInfo>,
+    val cameras: List<CameraInfo>
+)
+
+/**
+ * Listener for [DeviceRegistry.setChangeListener].
+ * Implemented in Java/Kotlin and called from C++ via JNI.
+ */
+fun interface DeviceChangeListener {
+    /**
+     * Called when a camera appears or a hot-pluggable camera goes away, on a native thread.
+     * @param generation Generation the next [DeviceRegistry.snapshot] will carry
+     */
+    fun onDevicesChanged(generation: Long)
+}
+
+/**
+ * JNI bridge to the native device registry.
+ * The native layer serializes every IMU sensor and camera (including stream configurations
+ * and FPS ranges) into one binary snapshot, matching C++ device_registry_format.h, and only
+ * rebuilds it when the camera set changes. The parsed snapshot is cached here by generation,
+ * so repeated enumeration costs one JNI call.
+ */
+object DeviceRegistry {
+
+    private val log = SensorLogger.Logger("NativeSensor.Registry")
+
+    private const val MAGIC = 0x5244534e    // "NSDR"
+    private const val VERSION = 1
+    private const val HEADER_BYTES = 64
+    private const val SENSOR_RECORD_BYTES = 32
+    private const val CAMERA_RECORD_BYTES = 48
+    private const val STREAM_CONFIG_RECORD_BYTES = 12
+    private const val FPS_RANGE_RECORD_BYTES = 8
+    private const val CAMERA_FLAG_PHYSICAL = 1
+    private const val INITIAL_BUFFER_BYTES = 16 * 1024
+
+    init {
+        try {
+            System.loadLibrary("nativesensor")
+            log.info("Device registry native library ready")
+        } catch (e: UnsatisfiedLinkError) {
+            log.error("Failed to load native library for device registry", throwable = e)
+        }
+    }
+
+    private val lock = Any()
+    private var buffer: ByteBuffer = allocate(INITIAL_BUFFER_BYTES)
+    private var cached: DeviceSnapshot? = null
+
+    // Native method declarations
+    private external fun nativeGetGeneration(): Long
+    private external fun nativeExportSnapshot(buffer: ByteBuffer): Int
+    private external fun nativeSetChangeListener(listener: DeviceChangeListener?)
+
+    /**
+     * Get the current sensors and cameras. Served from the cache while the native
+     * generation is unchanged.
+     */
+    fun snapshot(): DeviceSnapshot = synchronized(lock) {
+        val generation = nativeGetGeneration()
+        cached?.takeIf { it.generation == generation } ?: exportSnapshot().also { cached = it }
+    }
+
+    /**
+     * Generation of the native registry; changes whenever the camera set changes.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getGeneration(): Long = nativeGetGeneration()
+
+    /**
+     * Register a listener for camera hot-plug, or clear it with null.
+     */
+    @Suppress("unused")  // Part of public API
+    fun setChangeListener(listener: DeviceChangeListener?) {
+        nativeSetChangeListener(listener)
+    }
+
+    private fun exportSnapshot(): DeviceSnapshot {
+        var size = nativeExportSnapshot(buffer)
+        if (size > buffer.capacity()) {
+            buffer = allocate(size)
+            size = nativeExportSnapshot(buffer)
+        }
+        return parse(buffer, size) ?: DeviceSnapshot(-1, emptyList(), emptyList()).also {
+            log.warn("Device registry snapshot unreadable", mapOf("bytes" to size))
+        }
+    }
+
+    private fun allocate(size: Int): ByteBuffer =
+        ByteBuffer.allocateDirect(size).order(ByteOrder.nativeOrder())
+
+    private fun parse(buffer: ByteBuffer, bytesWritten: Int): DeviceSnapshot? {
+        buffer.order(ByteOrder.nativeOrder())
+        if (bytesWritten < HEADER_BYTES || bytesWritten > buffer.capacity() ||
+            buffer.getInt(0) != MAGIC || buffer.getInt(4) != VERSION) {
+            return null
+        }
+        val generation = buffer.getLong(8)
+        val sensorCount = buffer.getInt(20)
+        val sensorsOffset = buffer.getInt(24)
+        val cameraCount = buffer.getInt(28)
+        val camerasOffset = buffer.getInt(32)
+        val streamConfigsOffset = buffer.getInt(40)
+        val fpsRangesOffset = buffer.getInt(48)
+        val stringsOffset = buffer.getInt(56)
+
+        fun string(offset: Int): String {
+            val start = stringsOffset + offset
+            val length = buffer.getShort(start).toInt() and 0xffff
+            val bytes = ByteArray(length)
+            for (i in 0 until length) {
+                bytes[i] = buffer.get(start + 2 + i)
+            }
+            return String(bytes, Charsets.UTF_8)
+        }
+
+        val sensors = List(sensorCount) { index ->
+            val record = sensorsOffset + index * SENSOR_RECORD_BYTES
+            SensorInfo(
+                handle = buffer.getInt(record),
+                type = buffer.getInt(record + 4),
+                name = string(buffer.getInt(record + 8)),
+                vendor = string(buffer.getInt(record + 12)),
+                minDelayUs = buffer.getInt(record + 16),
+                maxFrequencyHz = buffer.getFloat(record + 20),
+                fifoReserved = buffer.getInt(record + 24),
+                directReportRateLevel = buffer.getInt(record + 28)
+            )
+        }
+
+        val cameras = List(cameraCount) { index ->
+            val record = camerasOffset + index * CAMERA_RECORD_BYTES
+            val firstConfig = buffer.getInt(record + 32)
+            val firstRange = buffer.getInt(record + 40)
+            CameraInfo(
+                id = string(buffer.getInt(record)),
+                facing = CameraFacing.fromValue(buffer.getInt(record + 4)),
+                clusterType = CameraClusterType.fromValue(buffer.getInt(record + 8)),
+                width = buffer.getInt(record + 12),
+                height = buffer.getInt(record + 16),
+                maxFps = buffer.getInt(record + 20),
+                isPhysicalCamera = (buffer.getInt(record + 24) and CAMERA_FLAG_PHYSICAL) != 0,
+                physicalCameraIds = string(buffer.getInt(record + 28)),
+                streamConfigurations = List(buffer.getInt(record + 36)) { i ->
+                    val config = streamConfigsOffset + (firstConfig + i) * STREAM_CONFIG_RECORD_BYTES
+                    StreamConfiguration(
+                        format = buffer.getInt(config),
+                        width = buffer.getInt(config + 4),
+                        height = buffer.getInt(config + 8)
+                    )
+                },
+                fpsRanges = List(buffer.getInt(record + 44)) { i ->
+                    val range = fpsRangesOffset + (firstRange + i) * FPS_RANGE_RECORD_BYTES
+                    FpsRange(min = buffer.getInt(range), max = buffer.getInt(range + 4))
+                }
+            )
+        }
+        return DeviceSnapshot(generation, sensors, cameras)
+    }
+}
@@ -0,0 +1,111 @@
+package com.tw0b33rs.nativesensoraccess.sensor
+
+import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
+
+/**
+ * Accounted parts of the native pipeline. Ordinals match the JNI layer.
+ */
+enum class MemoryComponent {
+    /** AImageReader queues (gralloc buffers, estimated from capture size and depth) */
+    ImageReaders,
+    /** Packed camera frame pools */
+    FramePools,
+    /** IMU and orientation history rings, direct channel shared memory */
+    ImuRings,
+    /** Session recorder packet pool, mapping window and staging buffers */
+    Recorder
+}
+
+/**
+ * Native bytes held by one [MemoryComponent].
+ * @property peakBytes High-water mark since the process started
+ */
+data class MemoryComponentUsage(
+    val component: MemoryComponent,
+    val reservedBytes: Long,
+    val peakBytes: Long
+)
+
+/**
+ * Snapshot of native memory accounting.
+ * @property budgetBytes Global budget (0 = unlimited)
+ * @property degradedStreams Streams started with fewer buffers or a coarser repack
+ * @property refusedStreams Streams that did not fit even fully degraded
+ */
+data class MemoryUsage(
+    val totalBytes: Long,
+    val peakTotalBytes: Long,
+    val budgetBytes: Long,
+    val degradedStreams: Long,
+    val refusedStreams: Long,
+    val components: List<MemoryComponentUsage>
+) {
+    /** Bytes still available to new streams (Long.MAX_VALUE when unlimited) */
+    val availableBytes: Long
+        get() = if (budgetBytes > 0) (budgetBytes - totalBytes).coerceAtLeast(0L) else Long.MAX_VALUE
+}
+
+/**
+ * JNI bridge for per-component native memory accounting and the global budget that new
+ * camera streams and recordings degrade to fit.
+ */
+object MemoryBudget {
+
+    private val log = SensorLogger.Logger("NativeSensor.Memory")
+
+    private const val HEADER_FIELDS = 5
+    private val FIELD_COUNT = HEADER_FIELDS + 2 * MemoryComponent.entries.size
+
+    init {
+        try {
+            System.loadLibrary("nativesensor")
+            log.info("Memory budget native library ready")
+        } catch (e: UnsatisfiedLinkError) {
+            log.error("Failed to load native library for memory accounting", throwable = e)
+        }
+    }
+
+    // Reused by getUsage (locked while in use)
+    private val usageScratch = LongArray(FIELD_COUNT)
+
+    // Native method declarations
+    private external fun nativeSetBudget(budgetBytes: Long)
+    private external fun nativeGetUsage(out: LongArray)
+
+    /**
+     * Set the global native memory budget. Streams started afterwards use fewer reader images
+     * and pooled frames, then a coarser CPU repack, and fail to start only when even that does
+     * not fit. Running streams are never shrunk.
+     * @param budgetBytes Budget in bytes; 0 removes it
+     */
+    fun setBudget(budgetBytes: Long) {
+        log.info("Native memory budget set", mapOf("budgetMiB" to budgetBytes / (1024 * 1024)))
+        nativeSetBudget(budgetBytes)
+    }
+
+    /**
+     * Current native reservations per component, peaks and budget outcomes.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getUsage(): MemoryUsage {
+        val data = usageScratch
+        synchronized(data) {
+            nativeGetUsage(data)
+            return MemoryUsage(
+                totalBytes = data[0],
+                peakTotalBytes = data[1],
+                budgetBytes = data[2],
+                degradedStreams = data[3],
+                refusedStreams = data[4],
+                components = MemoryComponent.entries.map { component ->
+                    val base = HEADER_FIELDS + 2 * component.ordinal
+                    MemoryComponentUsage(
+                        component = component,
+                        reservedBytes = data[base],
+                        peakBytes = data[base + 1]
+                    )
+                }
+            )
+        }
+    }
+}
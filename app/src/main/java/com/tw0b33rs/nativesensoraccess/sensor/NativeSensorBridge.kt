@@ -3,6 +3,8 @@ package com.tw0b33rs.nativesensoraccess.sensor
 import com.tw0b33rs.nativesensoraccess.logging.SensorLogExtensions.logSensorDiscovery
 import com.tw0b33rs.nativesensoraccess.logging.SensorLogInfo
 import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 /**
  * JNI bridge to native sensor layer.
@@ -12,6 +14,32 @@ object NativeSensorBridge {
 
     private val log = SensorLogger.jni
 
+    /** Size of one packed record written by [drainImu] */
+    const val IMU_RECORD_BYTES = 24
+
+    /** Byte offsets within a packed record (native byte order) */
+    const val IMU_RECORD_TIMESTAMP_NS = 0    // Long, hardware timestamp
+    const val IMU_RECORD_X = 8               // Float
+    const val IMU_RECORD_Y = 12              // Float
+    const val IMU_RECORD_Z = 16              // Float
+    const val IMU_RECORD_SENSOR_TYPE = 20    // Int, SensorInfo.SENSOR_TYPE_*
+
+    /** Size of one packed record written by [drainOrientation] */
+    const val ORIENTATION_RECORD_BYTES = 48
+
+    /** Byte offsets within a packed orientation record (native byte order) */
+    const val ORIENTATION_RECORD_TIMESTAMP_NS = 0    // Long, gyroscope hardware timestamp
+    const val ORIENTATION_RECORD_QW = 8              // Float quaternion w, x, y, z
+    const val ORIENTATION_RECORD_GRAVITY = 24        // Float x, y, z (m/s², device frame)
+    const val ORIENTATION_RECORD_LINEAR = 36         // Float x, y, z (m/s², device frame)
+
+    /** Direct channel ring layout: consecutive sensor events written cyclically by the HAL */
+    const val DIRECT_EVENT_BYTES = 104
+    const val DIRECT_EVENT_TYPE = 8          // Int, SensorInfo.SENSOR_TYPE_*
+    const val DIRECT_EVENT_COUNTER = 12      // Int, incremented per event and written last
+    const val DIRECT_EVENT_TIMESTAMP_NS = 16 // Long
+    const val DIRECT_EVENT_VALUES = 24       // Float x, y, z
+
     init {
         try {
             System.loadLibrary("nativesensor")
@@ -21,26 +49,72 @@ object NativeSensorBridge {
         }
     }
 
+    // Reused by the polled getters so a poll allocates no JNI arrays (each locked while in use)
+    private val accelScratch = FloatArray(4)
+    private val gyroScratch = FloatArray(4)
+    private val statsScratch = FloatArray(4)
+    private val metadataScratch = IntArray(6)
+    private val orientationScratch = FloatArray(11)
+    private val switchStatsScratch = LongArray(5)
+
     // Native method declarations
-    private external fun nativeInit()
+    private external fun nativeInit(
+        accelPeriodUs: Int,
+        accelBatchLatencyUs: Long,
+        gyroPeriodUs: Int,
+        gyroBatchLatencyUs: Long,
+        useDirectChannel: Boolean,
+        fusionAlgorithm: Int,
+        fusionGain: Float,
+        fusionIntegralGain: Float,
+        streamUncalibrated: Boolean
+    )
+    private external fun nativeFlush()
+    private external fun nativeIsDirectChannelActive(): Boolean
+    private external fun nativeGetDirectChannelBuffer(): ByteBuffer?
     private external fun nativeStop()
-    private external fun nativeGetAccelData(): FloatArray
-    private external fun nativeGetGyroData(): FloatArray
-    private external fun nativeGetStats(): FloatArray
-    private external fun nativeGetMetadata(): IntArray
-    private external fun nativeEnumerateSensors(): String
+    private external fun nativeGetAccelData(out: FloatArray)
+    private external fun nativeGetGyroData(out: FloatArray)
+    private external fun nativeGetStats(out: FloatArray)
+    private external fun nativeDrainImu(buffer: ByteBuffer): Int
+    private external fun nativeGetImuOverflowCount(): Long
+    private external fun nativeGetOrientation(out: FloatArray)
+    private external fun nativeDrainOrientation(buffer: ByteBuffer): Int
+    private external fun nativeGetOrientationOverflowCount(): Long
+    private external fun nativeGetMetadata(out: IntArray)
     private external fun nativeSwitchSensors(accelHandle: Int, gyroHandle: Int)
+    private external fun nativeGetSwitchStats(out: LongArray)
     private external fun nativeIsRunning(): Boolean
 
     /**
-     * Initialize and start IMU sensors at maximum hardware rate.
+     * Initialize and start IMU sensors, at maximum hardware rate and unbatched by default.
+     * @param config Per-sensor sampling period, hardware FIFO batching latency and
+     *        direct channel selection
      */
-    fun init() {
+    fun init(config: ImuStartOptions = ImuStartOptions()) {
         SensorLogger.imu.section("IMU Initialization")
-        SensorLogger.imu.info("Starting IMU sensors at maximum hardware rate")
+        SensorLogger.imu.info("Starting IMU sensors", mapOf(
+            "accelPeriodUs" to config.accel.samplingPeriodUs,
+            "accelBatchLatencyUs" to config.accel.maxBatchReportLatencyUs,
+            "gyroPeriodUs" to config.gyro.samplingPeriodUs,
+            "gyroBatchLatencyUs" to config.gyro.maxBatchReportLatencyUs,
+            "directChannel" to config.useDirectChannel,
+            "fusion" to config.fusion.algorithm.name,
+            "streamUncalibrated" to config.streamUncalibrated
+        ))
 
         logDiscoveredSensors()
-        nativeInit()
+        nativeInit(
+            config.accel.samplingPeriodUs,
+            config.accel.maxBatchReportLatencyUs,
+            config.gyro.samplingPeriodUs,
+            config.gyro.maxBatchReportLatencyUs,
+            config.useDirectChannel,
+            config.fusion.algorithm.ordinal,
+            config.fusion.gain,
+            config.fusion.mahonyIntegralGain,
+            config.streamUncalibrated
+        )
 
         // Note: Metadata will show actual values once sensor thread has initialized.
         // The actual sensor registration happens async in native layer.
@@ -58,6 +132,30 @@ object NativeSensorBridge {
         SensorLogger.imu.info("IMU sensors stopped")
     }
 
+    /**
+     * Deliver any samples buffered in the hardware FIFO now (no-op when unbatched).
+     */
+    @Suppress("unused")  // Part of public API
+    fun flush() {
+        nativeFlush()
+    }
+
+    /**
+     * Check if samples arrive through the shared-memory direct channel rather than the event queue.
+     */
+    @Suppress("unused")  // Part of public API
+    fun isDirectChannelActive(): Boolean = nativeIsDirectChannelActive()
+
+    /**
+     * Zero-copy read-only view of the direct channel ring, or null when not in direct mode.
+     * Events are [DIRECT_EVENT_BYTES] wide; a slot holds a new event once its
+     * [DIRECT_EVENT_COUNTER] value is one past the last one read. Re-read the counter after
+     * reading a slot to detect it being overwritten. Invalid once the IMU is stopped.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getDirectChannelBuffer(): ByteBuffer? =
+        nativeGetDirectChannelBuffer()?.asReadOnlyBuffer()?.order(ByteOrder.nativeOrder())
+
     /**
      * Check if sensors are currently running.
      */
@@ -68,13 +166,16 @@ object NativeSensorBridge {
      * @return ImuSample with x, y, z values in m/s² and timestamp
      */
     fun getAccelData(): ImuSample {
-        val data = nativeGetAccelData()
-        return ImuSample(
-            x = data.getOrElse(0) { 0f },
-            y = data.getOrElse(1) { 0f },
-            z = data.getOrElse(2) { 0f },
-            timestampMs = data.getOrElse(3) { 0f }
-        )
+        val data = accelScratch
+        synchronized(data) {
+            nativeGetAccelData(data)
+            return ImuSample(
+                x = data.getOrElse(0) { 0f },
+                y = data.getOrElse(1) { 0f },
+                z = data.getOrElse(2) { 0f },
+                timestampMs = data.getOrElse(3) { 0f }
+            )
+        }
     }
 
     /**
@@ -82,40 +183,131 @@ object NativeSensorBridge {
      * @return ImuSample with x, y, z values in rad/s and timestamp
      */
     fun getGyroData(): ImuSample {
-        val data = nativeGetGyroData()
-        return ImuSample(
-            x = data.getOrElse(0) { 0f },
-            y = data.getOrElse(1) { 0f },
-            z = data.getOrElse(2) { 0f },
-            timestampMs = data.getOrElse(3) { 0f }
-        )
+        val data = gyroScratch
+        synchronized(data) {
+            nativeGetGyroData(data)
+            return ImuSample(
+                x = data.getOrElse(0) { 0f },
+                y = data.getOrElse(1) { 0f },
+                z = data.getOrElse(2) { 0f },
+                timestampMs = data.getOrElse(3) { 0f }
+            )
+        }
     }
 
+    /**
+     * Get the latest fused orientation (updated at gyroscope rate on the sensor thread).
+     * timestampMs is 0 until the first estimate.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getOrientation(): OrientationSample {
+        val data = orientationScratch
+        synchronized(data) {
+            nativeGetOrientation(data)
+            return OrientationSample(
+                qw = data.getOrElse(0) { 1f },
+                qx = data.getOrElse(1) { 0f },
+                qy = data.getOrElse(2) { 0f },
+                qz = data.getOrElse(3) { 0f },
+                gravityX = data.getOrElse(4) { 0f },
+                gravityY = data.getOrElse(5) { 0f },
+                gravityZ = data.getOrElse(6) { 0f },
+                linearX = data.getOrElse(7) { 0f },
+                linearY = data.getOrElse(8) { 0f },
+                linearZ = data.getOrElse(9) { 0f },
+                timestampMs = data.getOrElse(10) { 0f }
+            )
+        }
+    }
+
+    /**
+     * Allocate a reusable buffer for [drainOrientation].
+     * @param maxRecords Records the buffer can hold per drain
+     */
+    @Suppress("unused")  // Part of public API
+    fun allocateOrientationBuffer(maxRecords: Int): ByteBuffer =
+        ByteBuffer.allocateDirect(maxRecords * ORIENTATION_RECORD_BYTES).order(ByteOrder.nativeOrder())
+
+    /**
+     * Copy every orientation estimated since the previous call into [buffer] (one per gyroscope
+     * sample, in timestamp order), one JNI call per poll. Records are [ORIENTATION_RECORD_BYTES]
+     * wide; estimates that do not fit stay queued for the next call.
+     * @param buffer Direct buffer from [allocateOrientationBuffer]
+     * @return Number of records written
+     */
+    @Suppress("unused")  // Part of public API
+    fun drainOrientation(buffer: ByteBuffer): Int {
+        require(buffer.isDirect) { "drainOrientation requires a direct ByteBuffer" }
+        return nativeDrainOrientation(buffer)
+    }
+
+    /**
+     * Orientation estimates lost because [drainOrientation] was not called often enough
+     * (cumulative).
+     */
+    @Suppress("unused")  // Part of public API
+    fun getOrientationOverflowCount(): Long = nativeGetOrientationOverflowCount()
+
+    /**
+     * Allocate a reusable buffer for [drainImu].
+     * @param maxRecords Records the buffer can hold per drain
+     */
+    fun allocateImuBuffer(maxRecords: Int): ByteBuffer =
+        ByteBuffer.allocateDirect(maxRecords * IMU_RECORD_BYTES).order(ByteOrder.nativeOrder())
+
+    /**
+     * Copy every IMU sample recorded since the previous call into [buffer], one JNI call per poll.
+     * Records are [IMU_RECORD_BYTES] wide: accelerometer samples first, then gyroscope, each in
+     * timestamp order, then any uncalibrated companion samples. Read them with absolute gets, e.g.
+     * `buffer.getLong(i * IMU_RECORD_BYTES + IMU_RECORD_TIMESTAMP_NS)`.
+     * Samples that do not fit stay queued for the next call.
+     * @param buffer Direct buffer from [allocateImuBuffer]
+     * @return Number of records written
+     */
+    fun drainImu(buffer: ByteBuffer): Int {
+        require(buffer.isDirect) { "drainImu requires a direct ByteBuffer" }
+        return nativeDrainImu(buffer)
+    }
+
+    /**
+     * Samples lost because [drainImu] was not called often enough (cumulative).
+     */
+    @Suppress("unused")  // Part of public API
+    fun getImuOverflowCount(): Long = nativeGetImuOverflowCount()
+
     /**
      * Get IMU statistics (resets measurement window).
      * @return ImuStats with frequency and latency measurements
      */
     fun getStats(): ImuStats {
-        val data = nativeGetStats()
-        return ImuStats(
-            accelFrequencyHz = data.getOrElse(0) { 0f },
-            accelLatencyMs = data.getOrElse(1) { 0f },
-            gyroFrequencyHz = data.getOrElse(2) { 0f },
-            gyroLatencyMs = data.getOrElse(3) { 0f }
-        )
+        val data = statsScratch
+        synchronized(data) {
+            nativeGetStats(data)
+            return ImuStats(
+                accelFrequencyHz = data.getOrElse(0) { 0f },
+                accelLatencyMs = data.getOrElse(1) { 0f },
+                gyroFrequencyHz = data.getOrElse(2) { 0f },
+                gyroLatencyMs = data.getOrElse(3) { 0f }
+            )
+        }
     }
 
     /**
      * Get current sensor metadata.
      */
     fun getMetadata(): ImuMetadata {
-        val data = nativeGetMetadata()
-        return ImuMetadata(
-            accelMinDelayUs = data.getOrElse(0) { 0 },
-            accelFifoReserved = data.getOrElse(1) { 0 },
-            gyroMinDelayUs = data.getOrElse(2) { 0 },
-            gyroFifoReserved = data.getOrElse(3) { 0 }
-        )
+        val data = metadataScratch
+        synchronized(data) {
+            nativeGetMetadata(data)
+            return ImuMetadata(
+                accelMinDelayUs = data.getOrElse(0) { 0 },
+                accelFifoReserved = data.getOrElse(1) { 0 },
+                gyroMinDelayUs = data.getOrElse(2) { 0 },
+                gyroFifoReserved = data.getOrElse(3) { 0 },
+                accelBatchLatencyUs = data.getOrElse(4) { 0 },
+                gyroBatchLatencyUs = data.getOrElse(5) { 0 }
+            )
+        }
     }
 
     /**
@@ -123,38 +315,16 @@ object NativeSensorBridge {
      * @return List of available accelerometers and gyroscopes
      */
     fun enumerateSensors(): List<SensorInfo> {
-        val rawData = nativeEnumerateSensors()
-        if (rawData.isEmpty()) {
-            log.warn("No sensor data returned from native layer")
-            return emptyList()
-        }
-
-        return rawData.trim().split("\n").mapNotNull { line ->
-            val parts = line.split("|")
-            if (parts.size == 7) {
-                try {
-                    SensorInfo(
-                        handle = parts[0].toInt(),
-                        type = parts[1].toInt(),
-                        name = parts[2],
-                        vendor = parts[3],
-                        minDelayUs = parts[4].toInt(),
-                        maxFrequencyHz = parts[5].toFloat(),
-                        fifoReserved = parts[6].toInt()
-                    )
-                } catch (e: Exception) {
-                    log.warn("Failed to parse sensor info: $line", throwable = e)
-                    null
-                }
-            } else {
-                log.debug("Skipping malformed sensor line", mapOf("line" to line, "parts" to parts.size))
-                null
+        return DeviceRegistry.snapshot().sensors.also { sensors ->
+            if (sensors.isEmpty()) {
+                log.warn("No sensor data returned from native layer")
             }
         }
     }
 
     /**
-     * Switch to specific sensors by handle.
+     * Switch to specific sensors by handle. While running, only the sensors that change are
+     * swapped on the live sensor queue; returns once the switch has been applied.
      * @param accelHandle Accelerometer handle from enumeration (-1 for default)
      * @param gyroHandle Gyroscope handle from enumeration (-1 for default)
      */
@@ -166,6 +336,24 @@ object NativeSensorBridge {
         nativeSwitchSensors(accelHandle, gyroHandle)
     }
 
+    /**
+     * Get in-place switch counters and the sample gaps they caused.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getSwitchStats(): ImuSwitchStats {
+        val data = switchStatsScratch
+        synchronized(data) {
+            nativeGetSwitchStats(data)
+            return ImuSwitchStats(
+                switchCount = data.getOrElse(0) { 0L },
+                lastAccelGapNs = data.getOrElse(1) { 0L },
+                lastGyroGapNs = data.getOrElse(2) { 0L },
+                maxGapNs = data.getOrElse(3) { 0L },
+                lastReconfigureNs = data.getOrElse(4) { 0L }
+            )
+        }
+    }
+
     /**
      * Get accelerometers from enumerated sensors.
      */
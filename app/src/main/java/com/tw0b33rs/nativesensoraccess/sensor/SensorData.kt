@@ -10,7 +10,8 @@ data class SensorInfo(
     val vendor: String,
     val minDelayUs: Int,
     val maxFrequencyHz: Float,
-    val fifoReserved: Int
+    val fifoReserved: Int,
+    val directReportRateLevel: Int = 0
 ) {
     val isAccelerometer: Boolean
         get() = type == SENSOR_TYPE_ACCELEROMETER || type == SENSOR_TYPE_ACCELEROMETER_UNCALIBRATED
@@ -21,6 +22,10 @@ data class SensorInfo(
     val isUncalibrated: Boolean
         get() = type == SENSOR_TYPE_ACCELEROMETER_UNCALIBRATED || type == SENSOR_TYPE_GYROSCOPE_UNCALIBRATED
 
+    /** Sensor can report into a shared-memory direct channel */
+    val supportsDirectChannel: Boolean
+        get() = directReportRateLevel > 0
+
     companion object {
         const val SENSOR_TYPE_ACCELEROMETER = 1
         const val SENSOR_TYPE_GYROSCOPE = 4
@@ -56,6 +61,92 @@ data class ImuMetadata(
     val accelMinDelayUs: Int,
     val accelFifoReserved: Int,
     val gyroMinDelayUs: Int,
-    val gyroFifoReserved: Int
+    val gyroFifoReserved: Int,
+    val accelBatchLatencyUs: Int = 0,
+    val gyroBatchLatencyUs: Int = 0
+)
+
+/**
+ * In-place sensor switch statistics, cumulative since the IMU started.
+ * A gap is the hardware-timestamp distance between the last sample of the replaced sensor
+ * and the first sample of its replacement (0 until one has been measured).
+ * @param lastReconfigureNs Time the native side spent disabling/enabling sensors
+ */
+data class ImuSwitchStats(
+    val switchCount: Long,
+    val lastAccelGapNs: Long,
+    val lastGyroGapNs: Long,
+    val maxGapNs: Long,
+    val lastReconfigureNs: Long
+)
+
+/**
+ * Sampling and hardware FIFO batching request for one IMU sensor.
+ * @param samplingPeriodUs Sampling period in microseconds (0 = maximum hardware rate)
+ * @param maxBatchReportLatencyUs Max time events may wait in the hardware FIFO
+ *        (0 = deliver immediately). Clamped to what the sensor's reserved FIFO can hold.
+ */
+data class ImuSensorConfig(
+    val samplingPeriodUs: Int = 0,
+    val maxBatchReportLatencyUs: Long = 0
+)
+
+/**
+ * Native orientation estimator run on the sensor thread.
+ * Ordinals match C++ FusionAlgorithm; [Disabled] skips fusion.
+ */
+enum class FusionAlgorithm {
+    Madgwick,
+    Mahony,
+    Disabled
+}
+
+/**
+ * Sensor fusion configuration.
+ * @param gain Madgwick beta (rad/s) or Mahony proportional gain; higher trusts the
+ *        accelerometer more. 0 uses the native default.
+ * @param mahonyIntegralGain Mahony gyro bias integral gain (0 = off)
+ */
+data class FusionOptions(
+    val algorithm: FusionAlgorithm = FusionAlgorithm.Madgwick,
+    val gain: Float = 0f,
+    val mahonyIntegralGain: Float = 0f
+)
+
+/**
+ * Fused device orientation at one gyroscope sample.
+ * The quaternion rotates device coordinates into a Z-up world frame (yaw relative to the
+ * heading at start). Gravity and linear acceleration are in device coordinates, m/s².
+ */
+data class OrientationSample(
+    val qw: Float,
+    val qx: Float,
+    val qy: Float,
+    val qz: Float,
+    val gravityX: Float,
+    val gravityY: Float,
+    val gravityZ: Float,
+    val linearX: Float,
+    val linearY: Float,
+    val linearZ: Float,
+    val timestampMs: Float
+)
+
+/**
+ * IMU start configuration. Batching keeps every hardware-timestamped sample while
+ * letting the application processor sleep between FIFO reports.
+ * @param useDirectChannel Have the HAL write into a shared-memory ring instead of the event
+ *        queue (no sensor thread); falls back to the event queue when a sensor lacks support
+ * @param fusion Orientation estimation on the sensor thread, read with
+ *        NativeSensorBridge.getOrientation / drainOrientation
+ * @param streamUncalibrated Also stream the uncalibrated variant of each selected calibrated
+ *        sensor (event queue only); its drainImu records carry the *_UNCALIBRATED sensor type
+ */
+data class ImuStartOptions(
+    val accel: ImuSensorConfig = ImuSensorConfig(),
+    val gyro: ImuSensorConfig = ImuSensorConfig(),
+    val useDirectChannel: Boolean = false,
+    val fusion: FusionOptions = FusionOptions(),
+    val streamUncalibrated: Boolean = false
 )
 
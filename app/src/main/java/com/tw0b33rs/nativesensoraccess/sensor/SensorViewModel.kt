@@ -11,11 +11,9 @@ import com.tw0b33rs.nativesensoraccess.streaming.StreamingState
 import com.tw0b33rs.nativesensoraccess.streaming.StreamingStateListener
 import com.tw0b33rs.nativesensoraccess.streaming.WebRTCManager
 import kotlinx.coroutines.Dispatchers
-import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
-import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
 import org.webrtc.VideoTrack
@@ -120,7 +118,7 @@ class SensorViewModel : ViewModel() {
     private val _uiState = MutableStateFlow(SensorUiState())
     val uiState: StateFlow<SensorUiState> = _uiState.asStateFlow()
 
-    private var isPolling = false
+    private var isReceivingUpdates = false
     private var perfLogCounter = 0
     private var activeCameraSurface: Surface? = null
 
@@ -174,6 +172,8 @@ class SensorViewModel : ViewModel() {
         viewModelScope.launch(Dispatchers.IO) {
             log.info("Starting sensor system (async)")
 
+            // Keep IMU delivery ahead of the renderer on contended cores
+            ThreadScheduling.setConfig(ThreadRole.Imu, ThreadSchedulingConfig.URGENT)
             NativeSensorBridge.init()
             val accelerometers = NativeSensorBridge.getAccelerometers()
             val gyroscopes = NativeSensorBridge.getGyroscopes()
@@ -192,8 +192,8 @@ class SensorViewModel : ViewModel() {
                     isImuRunning = true
                 )
 
-                // Start polling for UI updates
-                startPolling()
+                // Native side pushes IMU and camera state from here on
+                startStateUpdates()
             }
         }
     }
@@ -203,8 +203,9 @@ class SensorViewModel : ViewModel() {
      */
     fun stopSensors() {
         log.info("Stopping sensor system")
-        isPolling = false
+        isReceivingUpdates = false
         viewModelScope.launch(Dispatchers.IO) {
+            StateUpdates.stop()
             NativeSensorBridge.stop()
             stopCameraPreview()
         }
@@ -227,7 +228,7 @@ class SensorViewModel : ViewModel() {
                     selectedGyroHandle = gyroHandle
                 )
             }
-            delay(SENSOR_SWITCH_DELAY_MS)
+            // The native switch returns once the new sensors are registered
             updateMetadata()
         }
     }
@@ -565,80 +566,59 @@ class SensorViewModel : ViewModel() {
     }
 
     // ==========================================================================
-    // Polling & Updates
+    // State Updates
     // ==========================================================================
 
-    private fun startPolling() {
-        if (isPolling) return
-        isPolling = true
+    private fun startStateUpdates() {
+        if (isReceivingUpdates) return
+        isReceivingUpdates = true
         perfLogCounter = 0
 
-        viewModelScope.launch(Dispatchers.Default) {
-            while (isActive && isPolling) {
-                val sensorData = fetchSensorData()
+        // Called on the native notifier thread, only when something changed
+        StateUpdates.start(maxRateHz = 1000f / UI_UPDATE_INTERVAL_MS) { update ->
+            viewModelScope.launch(Dispatchers.Main) { applyStateUpdate(update) }
+        }
+    }
 
-                // Update UI state on Main thread
-                withContext(Dispatchers.Main) {
-                    _uiState.value = _uiState.value.copy(
-                        accelSample = sensorData.accel,
-                        gyroSample = sensorData.gyro,
-                        stats = sensorData.stats,
-                        metadata = sensorData.metadata,
-                        isImuRunning = sensorData.isRunning
-                    )
-                }
+    private fun applyStateUpdate(update: SensorStateUpdate) {
+        // Updates already queued when the sensors were stopped
+        if (!isReceivingUpdates) return
 
-                perfLogCounter++
-                if (perfLogCounter >= PERF_LOG_INTERVAL) {
-                    perfLogCounter = 0
-                    perfLog.logPerformanceStats("Accelerometer", sensorData.stats.accelFrequencyHz, sensorData.stats.accelLatencyMs)
-                    perfLog.logPerformanceStats("Gyroscope", sensorData.stats.gyroFrequencyHz, sensorData.stats.gyroLatencyMs)
-                }
+        _uiState.value = _uiState.value.copy(
+            accelSample = update.accel,
+            gyroSample = update.gyro,
+            stats = update.stats,
+            metadata = update.metadata,
+            isImuRunning = update.isImuRunning
+        )
 
-                updateCameraStats()
-                delay(UI_UPDATE_INTERVAL_MS)
+        if (update.hasChanged(StateUpdates.CHANGED_IMU_STATS)) {
+            perfLogCounter++
+            if (perfLogCounter >= PERF_LOG_INTERVAL) {
+                perfLogCounter = 0
+                perfLog.logPerformanceStats("Accelerometer", update.stats.accelFrequencyHz, update.stats.accelLatencyMs)
+                perfLog.logPerformanceStats("Gyroscope", update.stats.gyroFrequencyHz, update.stats.gyroLatencyMs)
             }
         }
-    }
 
-    private data class SensorDataSnapshot(
-        val accel: ImuSample,
-        val gyro: ImuSample,
-        val stats: ImuStats,
-        val metadata: ImuMetadata,
-        val isRunning: Boolean
-    )
-
-    private fun fetchSensorData(): SensorDataSnapshot {
-        return SensorDataSnapshot(
-            accel = NativeSensorBridge.getAccelData(),
-            gyro = NativeSensorBridge.getGyroData(),
-            stats = NativeSensorBridge.getStats(),
-            metadata = NativeSensorBridge.getMetadata(),
-            isRunning = NativeSensorBridge.isRunning()
-        )
+        if (update.activeCameraStreams > 0 && update.hasChanged(StateUpdates.CHANGED_CAMERA_STATS)) {
+            updateCameraStats(update.cameraStats)
+        }
     }
 
-    private suspend fun updateCameraStats() {
-        if (!CameraBridge.isStreaming()) return
-
-        val stats = CameraBridge.getStats()
-        val currentDest = _uiState.value.currentDestination
-
-        withContext(Dispatchers.Main) {
-            _uiState.value = when (currentDest) {
-                NavigationDestination.PassthroughCameras -> _uiState.value.copy(
-                    passthroughCluster = _uiState.value.passthroughCluster.copy(stats = stats)
-                )
-                NavigationDestination.Avatar -> _uiState.value.copy(
-                    trackingCluster = _uiState.value.trackingCluster.copy(stats = stats)
-                )
-                NavigationDestination.EyeTrackingCameras -> _uiState.value.copy(
-                    eyeTrackingCluster = _uiState.value.eyeTrackingCluster.copy(stats = stats)
-                )
-                NavigationDestination.ImuSensors,
-                NavigationDestination.Streaming -> _uiState.value
-            }
+    private fun updateCameraStats(stats: CameraStats) {
+        _uiState.value = when (_uiState.value.currentDestination) {
+            NavigationDestination.PassthroughCameras -> _uiState.value.copy(
+                passthroughCluster = _uiState.value.passthroughCluster.copy(stats = stats)
+            )
+            NavigationDestination.Avatar -> _uiState.value.copy(
+                trackingCluster = _uiState.value.trackingCluster.copy(stats = stats)
+            )
+            NavigationDestination.EyeTrackingCameras -> _uiState.value.copy(
+                eyeTrackingCluster = _uiState.value.eyeTrackingCluster.copy(stats = stats)
+            )
+            NavigationDestination.ImuSensors,
+            NavigationDestination.Streaming -> _uiState.value
         }
     }
 
@@ -660,6 +640,5 @@ class SensorViewModel : ViewModel() {
     companion object {
         private const val UI_UPDATE_INTERVAL_MS = 100L
         private const val PERF_LOG_INTERVAL = 100
-        private const val SENSOR_SWITCH_DELAY_MS = 100L
     }
 }
@@ -0,0 +1,192 @@
+package com.tw0b33rs.nativesensoraccess.sensor
+
+import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * One push from the native state notifier.
+ * Every section is current; [changedMask] names the ones that differ from the previous update.
+ */
+data class SensorStateUpdate(
+    val sequence: Long,
+    val changedMask: Int,
+    val accel: ImuSample,
+    val gyro: ImuSample,
+    val stats: ImuStats,
+    val metadata: ImuMetadata,
+    val isImuRunning: Boolean,
+    val activeCameraStreams: Int,
+    val cameraStats: CameraStats
+) {
+    /** True if the section flagged by [flag] (a StateUpdates.CHANGED_* value) changed */
+    fun hasChanged(flag: Int): Boolean = (changedMask and flag) != 0
+}
+
+/**
+ * Listener for [StateUpdates.start], called on the native notifier thread.
+ */
+fun interface SensorStateListener {
+    fun onStateUpdate(update: SensorStateUpdate)
+}
+
+/**
+ * Called from C++ via JNI once new state has been written to the registered buffer.
+ */
+fun interface NativeStateCallback {
+    /**
+     * @param changedMask StateUpdates.CHANGED_* flags of the sections that changed
+     */
+    fun onStateChanged(changedMask: Int)
+}
+
+/**
+ * JNI bridge to the native state notifier, which replaces polling the IMU and camera getters
+ * from the UI. A native thread coalesces IMU batches and camera activity, collects at most
+ * maxRateHz times per second, and pushes a packed snapshot (C++ state_snapshot_format.h) with
+ * one upcall only when something changed. While sensors and previews are stopped it sleeps
+ * and delivers nothing.
+ */
+object StateUpdates {
+
+    private val log = SensorLogger.Logger("NativeSensor.Notify")
+
+    /** StateSnapshot::changedMask flags */
+    const val CHANGED_IMU_SAMPLES = 1 shl 0
+    const val CHANGED_IMU_STATS = 1 shl 1
+    const val CHANGED_IMU_METADATA = 1 shl 2
+    const val CHANGED_CAMERA_STATS = 1 shl 3
+
+    /** Default update rate, matching the former UI polling interval */
+    const val DEFAULT_MAX_RATE_HZ = 10f
+
+    private const val VERSION = 1
+    private const val SNAPSHOT_BYTES = 112
+
+    init {
+        try {
+            System.loadLibrary("nativesensor")
+            log.info("State notifier native library ready")
+        } catch (e: UnsatisfiedLinkError) {
+            log.error("Failed to load native library for state updates", throwable = e)
+        }
+    }
+
+    private val lock = Any()
+    private val buffer: ByteBuffer =
+        ByteBuffer.allocateDirect(SNAPSHOT_BYTES).order(ByteOrder.nativeOrder())
+    @Volatile
+    private var listener: SensorStateListener? = null
+
+    // Reused by getStats (locked while in use)
+    private val statsScratch = LongArray(3)
+
+    // Native method declarations
+    private external fun nativeStart(
+        buffer: ByteBuffer,
+        maxRateHz: Float,
+        callback: NativeStateCallback
+    ): Boolean
+    private external fun nativeStop()
+    private external fun nativeSetMaxRate(maxRateHz: Float)
+    private external fun nativeGetStats(out: LongArray)
+
+    private val nativeCallback = NativeStateCallback { changedMask ->
+        val update = parse(changedMask) ?: return@NativeStateCallback
+        listener?.onStateUpdate(update)
+    }
+
+    /**
+     * Start pushing state to [listener]; the first update carries every section.
+     * @param maxRateHz Upper bound on updates per second (clamped natively to 1–240)
+     * @return false if updates are already running or could not be started
+     */
+    fun start(
+        maxRateHz: Float = DEFAULT_MAX_RATE_HZ,
+        listener: SensorStateListener
+    ): Boolean = synchronized(lock) {
+        this.listener = listener
+        val started = nativeStart(buffer, maxRateHz, nativeCallback)
+        if (started) {
+            log.info("State updates started", mapOf("maxRateHz" to maxRateHz))
+        } else {
+            this.listener = null
+            log.warn("State updates not started")
+        }
+        started
+    }
+
+    /**
+     * Stop updates. Once this returns the listener is not called again.
+     */
+    fun stop() {
+        synchronized(lock) {
+            nativeStop()
+            listener = null
+        }
+    }
+
+    /**
+     * Change the update rate while running.
+     */
+    @Suppress("unused")  // Part of public API
+    fun setMaxRate(maxRateHz: Float) {
+        nativeSetMaxRate(maxRateHz)
+    }
+
+    /**
+     * Notifier counters: posts (including coalesced ones), eventfd wakeups and collections.
+     * Updates delivered are at most the collections.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getStats(): Triple<Long, Long, Long> {
+        val data = statsScratch
+        synchronized(data) {
+            nativeGetStats(data)
+            return Triple(data.getOrElse(0) { 0L }, data.getOrElse(1) { 0L }, data.getOrElse(2) { 0L })
+        }
+    }
+
+    /** Runs on the notifier thread before native code touches the buffer again */
+    private fun parse(changedMask: Int): SensorStateUpdate? {
+        val b = buffer
+        if (b.getInt(0) != VERSION) {
+            log.warn("Unexpected state snapshot version", mapOf("version" to b.getInt(0)))
+            return null
+        }
+        fun sample(offset: Int) = ImuSample(
+            x = b.getFloat(offset),
+            y = b.getFloat(offset + 4),
+            z = b.getFloat(offset + 8),
+            timestampMs = b.getFloat(offset + 12)
+        )
+        return SensorStateUpdate(
+            sequence = b.getLong(8),
+            changedMask = changedMask,
+            accel = sample(16),
+            gyro = sample(32),
+            stats = ImuStats(
+                accelFrequencyHz = b.getFloat(48),
+                accelLatencyMs = b.getFloat(52),
+                gyroFrequencyHz = b.getFloat(56),
+                gyroLatencyMs = b.getFloat(60)
+            ),
+            metadata = ImuMetadata(
+                accelMinDelayUs = b.getInt(64),
+                accelFifoReserved = b.getInt(68),
+                gyroMinDelayUs = b.getInt(72),
+                gyroFifoReserved = b.getInt(76),
+                accelBatchLatencyUs = b.getInt(80),
+                gyroBatchLatencyUs = b.getInt(84)
+            ),
+            isImuRunning = b.getInt(88) != 0,
+            activeCameraStreams = b.getInt(92),
+            cameraStats = CameraStats(
+                frameRateHz = b.getFloat(96),
+                latencyMs = b.getFloat(100),
+                frameCount = b.getFloat(104).toLong(),
+                droppedFrames = b.getFloat(108).toLong()
+            )
+        )
+    }
+}
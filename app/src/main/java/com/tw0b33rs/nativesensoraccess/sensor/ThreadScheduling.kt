@@ -0,0 +1,156 @@
+package com.tw0b33rs.nativesensoraccess.sensor
+
+import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
+
+/**
+ * Native worker thread roles. Ordinals match the JNI layer.
+ */
+enum class ThreadRole {
+    /** ImuManager sensor thread (applied from the next [NativeSensorBridge.init] and live) */
+    Imu,
+    /** Capture dispatch threads feeding NativeFrameCallback and the recorder */
+    FrameDispatch,
+    /** Hardware encoder output thread */
+    Encoder,
+    /** State notifier and session replay threads */
+    Background;
+
+    companion object {
+        fun fromValue(value: Int): ThreadRole = entries.getOrElse(value) { Background }
+    }
+}
+
+/**
+ * Scheduling for the threads of one [ThreadRole].
+ * @property niceValue -20 (most urgent) to 19; used when [realtime] is refused
+ * @property realtime Request SCHED_FIFO (most devices refuse it to apps)
+ * @property realtimePriority SCHED_FIFO priority, 1–99
+ * @property cpuMask Bit n allows CPU n; 0 keeps the inherited affinity
+ */
+data class ThreadSchedulingConfig(
+    val niceValue: Int = 0,
+    val realtime: Boolean = false,
+    val realtimePriority: Int = 1,
+    val cpuMask: Long = 0L
+) {
+    companion object {
+        /** Latency-critical sensor thread: highest priority an app can normally get */
+        val URGENT = ThreadSchedulingConfig(niceValue = -19, realtime = true, realtimePriority = 2)
+    }
+}
+
+/**
+ * Scheduler counters of one native worker thread.
+ * @property policy SCHED_* (0 = OTHER, 1 = FIFO); -1 if the policy could not be read
+ * @property runQueueWaitNs Time spent runnable but waiting for a CPU (scheduling latency)
+ */
+data class ThreadSchedulingStats(
+    val role: ThreadRole,
+    val tid: Int,
+    val policy: Int,
+    val niceValue: Int,
+    val runTimeNs: Long,
+    val runQueueWaitNs: Long,
+    val timeslices: Long
+) {
+    /** Mean scheduling latency per wakeup */
+    val meanRunQueueWaitUs: Float
+        get() = if (timeslices > 0) runQueueWaitNs.toFloat() / timeslices / 1000f else 0f
+}
+
+/**
+ * JNI bridge for native thread priority, SCHED_FIFO, CPU affinity and the APerformanceHint
+ * session of the frame pipeline.
+ */
+object ThreadScheduling {
+
+    private val log = SensorLogger.Logger("NativeSensor.Sched")
+
+    /** Failure flags returned by [setConfig] */
+    const val FAILED_NICE = 1 shl 0
+    const val FAILED_REALTIME = 1 shl 1
+    const val FAILED_AFFINITY = 1 shl 2
+
+    private const val FIELDS_PER_THREAD = 7
+    private const val MAX_THREADS = 16
+
+    init {
+        try {
+            System.loadLibrary("nativesensor")
+            log.info("Thread scheduling native library ready")
+        } catch (e: UnsatisfiedLinkError) {
+            log.error("Failed to load native library for thread scheduling", throwable = e)
+        }
+    }
+
+    // Reused by getThreadStats (locked while in use)
+    private val statsScratch = LongArray(FIELDS_PER_THREAD * MAX_THREADS)
+
+    // Native method declarations
+    private external fun nativeSetConfig(
+        role: Int,
+        niceValue: Int,
+        realtime: Boolean,
+        realtimePriority: Int,
+        cpuMask: Long
+    ): Int
+    private external fun nativeSetFrameWorkTarget(targetWorkDurationNs: Long): Boolean
+    private external fun nativeGetThreadStats(out: LongArray): Int
+
+    /**
+     * Set the scheduling of a role's threads, applied to running threads now and to threads
+     * started later.
+     * @return FAILED_* flags for parts the kernel refused (0 = fully applied).
+     *         SCHED_FIFO refusal falls back to [ThreadSchedulingConfig.niceValue].
+     */
+    fun setConfig(role: ThreadRole, config: ThreadSchedulingConfig): Int {
+        val failed = nativeSetConfig(
+            role.ordinal,
+            config.niceValue,
+            config.realtime,
+            config.realtimePriority,
+            config.cpuMask
+        )
+        log.info("Thread scheduling set", mapOf(
+            "role" to role.name,
+            "nice" to config.niceValue,
+            "realtime" to config.realtime,
+            "cpuMask" to "0x" + config.cpuMask.toString(16),
+            "failed" to failed
+        ))
+        return failed
+    }
+
+    /**
+     * Open an APerformanceHint session over the dispatch and encoder threads, reporting one
+     * unit of work per delivered frame (e.g. 33_333_333 ns at 30 fps); 0 closes it.
+     * @return true if a session is open (it opens once a frame pipeline thread runs)
+     */
+    @Suppress("unused")  // Part of public API
+    fun setFrameWorkTarget(targetWorkDurationNs: Long): Boolean =
+        nativeSetFrameWorkTarget(targetWorkDurationNs)
+
+    /**
+     * Scheduler counters (including observed scheduling latency) of every running native
+     * worker thread.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getThreadStats(): List<ThreadSchedulingStats> {
+        val data = statsScratch
+        synchronized(data) {
+            val count = nativeGetThreadStats(data)
+            return List(count) { i ->
+                val base = i * FIELDS_PER_THREAD
+                ThreadSchedulingStats(
+                    role = ThreadRole.fromValue(data[base].toInt()),
+                    tid = data[base + 1].toInt(),
+                    policy = data[base + 2].toInt(),
+                    niceValue = data[base + 3].toInt(),
+                    runTimeNs = data[base + 4],
+                    runQueueWaitNs = data[base + 5],
+                    timeslices = data[base + 6]
+                )
+            }
+        }
+    }
+}
@@ -1,6 +1,95 @@
 package com.tw0b33rs.nativesensoraccess.streaming
 
+import android.hardware.HardwareBuffer
 import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
+import com.tw0b33rs.nativesensoraccess.sensor.FrameLatencySnapshot
+import java.nio.ByteBuffer
+
+/**
+ * Packed YUV layouts the native layer can deliver, matching C++ YuvOutputFormat.
+ */
+enum class FrameFormat(val value: Int) {
+    I420(0),
+    NV12(1),
+    /** Luma plane only (width * height bytes), e.g. for monochrome IR eye-tracking cameras */
+    Y8(2)
+}
+
+/**
+ * What the native dispatch thread discards when the frame consumer falls behind,
+ * matching C++ FrameDropPolicy.
+ */
+enum class FrameDropPolicy(val value: Int) {
+    /** Deliver the most recent frame, discarding stale queued ones */
+    DROP_OLDEST(0),
+    /** Deliver every queued frame in order, discarding new arrivals while full */
+    DROP_NEWEST(1)
+}
+
+/**
+ * Hardware video codecs for the native encoder, matching C++ VideoCodec.
+ */
+enum class VideoCodec(val value: Int) {
+    H264(0),
+    HEVC(1)
+}
+
+/**
+ * Native hardware encoder statistics.
+ * Rates cover the window since the previous call; latencies run from start of exposure to
+ * the encoded packet leaving the codec.
+ */
+data class NativeEncoderStats(
+    val packets: Long,
+    val keyFrames: Long,
+    val bytes: Long,
+    val bitrateKbps: Float,
+    val frameRateHz: Float,
+    val latencyP50Ms: Float,
+    val latencyP95Ms: Float,
+    val latencyP99Ms: Float
+)
+
+/**
+ * Receives encoded H.264/HEVC access units (Annex-B) from the native hardware encoder.
+ * Invoked on the native encoder's output thread.
+ */
+interface NativeEncodedPacketCallback {
+    companion object {
+        /** IDR / sync frame */
+        const val FLAG_KEY_FRAME = 1
+        /** Parameter sets only (SPS/PPS, plus VPS for HEVC), no picture data */
+        const val FLAG_CODEC_CONFIG = 2
+    }
+
+    /**
+     * @param data Direct buffer aliasing the codec's output; only valid until this returns
+     * @param timestampNs Sensor timestamp of the source frame
+     * @param flags [FLAG_KEY_FRAME] and/or [FLAG_CODEC_CONFIG]
+     */
+    fun onEncodedPacket(data: ByteBuffer, timestampNs: Long, flags: Int)
+}
+
+/**
+ * Frame capture statistics including native frame buffer pool and dispatch queue occupancy.
+ * @property bufferPoolInUse Pooled frames the consumer holds; in hardware buffer mode, frames
+ *           not yet passed to [StreamingBridge.releaseHardwareBuffer]
+ * @property decimatedFrames Frames discarded by the [StreamingBridge.setCaptureTarget] frame
+ *           rate cap before any conversion
+ * @property scaleFactor Current native downscale (1, 2 or 4) chosen from the target bitrate
+ */
+data class CaptureStats(
+    val frameRateHz: Float,
+    val latencyMs: Float,
+    val frameCount: Long,
+    val droppedFrames: Long,
+    val bufferPoolCapacity: Int,
+    val bufferPoolInUse: Int,
+    val bufferPoolStarvations: Long,
+    val dispatchQueueDepth: Int,
+    val decimatedFrames: Long,
+    val scaleFactor: Int
+)
 
 /**
  * Callback interface for receiving raw camera frames from native layer.
@@ -9,12 +98,36 @@ import com.tw0b33rs.nativesensoraccess.logging.SensorLogger
 interface NativeFrameCallback {
     /**
      * Called when a new frame is available from the native camera.
-     * @param data I420 YUV frame data
+     * Invoked on a dedicated native dispatch thread, never the camera's image reader thread.
+     * @param data Tightly packed YUV frame data in the requested [FrameFormat] (I420 by default)
      * @param width Frame width in pixels
      * @param height Frame height in pixels
      * @param timestampNs Hardware timestamp in nanoseconds
      */
     fun onFrame(data: ByteArray, width: Int, height: Int, timestampNs: Long)
+
+    /**
+     * Called when a new frame is available in hardware buffer mode (no CPU copy).
+     * Invoked on the camera's image reader thread. The camera does not write the buffer again
+     * until [StreamingBridge.releaseHardwareBuffer] is called with [frameId], so it may be
+     * consumed asynchronously (GPU import, MediaCodec input). Every frame must be released;
+     * while the consumer holds all it may (the reader depth minus one) new frames are dropped.
+     * @param buffer GPU-resident frame in the camera's private format; close it when done
+     * @param width Frame width in pixels
+     * @param height Frame height in pixels
+     * @param timestampNs Hardware timestamp in nanoseconds
+     * @param frameId Release token for this frame
+     */
+    fun onHardwareBuffer(
+        buffer: HardwareBuffer,
+        width: Int,
+        height: Int,
+        timestampNs: Long,
+        frameId: Long
+    ) {
+        buffer.close()
+        StreamingBridge.releaseHardwareBuffer(frameId)
+    }
 }
 
 /**
@@ -34,35 +147,112 @@ object StreamingBridge {
         }
     }
 
+    // Reused by the polled getters so a poll allocates no JNI arrays (each locked while in use)
+    private val captureStatsScratch = FloatArray(10)
+    private val encoderStatsScratch = FloatArray(8)
+
     // Native method declarations
     private external fun nativeSetFrameCallback(callback: NativeFrameCallback?)
-    private external fun nativeStartFrameCapture(cameraId: String, width: Int, height: Int): Boolean
-    private external fun nativeStopFrameCapture()
-    private external fun nativeIsCapturing(): Boolean
+    private external fun nativeSetCaptureFrameCallback(cameraId: String, callback: NativeFrameCallback?)
+    private external fun nativeStartFrameCapture(
+        cameraId: String,
+        width: Int,
+        height: Int,
+        useHardwareBuffer: Boolean,
+        outputFormat: Int,
+        dropPolicy: Int
+    ): Boolean
+    private external fun nativeReleaseHardwareBuffer(frameId: Long, releaseFenceFd: Int): Boolean
+    private external fun nativeStopFrameCapture(cameraId: String?)
+    private external fun nativeIsCapturing(cameraId: String?): Boolean
+    private external fun nativeGetActiveCaptures(): String
+    private external fun nativeGetCaptureStats(cameraId: String?, out: FloatArray)
+    private external fun nativeSetCaptureTarget(
+        cameraId: String?,
+        bitrateBps: Int,
+        maxFrameRate: Float
+    ): Boolean
+    private external fun nativeSetCaptureCrop(
+        cameraId: String,
+        x: Int,
+        y: Int,
+        width: Int,
+        height: Int
+    ): Boolean
+    private external fun nativeGetLatencySnapshot(cameraId: String?, buffer: ByteBuffer): Int
     private external fun nativeReleaseEncoder()
+    private external fun nativeSetEncodedPacketCallback(callback: NativeEncodedPacketCallback?)
+    private external fun nativeStartNativeEncoder(
+        cameraId: String,
+        width: Int,
+        height: Int,
+        codec: Int,
+        bitrateBps: Int,
+        frameRate: Int,
+        keyFrameIntervalSec: Float,
+        lowLatency: Boolean
+    ): Boolean
+    private external fun nativeStopNativeEncoder()
+    private external fun nativeIsNativeEncoding(): Boolean
+    private external fun nativeRequestKeyFrame(): Boolean
+    private external fun nativeSetEncoderBitrate(bitrateBps: Int): Boolean
+    private external fun nativeGetNativeEncoderStats(out: FloatArray)
 
     /**
-     * Register a callback to receive raw camera frames.
-     * Must be called before startFrameCapture.
+     * Register a callback to receive raw camera frames from every capture without its own
+     * per-camera callback (and from session replay). Takes effect on running captures.
      */
     fun setFrameCallback(callback: NativeFrameCallback?) {
         log.info("Setting frame callback: ${if (callback != null) "registered" else "cleared"}")
         nativeSetFrameCallback(callback)
     }
 
+    /**
+     * Register a callback for one camera's capture, overriding the default from
+     * [setFrameCallback]. Each capture delivers on its own dispatch thread, so callbacks of
+     * different cameras run concurrently.
+     * @param callback null to fall back to the default callback
+     */
+    @Suppress("unused")  // Part of public API
+    fun setFrameCallback(cameraId: String, callback: NativeFrameCallback?) {
+        log.info("Setting frame callback", mapOf(
+            "cameraId" to cameraId,
+            "callback" to if (callback != null) "registered" else "cleared"
+        ))
+        nativeSetCaptureFrameCallback(cameraId, callback)
+    }
+
     /**
      * Start capturing frames from a camera for encoding.
+     * Captures of different cameras run in parallel; starting one leaves the others running.
      * @param cameraId Camera ID to capture from
      * @param width Desired capture width
      * @param height Desired capture height
+     * @param useHardwareBuffer Deliver frames via [NativeFrameCallback.onHardwareBuffer]
+     *        instead of copied YUV byte arrays
+     * @param format Packed layout of byte array frames (ignored in hardware buffer mode)
+     * @param dropPolicy Frames to discard when [NativeFrameCallback.onFrame] falls behind
+     *        (ignored in hardware buffer mode)
      * @return true if capture started successfully
      */
-    fun startFrameCapture(cameraId: String, width: Int, height: Int): Boolean {
+    fun startFrameCapture(
+        cameraId: String,
+        width: Int,
+        height: Int,
+        useHardwareBuffer: Boolean = false,
+        format: FrameFormat = FrameFormat.I420,
+        dropPolicy: FrameDropPolicy = FrameDropPolicy.DROP_OLDEST
+    ): Boolean {
         log.info("Starting frame capture", mapOf(
             "cameraId" to cameraId,
-            "resolution" to "${width}x${height}"
+            "resolution" to "${width}x${height}",
+            "hardwareBuffer" to useHardwareBuffer,
+            "format" to format.name,
+            "dropPolicy" to dropPolicy.name
         ))
-        return nativeStartFrameCapture(cameraId, width, height).also { success ->
+        return nativeStartFrameCapture(
+            cameraId, width, height, useHardwareBuffer, format.value, dropPolicy.value
+        ).also { success ->
             if (success) {
                 log.info("Frame capture started: $cameraId")
             } else {
@@ -71,18 +261,227 @@ object StreamingBridge {
         }
     }
 
+    /**
+     * Return a frame delivered to [NativeFrameCallback.onHardwareBuffer] to the camera.
+     * Safe from any thread; releasing a frame twice, or after its capture stopped, is a no-op.
+     * @param frameId Id passed to the callback
+     * @param releaseFenceFd Sync fence fd signalled when the consumer's GPU or codec access
+     *        completes, or -1 if it already has; ownership of the fd passes to this call
+     * @return true if the frame was still held
+     */
+    fun releaseHardwareBuffer(frameId: Long, releaseFenceFd: Int = -1): Boolean =
+        nativeReleaseHardwareBuffer(frameId, releaseFenceFd)
+
     /**
      * Stop frame capture.
+     * @param cameraId Capture to stop, or null to stop every capture
      */
-    fun stopFrameCapture() {
-        log.info("Stopping frame capture")
-        nativeStopFrameCapture()
+    fun stopFrameCapture(cameraId: String? = null) {
+        log.info("Stopping frame capture", mapOf("cameraId" to (cameraId ?: "all")))
+        nativeStopFrameCapture(cameraId)
     }
 
     /**
      * Check if currently capturing frames.
+     * @param cameraId Capture to check, or null for any capture
+     */
+    fun isCapturing(cameraId: String? = null): Boolean = nativeIsCapturing(cameraId)
+
+    /**
+     * Get the camera IDs with a running frame capture.
+     */
+    @Suppress("unused")  // Part of public API
+    fun getActiveCaptures(): List<String> {
+        val ids = nativeGetActiveCaptures()
+        return if (ids.isEmpty()) emptyList() else ids.split(",")
+    }
+
+    /**
+     * Get frame capture statistics, including buffer pool occupancy, starvation count
+     * and dispatch queue depth.
+     * @param cameraId Capture to query, or null for the only (or an arbitrary) capture
+     */
+    @Suppress("unused")  // Part of public API
+    fun getCaptureStats(cameraId: String? = null): CaptureStats {
+        val data = captureStatsScratch
+        synchronized(data) {
+            nativeGetCaptureStats(cameraId, data)
+            return CaptureStats(
+                frameRateHz = data.getOrElse(0) { 0f },
+                latencyMs = data.getOrElse(1) { 0f },
+                frameCount = data.getOrElse(2) { 0f }.toLong(),
+                droppedFrames = data.getOrElse(3) { 0f }.toLong(),
+                bufferPoolCapacity = data.getOrElse(4) { 0f }.toInt(),
+                bufferPoolInUse = data.getOrElse(5) { 0f }.toInt(),
+                bufferPoolStarvations = data.getOrElse(6) { 0f }.toLong(),
+                dispatchQueueDepth = data.getOrElse(7) { 0f }.toInt(),
+                decimatedFrames = data.getOrElse(8) { 0f }.toLong(),
+                scaleFactor = data.getOrElse(9) { 1f }.toInt()
+            )
+        }
+    }
+
+    /**
+     * Adapt native frame delivery to the encoder's current budget (e.g. from WebRTC bandwidth
+     * estimates), so frames it would drop are never converted or copied.
+     * Frames above [maxFrameRate] are discarded as they arrive, and byte array frames are
+     * box-downscaled 2x or 4x natively when [bitrateBps] cannot carry the capture resolution;
+     * [NativeFrameCallback.onFrame] then sees the reduced width and height.
+     * @param bitrateBps Target encoder bitrate; 0 keeps full resolution
+     * @param maxFrameRate Delivered frame rate cap; 0 delivers every camera frame
+     * @param cameraId Capture to adapt, or null for every running capture
+     * @return false if no such capture is running
+     */
+    @Suppress("unused")  // Part of public API
+    fun setCaptureTarget(
+        bitrateBps: Int,
+        maxFrameRate: Float = 0f,
+        cameraId: String? = null
+    ): Boolean {
+        log.info("Setting capture target", mapOf(
+            "cameraId" to (cameraId ?: "all"),
+            "bitrateBps" to bitrateBps,
+            "maxFrameRate" to maxFrameRate
+        ))
+        return nativeSetCaptureTarget(cameraId, bitrateBps, maxFrameRate)
+    }
+
+    /**
+     * Deliver only a region of interest of each byte array frame. The window is cut out
+     * natively while repacking, so pixels outside it are never read or copied; combined with
+     * [FrameFormat.Y8] a gaze pipeline receives a small fraction of the full frame.
+     * Coordinates are capture pixels (before any [setCaptureTarget] downscale) and round down
+     * to even; a window outside the frame falls back to the full frame.
+     * @return false if the camera has no capture
+     */
+    @Suppress("unused")  // Part of public API
+    fun setCaptureCrop(cameraId: String, x: Int, y: Int, width: Int, height: Int): Boolean {
+        log.info("Setting capture crop", mapOf(
+            "cameraId" to cameraId,
+            "region" to "${width}x${height}@$x,$y"
+        ))
+        return nativeSetCaptureCrop(cameraId, x, y, width, height)
+    }
+
+    /**
+     * Restore full-frame delivery after [setCaptureCrop].
+     */
+    @Suppress("unused")  // Part of public API
+    fun clearCaptureCrop(cameraId: String): Boolean = nativeSetCaptureCrop(cameraId, 0, 0, 0, 0)
+
+    /**
+     * Get latency percentiles (capture completed, image available, JNI delivered), jitter
+     * and drop counters for a frame capture.
+     * @param buffer Reusable buffer from [FrameLatencySnapshot.allocateBuffer]
+     * @param cameraId Capture to query, or null for the only (or an arbitrary) capture
+     * @return null if no such capture is running
+     */
+    @Suppress("unused")  // Part of public API
+    fun getLatencySnapshot(
+        buffer: ByteBuffer = FrameLatencySnapshot.allocateBuffer(),
+        cameraId: String? = null
+    ): FrameLatencySnapshot? {
+        require(buffer.isDirect) { "getLatencySnapshot requires a direct ByteBuffer" }
+        return FrameLatencySnapshot.parse(buffer, nativeGetLatencySnapshot(cameraId, buffer))
+    }
+
+    /**
+     * Register a callback to receive encoded packets from [startNativeEncoder].
+     */
+    @Suppress("unused")  // Part of public API
+    fun setEncodedPacketCallback(callback: NativeEncodedPacketCallback?) {
+        log.info("Setting encoded packet callback: ${if (callback != null) "registered" else "cleared"}")
+        nativeSetEncodedPacketCallback(callback)
+    }
+
+    /**
+     * Start hardware encoding of a camera without any CPU copy of the frames.
+     * The codec's input surface becomes an output of the camera's shared session, so a
+     * preview or frame capture of the same camera keeps running alongside it.
+     * @param width Encoded width; must be a supported camera output size (e.g. 3840x2160)
+     * @param keyFrameIntervalSec GOP length in seconds (0 = all key frames)
+     * @param lowLatency Codec low-latency mode with realtime priority and no B-frames
+     * @return true if the encoder is configured and attached to the camera
      */
-    fun isCapturing(): Boolean = nativeIsCapturing()
+    @Suppress("unused")  // Part of public API
+    fun startNativeEncoder(
+        cameraId: String,
+        width: Int,
+        height: Int,
+        codec: VideoCodec = VideoCodec.H264,
+        bitrateBps: Int = 8_000_000,
+        frameRate: Int = 30,
+        keyFrameIntervalSec: Float = 1.0f,
+        lowLatency: Boolean = true
+    ): Boolean {
+        log.info("Starting native encoder", mapOf(
+            "cameraId" to cameraId,
+            "resolution" to "${width}x${height}",
+            "codec" to codec.name,
+            "bitrateBps" to bitrateBps,
+            "frameRate" to frameRate,
+            "keyFrameIntervalSec" to keyFrameIntervalSec,
+            "lowLatency" to lowLatency
+        ))
+        return nativeStartNativeEncoder(
+            cameraId, width, height, codec.value, bitrateBps, frameRate,
+            keyFrameIntervalSec, lowLatency
+        ).also { success ->
+            if (success) {
+                log.info("Native encoder started: $cameraId")
+            } else {
+                log.error("Failed to start native encoder: $cameraId")
+            }
+        }
+    }
+
+    /**
+     * Stop hardware encoding (other consumers of the camera keep streaming).
+     */
+    @Suppress("unused")  // Part of public API
+    fun stopNativeEncoder() {
+        log.info("Stopping native encoder")
+        nativeStopNativeEncoder()
+    }
+
+    /**
+     * Check if the hardware encoder is running.
+     */
+    @Suppress("unused")  // Part of public API
+    fun isNativeEncoding(): Boolean = nativeIsNativeEncoding()
+
+    /**
+     * Ask the hardware encoder for an IDR frame as soon as possible.
+     */
+    @Suppress("unused")  // Part of public API
+    fun requestKeyFrame(): Boolean = nativeRequestKeyFrame()
+
+    /**
+     * Change the hardware encoder's target bitrate without restarting it.
+     */
+    @Suppress("unused")  // Part of public API
+    fun setEncoderBitrate(bitrateBps: Int): Boolean = nativeSetEncoderBitrate(bitrateBps)
+
+    /**
+     * Get hardware encoder statistics (rates since the previous call).
+     */
+    @Suppress("unused")  // Part of public API
+    fun getNativeEncoderStats(): NativeEncoderStats {
+        val data = encoderStatsScratch
+        synchronized(data) {
+            nativeGetNativeEncoderStats(data)
+            return NativeEncoderStats(
+                packets = data.getOrElse(0) { 0f }.toLong(),
+                keyFrames = data.getOrElse(1) { 0f }.toLong(),
+                bytes = data.getOrElse(2) { 0f }.toLong(),
+                bitrateKbps = data.getOrElse(3) { 0f },
+                frameRateHz = data.getOrElse(4) { 0f },
+                latencyP50Ms = data.getOrElse(5) { 0f },
+                latencyP95Ms = data.getOrElse(6) { 0f },
+                latencyP99Ms = data.getOrElse(7) { 0f }
+            )
+        }
+    }
 
     /**
      * Release all encoder resources.